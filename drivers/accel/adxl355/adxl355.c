@@ -56,6 +56,8 @@ static const uint8_t adxl355_part_id[] = {
 /******************************************************************************/
 static uint32_t adxl355_accel_array_conv(struct adxl355_dev *dev,
 		uint8_t *raw_array);
+static int adxl355_fifo_burst_read(struct adxl355_dev *dev, uint16_t *start,
+				   uint8_t *sets_nb);
 static int64_t adxl355_accel_conv(struct adxl355_dev *dev, uint32_t raw_accel);
 static int64_t adxl355_temp_conv(struct adxl355_dev *dev, uint16_t raw_temp);
 
@@ -711,11 +713,106 @@ int adxl355_set_fifo_samples(struct adxl355_dev *dev, uint8_t reg_value)
 	return ret;
 }
 
+/***************************************************************************//**
+ * @brief Sets the FIFO watermark. The FIFO_FULL status bit, and the interrupt
+ *        mapped to it, is raised once the FIFO holds this many x, y, z sets.
+ *
+ * @param dev     - The device structure.
+ * @param sets_nb - Number of x, y, z sets, 1 to ADXL355_MAX_FIFO_SETS.
+ *
+ * @return ret    - Result of the writing procedure.
+*******************************************************************************/
+int adxl355_set_fifo_watermark(struct adxl355_dev *dev, uint8_t sets_nb)
+{
+	if (!sets_nb || sets_nb > ADXL355_MAX_FIFO_SETS)
+		return -EINVAL;
+
+	return adxl355_set_fifo_samples(dev, sets_nb * ADXL355_FIFO_SET_ENTRIES);
+}
+
+/***************************************************************************//**
+ * @brief Reads all the FIFO entries in a single burst and locates the first
+ *        complete x, y, z set. A set is only accepted when it starts with the
+ *        x-axis marker, so a read that previously stopped in the middle of a
+ *        set is realigned on the next x entry instead of shifting the axes.
+ *
+ * @param dev     - The device structure.
+ * @param start   - Offset in dev->comm_buff of the first complete set.
+ * @param sets_nb - Number of complete sets found in dev->comm_buff.
+ *
+ * @return ret    - Result of the reading procedure.
+*******************************************************************************/
+static int adxl355_fifo_burst_read(struct adxl355_dev *dev, uint16_t *start,
+				   uint8_t *sets_nb)
+{
+	uint8_t entries;
+	uint16_t len;
+	uint16_t idx;
+	int ret;
+
+	*start = 0;
+	*sets_nb = 0;
+
+	ret = adxl355_get_nb_of_fifo_entries(dev, &entries);
+	if (ret)
+		return ret;
+
+	if (!entries)
+		return 0;
+
+	len = entries * 3;
+	ret = adxl355_read_device_data(dev, ADXL355_ADDR(ADXL355_FIFO_DATA), len,
+				       dev->comm_buff);
+	if (ret)
+		return ret;
+
+	for (idx = 0; idx < len; idx += 3) {
+		if ((dev->comm_buff[idx + 2] & (ADXL355_FIFO_X_MARKER |
+						ADXL355_FIFO_EMPTY_MARKER)) == ADXL355_FIFO_X_MARKER)
+			break;
+	}
+
+	*start = idx;
+	*sets_nb = (len - idx) / (ADXL355_FIFO_SET_ENTRIES * 3);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Drains the FIFO in a single burst read and returns the complete
+ *        x, y, z sets as sign extended samples.
+ *
+ * @param dev     - The device structure.
+ * @param xyz     - Interleaved x, y, z samples. Must hold at least
+ *                  ADXL355_MAX_FIFO_SETS * 3 values.
+ * @param sets_nb - Number of sets written in xyz.
+ *
+ * @return ret    - Result of the reading procedure.
+*******************************************************************************/
+int adxl355_fifo_drain(struct adxl355_dev *dev, int32_t *xyz,
+		       uint8_t *sets_nb)
+{
+	uint16_t start;
+	uint8_t *entry;
+	uint16_t i;
+	int ret;
+
+	ret = adxl355_fifo_burst_read(dev, &start, sets_nb);
+	if (ret)
+		return ret;
+
+	entry = &dev->comm_buff[start];
+	for (i = 0; i < *sets_nb * ADXL355_FIFO_SET_ENTRIES; i++, entry += 3)
+		xyz[i] = no_os_sign_extend32(adxl355_accel_array_conv(dev, entry), 19);
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Reads fifo data and returns the raw values.
  *
  * @param dev          - The device structure.
- * @param fifo_entries - The number of fifo entries.
+ * @param fifo_entries - The number of fifo entries holding complete sets.
  * @param raw_x        - Raw x-axis data.
  * @param raw_y        - Raw y-axis data.
  * @param raw_z        - Raw z-axis data.
@@ -725,32 +822,26 @@ int adxl355_set_fifo_samples(struct adxl355_dev *dev, uint8_t reg_value)
 int adxl355_get_raw_fifo_data(struct adxl355_dev *dev, uint8_t *fifo_entries,
 			      uint32_t *raw_x, uint32_t *raw_y, uint32_t *raw_z)
 {
+	uint8_t sets_nb;
+	uint16_t start;
+	uint8_t *entry;
+	uint8_t i;
 	int ret;
 
-	ret = adxl355_get_nb_of_fifo_entries(dev, fifo_entries);
+	ret = adxl355_fifo_burst_read(dev, &start, &sets_nb);
 	if (ret)
 		return ret;
 
-	if (*fifo_entries > 0) {
-
-		ret = adxl355_read_device_data(dev, ADXL355_ADDR(ADXL355_FIFO_DATA),
-					       *fifo_entries * 3, dev->comm_buff);
-		if (ret)
-			return ret;
-
-		for (uint16_t idx = 0; idx < *fifo_entries * 3; idx = idx + 9) {
-			if (((dev->comm_buff[idx+2] & 1) == 1)
-			    && ((dev->comm_buff[idx+2] & 2) == 0)) {
-				// This is x-axis
-				// Process data
-				raw_x[idx/9] = adxl355_accel_array_conv(dev, &dev->comm_buff[idx]);
-				raw_y[idx/9] = adxl355_accel_array_conv(dev, &dev->comm_buff[idx+3]);
-				raw_z[idx/9] = adxl355_accel_array_conv(dev, &dev->comm_buff[idx+6]);
-			}
-		}
+	entry = &dev->comm_buff[start];
+	for (i = 0; i < sets_nb; i++, entry += 9) {
+		raw_x[i] = adxl355_accel_array_conv(dev, entry);
+		raw_y[i] = adxl355_accel_array_conv(dev, entry + 3);
+		raw_z[i] = adxl355_accel_array_conv(dev, entry + 6);
 	}
 
-	return ret;
+	*fifo_entries = sets_nb * ADXL355_FIFO_SET_ENTRIES;
+
+	return 0;
 }
 
 /***************************************************************************//**
@@ -84,6 +84,12 @@
 
 #define ADXL355_SHADOW_REGISTER_BASE_ADDR (ADXL355_ADDR(0x50) | SET_ADXL355_TRANSF_LEN(5))
 #define ADXL355_MAX_FIFO_SAMPLES_VAL  0x60
+/* Each FIFO set holds one x, one y and one z entry */
+#define ADXL355_FIFO_SET_ENTRIES      3
+#define ADXL355_MAX_FIFO_SETS         (ADXL355_MAX_FIFO_SAMPLES_VAL / ADXL355_FIFO_SET_ENTRIES)
+/* FIFO entry markers, found in the least significant byte of each entry */
+#define ADXL355_FIFO_X_MARKER         NO_OS_BIT(0)
+#define ADXL355_FIFO_EMPTY_MARKER     NO_OS_BIT(1)
 #define ADXL355_SELF_TEST_TRIGGER_VAL 0x03
 #define ADXL355_RESET_CODE            0x52
 
@@ -373,6 +379,13 @@ int adxl355_get_nb_of_fifo_entries(struct adxl355_dev *dev, uint8_t *reg_value);
 /*! Sets the number of FIFO samples register value. */
 int adxl355_set_fifo_samples(struct adxl355_dev *dev, uint8_t reg_value);
 
+/*! Sets the FIFO watermark, expressed in x, y, z sets. */
+int adxl355_set_fifo_watermark(struct adxl355_dev *dev, uint8_t sets_nb);
+
+/*! Drains the FIFO in a single burst and returns sign extended x, y, z sets. */
+int adxl355_fifo_drain(struct adxl355_dev *dev, int32_t *xyz,
+		       uint8_t *sets_nb);
+
 /*! Reads fifo data and returns the raw values. */
 int adxl355_get_raw_fifo_data(struct adxl355_dev *dev, uint8_t *fifo_entries,
 			      uint32_t *raw_x, uint32_t *raw_y, uint32_t *raw_z);
@@ -981,6 +981,47 @@ static int adxl355_iio_update_channels(void* dev, uint32_t mask)
 	return 0;
 }
 
+/***************************************************************************//**
+ * @brief Drains the FIFO and writes every x, y, z set to the buffer. Used when
+ *        the trigger is driven by the FIFO watermark interrupt.
+ *
+ * @param dev_data  - The iio device data structure.
+ *
+ * @return ret - Result of the handling procedure.
+*******************************************************************************/
+static int32_t adxl355_fifo_trigger_handler(struct iio_device_data *dev_data)
+{
+	struct adxl355_iio_dev *iio_adxl355 = dev_data->dev;
+	uint32_t mask = dev_data->buffer->active_mask;
+	int32_t data_buff[3];
+	int32_t *set;
+	uint8_t sets_nb;
+	uint8_t i, j;
+	int ret;
+
+	ret = adxl355_fifo_drain(iio_adxl355->adxl355_dev, iio_adxl355->fifo_xyz,
+				 &sets_nb);
+	if (ret)
+		return ret;
+
+	set = iio_adxl355->fifo_xyz;
+	for (i = 0; i < sets_nb; i++, set += ADXL355_FIFO_SET_ENTRIES) {
+		j = 0;
+		if (mask & NO_OS_BIT(0))
+			data_buff[j++] = set[0];
+		if (mask & NO_OS_BIT(1))
+			data_buff[j++] = set[1];
+		if (mask & NO_OS_BIT(2))
+			data_buff[j++] = set[2];
+
+		ret = iio_buffer_push_scan(dev_data->buffer, data_buff);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Handles trigger: reads one data-set and writes it to the buffer.
  *
@@ -1006,6 +1047,9 @@ static int32_t adxl355_trigger_handler(struct iio_device_data *dev_data)
 	if (!iio_adxl355->adxl355_dev)
 		return -EINVAL;
 
+	if (iio_adxl355->fifo_watermark)
+		return adxl355_fifo_trigger_handler(dev_data);
+
 	adxl355 = iio_adxl355->adxl355_dev;
 
 	adxl355_get_raw_xyz(adxl355, &x, &y, &z);
@@ -1040,6 +1084,7 @@ int adxl355_iio_init(struct adxl355_iio_dev **iio_dev,
 {
 	int ret;
 	struct adxl355_iio_dev *desc;
+	union adxl355_int_mask int_mask;
 
 	desc = (struct adxl355_iio_dev *)no_os_calloc(1, sizeof(*desc));
 	if (!desc)
@@ -1069,6 +1114,22 @@ int adxl355_iio_init(struct adxl355_iio_dev **iio_dev,
 	if (ret)
 		goto error_config;
 
+	// Route the FIFO watermark to INT1 when FIFO streaming is requested
+	if (init_param->fifo_watermark) {
+		ret = adxl355_set_fifo_watermark(desc->adxl355_dev,
+						 init_param->fifo_watermark);
+		if (ret)
+			goto error_config;
+
+		int_mask.value = 0;
+		int_mask.fields.FULL_EN1 = 1;
+		ret = adxl355_config_int_pins(desc->adxl355_dev, int_mask);
+		if (ret)
+			goto error_config;
+
+		desc->fifo_watermark = init_param->fifo_watermark;
+	}
+
 	*iio_dev = desc;
 
 	return 0;
@@ -37,6 +37,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include "iio.h"
+#include "adxl355.h"
 #include "no_os_irq.h"
 
 /******************************************************************************/
@@ -53,10 +54,15 @@ struct adxl355_iio_dev {
 	int adxl355_hpf_3db_table[7][2];
 	uint32_t active_channels;
 	uint8_t no_of_active_channels;
+	uint8_t fifo_watermark;
+	int32_t fifo_xyz[ADXL355_MAX_FIFO_SETS * ADXL355_FIFO_SET_ENTRIES];
 };
 
 struct adxl355_iio_dev_init_param {
 	struct adxl355_init_param *adxl355_dev_init;
+	/** Number of x, y, z sets after which the FIFO_FULL interrupt is raised
+	 *  on INT1. When 0, the trigger is driven by DRDY, one sample at a time. */
+	uint8_t fifo_watermark;
 };
 
 /******************************************************************************/
@@ -1125,6 +1125,75 @@ int adxl367_read_raw_fifo(struct adxl367_dev *dev, int16_t *x, int16_t *y,
 	return 0;
 }
 
+/***************************************************************************//**
+ * @brief Drains the FIFO in a single burst read and returns the complete sample
+ * 		sets, interleaved in the order given by the FIFO format (for example
+ * 		x, y, z, temp for ADXL367_FIFO_FORMAT_XYZT). Leading entries which do
+ * 		not carry the channel ID of the first channel in a set are dropped,
+ * 		so the output is realigned after a previously interrupted read.
+ * 		Requires the ADXL367_14B_CHID read mode.
+ *
+ * @param dev     - The device structure.
+ * @param samples - Sign extended samples. Must hold ADXL367_FIFO_MAX_ENTRIES
+ * 			values.
+ * @param sets_nb - Number of complete sets stored in samples.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int adxl367_fifo_drain(struct adxl367_dev *dev, int16_t *samples,
+		       uint16_t *sets_nb)
+{
+	uint16_t entries, first, i;
+	uint8_t first_id;
+	uint16_t raw;
+	int ret;
+
+	*sets_nb = 0;
+
+	if (dev->fifo_read_mode != ADXL367_14B_CHID || !samples_per_set)
+		return -EINVAL;
+
+	ret = adxl367_get_nb_of_fifo_entries(dev, &entries);
+	if (ret)
+		return ret;
+
+	if (!entries)
+		return 0;
+
+	ret = adxl367_get_fifo_value(dev, dev->fifo_buffer, entries * 2);
+	if (ret)
+		return ret;
+
+	switch (dev->fifo_format) {
+	case ADXL367_FIFO_FORMAT_Y:
+	case ADXL367_FIFO_FORMAT_YT:
+	case ADXL367_FIFO_FORMAT_YA:
+		first_id = ADXL367_FIFO_Y_ID;
+		break;
+	case ADXL367_FIFO_FORMAT_Z:
+	case ADXL367_FIFO_FORMAT_ZT:
+	case ADXL367_FIFO_FORMAT_ZA:
+		first_id = ADXL367_FIFO_Z_ID;
+		break;
+	default:
+		first_id = ADXL367_FIFO_X_ID;
+		break;
+	}
+
+	for (first = 0; first < entries; first++)
+		if ((dev->fifo_buffer[first * 2] >> 6) == first_id)
+			break;
+
+	*sets_nb = (entries - first) / samples_per_set;
+
+	for (i = 0; i < *sets_nb * samples_per_set; i++) {
+		raw = no_os_get_unaligned_be16(&dev->fifo_buffer[(first + i) * 2]);
+		samples[i] = no_os_sign_extend32(raw & ADXL367_FIFO_DATA_MSK, 13);
+	}
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Reads converted values from FIFO. If, after setting FIFO mode, any of
  *      x, y, z, temp or adc aren't selected, assign NULL pointer. Uses
@@ -256,6 +256,9 @@
 #define ADXL367_FIFO_Y_ID		0x01
 #define ADXL367_FIFO_Z_ID		0x02
 #define ADXL367_FIFO_TEMP_ADC_ID	0x03
+#define ADXL367_FIFO_DATA_MSK		NO_OS_GENMASK(13, 0)
+/* FIFO capacity, in entries */
+#define ADXL367_FIFO_MAX_ENTRIES	512
 
 #define ADXL367_ABSOLUTE		0x00
 #define ADXL367_REFERENCED 		0x01
@@ -567,6 +570,10 @@ int adxl367_fifo_setup(struct adxl367_dev *dev,
 int adxl367_read_raw_fifo(struct adxl367_dev *dev, int16_t *x, int16_t *y,
 			  int16_t *z, int16_t *temp_adc, uint16_t *entries);
 
+/* Drains the FIFO in a single burst and returns the complete sample sets. */
+int adxl367_fifo_drain(struct adxl367_dev *dev, int16_t *samples,
+		       uint16_t *sets_nb);
+
 /* Reads converted values from FIFO. */
 int adxl367_read_converted_fifo(struct adxl367_dev *dev,
 				struct adxl367_fractional_val *x, struct adxl367_fractional_val *y,
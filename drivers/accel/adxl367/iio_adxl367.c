@@ -709,6 +709,53 @@ static int adxl367_iio_read_samples(void* dev, int* buff, uint32_t samples)
 	return samples;
 }
 
+/***************************************************************************//**
+ * @brief Handles trigger: drains the FIFO and writes every x, y, z, temp set to
+ * 		  the buffer. Meant to be driven by the FIFO watermark interrupt.
+ *
+ * @param dev_data  - The iio device data structure.
+ *
+ * @return ret - Result of the handling procedure.
+*******************************************************************************/
+static int32_t adxl367_trigger_handler(struct iio_device_data *dev_data)
+{
+	struct adxl367_iio_dev *iio_adxl367;
+	int16_t data_buff[4];
+	uint32_t mask;
+	int16_t *set;
+	uint16_t sets_nb, i;
+	uint8_t ch, j;
+	int ret;
+
+	if (!dev_data)
+		return -EINVAL;
+
+	iio_adxl367 = (struct adxl367_iio_dev *)dev_data->dev;
+
+	if (!iio_adxl367->adxl367_dev || !iio_adxl367->fifo_watermark)
+		return -EINVAL;
+
+	ret = adxl367_fifo_drain(iio_adxl367->adxl367_dev,
+				 iio_adxl367->fifo_samples, &sets_nb);
+	if (ret)
+		return ret;
+
+	mask = dev_data->buffer->active_mask;
+	set = iio_adxl367->fifo_samples;
+	for (i = 0; i < sets_nb; i++, set += NO_OS_ARRAY_SIZE(data_buff)) {
+		j = 0;
+		for (ch = 0; ch < NO_OS_ARRAY_SIZE(data_buff); ch++)
+			if (mask & NO_OS_BIT(ch))
+				data_buff[j++] = set[ch];
+
+		ret = iio_buffer_push_scan(dev_data->buffer, data_buff);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Initializes the ADXL367 IIO driver
  *
@@ -723,6 +770,7 @@ int adxl367_iio_init(struct adxl367_iio_dev **iio_dev,
 {
 	int ret;
 	struct adxl367_iio_dev *desc;
+	struct adxl367_int_map int_map = { 0 };
 
 	desc = (struct adxl367_iio_dev *)no_os_calloc(1, sizeof(*desc));
 	if (!desc)
@@ -745,6 +793,22 @@ int adxl367_iio_init(struct adxl367_iio_dev **iio_dev,
 	if (ret)
 		goto error_config;
 
+	// Stream x, y, z, temp sets through the FIFO, watermark routed to INT1
+	if (init_param->fifo_watermark) {
+		ret = adxl367_fifo_setup(desc->adxl367_dev, ADXL367_STREAM_MODE,
+					 ADXL367_FIFO_FORMAT_XYZT,
+					 init_param->fifo_watermark);
+		if (ret)
+			goto error_config;
+
+		int_map.fifo_watermark = 1;
+		ret = adxl367_int_map(desc->adxl367_dev, &int_map, 1);
+		if (ret)
+			goto error_config;
+
+		desc->fifo_watermark = init_param->fifo_watermark;
+	}
+
 	// Enter measure mode
 	ret = adxl367_set_power_mode(desc->adxl367_dev, ADXL367_OP_MEASURE);
 	if (ret)
@@ -887,6 +951,7 @@ static struct iio_device adxl367_iio_dev = {
 	.num_ch = NO_OS_ARRAY_SIZE(adxl367_channels),
 	.channels = adxl367_channels,
 	.pre_enable = (int32_t (*)())adxl367_iio_update_channels,
+	.trigger_handler = (int32_t (*)())adxl367_trigger_handler,
 	.read_dev = (int32_t (*)())adxl367_iio_read_samples,
 	.debug_reg_read = (int32_t (*)())adxl367_iio_read_reg,
 	.debug_reg_write = (int32_t (*)())adxl367_iio_write_reg
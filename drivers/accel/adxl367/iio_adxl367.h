@@ -37,6 +37,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include "iio.h"
+#include "adxl367.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -46,10 +47,15 @@ struct adxl367_iio_dev {
 	struct iio_device *iio_dev;
 	uint32_t active_channels;
 	uint8_t no_of_active_channels;
+	uint8_t fifo_watermark;
+	int16_t fifo_samples[ADXL367_FIFO_MAX_ENTRIES];
 };
 
 struct adxl367_iio_init_param {
 	struct adxl367_init_param *adxl367_initial_param;
+	/** Number of x, y, z, temp sets after which the FIFO watermark
+	 *  interrupt is raised on INT1. When 0, the FIFO is not used. */
+	uint8_t fifo_watermark;
 };
 
 /******************************************************************************/
@@ -34,6 +34,7 @@
 /******************************************************************************/
 /***************************** Include Files **********************************/
 /******************************************************************************/
+#include <string.h>
 #include "ad74413r.h"
 #include "no_os_crc8.h"
 #include "no_os_delay.h"
@@ -47,6 +48,7 @@
 #define AD74413R_FRAME_SIZE 		4
 #define AD74413R_CRC_POLYNOMIAL 	0x7
 #define AD74413R_DIN_DEBOUNCE_LEN 	NO_OS_BIT(5)
+#define AD74413R_ADC_RDY_POLL_US	10
 
 /******************************************************************************/
 /************************ Variable Declarations ******************************/
@@ -278,6 +280,86 @@ int ad74413r_reg_read(struct ad74413r_desc *desc, uint32_t addr, uint16_t *val)
 	return 0;
 }
 
+/**
+ * @brief Read the raw frames of multiple registers in a single SPI transfer
+ * list. Each frame selects the register returned by the next one, so reading
+ * N registers takes N + 1 frames instead of 2 * N. The CRC of all the frames
+ * is checked once the transfer is done.
+ * @param desc - The device structure.
+ * @param addr - The registers' addresses.
+ * @param nb_regs - The number of registers (at most AD74413R_MAX_READBACK_REGS).
+ * @param frames - The raw comm frames, AD74413R_FRAME_SIZE bytes each.
+ * @return 0 in case of success, -EINVAL if a CRC check failed, negative error
+ * otherwise.
+ */
+int ad74413r_reg_read_multiple_raw(struct ad74413r_desc *desc,
+				   const uint32_t *addr, uint32_t nb_regs,
+				   uint8_t *frames)
+{
+	uint8_t tx[(AD74413R_MAX_READBACK_REGS + 1) * AD74413R_FRAME_SIZE];
+	uint8_t rx[(AD74413R_MAX_READBACK_REGS + 1) * AD74413R_FRAME_SIZE];
+	struct no_os_spi_msg msgs[AD74413R_MAX_READBACK_REGS + 1] = { 0 };
+	uint8_t *frame;
+	uint32_t i;
+	int ret;
+
+	if (!nb_regs || nb_regs > AD74413R_MAX_READBACK_REGS)
+		return -EINVAL;
+
+	for (i = 0; i <= nb_regs; i++) {
+		frame = &tx[i * AD74413R_FRAME_SIZE];
+		if (i < nb_regs)
+			ad74413r_format_reg_write(AD74413R_READ_SELECT, addr[i], frame);
+		else
+			ad74413r_format_reg_write(AD74413R_NOP, AD74413R_NOP, frame);
+
+		msgs[i].tx_buff = frame;
+		msgs[i].rx_buff = &rx[i * AD74413R_FRAME_SIZE];
+		msgs[i].bytes_number = AD74413R_FRAME_SIZE;
+		msgs[i].cs_change = 1;
+	}
+
+	ret = no_os_spi_transfer(desc->comm_desc, msgs, nb_regs + 1);
+	if (ret)
+		return ret;
+
+	/* The first frame holds the response to a previous command */
+	memcpy(frames, &rx[AD74413R_FRAME_SIZE], nb_regs * AD74413R_FRAME_SIZE);
+
+	for (i = 0; i < nb_regs; i++) {
+		frame = &frames[i * AD74413R_FRAME_SIZE];
+		if (no_os_crc8(_crc_table, frame, 3, 0) != frame[3])
+			ret = -EINVAL;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Read multiple registers' values using pipelined readback.
+ * @param desc - The device structure.
+ * @param addr - The registers' addresses.
+ * @param nb_regs - The number of registers (at most AD74413R_MAX_READBACK_REGS).
+ * @param val - The registers' values.
+ * @return 0 in case of success, negative error otherwise
+ */
+int ad74413r_reg_read_multiple(struct ad74413r_desc *desc, const uint32_t *addr,
+			       uint32_t nb_regs, uint16_t *val)
+{
+	uint8_t frames[AD74413R_MAX_READBACK_REGS * AD74413R_FRAME_SIZE];
+	uint32_t i;
+	int ret;
+
+	ret = ad74413r_reg_read_multiple_raw(desc, addr, nb_regs, frames);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < nb_regs; i++)
+		val[i] = no_os_get_unaligned_be16(&frames[i * AD74413R_FRAME_SIZE + 1]);
+
+	return 0;
+}
+
 /**
  * @brief Update a register's field.
  * @param desc  - The device structure.
@@ -694,6 +776,38 @@ int ad74413r_set_adc_conv_seq(struct ad74413r_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Wait for the end of a conversion sequence, signaled by the ADC_DATA_RDY
+ * bit, and clear it.
+ * @param desc - The device structure.
+ * @param timeout_us - Maximum time to wait.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad74413r_wait_adc_data_ready(struct ad74413r_desc *desc,
+				 uint32_t timeout_us)
+{
+	uint32_t timeout = timeout_us / AD74413R_ADC_RDY_POLL_US;
+	uint16_t status;
+	int ret;
+
+	while (true) {
+		ret = ad74413r_reg_read(desc, AD74413R_LIVE_STATUS, &status);
+		if (ret)
+			return ret;
+
+		if (status & AD74413R_ADC_DATA_RDY_MASK)
+			break;
+
+		if (!timeout--)
+			return -ETIMEDOUT;
+
+		no_os_udelay(AD74413R_ADC_RDY_POLL_US);
+	}
+
+	return ad74413r_reg_write(desc, AD74413R_LIVE_STATUS,
+				  AD74413R_ADC_DATA_RDY_MASK);
+}
+
 /**
  * @brief Get a single ADC raw value for a specific channel, then power down the ADC.
  * @param desc - The device structure.
@@ -721,10 +835,6 @@ int ad74413r_get_adc_single(struct ad74413r_desc *desc, uint32_t ch,
 	if (ret)
 		return ret;
 
-	ret = ad74413r_set_adc_conv_seq(desc, AD74413R_START_SINGLE);
-	if (ret)
-		return ret;
-
 	if (is_diag)
 		ret = ad74413r_get_adc_diag_rejection(desc, &rejection);
 	else
@@ -737,11 +847,23 @@ int ad74413r_get_adc_single(struct ad74413r_desc *desc, uint32_t ch,
 	else
 		delay = conv_times_ad74412r[rejection];
 
-	/** Wait for all channels to complete the conversion. */
-	if (delay < 1000)
-		no_os_udelay(delay * nb_active_channels);
-	else
-		no_os_mdelay((delay * nb_active_channels) / 1000);
+	/* Discard a data ready flag left by a previous sequence */
+	ret = ad74413r_reg_write(desc, AD74413R_LIVE_STATUS,
+				 AD74413R_ADC_DATA_RDY_MASK);
+	if (ret)
+		return ret;
+
+	ret = ad74413r_set_adc_conv_seq(desc, AD74413R_START_SINGLE);
+	if (ret)
+		return ret;
+
+	/**
+	 * Wait for all channels to complete the conversion. The worst case
+	 * conversion time is only used as a timeout.
+	 */
+	ret = ad74413r_wait_adc_data_ready(desc, 2 * delay * nb_active_channels);
+	if (ret)
+		return ret;
 
 	if (is_diag)
 		ret = ad74413r_get_diag(desc, ch, val);
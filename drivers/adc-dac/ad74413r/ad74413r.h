@@ -41,6 +41,10 @@
 #define AD74413R_N_CHANNELS             4
 #define AD74413R_N_DIAG_CHANNELS	4
 
+/** Maximum number of registers read by a single pipelined readback */
+#define AD74413R_MAX_READBACK_REGS	(AD74413R_N_CHANNELS + \
+					 AD74413R_N_DIAG_CHANNELS + 2)
+
 #define AD74413R_CH_A                   0
 #define AD74413R_CH_B                   1
 #define AD74413R_CH_C                   2
@@ -138,6 +142,9 @@
 #define AD74413R_DIAG_EN_MASK(x)		(NO_OS_BIT(x) << 4)
 #define AD74413R_CH_EN_MASK(x)                  NO_OS_BIT(x)
 
+/** LIVE_STATUS register */
+#define AD74413R_ADC_DATA_RDY_MASK		NO_OS_BIT(14)
+
 /** DIAG_ASSIGN register */
 #define AD74413R_DIAG_ASSIGN_MASK(x)		(NO_OS_GENMASK(3, 0) << (x * 4))
 
@@ -371,6 +378,14 @@ int ad74413r_reg_read_raw(struct ad74413r_desc *, uint32_t, uint8_t *);
 /** Read a register's value */
 int ad74413r_reg_read(struct ad74413r_desc *, uint32_t, uint16_t *);
 
+/** Read the raw frames of multiple registers using pipelined readback */
+int ad74413r_reg_read_multiple_raw(struct ad74413r_desc *, const uint32_t *,
+				   uint32_t, uint8_t *);
+
+/** Read multiple registers' values using pipelined readback */
+int ad74413r_reg_read_multiple(struct ad74413r_desc *, const uint32_t *,
+			       uint32_t, uint16_t *);
+
 /** Update a register's field */
 int ad74413r_reg_update(struct ad74413r_desc *, uint32_t, uint16_t,
 			uint16_t);
@@ -495,6 +510,9 @@ int ad74413r_gpo_set_multiple(struct ad74413r_desc *, uint32_t);
 int ad74413r_get_live(struct ad74413r_desc *,
 		      union ad74413r_live_status *);
 
+/** Wait for the end of a conversion sequence and clear the data ready flag */
+int ad74413r_wait_adc_data_ready(struct ad74413r_desc *, uint32_t);
+
 /**
  * The code value will be loaded into the DACs when the CLR_EN bit in the
  * OUTPUT_CONFIGx registers is asserted and the DAC clear key is written
@@ -47,6 +47,10 @@
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
+/** Longest conversion sequence: all the channels at the lowest rate */
+#define AD74413R_IIO_SCAN_TIMEOUT_US	(2 * (AD74413R_N_CHANNELS + \
+					      AD74413R_N_DIAG_CHANNELS) * 100000)
+
 #define AD74413R_ADC_CHANNEL(type, attrs)                       \
         {                                                       \
                 .ch_type = type,                                \
@@ -168,6 +172,8 @@ static int ad74413r_iio_buffer_disable(void *dev);
 static int ad74413r_iio_read_samples(void *dev, uint32_t *buf,
 				     uint32_t samples);
 static int ad74413r_iio_trigger_handler(struct iio_device_data *dev_data);
+static uint32_t ad74413r_iio_result_reg(struct ad74413r_iio_desc *iio_desc,
+					uint32_t ch);
 
 /******************************************************************************/
 /************************ Variable Declarations *******************************/
@@ -1366,6 +1372,7 @@ static int ad74413r_iio_update_channels(void *dev, uint32_t mask)
 
 	iio_desc->active_channels = mask;
 	iio_desc->no_of_active_channels = no_os_hweight8(mask);
+	iio_desc->nb_scan_regs = 0;
 
 	for (i = 0; i < AD74413R_N_CHANNELS + AD74413R_N_DIAG_CHANNELS; i++) {
 		if (mask & NO_OS_BIT(i)) {
@@ -1373,6 +1380,10 @@ static int ad74413r_iio_update_channels(void *dev, uint32_t mask)
 			if (ret)
 				return ret;
 
+			iio_desc->scan_ch[iio_desc->nb_scan_regs] = ch;
+			iio_desc->scan_regs[iio_desc->nb_scan_regs++] =
+				ad74413r_iio_result_reg(iio_desc, ch);
+
 			if (ch < AD74413R_N_CHANNELS) {
 				ret = ad74413r_set_adc_channel_enable(iio_desc->ad74413r_desc,
 								      ch, true);
@@ -1433,6 +1444,61 @@ static int ad74413r_iio_buffer_disable(void *dev)
 	return 0;
 }
 
+/**
+ * @brief Get the register holding the result of a channel.
+ * @param iio_desc - The iio device structure.
+ * @param ch - The channel index, diagnostics channels start at
+ * AD74413R_N_CHANNELS.
+ * @return The register's address.
+ */
+static uint32_t ad74413r_iio_result_reg(struct ad74413r_iio_desc *iio_desc,
+					uint32_t ch)
+{
+	if (ch >= AD74413R_N_CHANNELS)
+		return AD74413R_DIAG_RESULT(ch - AD74413R_N_CHANNELS);
+
+	if (iio_desc->channel_configs[ch].function == AD74413R_DIGITAL_INPUT ||
+	    iio_desc->channel_configs[ch].function == AD74413R_DIGITAL_INPUT_LOOP)
+		return AD74413R_DIN_COMP_OUT;
+
+	return AD74413R_ADC_RESULT(ch);
+}
+
+/**
+ * @brief Read the results of all the active channels using a single pipelined
+ * readback.
+ * @param iio_desc - The iio device structure.
+ * @param buff - Scan buffer, 4 bytes (a raw comm frame) for each channel.
+ * @return 0 in case of success, an error code otherwise.
+ */
+static int ad74413r_iio_read_scan(struct ad74413r_iio_desc *iio_desc,
+				  uint8_t *buff)
+{
+	uint32_t digital_val;
+	uint8_t *frame;
+	uint32_t i;
+	int ret;
+
+	ret = ad74413r_reg_read_multiple_raw(iio_desc->ad74413r_desc,
+					     iio_desc->scan_regs,
+					     iio_desc->nb_scan_regs, buff);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < iio_desc->nb_scan_regs; i++) {
+		if (iio_desc->scan_regs[i] != AD74413R_DIN_COMP_OUT)
+			continue;
+
+		frame = &buff[i * 4];
+		digital_val = no_os_field_get(AD74413R_DIN_COMP_CH(iio_desc->scan_ch[i]),
+					      frame[2]);
+		frame[1] = 0x0;
+		frame[2] = !!digital_val;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Read a number of samples from each enabled channel.
  * @param dev - The iio device structure.
@@ -1443,22 +1509,19 @@ static int ad74413r_iio_buffer_disable(void *dev)
 static int ad74413r_iio_read_samples(void *dev, uint32_t *buf, uint32_t samples)
 {
 	int ret;
-	uint32_t j = 0;
-	uint32_t val;
-	uint32_t i, chan_i;
+	uint32_t i;
 	struct ad74413r_iio_desc *iio_desc = dev;
 
 	for (i = 0; i < samples; i++) {
-		for (chan_i = 0; chan_i < AD74413R_N_CHANNELS; chan_i++) {
-			if (iio_desc->active_channels & NO_OS_BIT(chan_i)) {
-				ret = ad74413r_reg_read_raw(iio_desc->ad74413r_desc,
-							    AD74413R_ADC_RESULT(chan_i),
-							    (uint8_t *)&val);
-				if (ret)
-					return ret;
-				buf[j++] = val;
-			}
-		}
+		ret = ad74413r_wait_adc_data_ready(iio_desc->ad74413r_desc,
+						   AD74413R_IIO_SCAN_TIMEOUT_US);
+		if (ret)
+			return ret;
+
+		ret = ad74413r_iio_read_scan(iio_desc,
+					     (uint8_t *)&buf[i * iio_desc->nb_scan_regs]);
+		if (ret)
+			return ret;
 	}
 
 	return samples;
@@ -1471,53 +1534,12 @@ static int ad74413r_iio_read_samples(void *dev, uint32_t *buf, uint32_t samples)
  */
 static int ad74413r_iio_trigger_handler(struct iio_device_data *dev_data)
 {
+	uint8_t buff[AD74413R_MAX_READBACK_REGS * 4];
 	int ret;
-	uint32_t i;
-	uint32_t ch;
-	uint32_t diag_ch_idx;
-	uint32_t digital_val;
-	uint8_t buff[32] = {0};
-	uint32_t buffer_idx = 0;
-	struct ad74413r_iio_desc *iio_desc;
-	struct ad74413r_channel_config *config;
-	struct ad74413r_desc *desc;
-
-	iio_desc = dev_data->dev;
-	desc = iio_desc->ad74413r_desc;
-	config = iio_desc->channel_configs;
 
-	for (i = 0; i < AD74413R_N_CHANNELS + AD74413R_N_CHANNELS; i++) {
-		if (iio_desc->active_channels & NO_OS_BIT(i)) {
-			ret = _get_ch_by_idx(iio_desc->iio_dev, i, &ch);
-			if (ret)
-				continue;
-
-			if (ch < AD74413R_N_DIAG_CHANNELS) {
-				if (config[ch].function == AD74413R_DIGITAL_INPUT ||
-				    config[ch].function == AD74413R_DIGITAL_INPUT_LOOP) {
-					ret = ad74413r_reg_read_raw(desc, AD74413R_DIN_COMP_OUT,
-								    &buff[buffer_idx]);
-					digital_val = no_os_field_get(AD74413R_DIN_COMP_CH(ch),
-								      buff[buffer_idx + 2]);
-					buff[buffer_idx + 1] = 0x0;
-					buff[buffer_idx + 2] = !!digital_val;
-				} else {
-					ret = ad74413r_reg_read_raw(desc, AD74413R_ADC_RESULT(ch),
-								    &buff[buffer_idx]);
-				}
-			} else {
-				diag_ch_idx = ch - AD74413R_N_DIAG_CHANNELS;
-				ret = ad74413r_reg_read_raw(desc,
-							    AD74413R_DIAG_RESULT(diag_ch_idx),
-							    &buff[buffer_idx]);
-			}
-
-			if (ret)
-				return ret;
-
-			buffer_idx += 4;
-		}
-	}
+	ret = ad74413r_iio_read_scan(dev_data->dev, buff);
+	if (ret)
+		return ret;
 
 	return iio_buffer_push_scan(dev_data->buffer, buff);
 }
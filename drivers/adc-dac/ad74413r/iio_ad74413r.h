@@ -82,6 +82,12 @@ struct ad74413r_iio_desc {
 	enum ad74413r_conv_seq conv_state;
 	struct ad74413r_diag_channel_config
 		diag_channel_configs[AD74413R_N_DIAG_CHANNELS];
+	/** Result registers of the active channels, in scan order */
+	uint32_t scan_regs[AD74413R_MAX_READBACK_REGS];
+	/** Channel index of each scan_regs entry */
+	uint8_t scan_ch[AD74413R_MAX_READBACK_REGS];
+	/** Number of scan_regs entries */
+	uint8_t nb_scan_regs;
 };
 
 /**
@@ -34,6 +34,7 @@
 /******************************************************************************/
 /***************************** Include Files **********************************/
 /******************************************************************************/
+#include <string.h>
 #include "ad74416h.h"
 #include "no_os_crc8.h"
 #include "no_os_delay.h"
@@ -47,6 +48,7 @@
 #define AD74416H_CRC_POLYNOMIAL 	0x7
 #define AD74416H_DIN_DEBOUNCE_LEN 	NO_OS_BIT(5)
 #define AD77416H_DEV_ADDRESS_MSK	NO_OS_GENMASK(5, 4)
+#define AD74416H_ADC_RDY_POLL_US	10
 
 /******************************************************************************/
 /************************ Variable Declarations ******************************/
@@ -231,6 +233,88 @@ int ad74416h_reg_read(struct ad74416h_desc *desc, uint32_t addr, uint16_t *val)
 	return 0;
 }
 
+/**
+ * @brief Read the raw frames of multiple registers in a single SPI transfer
+ * list. Each frame selects the register returned by the next one, so reading
+ * N registers takes N + 1 frames instead of 2 * N. The CRC of all the frames
+ * is checked once the transfer is done.
+ * @param desc - The device structure.
+ * @param addr - The registers' addresses.
+ * @param nb_regs - The number of registers (at most AD74416H_MAX_READBACK_REGS).
+ * @param frames - The raw comm frames, AD74416H_FRAME_SIZE bytes each.
+ * @return 0 in case of success, -EINVAL if a CRC check failed, negative error
+ * otherwise.
+ */
+int ad74416h_reg_read_multiple_raw(struct ad74416h_desc *desc,
+				   const uint32_t *addr, uint32_t nb_regs,
+				   uint8_t *frames)
+{
+	uint8_t tx[(AD74416H_MAX_READBACK_REGS + 1) * AD74416H_FRAME_SIZE];
+	uint8_t rx[(AD74416H_MAX_READBACK_REGS + 1) * AD74416H_FRAME_SIZE];
+	struct no_os_spi_msg msgs[AD74416H_MAX_READBACK_REGS + 1] = { 0 };
+	uint8_t *frame;
+	uint32_t i;
+	int ret;
+
+	if (!nb_regs || nb_regs > AD74416H_MAX_READBACK_REGS)
+		return -EINVAL;
+
+	for (i = 0; i <= nb_regs; i++) {
+		frame = &tx[i * AD74416H_FRAME_SIZE];
+		if (i < nb_regs)
+			ad74416h_format_reg_write(desc->dev_addr, AD74416H_READ_SELECT,
+						  addr[i], frame);
+		else
+			ad74416h_format_reg_write(desc->dev_addr, AD74416H_NOP,
+						  AD74416H_NOP, frame);
+
+		msgs[i].tx_buff = frame;
+		msgs[i].rx_buff = &rx[i * AD74416H_FRAME_SIZE];
+		msgs[i].bytes_number = AD74416H_FRAME_SIZE;
+		msgs[i].cs_change = 1;
+	}
+
+	ret = no_os_spi_transfer(desc->spi_desc, msgs, nb_regs + 1);
+	if (ret)
+		return ret;
+
+	/* The first frame holds the response to a previous command */
+	memcpy(frames, &rx[AD74416H_FRAME_SIZE], nb_regs * AD74416H_FRAME_SIZE);
+
+	for (i = 0; i < nb_regs; i++) {
+		frame = &frames[i * AD74416H_FRAME_SIZE];
+		if (no_os_crc8(_crc_table, frame, 4, 0) != frame[4])
+			ret = -EINVAL;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Read multiple registers' values using pipelined readback.
+ * @param desc - The device structure.
+ * @param addr - The registers' addresses.
+ * @param nb_regs - The number of registers (at most AD74416H_MAX_READBACK_REGS).
+ * @param val - The registers' values.
+ * @return 0 in case of success, negative error otherwise
+ */
+int ad74416h_reg_read_multiple(struct ad74416h_desc *desc, const uint32_t *addr,
+			       uint32_t nb_regs, uint16_t *val)
+{
+	uint8_t frames[AD74416H_MAX_READBACK_REGS * AD74416H_FRAME_SIZE];
+	uint32_t i;
+	int ret;
+
+	ret = ad74416h_reg_read_multiple_raw(desc, addr, nb_regs, frames);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < nb_regs; i++)
+		val[i] = no_os_get_unaligned_be16(&frames[i * AD74416H_FRAME_SIZE + 2]);
+
+	return 0;
+}
+
 /**
  * @brief Update a register's field.
  * @param desc  - The device structure.
@@ -288,25 +372,51 @@ int ad74416h_nb_active_channels(struct ad74416h_desc *desc,
 int ad74416h_get_raw_adc_result(struct ad74416h_desc *desc, uint32_t ch,
 				uint32_t *val)
 {
-	uint32_t val_msb, val_lsb;
+	return ad74416h_get_raw_adc_results(desc, NO_OS_BIT(ch), val);
+}
+
+/**
+ * @brief Read the raw ADC conversion values of multiple channels, using a
+ * single pipelined readback.
+ * @param desc - The device structure.
+ * @param ch_mask - The channels to be read.
+ * @param val - The ADC raw conversion values, in ascending channel order.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad74416h_get_raw_adc_results(struct ad74416h_desc *desc, uint32_t ch_mask,
+				 uint32_t *val)
+{
+	uint32_t addr[2 * AD74416H_N_CHANNELS];
+	uint16_t res[2 * AD74416H_N_CHANNELS];
+	bool upr = desc->id == ID_AD74416H;
+	uint32_t ch, i, nb_regs = 0;
 	int ret;
 
-	if (desc->id == ID_AD74416H) {
-		ret = ad74416h_reg_read(desc, AD74416H_ADC_RESULT_UPR(ch),
-					&val_msb);
-		if (ret)
-			return ret;
+	if (!ch_mask || ch_mask & ~NO_OS_GENMASK(AD74416H_N_CHANNELS - 1, 0))
+		return -EINVAL;
+
+	for (ch = 0; ch < AD74416H_N_CHANNELS; ch++) {
+		if (!(ch_mask & NO_OS_BIT(ch)))
+			continue;
+
+		if (upr)
+			addr[nb_regs++] = AD74416H_ADC_RESULT_UPR(ch);
+		addr[nb_regs++] = AD74416H_ADC_RESULT(ch);
 	}
 
-	ret = ad74416h_reg_read(desc, AD74416H_ADC_RESULT(ch), &val_lsb);
+	ret = ad74416h_reg_read_multiple(desc, addr, nb_regs, res);
 	if (ret)
 		return ret;
 
-	if (desc->id == ID_AD74416H)
-		*val = (no_os_field_get(AD74416H_CONV_RES_UPR_MSK, val_msb) << 16) |
-		       no_os_field_get(AD74416H_CONV_RESULT_MSK, val_lsb);
-	else
-		*val = no_os_field_get(AD74416H_CONV_RESULT_MSK, val_lsb);
+	for (i = 0; i < nb_regs; i++) {
+		if (upr) {
+			*val = no_os_field_get(AD74416H_CONV_RES_UPR_MSK, res[i++]) << 16;
+			*val |= no_os_field_get(AD74416H_CONV_RESULT_MSK, res[i]);
+		} else {
+			*val = no_os_field_get(AD74416H_CONV_RESULT_MSK, res[i]);
+		}
+		val++;
+	}
 
 	return 0;
 }
@@ -498,6 +608,38 @@ int ad74416h_set_adc_conv_seq(struct ad74416h_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Wait for the end of a conversion sequence, signaled by the ADC_DATA_RDY
+ * bit, and clear it.
+ * @param desc - The device structure.
+ * @param timeout_us - Maximum time to wait.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad74416h_wait_adc_data_ready(struct ad74416h_desc *desc,
+				 uint32_t timeout_us)
+{
+	uint32_t timeout = timeout_us / AD74416H_ADC_RDY_POLL_US;
+	uint16_t status;
+	int ret;
+
+	while (true) {
+		ret = ad74416h_reg_read(desc, AD74416H_LIVE_STATUS, &status);
+		if (ret)
+			return ret;
+
+		if (status & AD74416H_ADC_DATA_RDY_MSK)
+			break;
+
+		if (!timeout--)
+			return -ETIMEDOUT;
+
+		no_os_udelay(AD74416H_ADC_RDY_POLL_US);
+	}
+
+	return ad74416h_reg_write(desc, AD74416H_LIVE_STATUS,
+				  AD74416H_ADC_DATA_RDY_MSK);
+}
+
 /**
  * @brief Get a single ADC raw value for a specific channel, then power down the ADC.
  * @param desc - The device structure.
@@ -521,17 +663,26 @@ int ad74416h_get_adc_single(struct ad74416h_desc *desc, uint32_t ch,
 	if (ret)
 		return ret;
 
-	ret = ad74416h_set_adc_conv_seq(desc, AD74416H_START_SINGLE);
+	ret = ad74416h_get_adc_rate(desc, ch, &rate);
 	if (ret)
 		return ret;
 
-	ret = ad74416h_get_adc_rate(desc, ch, &rate);
+	delay = AD74116H_CONV_TIME_US / conv_rate_ad74416h[rate];
+
+	/* Discard a data ready flag left by a previous sequence */
+	ret = ad74416h_reg_write(desc, AD74416H_LIVE_STATUS,
+				 AD74416H_ADC_DATA_RDY_MSK);
 	if (ret)
 		return ret;
 
-	delay = AD74116H_CONV_TIME_US / conv_rate_ad74416h[rate];
+	ret = ad74416h_set_adc_conv_seq(desc, AD74416H_START_SINGLE);
+	if (ret)
+		return ret;
 
-	no_os_udelay(delay * nb_active_channels);
+	/* The worst case conversion time is only used as a timeout */
+	ret = ad74416h_wait_adc_data_ready(desc, 2 * delay * nb_active_channels);
+	if (ret)
+		return ret;
 
 	ret = ad74416h_get_raw_adc_result(desc, ch, val);
 	if (ret)
@@ -48,6 +48,13 @@
 
 #define AD74416H_N_CHANNELS             4
 
+/**
+ * Maximum number of registers read by a single pipelined readback: the upper
+ * and lower ADC results and the diagnostic result of each channel, plus two
+ * status registers.
+ */
+#define AD74416H_MAX_READBACK_REGS	(3 * AD74416H_N_CHANNELS + 2)
+
 #define AD74416H_CH_A                   0
 #define AD74416H_CH_B                   1
 #define AD74416H_CH_C                   2
@@ -668,6 +675,14 @@ int ad74416h_reg_read_raw(struct ad74416h_desc *, uint32_t, uint8_t *);
 /** Read a register's value */
 int ad74416h_reg_read(struct ad74416h_desc *, uint32_t, uint16_t *);
 
+/** Read the raw frames of multiple registers using pipelined readback */
+int ad74416h_reg_read_multiple_raw(struct ad74416h_desc *, const uint32_t *,
+				   uint32_t, uint8_t *);
+
+/** Read multiple registers' values using pipelined readback */
+int ad74416h_reg_read_multiple(struct ad74416h_desc *, const uint32_t *,
+			       uint32_t, uint16_t *);
+
 /** Update a register's field */
 int ad74416h_reg_update(struct ad74416h_desc *, uint32_t, uint16_t,
 			uint16_t);
@@ -697,6 +712,13 @@ int ad74416h_set_channel_i_limit(struct ad74416h_desc *, uint32_t,
 int ad74416h_get_raw_adc_result(struct ad74416h_desc *, uint32_t,
 				uint32_t *);
 
+/** Read the raw ADC conversion values of multiple channels */
+int ad74416h_get_raw_adc_results(struct ad74416h_desc *, uint32_t,
+				 uint32_t *);
+
+/** Wait for the end of a conversion sequence and clear the data ready flag */
+int ad74416h_wait_adc_data_ready(struct ad74416h_desc *, uint32_t);
+
 /** Enable/disable a specific ADC channel */
 int ad74416h_set_adc_channel_enable(struct ad74416h_desc *, uint32_t,
 				    bool);
@@ -48,6 +48,10 @@
  */
 #define AD7124_POST_RESET_DELAY	4
 
+/* Read data command, also used to exit the continuous read mode */
+#define AD7124_READ_DATA_CMD	(AD7124_COMM_REG_WEN | AD7124_COMM_REG_RD | \
+				 AD7124_COMM_REG_RA(AD7124_DATA_REG))
+
 /***************************************************************************//**
  * @brief Reads the value of the specified register without checking if the
  *        device is ready to accept user requests.
@@ -980,6 +984,303 @@ int ad7124_set_power_mode(struct ad7124_dev *device,
 	return 0;
 }
 
+/***************************************************************************//**
+ * @brief Clocks out a continuous read sample: 24 bits of data followed by the
+ *        status byte and, if enabled, the CRC.
+ * @param dev    - The device structure.
+ * @param data   - Pointer to store the raw data.
+ * @param status - Pointer to store the status byte.
+ * @return Returns 0 for success or negative error code otherwise.
+*******************************************************************************/
+static int ad7124_cont_read_transfer(struct ad7124_dev *dev, uint32_t *data,
+				     uint8_t *status)
+{
+	uint8_t buf[6] = { 0 };
+	uint8_t len;
+	int ret;
+
+	len = (dev->use_crc != AD7124_DISABLE_CRC) ? 5 : 4;
+
+	ret = no_os_spi_write_and_read(dev->spi_desc, buf + 1, len);
+	if (ret)
+		return ret;
+
+	/* The CRC covers the read data command, as for a data register read */
+	if (dev->use_crc == AD7124_USE_CRC) {
+		buf[0] = AD7124_READ_DATA_CMD;
+		if (ad7124_compute_crc8(buf, len + 1))
+			return -EBADMSG;
+	}
+
+	*data = no_os_get_unaligned_be24(buf + 1);
+	*status = buf[4];
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief DOUT/RDY falling edge handler, reads the new sample in continuous read
+ *        mode and queues it.
+ * @param ctx - The device structure.
+ * @return None.
+*******************************************************************************/
+static void ad7124_rdy_irq_handler(void *ctx)
+{
+	struct ad7124_dev *dev = ctx;
+	uint32_t head = dev->cont_read_head;
+	uint32_t next = (head + 1) % AD7124_CONT_READ_BUF_SIZE;
+	uint32_t data;
+	uint8_t status;
+	int ret;
+
+	/* DOUT/RDY toggles while the sample is clocked out */
+	ret = no_os_irq_disable(dev->irq_ctrl, dev->gpio_rdy->number);
+	if (ret)
+		return;
+
+	ret = ad7124_cont_read_transfer(dev, &data, &status);
+	if (ret || next == dev->cont_read_tail) {
+		dev->cont_read_dropped++;
+	} else {
+		dev->cont_read_data[head] = data;
+		dev->cont_read_status[head] = status;
+		dev->cont_read_head = next;
+	}
+
+	no_os_irq_enable(dev->irq_ctrl, dev->gpio_rdy->number);
+}
+
+/***************************************************************************//**
+ * @brief Wait for DOUT/RDY to go low.
+ * @param dev        - The device structure.
+ * @param timeout_ms - Maximum time to wait.
+ * @return Returns 0 for success or negative error code otherwise.
+*******************************************************************************/
+static int ad7124_wait_for_rdy_low(struct ad7124_dev *dev, uint32_t timeout_ms)
+{
+	uint32_t timeout = timeout_ms * 1000 / AD7124_CONT_READ_POLL_US;
+	uint8_t rdy;
+	int ret;
+
+	while (true) {
+		ret = no_os_gpio_get_value(dev->gpio_rdy, &rdy);
+		if (ret)
+			return ret;
+		if (rdy == NO_OS_GPIO_LOW)
+			return 0;
+		if (!timeout--)
+			return -ETIMEDOUT;
+
+		no_os_udelay(AD7124_CONT_READ_POLL_US);
+	}
+}
+
+/***************************************************************************//**
+ * @brief Start a continuous acquisition of the enabled channels, with the
+ *        status register appended to each sample. When the DOUT/RDY GPIO is
+ *        available, the continuous read mode is used so that each sample is a
+ *        single transfer, without command byte. If an IRQ controller is also
+ *        available, samples are read on the DOUT/RDY falling edge.
+ * @param dev - The device structure.
+ * @return Returns 0 for success or negative error code otherwise.
+*******************************************************************************/
+int ad7124_continuous_read_start(struct ad7124_dev *dev)
+{
+	uint32_t ctrl;
+	int ret;
+
+	if (!dev)
+		return -EINVAL;
+
+	if (dev->cont_read_en)
+		return 0;
+
+	ctrl = dev->regs[AD7124_ADC_Control].value;
+	ctrl &= ~AD7124_ADC_CTRL_REG_MODE_MSK;
+	ctrl |= no_os_field_prep(AD7124_ADC_CTRL_REG_MODE_MSK, AD7124_CONTINUOUS) |
+		AD7124_ADC_CTRL_REG_DATA_STATUS;
+	/* Without DOUT/RDY the status register has to be polled, which is not
+	 * possible in continuous read mode */
+	if (dev->gpio_rdy)
+		ctrl |= AD7124_ADC_CTRL_REG_CONT_READ;
+
+	dev->cont_read_head = 0;
+	dev->cont_read_tail = 0;
+	dev->cont_read_dropped = 0;
+
+	ret = ad7124_write_register2(dev, AD7124_ADC_Control, ctrl);
+	if (ret)
+		return ret;
+
+	dev->mode = AD7124_CONTINUOUS;
+	dev->cont_read_en = true;
+
+	if (dev->irq_ctrl)
+		return no_os_irq_enable(dev->irq_ctrl, dev->gpio_rdy->number);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Get the next sample of a continuous acquisition.
+ * @param dev        - The device structure.
+ * @param data       - Pointer to store the raw data.
+ * @param chan       - Pointer to store the channel the sample belongs to.
+ * @param timeout_ms - Maximum time to wait for the sample.
+ * @return Returns 0 for success or negative error code otherwise.
+*******************************************************************************/
+int ad7124_continuous_read_sample(struct ad7124_dev *dev, int32_t *data,
+				  uint8_t *chan, uint32_t timeout_ms)
+{
+	uint32_t timeout = timeout_ms * 1000 / AD7124_CONT_READ_POLL_US;
+	uint32_t raw, tail;
+	uint8_t status;
+	int ret;
+
+	if (!dev || !dev->cont_read_en)
+		return -EINVAL;
+
+	if (dev->irq_ctrl) {
+		while (dev->cont_read_tail == dev->cont_read_head) {
+			if (!timeout--)
+				return -ETIMEDOUT;
+
+			no_os_udelay(AD7124_CONT_READ_POLL_US);
+		}
+
+		tail = dev->cont_read_tail;
+		raw = dev->cont_read_data[tail];
+		status = dev->cont_read_status[tail];
+		dev->cont_read_tail = (tail + 1) % AD7124_CONT_READ_BUF_SIZE;
+	} else if (dev->gpio_rdy) {
+		ret = ad7124_wait_for_rdy_low(dev, timeout_ms);
+		if (ret)
+			return ret;
+
+		ret = ad7124_cont_read_transfer(dev, &raw, &status);
+		if (ret)
+			return ret;
+	} else {
+		ret = ad7124_wait_for_conv_ready(dev, timeout);
+		if (ret)
+			return ret;
+
+		/* Data and status are read in a single transfer */
+		ret = ad7124_read_register(dev, &dev->regs[AD7124_Data]);
+		if (ret)
+			return ret;
+
+		raw = dev->regs[AD7124_Data].value;
+		status = dev->regs[AD7124_Status].value;
+	}
+
+	*data = raw;
+	*chan = AD7124_STATUS_REG_CH_ACTIVE(status);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Get a sample of each channel in a mask. The sequencer converts the
+ *        enabled channels in ascending order, samples are demultiplexed using
+ *        the channel ID of the status byte. If a sample is lost, the partial
+ *        scan is discarded and the next sequence is waited for.
+ * @param dev        - The device structure.
+ * @param ch_mask    - Channels to be read, all of them must be enabled.
+ * @param scan       - Samples, in ascending channel order.
+ * @param timeout_ms - Maximum time to wait for each sample.
+ * @return Returns 0 for success or negative error code otherwise.
+*******************************************************************************/
+int ad7124_continuous_read_scan(struct ad7124_dev *dev, uint32_t ch_mask,
+				int32_t *scan, uint32_t timeout_ms)
+{
+	uint32_t first, next, skipped = 0, i = 0;
+	uint32_t remaining;
+	int32_t data;
+	uint8_t chan;
+	int ret;
+
+	if (!ch_mask || (ch_mask & ~NO_OS_GENMASK(AD7124_MAX_CHANNELS - 1, 0)))
+		return -EINVAL;
+
+	first = no_os_find_first_set_bit(ch_mask);
+	next = first;
+
+	while (true) {
+		ret = ad7124_continuous_read_sample(dev, &data, &chan, timeout_ms);
+		if (ret)
+			return ret;
+
+		if (chan != next) {
+			if (++skipped > 2 * AD7124_MAX_CHANNELS)
+				return -EIO;
+
+			/* Enabled channels outside the mask are ignored */
+			if (!(ch_mask & NO_OS_BIT(chan)))
+				continue;
+
+			i = 0;
+			next = first;
+			if (chan != first)
+				continue;
+		}
+
+		scan[i++] = data;
+
+		remaining = ch_mask & ~NO_OS_GENMASK(chan, 0);
+		if (!remaining)
+			return 0;
+
+		next = no_os_find_first_set_bit(remaining);
+	}
+}
+
+/***************************************************************************//**
+ * @brief Stop a continuous acquisition. The continuous read mode is exited by
+ *        a read data command, only decoded while DOUT/RDY is low.
+ * @param dev - The device structure.
+ * @return Returns 0 for success or negative error code otherwise.
+*******************************************************************************/
+int ad7124_continuous_read_stop(struct ad7124_dev *dev)
+{
+	uint8_t buf[6] = { 0 };
+	uint32_t ctrl;
+	int ret;
+
+	if (!dev)
+		return -EINVAL;
+
+	if (!dev->cont_read_en)
+		return 0;
+
+	if (dev->irq_ctrl) {
+		ret = no_os_irq_disable(dev->irq_ctrl, dev->gpio_rdy->number);
+		if (ret)
+			return ret;
+	}
+
+	ctrl = dev->regs[AD7124_ADC_Control].value;
+	if (ctrl & AD7124_ADC_CTRL_REG_CONT_READ) {
+		ret = ad7124_wait_for_rdy_low(dev, AD7124_MAX_CONV_TIME_MS);
+		if (ret)
+			return ret;
+
+		buf[0] = AD7124_READ_DATA_CMD;
+		ret = no_os_spi_write_and_read(dev->spi_desc, buf,
+					       (dev->use_crc != AD7124_DISABLE_CRC) ? 6 : 5);
+		if (ret)
+			return ret;
+
+		ctrl &= ~AD7124_ADC_CTRL_REG_CONT_READ;
+		dev->regs[AD7124_ADC_Control].value = ctrl;
+	}
+
+	dev->cont_read_en = false;
+
+	return ad7124_write_register2(dev, AD7124_ADC_Control,
+				      ctrl & ~AD7124_ADC_CTRL_REG_DATA_STATUS);
+}
+
 /***************************************************************************//**
  * @brief Initializes the AD7124.
  * @param device     - The device structure.
@@ -995,7 +1296,7 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 	uint8_t setup_index;
 	uint8_t ch_index;
 
-	dev = (struct ad7124_dev *)no_os_malloc(sizeof(*dev));
+	dev = (struct ad7124_dev *)no_os_calloc(1, sizeof(*dev));
 	if (!dev)
 		return -ENOMEM;
 
@@ -1007,18 +1308,54 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 	if (ret)
 		goto error_dev;
 
+	ret = no_os_gpio_get_optional(&dev->gpio_rdy, init_param->gpio_rdy);
+	if (ret)
+		goto error_spi;
+
+	if (dev->gpio_rdy) {
+		ret = no_os_gpio_direction_input(dev->gpio_rdy);
+		if (ret)
+			goto error_gpio;
+	}
+
+	if (init_param->irq_ctrl) {
+		if (!dev->gpio_rdy) {
+			ret = -EINVAL;
+			goto error_gpio;
+		}
+
+		dev->irq_cb.callback = ad7124_rdy_irq_handler;
+		dev->irq_cb.ctx = dev;
+		dev->irq_cb.event = NO_OS_EVT_GPIO;
+		dev->irq_cb.peripheral = NO_OS_GPIO_IRQ;
+
+		ret = no_os_irq_register_callback(init_param->irq_ctrl,
+						  dev->gpio_rdy->number,
+						  &dev->irq_cb);
+		if (ret)
+			goto error_gpio;
+
+		dev->irq_ctrl = init_param->irq_ctrl;
+
+		ret = no_os_irq_trigger_level_set(dev->irq_ctrl,
+						  dev->gpio_rdy->number,
+						  NO_OS_IRQ_EDGE_FALLING);
+		if (ret)
+			goto error_irq;
+	}
+
 	/* Update the device structure with power-on/reset settings. */
 	dev->check_ready = init_param->check_ready;
 
 	/*  Reset the device interface.*/
 	ret = ad7124_reset(dev);
 	if (ret)
-		goto error_spi;
+		goto error_irq;
 
 	/* Initialize ADC mode register. */
 	ret = ad7124_write_register(dev, dev->regs[AD7124_ADC_CTRL_REG]);
 	if (ret)
-		goto error_spi;
+		goto error_irq;
 
 	/* Get CRC State. */
 	ad7124_update_crcsetting(dev);
@@ -1029,7 +1366,7 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 	/* Read ID register to identify the part. */
 	ret = ad7124_read_register(dev, &dev->regs[AD7124_ID_REG]);
 	if (ret)
-		goto error_spi;
+		goto error_irq;
 
 	if (dev->active_device == ID_AD7124_4) {
 		switch (dev->regs[AD7124_ID_REG].value) {
@@ -1039,7 +1376,7 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 			break;
 
 		default:
-			goto error_spi;
+			goto error_irq;
 		}
 	}
 
@@ -1051,7 +1388,7 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 			break;
 
 		default:
-			goto error_spi;
+			goto error_irq;
 		}
 	}
 
@@ -1060,56 +1397,62 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 					  init_param->setups[setup_index].bi_unipolar,
 					  setup_index);
 		if (ret)
-			goto error_spi;
+			goto error_irq;
 
 		ret = ad7124_set_reference_source(dev,
 						  init_param->setups[setup_index].ref_source,
 						  setup_index,
 						  init_param->ref_en);
 		if (ret)
-			goto error_spi;
+			goto error_irq;
 
 		ret = ad7124_enable_buffers(dev,
 					    init_param->setups[setup_index].ain_buff,
 					    init_param->setups[setup_index].ref_buff,
 					    setup_index);
 		if (ret)
-			goto error_spi;
+			goto error_irq;
 	}
 
 	ret = ad7124_set_adc_mode(dev, init_param->mode);
 	if (ret)
-		goto error_spi;
+		goto error_irq;
 
 	ret = ad7124_set_power_mode(dev,
 				    init_param->power_mode);
 	if (ret)
-		goto error_spi;
+		goto error_irq;
 
 	for (ch_index = 0; ch_index < AD7124_MAX_CHANNELS; ch_index++) {
 		ret = ad7124_connect_analog_input(dev,
 						  ch_index,
 						  init_param->chan_map[ch_index].ain);
 		if (ret)
-			goto error_spi;
+			goto error_irq;
 
 		ret = ad7124_assign_setup(dev,
 					  ch_index,
 					  init_param->chan_map[ch_index].setup_sel);
 		if (ret)
-			goto error_spi;
+			goto error_irq;
 
 		ret = ad7124_set_channel_status(dev,
 						ch_index,
 						init_param->chan_map[ch_index].channel_enable);
 		if (ret)
-			goto error_spi;
+			goto error_irq;
 	}
 
 	*device = dev;
 
 	return 0;
 
+error_irq:
+	if (dev->irq_ctrl)
+		no_os_irq_unregister_callback(dev->irq_ctrl, dev->gpio_rdy->number,
+					      &dev->irq_cb);
+error_gpio:
+	no_os_gpio_remove(dev->gpio_rdy);
 error_spi:
 	no_os_spi_remove(dev->spi_desc);
 error_dev:
@@ -1127,6 +1470,22 @@ int32_t ad7124_remove(struct ad7124_dev *dev)
 {
 	int32_t ret;
 
+	ret = ad7124_continuous_read_stop(dev);
+	if (ret)
+		return ret;
+
+	if (dev->irq_ctrl) {
+		ret = no_os_irq_unregister_callback(dev->irq_ctrl,
+						    dev->gpio_rdy->number,
+						    &dev->irq_cb);
+		if (ret)
+			return ret;
+	}
+
+	ret = no_os_gpio_remove(dev->gpio_rdy);
+	if (ret)
+		return ret;
+
 	ret = no_os_spi_remove(dev->spi_desc);
 	if (ret)
 		return ret;
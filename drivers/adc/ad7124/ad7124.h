@@ -39,6 +39,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "no_os_spi.h"
+#include "no_os_gpio.h"
+#include "no_os_irq.h"
 #include "no_os_delay.h"
 #include "no_os_util.h"
 
@@ -54,6 +56,13 @@
 /* Maximum number of channels */
 #define AD7124_MAX_CHANNELS	16
 
+/* Number of continuous read samples buffered between two RDY interrupts */
+#define AD7124_CONT_READ_BUF_SIZE	32
+/* Polling period while waiting for a continuous read sample */
+#define AD7124_CONT_READ_POLL_US	10
+/* Longest conversion time, at the lowest output data rate */
+#define AD7124_MAX_CONV_TIME_MS	1000
+
 /* AD7124-4 Standard Device ID */
 #define AD7124_4_STD_ID  0x04
 /* AD7124-4 B Grade Device ID */
@@ -497,6 +506,21 @@ struct ad7124_dev {
 	struct ad7124_channel_setup setups[AD7124_MAX_SETUPS];
 	/* Channel Mapping*/
 	struct ad7124_channel_map chan_map[AD7124_MAX_CHANNELS];
+	/* DOUT/RDY GPIO, optional */
+	struct no_os_gpio_desc *gpio_rdy;
+	/* IRQ controller handling the DOUT/RDY falling edge, optional */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/* DOUT/RDY interrupt callback */
+	struct no_os_callback_desc irq_cb;
+	/* Continuous read (DATA_STATUS) acquisition running */
+	bool cont_read_en;
+	/* Samples read by the RDY interrupt and not yet consumed */
+	uint32_t cont_read_data[AD7124_CONT_READ_BUF_SIZE];
+	uint8_t cont_read_status[AD7124_CONT_READ_BUF_SIZE];
+	volatile uint32_t cont_read_head;
+	volatile uint32_t cont_read_tail;
+	/* Samples dropped because of a full buffer or a CRC error */
+	uint32_t cont_read_dropped;
 };
 
 struct ad7124_init_param {
@@ -518,6 +542,11 @@ struct ad7124_init_param {
 	struct ad7124_channel_setup setups[AD7124_MAX_SETUPS];
 	/* Channel Mapping*/
 	struct ad7124_channel_map chan_map[AD7124_MAX_CHANNELS];
+	/* DOUT/RDY GPIO, optional. Needed to use the continuous read mode. */
+	struct no_os_gpio_init_param *gpio_rdy;
+	/* IRQ controller handling the DOUT/RDY falling edge, optional. Needs
+	 * gpio_rdy, samples are then read from interrupt context. */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
 };
 
 /******************************************************************************/
@@ -646,6 +675,20 @@ int ad7124_enable_buffers(struct ad7124_dev* device,
 int ad7124_set_power_mode(struct ad7124_dev *device,
 			  enum ad7124_power_mode mode);
 
+/* Start a continuous acquisition with the status appended to the data. */
+int ad7124_continuous_read_start(struct ad7124_dev *dev);
+
+/* Get the next sample of a continuous acquisition. */
+int ad7124_continuous_read_sample(struct ad7124_dev *dev, int32_t *data,
+				  uint8_t *chan, uint32_t timeout_ms);
+
+/* Get a sample of each channel in a mask, in sequencer order. */
+int ad7124_continuous_read_scan(struct ad7124_dev *dev, uint32_t ch_mask,
+				int32_t *scan, uint32_t timeout_ms);
+
+/* Stop a continuous acquisition. */
+int ad7124_continuous_read_stop(struct ad7124_dev *dev);
+
 /* Initializes the AD7124 */
 int32_t ad7124_setup(struct ad7124_dev **device,
 		     struct ad7124_init_param *init_param);
@@ -625,78 +625,63 @@ static int32_t iio_ad7124_close_channels(void *dev)
 }
 
 /**
- * @brief Get active channels in the form of a mask.
- * @param [in] desc - Device descriptor.
- * @param [out] mask - Resulting mask representing active channels.
+ * @brief Start the continuous acquisition of the active channels.
+ * @param [in] dev - Application descriptor.
+ * @param [in] mask - Mask of the active channels.
  * @return 0 in case of success, error code otherwise.
  */
-static int32_t iio_ad7124_get_active_channels(struct ad7124_dev * desc,
-		uint32_t *mask)
+static int32_t iio_ad7124_buffer_enable(void *dev, uint32_t mask)
 {
-	int32_t ret, i;
-	uint32_t reg_temp;
+	int32_t ret;
 
-	*mask = 0;
-	for (i = 0; i < 16; i++) {
-		ret = ad7124_read_register2(desc,
-					    (AD7124_CH0_MAP_REG + i),
-					    &reg_temp);
-		if (ret != 0)
-			return ret;
-		if (reg_temp & AD7124_CH_MAP_REG_CH_ENABLE)
-			*mask |= 1 << i;
-	}
+	ret = iio_ad7124_update_active_channels(dev, mask);
+	if (ret)
+		return ret;
 
-	return 0;
+	return ad7124_continuous_read_start(dev);
 }
 
 /**
- * @brief Get a number of samples from all the active channels.
- * @param [in] dev - Device descriptor.
- * @param [out] buff - Sample buffer.
- * @param [in] bn_samples - Number of samples to get.
- * @return Number of samples read.
+ * @brief Stop the continuous acquisition and close the active channels.
+ * @param [in] dev - Application descriptor.
+ * @return 0 in case of success, error code otherwise.
  */
-static int32_t iio_ad7124_read_samples(void *dev, int32_t *buff,
-				       uint32_t nb_samples)
+static int32_t iio_ad7124_buffer_disable(void *dev)
 {
-	struct ad7124_dev *desc = (struct ad7124_dev *)dev;
-	int32_t ret, i = 0, k;
-	int32_t value;
-	uint32_t ch_id = -1, test;
-	uint32_t mask;
+	int32_t ret;
 
-	ret = iio_ad7124_get_active_channels(desc, &mask);
-	if (ret != 0)
+	ret = ad7124_continuous_read_stop(dev);
+	if (ret)
 		return ret;
 
-	get_next_ch_idx(mask, ch_id, &ch_id);
-	do {
-		ret = ad7124_wait_for_conv_ready(desc, 10000);
-		if (ret != 0)
-			return ret;
-		ret = ad7124_read_data(desc, &value);
-		if (ret != 0)
+	return iio_ad7124_close_channels(dev);
+}
+
+/**
+ * @brief Fill the buffer with scans of the active channels, demultiplexed from
+ *        the continuous read samples using their status byte.
+ * @param [in] dev_data - IIO device data.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int iio_ad7124_submit(struct iio_device_data *dev_data)
+{
+	int32_t scan[AD7124_MAX_CHANNELS];
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < dev_data->buffer->samples; i++) {
+		ret = ad7124_continuous_read_scan(dev_data->dev,
+						  dev_data->buffer->active_mask,
+						  scan, AD7124_MAX_CONV_TIME_MS);
+		if (ret)
 			return ret;
-		ret = ad7124_get_read_chan_id(desc, &test);
-		if (ret != 0)
+
+		ret = iio_buffer_push_scan(dev_data->buffer, scan);
+		if (ret)
 			return ret;
-	} while (ch_id != test);
-	buff[i++] = value;
-
-	for (k = 0; k < nb_samples; k++) {
-		while (get_next_ch_idx(mask, ch_id, &ch_id)) {
-			ret = ad7124_wait_for_conv_ready(desc, 10000);
-			if (ret != 0)
-				return ret;
-			ret = ad7124_read_data(desc, &value);
-			if (ret != 0)
-				return ret;
-			buff[i++] = value;
-		}
 	}
 
-	return nb_samples;
+	return 0;
 }
 
 struct iio_device iio_ad7124_device = {
@@ -705,9 +690,9 @@ struct iio_device iio_ad7124_device = {
 	.attributes = NULL,
 	.debug_attributes = NULL,
 	.buffer_attributes = NULL,
-	.pre_enable = iio_ad7124_update_active_channels,
-	.post_disable = iio_ad7124_close_channels,
-	.read_dev = (int32_t (*)())iio_ad7124_read_samples,
+	.pre_enable = iio_ad7124_buffer_enable,
+	.post_disable = iio_ad7124_buffer_disable,
+	.submit = iio_ad7124_submit,
 	.debug_reg_read = (int32_t (*)())ad7124_read_register2,
 	.debug_reg_write = (int32_t (*)())ad7124_write_register2
 };
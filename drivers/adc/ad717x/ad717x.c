@@ -41,12 +41,17 @@
 #include "ad717x.h"
 #include "no_os_error.h"
 #include "no_os_alloc.h"
+#include "no_os_delay.h"
 
 /* Error codes */
 #define INVALID_VAL -1 /* Invalid argument */
 #define COMM_ERR    -2 /* Communication error on receive */
 #define TIMEOUT     -3 /* A timeout has occured */
 
+/* Read data command, also used to exit the continuous read mode */
+#define AD717X_READ_DATA_CMD	(AD717X_COMM_REG_WEN | AD717X_COMM_REG_RD | \
+				 AD717X_COMM_REG_RA(AD717X_DATA_REG))
+
 /***************************************************************************//**
  * @brief Set channel status - Enable/Disable
  * @param device - AD717x Device descriptor.
@@ -371,6 +376,324 @@ int ad717x_single_read(ad717x_dev* device,  uint8_t id, int32_t *adc_raw_data)
 	return ad717x_set_channel_status(device, id, false);
 }
 
+/***************************************************************************//**
+ * @brief Read a sample and its status byte in a single transfer. The data
+ *        register size must account for the status byte.
+ * @param device - AD717x Device Descriptor
+ * @param cmd - True to send the read data command, false in continuous read
+ *		mode.
+ * @param data - Raw data
+ * @param status - Status byte
+ * @return Returns 0 for success or negative error code in case of failure.
+******************************************************************************/
+static int ad717x_data_status_read(ad717x_dev *device, bool cmd,
+				   uint32_t *data, uint8_t *status)
+{
+	ad717x_st_reg *data_reg;
+	uint8_t buf[8] = { 0 };
+	uint8_t check8 = 0;
+	uint8_t len, i;
+	int ret;
+
+	data_reg = AD717X_GetReg(device, AD717X_DATA_REG);
+	if (!data_reg)
+		return -EINVAL;
+
+	len = data_reg->size + ((device->useCRC != AD717X_DISABLE) ? 1 : 0);
+
+	buf[0] = AD717X_READ_DATA_CMD;
+	if (cmd)
+		ret = no_os_spi_write_and_read(device->spi_desc, buf, len + 1);
+	else
+		ret = no_os_spi_write_and_read(device->spi_desc, buf + 1, len);
+	if (ret)
+		return ret;
+
+	/* The checksum covers the read data command in both cases */
+	buf[0] = AD717X_READ_DATA_CMD;
+	if (device->useCRC == AD717X_USE_CRC)
+		check8 = AD717X_ComputeCRC8(buf, len + 1);
+	else if (device->useCRC == AD717X_USE_XOR)
+		check8 = AD717X_ComputeXOR8(buf, len + 1);
+	if (check8)
+		return -EBADMSG;
+
+	*data = 0;
+	for (i = 1; i < data_reg->size; i++)
+		*data = (*data << 8) | buf[i];
+	*status = buf[data_reg->size];
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief DOUT/RDY falling edge handler, reads the new sample in continuous read
+ *        mode and queues it.
+ * @param ctx - AD717x Device Descriptor
+ * @return None.
+******************************************************************************/
+static void ad717x_rdy_irq_handler(void *ctx)
+{
+	ad717x_dev *device = ctx;
+	uint32_t head = device->cont_read_head;
+	uint32_t next = (head + 1) % AD717X_CONT_READ_BUF_SIZE;
+	uint32_t data;
+	uint8_t status;
+	int ret;
+
+	/* DOUT/RDY toggles while the sample is clocked out */
+	ret = no_os_irq_disable(device->irq_ctrl, device->gpio_rdy->number);
+	if (ret)
+		return;
+
+	ret = ad717x_data_status_read(device, false, &data, &status);
+	if (ret || next == device->cont_read_tail) {
+		device->cont_read_dropped++;
+	} else {
+		device->cont_read_data[head] = data;
+		device->cont_read_status[head] = status;
+		device->cont_read_head = next;
+	}
+
+	no_os_irq_enable(device->irq_ctrl, device->gpio_rdy->number);
+}
+
+/***************************************************************************//**
+ * @brief Wait for DOUT/RDY to go low.
+ * @param device - AD717x Device Descriptor
+ * @param timeout_ms - Maximum time to wait.
+ * @return Returns 0 for success or negative error code in case of failure.
+******************************************************************************/
+static int ad717x_wait_for_rdy_low(ad717x_dev *device, uint32_t timeout_ms)
+{
+	uint32_t timeout = timeout_ms * 1000 / AD717X_CONT_READ_POLL_US;
+	uint8_t rdy;
+	int ret;
+
+	while (true) {
+		ret = no_os_gpio_get_value(device->gpio_rdy, &rdy);
+		if (ret)
+			return ret;
+		if (rdy == NO_OS_GPIO_LOW)
+			return 0;
+		if (!timeout--)
+			return -ETIMEDOUT;
+
+		no_os_udelay(AD717X_CONT_READ_POLL_US);
+	}
+}
+
+/***************************************************************************//**
+ * @brief Start a continuous acquisition of the enabled channels, with the
+ *        status register appended to each sample. When the DOUT/RDY GPIO is
+ *        available, the continuous read mode is used so that each sample is a
+ *        single transfer, without command byte. If an IRQ controller is also
+ *        available, samples are read on the DOUT/RDY falling edge.
+ * @param device - AD717x Device Descriptor
+ * @return Returns 0 for success or negative error code in case of failure.
+******************************************************************************/
+int ad717x_continuous_read_start(ad717x_dev *device)
+{
+	ad717x_st_reg *ifmode_reg;
+	int ret;
+
+	if (!device)
+		return -EINVAL;
+
+	if (device->cont_read_en)
+		return 0;
+
+	ifmode_reg = AD717X_GetReg(device, AD717X_IFMODE_REG);
+	if (!ifmode_reg)
+		return -EINVAL;
+
+	/* Registers can't be written once in continuous read mode */
+	ret = ad717x_set_adc_mode(device, CONTINUOUS);
+	if (ret)
+		return ret;
+
+	ifmode_reg->value |= AD717X_IFMODE_REG_DATA_STAT;
+	if (device->gpio_rdy)
+		ifmode_reg->value |= AD717X_IFMODE_REG_CONT_READ;
+
+	device->cont_read_head = 0;
+	device->cont_read_tail = 0;
+	device->cont_read_dropped = 0;
+
+	ret = AD717X_WriteRegister(device, AD717X_IFMODE_REG);
+	if (ret)
+		return ret;
+
+	ret = AD717X_ComputeDataregSize(device);
+	if (ret)
+		return ret;
+
+	device->cont_read_en = true;
+
+	if (device->irq_ctrl)
+		return no_os_irq_enable(device->irq_ctrl, device->gpio_rdy->number);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Get the next sample of a continuous acquisition.
+ * @param device - AD717x Device Descriptor
+ * @param data - Raw data
+ * @param chan - Channel the sample belongs to
+ * @param timeout_ms - Maximum time to wait for the sample.
+ * @return Returns 0 for success or negative error code in case of failure.
+******************************************************************************/
+int ad717x_continuous_read_sample(ad717x_dev *device, int32_t *data,
+				  uint8_t *chan, uint32_t timeout_ms)
+{
+	uint32_t timeout = timeout_ms * 1000 / AD717X_CONT_READ_POLL_US;
+	uint32_t raw, tail;
+	uint8_t status;
+	int ret;
+
+	if (!device || !device->cont_read_en)
+		return -EINVAL;
+
+	if (device->irq_ctrl) {
+		while (device->cont_read_tail == device->cont_read_head) {
+			if (!timeout--)
+				return -ETIMEDOUT;
+
+			no_os_udelay(AD717X_CONT_READ_POLL_US);
+		}
+
+		tail = device->cont_read_tail;
+		raw = device->cont_read_data[tail];
+		status = device->cont_read_status[tail];
+		device->cont_read_tail = (tail + 1) % AD717X_CONT_READ_BUF_SIZE;
+	} else {
+		if (device->gpio_rdy)
+			ret = ad717x_wait_for_rdy_low(device, timeout_ms);
+		else
+			ret = AD717X_WaitForReady(device, timeout);
+		if (ret)
+			return ret;
+
+		ret = ad717x_data_status_read(device, !device->gpio_rdy, &raw,
+					      &status);
+		if (ret)
+			return ret;
+	}
+
+	*data = raw;
+	*chan = AD717X_STATUS_REG_CH(status);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Get a sample of each channel in a mask. The sequencer converts the
+ *        enabled channels in ascending order, samples are demultiplexed using
+ *        the channel ID of the status byte. If a sample is lost, the partial
+ *        scan is discarded and the next sequence is waited for.
+ * @param device - AD717x Device Descriptor
+ * @param ch_mask - Channels to be read, all of them must be enabled.
+ * @param scan - Samples, in ascending channel order.
+ * @param timeout_ms - Maximum time to wait for each sample.
+ * @return Returns 0 for success or negative error code in case of failure.
+******************************************************************************/
+int ad717x_continuous_read_scan(ad717x_dev *device, uint32_t ch_mask,
+				int32_t *scan, uint32_t timeout_ms)
+{
+	uint32_t first, next, skipped = 0, i = 0;
+	uint32_t remaining;
+	int32_t data;
+	uint8_t chan;
+	int ret;
+
+	if (!ch_mask || (ch_mask & ~NO_OS_GENMASK(AD717x_MAX_CHANNELS - 1, 0)))
+		return -EINVAL;
+
+	first = no_os_find_first_set_bit(ch_mask);
+	next = first;
+
+	while (true) {
+		ret = ad717x_continuous_read_sample(device, &data, &chan,
+						    timeout_ms);
+		if (ret)
+			return ret;
+
+		if (chan != next) {
+			if (++skipped > 2 * AD717x_MAX_CHANNELS)
+				return -EIO;
+
+			/* Enabled channels outside the mask are ignored */
+			if (!(ch_mask & NO_OS_BIT(chan)))
+				continue;
+
+			i = 0;
+			next = first;
+			if (chan != first)
+				continue;
+		}
+
+		scan[i++] = data;
+
+		remaining = ch_mask & ~NO_OS_GENMASK(chan, 0);
+		if (!remaining)
+			return 0;
+
+		next = no_os_find_first_set_bit(remaining);
+	}
+}
+
+/***************************************************************************//**
+ * @brief Stop a continuous acquisition. The continuous read mode is exited by
+ *        a read data command, only decoded while DOUT/RDY is low.
+ * @param device - AD717x Device Descriptor
+ * @return Returns 0 for success or negative error code in case of failure.
+******************************************************************************/
+int ad717x_continuous_read_stop(ad717x_dev *device)
+{
+	ad717x_st_reg *ifmode_reg;
+	uint32_t data;
+	uint8_t status;
+	int ret;
+
+	if (!device)
+		return -EINVAL;
+
+	if (!device->cont_read_en)
+		return 0;
+
+	ifmode_reg = AD717X_GetReg(device, AD717X_IFMODE_REG);
+	if (!ifmode_reg)
+		return -EINVAL;
+
+	if (device->irq_ctrl) {
+		ret = no_os_irq_disable(device->irq_ctrl, device->gpio_rdy->number);
+		if (ret)
+			return ret;
+	}
+
+	if (ifmode_reg->value & AD717X_IFMODE_REG_CONT_READ) {
+		ret = ad717x_wait_for_rdy_low(device, AD717X_MAX_CONV_TIME_MS);
+		if (ret)
+			return ret;
+
+		ret = ad717x_data_status_read(device, true, &data, &status);
+		if (ret && ret != -EBADMSG)
+			return ret;
+
+		ifmode_reg->value &= ~AD717X_IFMODE_REG_CONT_READ;
+	}
+
+	device->cont_read_en = false;
+
+	ifmode_reg->value &= ~AD717X_IFMODE_REG_DATA_STAT;
+	ret = AD717X_WriteRegister(device, AD717X_IFMODE_REG);
+	if (ret)
+		return ret;
+
+	return AD717X_ComputeDataregSize(device);
+}
+
 /***************************************************************************//**
 * @brief  Searches through the list of registers of the driver instance and
 *         retrieves a pointer to the register that matches the given address.
@@ -784,7 +1107,7 @@ int32_t AD717X_Init(ad717x_dev **device,
 	uint8_t setup_index;
 	uint8_t ch_index;
 
-	dev = (ad717x_dev *)no_os_malloc(sizeof(*dev));
+	dev = (ad717x_dev *)no_os_calloc(1, sizeof(*dev));
 	if (!dev)
 		return -1;
 
@@ -796,6 +1119,40 @@ int32_t AD717X_Init(ad717x_dev **device,
 	if (ret < 0)
 		return ret;
 
+	ret = no_os_gpio_get_optional(&dev->gpio_rdy, init_param.gpio_rdy);
+	if (ret)
+		return ret;
+
+	if (dev->gpio_rdy) {
+		ret = no_os_gpio_direction_input(dev->gpio_rdy);
+		if (ret)
+			return ret;
+	}
+
+	if (init_param.irq_ctrl) {
+		if (!dev->gpio_rdy)
+			return -EINVAL;
+
+		dev->irq_cb.callback = ad717x_rdy_irq_handler;
+		dev->irq_cb.ctx = dev;
+		dev->irq_cb.event = NO_OS_EVT_GPIO;
+		dev->irq_cb.peripheral = NO_OS_GPIO_IRQ;
+
+		ret = no_os_irq_register_callback(init_param.irq_ctrl,
+						  dev->gpio_rdy->number,
+						  &dev->irq_cb);
+		if (ret)
+			return ret;
+
+		dev->irq_ctrl = init_param.irq_ctrl;
+
+		ret = no_os_irq_trigger_level_set(dev->irq_ctrl,
+						  dev->gpio_rdy->number,
+						  NO_OS_IRQ_EDGE_FALLING);
+		if (ret)
+			return ret;
+	}
+
 	/*  Reset the device interface.*/
 	ret = AD717X_Reset(dev);
 	if (ret < 0)
@@ -903,6 +1260,22 @@ int32_t AD717X_remove(ad717x_dev *dev)
 {
 	int32_t ret;
 
+	ret = ad717x_continuous_read_stop(dev);
+	if (ret)
+		return ret;
+
+	if (dev->irq_ctrl) {
+		ret = no_os_irq_unregister_callback(dev->irq_ctrl,
+						    dev->gpio_rdy->number,
+						    &dev->irq_cb);
+		if (ret)
+			return ret;
+	}
+
+	ret = no_os_gpio_remove(dev->gpio_rdy);
+	if (ret)
+		return ret;
+
 	ret = no_os_spi_remove(dev->spi_desc);
 
 	no_os_free(dev);
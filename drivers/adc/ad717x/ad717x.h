@@ -41,6 +41,8 @@
 /******************************************************************************/
 #include <stdint.h>
 #include "no_os_spi.h"
+#include "no_os_gpio.h"
+#include "no_os_irq.h"
 #include "no_os_util.h"
 #include <stdbool.h>
 
@@ -51,6 +53,12 @@
 #define AD717x_MAX_SETUPS			8
 /* Maximum number of channels in the AD717x-AD411x family */
 #define AD717x_MAX_CHANNELS			16
+/* Number of continuous read samples buffered between two RDY interrupts */
+#define AD717X_CONT_READ_BUF_SIZE		32
+/* Polling period while waiting for a continuous read sample */
+#define AD717X_CONT_READ_POLL_US		10
+/* Longest conversion time, at the lowest output data rate */
+#define AD717X_MAX_CONV_TIME_MS			1000
 
 /*
  *@enum	ad717x_mode
@@ -282,6 +290,21 @@ typedef struct {
 	struct ad717x_filtcon filter_configuration[AD717x_MAX_SETUPS];
 	/* ADC Mode */
 	enum ad717x_mode mode;
+	/* DOUT/RDY GPIO, optional */
+	struct no_os_gpio_desc *gpio_rdy;
+	/* IRQ controller handling the DOUT/RDY falling edge, optional */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/* DOUT/RDY interrupt callback */
+	struct no_os_callback_desc irq_cb;
+	/* Continuous (DATA_STAT) acquisition running */
+	bool cont_read_en;
+	/* Samples read by the RDY interrupt and not yet consumed */
+	uint32_t cont_read_data[AD717X_CONT_READ_BUF_SIZE];
+	uint8_t cont_read_status[AD717X_CONT_READ_BUF_SIZE];
+	volatile uint32_t cont_read_head;
+	volatile uint32_t cont_read_tail;
+	/* Samples dropped because of a full buffer or a checksum error */
+	uint32_t cont_read_dropped;
 } ad717x_dev;
 
 typedef struct {
@@ -308,6 +331,11 @@ typedef struct {
 	struct ad717x_filtcon filter_configuration[AD717x_MAX_SETUPS];
 	/* ADC Mode */
 	enum ad717x_mode mode;
+	/* DOUT/RDY GPIO, optional. Needed to use the continuous read mode. */
+	struct no_os_gpio_init_param *gpio_rdy;
+	/* IRQ controller handling the DOUT/RDY falling edge, optional. Needs
+	 * gpio_rdy, samples are then read from interrupt context. */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
 } ad717x_init_param;
 
 /*****************************************************************************/
@@ -601,6 +629,20 @@ int ad717x_enable_buffers(ad717x_dev* device, bool inbuf_en,
 int ad717x_single_read(ad717x_dev* device, uint8_t id,
 		       int32_t *adc_raw_data);
 
+/* Start a continuous acquisition with the status appended to the data */
+int ad717x_continuous_read_start(ad717x_dev *device);
+
+/* Get the next sample of a continuous acquisition */
+int ad717x_continuous_read_sample(ad717x_dev *device, int32_t *data,
+				  uint8_t *chan, uint32_t timeout_ms);
+
+/* Get a sample of each channel in a mask, in sequencer order */
+int ad717x_continuous_read_scan(ad717x_dev *device, uint32_t ch_mask,
+				int32_t *scan, uint32_t timeout_ms);
+
+/* Stop a continuous acquisition */
+int ad717x_continuous_read_stop(ad717x_dev *device);
+
 /* Configure device ODR */
 int32_t ad717x_configure_device_odr(ad717x_dev *dev, uint8_t filtcon_id,
 				    uint8_t odr_sel);
@@ -75,6 +75,9 @@
 #define AD7606_PARALLEL_CORE_ENABLE			0x01
 #define AD7606_PARALLEL_CORE_DISABLE			0x00
 
+/* Conversions read before their frames are validated and unpacked */
+#define AD7606_BLOCK_SAMPLES				32
+
 struct ad7606_chip_info {
 	const char *name;
 	uint8_t num_channels;
@@ -320,6 +323,8 @@ struct ad7606_dev {
 	uint8_t gain_ch[AD7606_MAX_CHANNELS];
 	/** Data buffer (used internally by the SPI communication functions) */
 	uint8_t data[28];
+	/** Raw frames of a block acquisition, AD7606_BLOCK_SAMPLES * sizeof(data) */
+	uint8_t *block;
 };
 
 /***************************************************************************//**
@@ -676,34 +681,14 @@ int32_t ad7606_convst(struct ad7606_dev *dev)
 	return no_os_gpio_set_value(dev->gpio_convst, 1);
 }
 
-/***************************************************************************//**
- * @brief Read conversion data.
- *
- * This function performs CRC16 computation and checking if enabled in the device.
- * If the status is enabled in device settings, each sample of data will contain
- * status information in the lowest 8 bits.
- *
- * The output buffer provided by the user should be as wide as to be able to
- * contain 1 sample from each channel since this function reads conversion data
- * across all channels.
- *
- * @param dev        - The device structure.
- * @param data       - Pointer to location of buffer where to store the data.
- *
- * @return ret - return code.
- *         Example: -EIO - SPI communication error.
- *                  -EBADMSG - CRC computation mismatch.
- *                  -ENOTSUP - Device bits per sample not supported.
- *                  0 - No errors encountered.
-*******************************************************************************/
-int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
+/* Internal function returning the size in bytes of a conversion frame, CRC
+ * included. The size of the sample data alone is returned in payload. */
+static uint32_t ad7606_frame_size(struct ad7606_dev *dev, uint32_t *payload)
 {
-	uint32_t sz;
-	int32_t ret, i;
-	uint16_t crc, icrc;
 	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
 	uint8_t sbits = dev->config.status_header ? 8 : 0;
 	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
+	uint32_t sz;
 
 	sz = nchannels * (bits + sbits);
 
@@ -716,52 +701,94 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 	 * remainder of this division because it is zero by design.
 	 */
 	sz /= 8;
+	*payload = sz;
 
-	if (dev->digital_diag_enable.int_crc_err_en) {
+	if (dev->digital_diag_enable.int_crc_err_en)
 		sz += 2;
-	}
 
-	memset(dev->data, 0, sz);
-	ret = no_os_spi_write_and_read(dev->spi_desc, dev->data, sz);
-	if (ret < 0)
-		return ret;
+	return sz;
+}
 
-	if (dev->digital_diag_enable.int_crc_err_en) {
-		sz -= 2;
-		crc = no_os_crc16(ad7606_crc16, dev->data, sz, 0);
-		icrc = ((uint16_t)dev->data[sz] << 8) |
-		       dev->data[sz+1];
-		if (icrc != crc)
-			return -EBADMSG;
-	}
+/* Internal function checking the CRC16 appended to a conversion frame. */
+static int32_t ad7606_frame_check(uint8_t *frame, uint32_t payload)
+{
+	uint16_t crc, icrc;
+
+	crc = no_os_crc16(ad7606_crc16, frame, payload, 0);
+	icrc = ((uint16_t)frame[payload] << 8) | frame[payload + 1];
+
+	return icrc != crc ? -EBADMSG : 0;
+}
+
+/* Internal function extending the samples of a conversion frame to 32-bit. */
+static int32_t ad7606_frame_unpack(struct ad7606_dev *dev, uint8_t *frame,
+				   uint32_t payload, uint32_t *data)
+{
+	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
+	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
+	int32_t i;
 
 	switch(bits) {
 	case 18:
 		if (dev->config.status_header)
-			ret = cpy26b32b(dev->data, sz, data);
-		else
-			ret = cpy18b32b(dev->data, sz, data);
-		if (ret < 0)
-			return ret;
-		break;
+			return cpy26b32b(frame, payload, data);
+		return cpy18b32b(frame, payload, data);
 	case 16:
 		for(i = 0; i < nchannels; i++) {
 			if (dev->config.status_header) {
-				data[i] = (uint32_t)dev->data[i*3] << 16;
-				data[i] |= (uint32_t)dev->data[i*3+1] << 8;
-				data[i] |= (uint32_t)dev->data[i*3+2];
+				data[i] = (uint32_t)frame[i*3] << 16;
+				data[i] |= (uint32_t)frame[i*3+1] << 8;
+				data[i] |= (uint32_t)frame[i*3+2];
 			} else {
-				data[i] = (uint32_t)dev->data[i*2] << 8;
-				data[i] |= (uint32_t)dev->data[i*2+1];
+				data[i] = (uint32_t)frame[i*2] << 8;
+				data[i] |= (uint32_t)frame[i*2+1];
 			}
 		}
-		break;
+		return 0;
 	default:
-		ret = -ENOTSUP;
-		break;
+		return -ENOTSUP;
 	};
+}
 
-	return ret;
+/***************************************************************************//**
+ * @brief Read conversion data.
+ *
+ * This function performs CRC16 computation and checking if enabled in the device.
+ * If the status is enabled in device settings, each sample of data will contain
+ * status information in the lowest 8 bits.
+ *
+ * The output buffer provided by the user should be as wide as to be able to
+ * contain 1 sample from each channel since this function reads conversion data
+ * across all channels.
+ *
+ * @param dev        - The device structure.
+ * @param data       - Pointer to location of buffer where to store the data.
+ *
+ * @return ret - return code.
+ *         Example: -EIO - SPI communication error.
+ *                  -EBADMSG - CRC computation mismatch.
+ *                  -ENOTSUP - Device bits per sample not supported.
+ *                  0 - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
+{
+	uint32_t sz, payload;
+	int32_t ret;
+
+	sz = ad7606_frame_size(dev, &payload);
+
+	memset(dev->data, 0, sz);
+	ret = no_os_spi_write_and_read(dev->spi_desc, dev->data, sz);
+	if (ret < 0)
+		return ret;
+
+	if (dev->digital_diag_enable.int_crc_err_en) {
+		ret = ad7606_frame_check(dev->data, payload);
+		if (ret)
+			return ret;
+	}
+
+	return ad7606_frame_unpack(dev, dev->data, payload, data);
 }
 
 /***************************************************************************//**
@@ -902,14 +929,54 @@ pwm_disable:
 }
 
 /***************************************************************************//**
- * @brief Blocking conversion start and read data (for a single sample from all
- *        channels).
+ * @brief Wait for the end of a conversion.
+ *
+ * @param dev        - The device structure.
+ *
+ * @return ret - return code.
+ *         Example: -ETIME - Timeout while waiting for the BUSY signal.
+ *                  0 - No errors encountered.
+*******************************************************************************/
+static int32_t ad7606_wait_busy(struct ad7606_dev *dev)
+{
+	int32_t ret;
+	uint8_t busy;
+	uint32_t timeout = tconv_max[AD7606_OSR_256];
+
+	if (!dev->gpio_busy) {
+		/* wait CONV time */
+		no_os_udelay(tconv_max[dev->oversampling.os_ratio]);
+		return 0;
+	}
+
+	/* Wait for BUSY falling edge */
+	while(timeout) {
+		ret = no_os_gpio_get_value(dev->gpio_busy, &busy);
+		if (ret < 0)
+			return ret;
+
+		if (busy == 0)
+			return 0;
+
+		no_os_udelay(1);
+		timeout--;
+	}
+
+	return -ETIME;
+}
+
+/***************************************************************************//**
+ * @brief Blocking conversion start and read of a block of samples.
  *
- * This function performs a conversion start and then proceeds to reading
- * the conversion data.
+ * The raw frames of all the conversions are read back to back into the block
+ * buffer, which is cleared only once. The CRCs are then validated for the
+ * whole block before the frames are unpacked in a single pass, sample after
+ * sample, all channels of a sample being contiguous.
  *
  * @param dev        - The device structure.
  * @param data       - Pointer to location of buffer where to store the data.
+ * @param samples    - Number of samples to read, at most
+ *                     AD7606_BLOCK_SAMPLES.
  *
  * @return ret - return code.
  *         Example: -EIO - SPI communication error.
@@ -917,45 +984,55 @@ pwm_disable:
  *                  -EBADMSG - CRC computation mismatch.
  *                  0 - No errors encountered.
 *******************************************************************************/
-static int32_t ad7606_read_one_sample(struct ad7606_dev *dev, uint32_t * data)
+static int32_t ad7606_read_block(struct ad7606_dev *dev, uint32_t *data,
+				 uint32_t samples)
 {
+	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
+	uint32_t sz, payload, i;
+	uint8_t *frame;
 	int32_t ret;
-	uint8_t busy;
-	uint32_t timeout = tconv_max[AD7606_OSR_256];
 
-	ret = ad7606_convst(dev);
-	if (ret < 0)
-		return ret;
+	sz = ad7606_frame_size(dev, &payload);
 
-	if (dev->gpio_busy) {
-		/* Wait for BUSY falling edge */
-		while(timeout) {
-			ret = no_os_gpio_get_value(dev->gpio_busy, &busy);
-			if (ret < 0)
-				return ret;
+	memset(dev->block, 0, samples * sz);
+
+	for (i = 0, frame = dev->block; i < samples; i++, frame += sz) {
+		ret = ad7606_convst(dev);
+		if (ret < 0)
+			return ret;
+
+		ret = ad7606_wait_busy(dev);
+		if (ret)
+			return ret;
 
-			if (busy == 0)
-				break;
+		ret = no_os_spi_write_and_read(dev->spi_desc, frame, sz);
+		if (ret < 0)
+			return ret;
+	}
 
-			no_os_udelay(1);
-			timeout--;
+	if (dev->digital_diag_enable.int_crc_err_en) {
+		for (i = 0, frame = dev->block; i < samples; i++, frame += sz) {
+			ret = ad7606_frame_check(frame, payload);
+			if (ret)
+				return ret;
 		}
+	}
 
-		if (timeout == 0)
-			return -ETIME;
-	} else {
-		/* wait CONV time */
-		no_os_udelay(tconv_max[dev->oversampling.os_ratio]);
+	for (i = 0, frame = dev->block; i < samples; i++, frame += sz) {
+		ret = ad7606_frame_unpack(dev, frame, payload, data);
+		if (ret)
+			return ret;
+		data += nchannels;
 	}
 
-	return ad7606_spi_data_read(dev, data);
+	return 0;
 }
 
 /***************************************************************************//**
  * @brief Read muliple raw samples from device.
  *
- * This function performs a series of conversion starts and then proceeds to
- * reading the conversion data (after each conversion).
+ * Without the AXI cores, this function performs a series of conversion starts
+ * and reads, in blocks of up to AD7606_BLOCK_SAMPLES samples.
  *
  * @param dev        - The device structure.
  * @param data       - Pointer to location of buffer where to store the data.
@@ -965,13 +1042,14 @@ static int32_t ad7606_read_one_sample(struct ad7606_dev *dev, uint32_t * data)
  *         Example: -EIO - SPI communication error.
  *                  -ETIME - Timeout while waiting for the BUSY signal.
  *                  -EBADMSG - CRC computation mismatch.
+ *                  -ENOMEM - Block buffer allocation failure.
  *                  0 - No errors encountered.
 *******************************************************************************/
 int32_t ad7606_read_samples(struct ad7606_dev *dev, uint32_t * data,
 			    uint32_t samples)
 {
 	struct ad7606_axi_dev *axi = &dev->axi_dev;
-	uint32_t nchannels, i, sample_size;
+	uint32_t nchannels, chunk;
 	int32_t ret;
 
 	if (dev->reg_mode) {
@@ -989,14 +1067,24 @@ int32_t ad7606_read_samples(struct ad7606_dev *dev, uint32_t * data,
 		return ad7606_read_raw_data_spi_engine(dev, data, samples);
 	}
 
+	if (!dev->block) {
+		dev->block = no_os_calloc(AD7606_BLOCK_SAMPLES,
+					  sizeof(dev->data));
+		if (!dev->block)
+			return -ENOMEM;
+	}
+
 	nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
-	sample_size = nchannels * sizeof(uint32_t);
 
-	for (i = 0; i < samples; i++) {
-		ret = ad7606_read_one_sample(dev, data);
+	while (samples) {
+		chunk = no_os_min(samples, AD7606_BLOCK_SAMPLES);
+
+		ret = ad7606_read_block(dev, data, chunk);
 		if (ret)
 			return ret;
-		data += sample_size;
+
+		data += chunk * nchannels;
+		samples -= chunk;
 	}
 
 	return 0;
@@ -1856,6 +1944,7 @@ int32_t ad7606_remove(struct ad7606_dev *dev)
 
 	ad7606_axi_remove(dev);
 
+	no_os_free(dev->block);
 	no_os_free(dev);
 
 	return ret;
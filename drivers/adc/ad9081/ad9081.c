@@ -832,12 +832,14 @@ static int32_t ad9081_spi_xfer(void *user_data, uint8_t *in_data,
 			       uint8_t *out_data, uint32_t size_bytes)
 {
 	struct ad9081_phy *phy = user_data;
-	uint8_t data[6];
+	uint8_t data[2 + AD9081_SHADOW_BURST_MAX];
 	uint16_t bytes_number;
 	int32_t ret;
 	int32_t i;
 
 	bytes_number = (size_bytes & 0xFF);
+	if (bytes_number > sizeof(data))
+		return -1;
 
 	if (phy->ad9081.hal_info.msb == SPI_MSB_FIRST) {
 		for (i = 0; i < bytes_number; i++)
@@ -1459,6 +1461,7 @@ int32_t ad9081_init(struct ad9081_phy **dev,
 	phy->ad9081.hal_info.addr_inc = SPI_ADDR_INC_AUTO;
 	phy->ad9081.hal_info.spi_xfer = ad9081_spi_xfer;
 	phy->ad9081.hal_info.log_write = ad9081_log_write;
+	phy->ad9081.shadow_info.enable = init_param->spi_reg_shadow_enable;
 
 	phy->ad9081.serdes_info = (adi_ad9081_serdes_settings_t) {
 		.ser_settings = { /* txfe jtx */
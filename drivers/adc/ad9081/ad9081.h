@@ -173,6 +173,8 @@ struct ad9081_init_param {
 	bool		continuous_sysref_mode_disable;
 	bool		tx_disable;
 	bool		rx_disable;
+	/* Batch the API bitfield writes through a register shadow */
+	bool		spi_reg_shadow_enable;
 	/* TX */
 	uint64_t	dac_frequency_hz;
 	/* The 4 DAC Main Datapaths */
@@ -292,6 +292,8 @@
 
 #define AD9081_USE_FLOATING_TYPE 0
 #define AD9081_USE_SPI_BURST_MODE 0
+#define AD9081_SHADOW_REG_NUM 64
+#define AD9081_SHADOW_BURST_MAX 16
 
 /*============= ENUMS ==============*/
 
@@ -890,6 +892,33 @@ typedef struct {
 		sysref_mode; /*!< sysref synchronization mode configuration */
 } adi_ad9081_clk_t;
 
+/*!
+ * @brief Shadowed Register Entry Structure
+ */
+typedef struct {
+	uint16_t addr; /*!< Direct space register address */
+	uint8_t value; /*!< Register value */
+} adi_ad9081_shadow_reg_t;
+
+/*!
+ * @brief Register Shadow Structure
+ *
+ * While enabled and inside an adi_ad9081_hal_shadow_begin()/_end() section,
+ * bitfield writes to the direct register space read-modify-write the known
+ * register values instead of the device and are queued in issue order.
+ * Queued writes to consecutive addresses go out as one streaming transfer.
+ */
+typedef struct {
+	uint8_t enable; /*!< Shadow bitfield writes, 0: disable, 1: enable */
+	uint8_t depth; /*!< Nesting level of begin/end sections */
+	uint8_t count; /*!< Number of entries in regs */
+	uint8_t pending; /*!< Number of entries in queue */
+	adi_ad9081_shadow_reg_t
+		regs[AD9081_SHADOW_REG_NUM]; /*!< Known values, sorted by addr */
+	adi_ad9081_shadow_reg_t
+		queue[AD9081_SHADOW_REG_NUM]; /*!< Writes not yet on the device */
+} adi_ad9081_shadow_t;
+
 /*!
  * @brief Device Structure
  */
@@ -898,6 +927,7 @@ typedef struct {
 	adi_ad9081_info_t dev_info;
 	adi_ad9081_serdes_settings_t serdes_info;
 	adi_ad9081_clk_t clk_info;
+	adi_ad9081_shadow_t shadow_info;
 } adi_ad9081_device_t;
 
 /*============= E X P O R T S ==============*/
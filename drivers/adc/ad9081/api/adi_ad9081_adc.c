@@ -1356,10 +1356,10 @@ int32_t adi_ad9081_adc_ddc_coarse_nco_set_f(adi_ad9081_device_t *device,
 }
 #endif
 
-int32_t adi_ad9081_adc_ddc_coarse_nco_ftw_set(adi_ad9081_device_t *device,
-					      uint8_t cddcs, uint64_t ftw,
-					      uint64_t modulus_a,
-					      uint64_t modulus_b)
+static int32_t
+adi_ad9081_adc_ddc_coarse_nco_ftw_write(adi_ad9081_device_t *device,
+					uint8_t cddcs, uint64_t ftw,
+					uint64_t modulus_a, uint64_t modulus_b)
 {
 	int32_t err;
 #if AD9081_USE_SPI_BURST_MODE > 0
@@ -1438,6 +1438,25 @@ int32_t adi_ad9081_adc_ddc_coarse_nco_ftw_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_adc_ddc_coarse_nco_ftw_set(adi_ad9081_device_t *device,
+					      uint8_t cddcs, uint64_t ftw,
+					      uint64_t modulus_a,
+					      uint64_t modulus_b)
+{
+	int32_t err, shadow_err;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	/* batch the paged ftw, modulus and phase offset writes */
+	err = adi_ad9081_hal_shadow_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_adc_ddc_coarse_nco_ftw_write(device, cddcs, ftw,
+						      modulus_a, modulus_b);
+	shadow_err = adi_ad9081_hal_shadow_end(device);
+	AD9081_ERROR_RETURN(err);
+
+	return shadow_err;
+}
+
 int32_t adi_ad9081_adc_ddc_coarse_nco_ftw_get(adi_ad9081_device_t *device,
 					      uint8_t cddc, uint64_t *ftw,
 					      uint64_t *modulus_a,
@@ -2119,10 +2138,10 @@ int32_t adi_ad9081_adc_ddc_fine_nco_set_f(adi_ad9081_device_t *device,
 }
 #endif
 
-int32_t adi_ad9081_adc_ddc_fine_nco_ftw_set(adi_ad9081_device_t *device,
-					    uint8_t fddcs, uint64_t ftw,
-					    uint64_t modulus_a,
-					    uint64_t modulus_b)
+static int32_t
+adi_ad9081_adc_ddc_fine_nco_ftw_write(adi_ad9081_device_t *device,
+				      uint8_t fddcs, uint64_t ftw,
+				      uint64_t modulus_a, uint64_t modulus_b)
 {
 	int32_t err;
 #if AD9081_USE_SPI_BURST_MODE > 0
@@ -2188,6 +2207,25 @@ int32_t adi_ad9081_adc_ddc_fine_nco_ftw_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_adc_ddc_fine_nco_ftw_set(adi_ad9081_device_t *device,
+					    uint8_t fddcs, uint64_t ftw,
+					    uint64_t modulus_a,
+					    uint64_t modulus_b)
+{
+	int32_t err, shadow_err;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	/* batch the paged ftw and modulus writes */
+	err = adi_ad9081_hal_shadow_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_adc_ddc_fine_nco_ftw_write(device, fddcs, ftw,
+						    modulus_a, modulus_b);
+	shadow_err = adi_ad9081_hal_shadow_end(device);
+	AD9081_ERROR_RETURN(err);
+
+	return shadow_err;
+}
+
 int32_t adi_ad9081_adc_ddc_fine_nco_ftw_get(adi_ad9081_device_t *device,
 					    uint8_t fddc, uint64_t *ftw,
 					    uint64_t *modulus_a,
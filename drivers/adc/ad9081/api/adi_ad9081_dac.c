@@ -448,10 +448,11 @@ int32_t adi_ad9081_dac_duc_nco_ftw0_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_dac_duc_nco_ftw_set(adi_ad9081_device_t *device,
-				       uint8_t dacs, uint8_t channels,
-				       uint64_t ftw, uint64_t acc_modulus,
-				       uint64_t acc_delta)
+static int32_t adi_ad9081_dac_duc_nco_ftw_write(adi_ad9081_device_t *device,
+						uint8_t dacs, uint8_t channels,
+						uint64_t ftw,
+						uint64_t acc_modulus,
+						uint64_t acc_delta)
 {
 	int32_t err;
 	uint8_t i, dac, channel;
@@ -618,6 +619,25 @@ int32_t adi_ad9081_dac_duc_nco_ftw_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_dac_duc_nco_ftw_set(adi_ad9081_device_t *device,
+				       uint8_t dacs, uint8_t channels,
+				       uint64_t ftw, uint64_t acc_modulus,
+				       uint64_t acc_delta)
+{
+	int32_t err, shadow_err;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	/* batch the paged ftw and modulus writes */
+	err = adi_ad9081_hal_shadow_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_dac_duc_nco_ftw_write(device, dacs, channels, ftw,
+					       acc_modulus, acc_delta);
+	shadow_err = adi_ad9081_hal_shadow_end(device);
+	AD9081_ERROR_RETURN(err);
+
+	return shadow_err;
+}
+
 int32_t adi_ad9081_dac_duc_main_nco_ftw_get(adi_ad9081_device_t *device,
 					    uint8_t dacs, uint64_t *ftw,
 					    uint64_t *acc_modulus,
@@ -15,7 +15,201 @@
 /*============= I N C L U D E S ============*/
 #include "adi_ad9081_hal.h"
 
+/*============= D E F I N E S ==============*/
+#define AD9081_SHADOW_PAGE_REG_FIRST 0x0018
+#define AD9081_SHADOW_PAGE_REG_LAST 0x001F
+
+static int32_t adi_ad9081_hal_spi_reg_get(adi_ad9081_device_t *device,
+					  uint32_t reg, uint8_t *data);
+static int32_t adi_ad9081_hal_spi_reg_set(adi_ad9081_device_t *device,
+					  uint32_t reg, uint32_t data);
+
 /*============= C O D E ====================*/
+static uint8_t adi_ad9081_hal_shadow_active(adi_ad9081_device_t *device)
+{
+	return (device->shadow_info.enable > 0) &&
+	       (device->shadow_info.depth > 0);
+}
+
+static uint8_t adi_ad9081_hal_shadow_is_page_reg(uint32_t reg)
+{
+	return (reg >= AD9081_SHADOW_PAGE_REG_FIRST) &&
+	       (reg <= AD9081_SHADOW_PAGE_REG_LAST);
+}
+
+/* index of the entry for addr, or of the position it should be inserted at */
+static uint8_t adi_ad9081_hal_shadow_find(adi_ad9081_shadow_t *shadow,
+					  uint16_t addr)
+{
+	uint8_t lo = 0, hi = shadow->count, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) >> 1;
+		if (shadow->regs[mid].addr < addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+static void adi_ad9081_hal_shadow_store(adi_ad9081_device_t *device,
+					uint16_t addr, uint8_t value)
+{
+	uint8_t i, j;
+	adi_ad9081_shadow_t *shadow = &device->shadow_info;
+
+	i = adi_ad9081_hal_shadow_find(shadow, addr);
+	if ((i < shadow->count) && (shadow->regs[i].addr == addr)) {
+		shadow->regs[i].value = value;
+		return;
+	}
+
+	/* values are only a cache, forget them all when running out of room */
+	if (shadow->count == AD9081_SHADOW_REG_NUM) {
+		shadow->count = 0;
+		i = 0;
+	}
+
+	for (j = shadow->count; j > i; j--)
+		shadow->regs[j] = shadow->regs[j - 1];
+	shadow->regs[i].addr = addr;
+	shadow->regs[i].value = value;
+	shadow->count++;
+}
+
+/* keep a known value in sync with a value that went straight to the device */
+static void adi_ad9081_hal_shadow_update(adi_ad9081_device_t *device,
+					 uint16_t addr, uint8_t value)
+{
+	adi_ad9081_shadow_t *shadow = &device->shadow_info;
+	uint8_t i = adi_ad9081_hal_shadow_find(shadow, addr);
+
+	if ((i < shadow->count) && (shadow->regs[i].addr == addr))
+		shadow->regs[i].value = value;
+}
+
+/* register read on behalf of a bitfield read-modify-write */
+static int32_t adi_ad9081_hal_bf_reg_get(adi_ad9081_device_t *device,
+					 uint32_t reg, uint8_t *data)
+{
+	int32_t err;
+	uint8_t i;
+	adi_ad9081_shadow_t *shadow = &device->shadow_info;
+
+	if (!adi_ad9081_hal_shadow_active(device) ||
+	    adi_ad9081_hal_shadow_is_page_reg(reg))
+		return adi_ad9081_hal_reg_get(device, reg, data);
+
+	i = adi_ad9081_hal_shadow_find(shadow, reg);
+	if ((i < shadow->count) && (shadow->regs[i].addr == reg)) {
+		*data = shadow->regs[i].value;
+		return API_CMS_ERROR_OK;
+	}
+
+	err = adi_ad9081_hal_spi_reg_get(device, reg, data);
+	AD9081_ERROR_RETURN(err);
+	adi_ad9081_hal_shadow_store(device, reg, *data);
+
+	return API_CMS_ERROR_OK;
+}
+
+/* register write on behalf of a bitfield read-modify-write */
+static int32_t adi_ad9081_hal_bf_reg_set(adi_ad9081_device_t *device,
+					 uint32_t reg, uint8_t data)
+{
+	int32_t err;
+	adi_ad9081_shadow_t *shadow = &device->shadow_info;
+
+	if (!adi_ad9081_hal_shadow_active(device) ||
+	    adi_ad9081_hal_shadow_is_page_reg(reg))
+		return adi_ad9081_hal_reg_set(device, reg, data);
+
+	if (shadow->pending == AD9081_SHADOW_REG_NUM) {
+		err = adi_ad9081_hal_shadow_flush(device);
+		AD9081_ERROR_RETURN(err);
+	}
+	shadow->queue[shadow->pending].addr = reg;
+	shadow->queue[shadow->pending].value = data;
+	shadow->pending++;
+	adi_ad9081_hal_shadow_store(device, reg, data);
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_hal_shadow_begin(adi_ad9081_device_t *device)
+{
+	AD9081_NULL_POINTER_RETURN(device);
+
+	if ((device->shadow_info.enable > 0) &&
+	    (device->shadow_info.depth < 0xFF))
+		device->shadow_info.depth++;
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_hal_shadow_end(adi_ad9081_device_t *device)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	if (device->shadow_info.depth == 0)
+		return API_CMS_ERROR_OK;
+	if (--device->shadow_info.depth > 0)
+		return API_CMS_ERROR_OK;
+
+	/* nothing guarantees the device is left alone between sections */
+	err = adi_ad9081_hal_shadow_flush(device);
+	device->shadow_info.count = 0;
+	device->shadow_info.pending = 0;
+
+	return err;
+}
+
+int32_t adi_ad9081_hal_shadow_flush(adi_ad9081_device_t *device)
+{
+	uint8_t in_data[2 + AD9081_SHADOW_BURST_MAX] = { 0 };
+	uint8_t out_data[2 + AD9081_SHADOW_BURST_MAX] = { 0 };
+	uint8_t i, j, n;
+	int8_t step;
+	adi_ad9081_shadow_t *shadow;
+	adi_ad9081_shadow_reg_t *queue;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_NULL_POINTER_RETURN(device->hal_info.spi_xfer);
+
+	shadow = &device->shadow_info;
+	queue = shadow->queue;
+	step = (device->hal_info.addr_inc == SPI_ADDR_INC_AUTO) ? 1 : -1;
+	for (i = 0; i < shadow->pending; i += n) {
+		/* writes that follow the streaming address order go out together */
+		n = 1;
+		while ((i + n < shadow->pending) &&
+		       (n < AD9081_SHADOW_BURST_MAX) &&
+		       (queue[i + n].addr == queue[i].addr + n * step))
+			n++;
+
+		in_data[0] = (queue[i].addr >> 8) & 0x3F;
+		in_data[1] = (queue[i].addr >> 0) & 0xFF;
+		for (j = 0; j < n; j++)
+			in_data[2 + j] = queue[i + j].value;
+		if (API_CMS_ERROR_OK !=
+		    device->hal_info.spi_xfer(device->hal_info.user_data,
+					      in_data, out_data, n + 2))
+			return API_CMS_ERROR_SPI_XFER;
+
+		for (j = 0; j < n; j++) {
+			if (API_CMS_ERROR_OK !=
+			    AD9081_LOG_SPIW(queue[i + j].addr,
+					    queue[i + j].value))
+				return API_CMS_ERROR_LOG_WRITE;
+		}
+	}
+	shadow->pending = 0;
+
+	return API_CMS_ERROR_OK;
+}
+
 int32_t adi_ad9081_hal_hw_open(adi_ad9081_device_t *device)
 {
 	AD9081_NULL_POINTER_RETURN(device);
@@ -42,8 +236,13 @@ int32_t adi_ad9081_hal_hw_close(adi_ad9081_device_t *device)
 
 int32_t adi_ad9081_hal_delay_us(adi_ad9081_device_t *device, uint32_t us)
 {
+	int32_t err;
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.delay_us);
+	if (adi_ad9081_hal_shadow_active(device)) {
+		err = adi_ad9081_hal_shadow_flush(device);
+		AD9081_ERROR_RETURN(err);
+	}
 	if (API_CMS_ERROR_OK !=
 	    device->hal_info.delay_us(device->hal_info.user_data, us)) {
 		return API_CMS_ERROR_DELAY_US;
@@ -175,7 +374,7 @@ int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 		for (reg_offset = 0; reg_offset < reg_bytes; reg_offset++) {
 			if ((offset + width) <= 8) { /* last 8bits */
 				if ((offset > 0) || ((offset + width) < 8)) {
-					err = adi_ad9081_hal_reg_get(
+					err = adi_ad9081_hal_bf_reg_get(
 						device, reg + reg_offset,
 						&data8);
 					AD9081_ERROR_RETURN(err);
@@ -185,7 +384,7 @@ int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 				data8 = data8 | ((value & mask) << offset);
 			} else {
 				if (offset > 0) {
-					err = adi_ad9081_hal_reg_get(
+					err = adi_ad9081_hal_bf_reg_get(
 						device, reg + reg_offset,
 						&data8);
 					AD9081_ERROR_RETURN(err);
@@ -197,8 +396,8 @@ int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 				width = offset + width - 8;
 				offset = 0;
 			}
-			err = adi_ad9081_hal_reg_set(device, reg + reg_offset,
-						     data8);
+			err = adi_ad9081_hal_bf_reg_set(device,
+							reg + reg_offset, data8);
 			AD9081_ERROR_RETURN(err);
 		}
 	} else { /* access extended space */
@@ -238,6 +437,51 @@ int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 
 int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
 			       uint8_t *data)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_NULL_POINTER_RETURN(data);
+
+	if (!adi_ad9081_hal_shadow_active(device))
+		return adi_ad9081_hal_spi_reg_get(device, reg, data);
+
+	/* pending writes must reach the device before it is read back */
+	err = adi_ad9081_hal_shadow_flush(device);
+	AD9081_ERROR_RETURN(err);
+	if (reg >= 0x4000)
+		device->shadow_info.count = 0;
+	err = adi_ad9081_hal_spi_reg_get(device, reg, data);
+	AD9081_ERROR_RETURN(err);
+	if (reg < 0x4000)
+		adi_ad9081_hal_shadow_update(device, reg, *data);
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_hal_reg_set(adi_ad9081_device_t *device, uint32_t reg,
+			       uint32_t data)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	if (!adi_ad9081_hal_shadow_active(device))
+		return adi_ad9081_hal_spi_reg_set(device, reg, data);
+
+	err = adi_ad9081_hal_shadow_flush(device);
+	AD9081_ERROR_RETURN(err);
+	/* page changes and extended space accesses remap the direct space */
+	if ((reg >= 0x4000) || adi_ad9081_hal_shadow_is_page_reg(reg))
+		device->shadow_info.count = 0;
+	err = adi_ad9081_hal_spi_reg_set(device, reg, data);
+	AD9081_ERROR_RETURN(err);
+	if (reg < 0x4000)
+		adi_ad9081_hal_shadow_update(device, reg, (uint8_t)data);
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_spi_reg_get(adi_ad9081_device_t *device,
+					  uint32_t reg, uint8_t *data)
 {
 	uint8_t in_data[6] = { 0 }, out_data[6] = { 0 };
 	AD9081_NULL_POINTER_RETURN(device);
@@ -332,8 +576,8 @@ int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_hal_reg_set(adi_ad9081_device_t *device, uint32_t reg,
-			       uint32_t data)
+static int32_t adi_ad9081_hal_spi_reg_set(adi_ad9081_device_t *device,
+					  uint32_t reg, uint32_t data)
 {
 	uint8_t in_data[6] = { 0 }, out_data[6] = { 0 };
 	AD9081_NULL_POINTER_RETURN(device);
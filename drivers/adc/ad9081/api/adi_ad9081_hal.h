@@ -179,6 +179,36 @@ int32_t adi_ad9081_hal_cbuspll_reg_get(adi_ad9081_device_t *device,
 int32_t adi_ad9081_hal_cbuspll_reg_set(adi_ad9081_device_t *device,
 				       uint32_t reg, uint8_t data);
 
+/**
+ * \brief Open a register shadow section.
+ *
+ * Sections may be nested, the shadow is flushed and dropped when the
+ * outermost section is closed. Has no effect if the shadow is disabled.
+ *
+ * \param[in]  device	         Pointer to device handler structure.
+ *
+ * \returns API_CMS_ERROR_OK is returned upon success. Otherwise, a failure code.
+ */
+int32_t adi_ad9081_hal_shadow_begin(adi_ad9081_device_t *device);
+
+/**
+ * \brief Close a register shadow section.
+ *
+ * \param[in]  device	         Pointer to device handler structure.
+ *
+ * \returns API_CMS_ERROR_OK is returned upon success. Otherwise, a failure code.
+ */
+int32_t adi_ad9081_hal_shadow_end(adi_ad9081_device_t *device);
+
+/**
+ * \brief Write all dirty shadowed registers to the device.
+ *
+ * \param[in]  device	         Pointer to device handler structure.
+ *
+ * \returns API_CMS_ERROR_OK is returned upon success. Otherwise, a failure code.
+ */
+int32_t adi_ad9081_hal_shadow_flush(adi_ad9081_device_t *device);
+
 int32_t adi_ad9081_hal_bf_wait_to_clear(adi_ad9081_device_t *device,
 					uint32_t reg, uint32_t info);
 int32_t adi_ad9081_hal_bf_wait_to_set(adi_ad9081_device_t *device, uint32_t reg,
@@ -40,6 +40,7 @@
 #include "no_os_spi.h"
 #include "no_os_gpio.h"
 #include "no_os_alloc.h"
+#include "no_os_util.h"
 #include "ad5940.h"
 
 static int AD5940_Initialize(struct ad5940_dev *dev);
@@ -232,16 +233,15 @@ int ad5940_SEQGenInsert(struct ad5940_dev *dev, uint32_t CmdWord)
 static int AD5940_SEQGenSearchReg(struct ad5940_dev *dev, uint32_t RegAddr,
 				  uint32_t *pIndex)
 {
-	uint32_t i;
+	uint32_t slot;
 
-	RegAddr = (RegAddr>>2)&0xff;
-	for(i=0; i<dev->SeqGenDB.RegCount; i++) {
-		if(RegAddr == dev->SeqGenDB.pRegInfo[i].RegAddr) {
-			*pIndex = i;
-			return 0;
-		}
-	}
-	return -EINVAL;
+	slot = dev->SeqGenDB.RegIndex[(RegAddr>>2)&0xff];
+	if(!slot)
+		return -EINVAL;
+
+	/* pRegInfo grows downwards, the newest register is at index 0 */
+	*pIndex = dev->SeqGenDB.RegCount - slot;
+	return 0;
 }
 
 static int AD5940_SEQGenGetRegDefault(struct ad5940_dev *dev, uint32_t RegAddr,
@@ -263,6 +263,7 @@ static int AD5940_SEQRegInfoInsert(struct ad5940_dev *dev, uint16_t RegAddr,
 		dev->SeqGenDB.pRegInfo[0].RegAddr = (RegAddr>>2)&0xff;
 		dev->SeqGenDB.pRegInfo[0].RegValue = RegData&0x00fffff;
 		dev->SeqGenDB.RegCount ++;
+		dev->SeqGenDB.RegIndex[(RegAddr>>2)&0xff] = dev->SeqGenDB.RegCount;
 	} else { /* There is no more buffer  */
 		dev->SeqGenDB.LastError = -ENOMEM;
 	}
@@ -330,6 +331,7 @@ int ad5940_SEQGenInit(struct ad5940_dev *dev, uint32_t *pBuffer,
 	dev->SeqGenDB.SeqLen = 0;
 
 	dev->SeqGenDB.RegCount = 0;
+	memset(dev->SeqGenDB.RegIndex, 0, sizeof(dev->SeqGenDB.RegIndex));
 	dev->SeqGenDB.LastError = 0;
 	dev->SeqGenDB.EngineStart = false;
 
@@ -650,22 +652,30 @@ static int AD5940_FIFORd_Fast(struct no_os_spi_desc *spi, uint32_t *pBuffer,
 	static uint32_t iobuf_alloc_sz = 0;
 	uint32_t iobuf_sz = 7 + uiReadCount * sizeof(uiReadCount);
 	static uint8_t *iobuf;
-	uint8_t *buf;
+	uint8_t setaddr[] = {SPICMD_SETADDR, (uint16_t)REG_AFE_DATAFIFORD >> 8, (uint8_t)REG_AFE_DATAFIFORD};
+	struct no_os_spi_msg xfer[] = {
+		{
+			.tx_buff = setaddr,
+			.bytes_number = sizeof(setaddr),
+			.cs_change = 1,
+		},
+		{
+			.bytes_number = iobuf_sz,
+			.cs_change = 1,
+		},
+	};
 	uint32_t i = 0;
 	uint32_t s = 0;
 
-	if (!iobuf_alloc_sz) {
-		iobuf = no_os_malloc(iobuf_sz);
-		if (!iobuf)
-			return -ENOMEM;
-	}
-
 	if (iobuf_alloc_sz < iobuf_sz) {
-		buf = realloc(iobuf, iobuf_sz);
-		if (!buf)
+		no_os_free(iobuf);
+		iobuf = no_os_malloc(iobuf_sz);
+		if (!iobuf) {
+			iobuf_alloc_sz = 0;
 			return -ENOMEM;
+		}
 
-		iobuf = buf;
+		iobuf_alloc_sz = iobuf_sz;
 	}
 
 	// zero-out everything, needed for bytes 1 through 6 (dummy bytes).
@@ -675,15 +685,49 @@ static int AD5940_FIFORd_Fast(struct no_os_spi_desc *spi, uint32_t *pBuffer,
 	// set the MOSI output during last two samples to 0x44444444 for each.
 	memset(&iobuf[iobuf_sz - 8], 0x44, 8);
 
-	ret = no_os_spi_write_and_read(spi, iobuf, iobuf_sz);
+	// address setup and FIFO read go out in the same SPI transfer.
+	xfer[1].tx_buff = iobuf;
+	xfer[1].rx_buff = iobuf;
+	ret = no_os_spi_transfer(spi, xfer, NO_OS_ARRAY_SIZE(xfer));
 	if (ret)
 		return ret;
 
 	for (i = 7; i < iobuf_sz; i += sizeof(uiReadCount))
-		pBuffer[s++] = iobuf[i] << 24 |
-			       iobuf[i + 1] << 16 |
-			       iobuf[i + 2] << 8 |
-			       iobuf[i + 3];
+		pBuffer[s++] = no_os_get_unaligned_be32(&iobuf[i]);
+
+	return 0;
+}
+
+static int AD5940_FIFORd_Short(struct no_os_spi_desc *spi, uint32_t *pBuffer,
+			       uint32_t uiReadCount)
+{
+	int ret;
+	uint8_t setaddr[] = {SPICMD_SETADDR, (uint16_t)REG_AFE_DATAFIFORD >> 8, (uint8_t)REG_AFE_DATAFIFORD};
+	uint8_t iobuf[AD5940_FIFORD_FAST_MIN - 1][6];
+	struct no_os_spi_msg xfer[2 * (AD5940_FIFORD_FAST_MIN - 1)] = {0};
+	uint32_t i;
+
+	// DATAFIFORD is in the 32-bit register space: command, dummy, 4 bytes.
+	for (i = 0; i < uiReadCount; i++) {
+		memset(iobuf[i], 0, sizeof(iobuf[i]));
+		iobuf[i][0] = SPICMD_READREG;
+
+		xfer[2 * i].tx_buff = setaddr;
+		xfer[2 * i].bytes_number = sizeof(setaddr);
+		xfer[2 * i].cs_change = 1;
+		xfer[2 * i + 1].tx_buff = iobuf[i];
+		xfer[2 * i + 1].rx_buff = iobuf[i];
+		xfer[2 * i + 1].bytes_number = sizeof(iobuf[i]);
+		xfer[2 * i + 1].cs_change = 1;
+	}
+
+	ret = no_os_spi_transfer(spi, xfer, 2 * uiReadCount);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < uiReadCount; i++)
+		pBuffer[i] = no_os_get_unaligned_be32(&iobuf[i][2]);
+
 	return 0;
 }
 
@@ -695,28 +739,49 @@ static int AD5940_FIFORd_Fast(struct no_os_spi_desc *spi, uint32_t *pBuffer,
  **/
 int ad5940_FIFORd(struct ad5940_dev *dev, uint32_t *pBuffer,
 		  uint32_t uiReadCount)
+{
+	if (!dev || !pBuffer)
+		return -EINVAL;
+
+	if (!uiReadCount)
+		return 0;
+
+	/* The fast FIFO read needs its last two words for the 0x44 pattern,
+	 * shorter reads are chained register reads in a single transfer. */
+	if (uiReadCount < AD5940_FIFORD_FAST_MIN)
+		return AD5940_FIFORd_Short(dev->spi, pBuffer, uiReadCount);
+
+	return AD5940_FIFORd_Fast(dev->spi, pBuffer, uiReadCount);
+}
+
+/**
+  @brief Read everything the data FIFO holds, in a single burst.
+  @param pBuffer: Pointer to a buffer that used to store data read back.
+  @param nBufferSize: Size of the buffer, in words.
+  @param pCount: Number of words read back.
+  @return 0 in case of success, negative error code otherwise.
+ **/
+int ad5940_FIFODrain(struct ad5940_dev *dev, uint32_t *pBuffer,
+		     uint32_t nBufferSize, uint32_t *pCount)
 {
 	int ret;
-	if (!dev)
+	uint32_t cnt;
+
+	if (!dev || !pBuffer || !pCount)
 		return -EINVAL;
 
-	if(uiReadCount < 4) {
-		uint8_t i;
-		for (i = 0; i < uiReadCount; i++) {
-			ret = AD5940_SPIReadReg(dev->spi, REG_AFE_DATAFIFORD, &pBuffer[i]);
-			if (ret)
-				break;
-		}
-	} else {
-		uint8_t iobuf[] = {SPICMD_SETADDR, 0, 0, 0, 0, (uint16_t)REG_AFE_DATAFIFORD >> 8, (uint8_t)REG_AFE_DATAFIFORD};
-		ret = no_os_spi_write_and_read(dev->spi, iobuf, sizeof(iobuf));
-		if (ret)
-			return ret;
+	ret = ad5940_FIFOGetCnt(dev, &cnt);
+	if (ret)
+		return ret;
 
-		ret = AD5940_FIFORd_Fast(dev->spi, pBuffer, uiReadCount);
-	}
+	cnt = no_os_min(cnt, nBufferSize);
+	ret = ad5940_FIFORd(dev, pBuffer, cnt);
+	if (ret)
+		return ret;
 
-	return ret;
+	*pCount = cnt;
+
+	return 0;
 }
 
 /** Write to address @ref RegAddr with data @RegData  */
@@ -2054,14 +2119,57 @@ int ad5940_SEQCmdWrite(struct ad5940_dev *dev, uint32_t StartAddr,
 		       const uint32_t *pCommand, uint32_t CmdCnt)
 {
 	int ret;
+	/* Per command: SETADDR, WRITEREG for the address, then for the data */
+	uint8_t iobuf[AD5940_SEQCMD_BURST][2][8];
+	struct no_os_spi_msg xfer[AD5940_SEQCMD_BURST * 4] = {0};
+	uint32_t i, j, n;
+	uint8_t *buf;
 
-	while(CmdCnt--) {
-		ret = ad5940_WriteReg(dev, REG_AFE_CMDFIFOWADDR, StartAddr++);
-		if (ret < 0)
-			return ret;
-		ret = ad5940_WriteReg(dev, REG_AFE_CMDFIFOWRITE, *pCommand++);
-		if (ret < 0)
+	if (!dev || !pCommand)
+		return -EINVAL;
+
+	/* Commands written while generating a sequence become part of it */
+	if(dev->SeqGenDB.EngineStart == true) {
+		while(CmdCnt--) {
+			ret = ad5940_WriteReg(dev, REG_AFE_CMDFIFOWADDR, StartAddr++);
+			if (ret < 0)
+				return ret;
+			ret = ad5940_WriteReg(dev, REG_AFE_CMDFIFOWRITE, *pCommand++);
+			if (ret < 0)
+				return ret;
+		}
+
+		return 0;
+	}
+
+	for (i = 0; i < NO_OS_ARRAY_SIZE(xfer); i++) {
+		buf = iobuf[i / 4][(i / 2) % 2];
+		xfer[i].tx_buff = (i % 2) ? &buf[3] : buf;
+		xfer[i].bytes_number = (i % 2) ? 5 : 3;
+		xfer[i].cs_change = 1;
+	}
+
+	while (CmdCnt) {
+		n = no_os_min(CmdCnt, AD5940_SEQCMD_BURST);
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < 2; j++) {
+				buf = iobuf[i][j];
+				no_os_put_unaligned_be16(j ? REG_AFE_CMDFIFOWRITE :
+							 REG_AFE_CMDFIFOWADDR, &buf[1]);
+				no_os_put_unaligned_be32(j ? pCommand[i] : StartAddr + i,
+							 &buf[4]);
+				buf[0] = SPICMD_SETADDR;
+				buf[3] = SPICMD_WRITEREG;
+			}
+		}
+
+		ret = no_os_spi_transfer(dev->spi, xfer, n * 4);
+		if (ret)
 			return ret;
+
+		StartAddr += n;
+		pCommand += n;
+		CmdCnt -= n;
 	}
 
 	return 0;
@@ -2114,6 +2222,46 @@ int ad5940_SEQInfoCfg(struct ad5940_dev *dev, SEQInfo_Type *pSeq)
 	return 0;
 }
 
+/**
+   @brief int AD5940_SEQImageLoad(SEQImage_Type *pImage)
+          ====== Write a precompiled sequencer image to SRAM and configure the
+          information registers of the sequences it contains.
+   @param pImage : {0 - 0xffffffff}
+          - Pointer to the image, as generated by tools/ad5940_seqgen.
+   @return return 0 in case of success, negative error code otherwise.
+ */
+int ad5940_SEQImageLoad(struct ad5940_dev *dev, const SEQImage_Type *pImage)
+{
+	int ret;
+	uint32_t i;
+	SEQInfo_Type seq;
+
+	if (!dev || !pImage || !pImage->pSeqCmd || !pImage->pSeqInfo)
+		return -EINVAL;
+
+	for (i = 0; i < pImage->SeqCnt; i++) {
+		seq = pImage->pSeqInfo[i];
+		if (seq.SeqRamAddr < pImage->SeqRamAddr ||
+		    seq.SeqRamAddr + seq.SeqLen > pImage->SeqRamAddr + pImage->SeqLen)
+			return -EINVAL;
+	}
+
+	ret = ad5940_SEQCmdWrite(dev, pImage->SeqRamAddr, pImage->pSeqCmd,
+				 pImage->SeqLen);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < pImage->SeqCnt; i++) {
+		seq = pImage->pSeqInfo[i];
+		seq.WriteSRAM = false;
+		ret = ad5940_SEQInfoCfg(dev, &seq);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
 /**
    @brief int AD5940_SEQInfoGet(uint32_t SeqId, SEQInfo_Type *pSeqInfo)
           ====== Get sequence info: start address and sequence length.
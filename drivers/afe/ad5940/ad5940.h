@@ -2421,6 +2421,10 @@ typedef enum {
 #define SPICMD_READREG	0x6d
 #define SPICMD_WRITEREG	0x2d
 #define SPICMD_READFIFO	0x5f
+/* Shortest FIFO read that uses the SPICMD_READFIFO command */
+#define AD5940_FIFORD_FAST_MIN	3
+/* Sequencer commands written to SRAM in a single SPI transfer */
+#define AD5940_SEQCMD_BURST	8
 /**
  * @} SPI_Block_Const
  * @} SPI_Block
@@ -3815,6 +3819,18 @@ typedef struct {
 	*pSeqCmd;  /**< Pointer to the sequencer commands that stored in MCU */
 } SEQInfo_Type;
 
+/**
+ * Precompiled sequencer image. All sequences are stored back to back in
+ * pSeqCmd and are written to SRAM starting at SeqRamAddr.
+*/
+typedef struct {
+	uint32_t SeqRamAddr;      /**< SRAM address of the first command */
+	uint32_t SeqLen;          /**< Total number of commands in the image */
+	const uint32_t *pSeqCmd;  /**< Sequencer commands of all sequences */
+	uint32_t SeqCnt;          /**< Number of sequences in the image */
+	const SEQInfo_Type *pSeqInfo; /**< Sequences, with absolute SRAM addresses */
+} SEQImage_Type;
+
 /**
  * Wakeup Timer Configure
  * */
@@ -3953,6 +3969,8 @@ struct SeqGen {
 	SEQGenRegInfo_Type *pRegInfo;
 	uint32_t RegCount;
 	int LastError;
+	/* Insertion order + 1 of each register in pRegInfo, 0 if untracked */
+	uint16_t RegIndex[256];
 };
 
 /**
@@ -3994,6 +4012,8 @@ int ad5940_WriteReg_mask(struct ad5940_dev *dev, uint16_t RegAddr,
 			 uint32_t mask, uint32_t RegData);
 int ad5940_FIFORd(struct ad5940_dev *dev, uint32_t *pBuffer,
 		  uint32_t uiReadCount);
+int ad5940_FIFODrain(struct ad5940_dev *dev, uint32_t *pBuffer,
+		     uint32_t nBufferSize, uint32_t *pCount);
 
 /* 2. AD5940 Top Control functions */
 int ad5940_AFECtrlS(struct ad5940_dev *dev, uint32_t AfeCtrlSet, bool State);
@@ -4058,6 +4078,8 @@ int ad5940_SEQMmrTrig(struct ad5940_dev *dev,
 int ad5940_SEQCmdWrite(struct ad5940_dev *dev, uint32_t StartAddr,
 		       const uint32_t *pCommand, uint32_t CmdCnt);
 int ad5940_SEQInfoCfg(struct ad5940_dev *dev, SEQInfo_Type *pSeq);
+int ad5940_SEQImageLoad(struct ad5940_dev *dev,
+			const SEQImage_Type *pImage); /* Write a precompiled image and its sequence info */
 int ad5940_SEQInfoGet(struct ad5940_dev *dev, uint32_t SeqId,
 		      SEQInfo_Type *pSeqInfo);
 int ad5940_SEQGpioCtrlS(struct ad5940_dev *dev,
@@ -529,6 +529,51 @@ static int AppBiaRtiaCal(struct ad5940_dev *dev)
 	return 0;
 }
 
+/* Generate the init and measurement sequences and write them to SRAM */
+int AppBiaSeqGen(struct ad5940_dev *dev, uint32_t *pBuffer, uint32_t BufferSize)
+{
+	int ret;
+
+	if (pBuffer == 0)
+		return -EINVAL;
+	if (BufferSize == 0)
+		return -EINVAL;
+	ret = ad5940_SEQGenInit(dev, pBuffer, BufferSize);
+	if (ret < 0)
+		return ret;
+
+	/* Generate initialize sequence */
+	ret = AppBiaSeqCfgGen(
+		      dev); /* Application initialization sequence using either MCU or sequencer */
+	if (ret < 0)
+		return ret;
+
+	/* Generate measurement sequence */
+	return AppBiaSeqMeasureGen(dev, AppBiaCfg.bImpedanceReadMode);
+}
+
+/* Load a precompiled image holding the init (SEQID_1) and measurement
+ * (SEQID_0) sequences, instead of generating them. */
+static int AppBiaSeqLoad(struct ad5940_dev *dev, const SEQImage_Type *pImage)
+{
+	uint32_t i;
+	bool init = false, measure = false;
+
+	for (i = 0; i < pImage->SeqCnt; i++) {
+		if (pImage->pSeqInfo[i].SeqId == SEQID_1) {
+			AppBiaCfg.InitSeqInfo = pImage->pSeqInfo[i];
+			init = true;
+		} else if (pImage->pSeqInfo[i].SeqId == SEQID_0) {
+			AppBiaCfg.MeasureSeqInfo = pImage->pSeqInfo[i];
+			measure = true;
+		}
+	}
+	if (!init || !measure)
+		return -EINVAL;
+
+	return ad5940_SEQImageLoad(dev, pImage);
+}
+
 /* This function provide application initialize.   */
 int AppBiaInit(struct ad5940_dev *dev, uint32_t *pBuffer, uint32_t BufferSize)
 {
@@ -589,22 +634,11 @@ int AppBiaInit(struct ad5940_dev *dev, uint32_t *pBuffer, uint32_t BufferSize)
 	/* Initialize sequencer generator */
 	if ((AppBiaCfg.BiaInited == false) ||
 	    (AppBiaCfg.bParamsChanged == true)) {
-		if (pBuffer == 0)
-			return -EINVAL;
-		if (BufferSize == 0)
-			return -EINVAL;
-		ret = ad5940_SEQGenInit(dev, pBuffer, BufferSize);
-		if (ret < 0)
-			return ret;
-
-		/* Generate initialize sequence */
-		ret = AppBiaSeqCfgGen(
-			      dev); /* Application initialization sequence using either MCU or sequencer */
-		if (ret < 0)
-			return ret;
-
-		/* Generate measurement sequence */
-		ret = AppBiaSeqMeasureGen(dev, AppBiaCfg.bImpedanceReadMode);
+		/* The image only matches the configuration it was built for */
+		if (AppBiaCfg.pSeqImage && !AppBiaCfg.bParamsChanged)
+			ret = AppBiaSeqLoad(dev, AppBiaCfg.pSeqImage);
+		else
+			ret = AppBiaSeqGen(dev, pBuffer, BufferSize);
 		if (ret < 0)
 			return ret;
 	}
@@ -94,6 +94,7 @@ typedef struct {
 	SEQInfo_Type MeasureSeqInfo;
 	bool StopRequired;  /* After FIFO is ready, stop the measurment sequence */
 	uint32_t FifoDataCount; /* Count how many times impedance have been measured */
+	const SEQImage_Type *pSeqImage; /* Precompiled sequences matching this configuration. If set, they are loaded on the first initialization instead of generated. Sequences are generated when bParamsChanged is set. */
 	/* End */
 } AppBiaCfg_Type;
 
@@ -105,6 +106,7 @@ typedef struct {
 
 int AppBiaGetCfg(void *pCfg);
 int AppBiaInit(struct ad5940_dev *dev, uint32_t *pBuffer, uint32_t nBufferSize);
+int AppBiaSeqGen(struct ad5940_dev *dev, uint32_t *pBuffer, uint32_t BufferSize);
 int AppBiaISR(struct ad5940_dev *dev, void *pBuff, uint32_t *pCountd);
 int AppBiaCtrl(struct ad5940_dev *dev, int32_t BcmCtrl, void *pPara);
 void signExtend18To32(uint32_t *const pData, uint16_t nLen);
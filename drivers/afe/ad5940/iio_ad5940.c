@@ -38,6 +38,7 @@
 #include "no_os_delay.h"
 #include "no_os_util.h"
 #include "no_os_alloc.h"
+#include "no_os_circular_buffer.h"
 #include "iio.h"
 #include "iio_ad5940.h"
 #include "bia_measurement.h"
@@ -54,6 +55,24 @@ static int32_t _ad5940_write_register2(struct ad5940_iio_dev *dev, uint32_t reg,
 	return ad5940_WriteReg(dev->ad5940, reg, writeval);
 }
 
+/* Wait for the sequencer to raise the data FIFO threshold interrupt */
+static int ad5940_iio_wait_data(struct ad5940_iio_dev *iiodev, uint32_t timeout)
+{
+	uint8_t gpio;
+	int ret;
+
+	while (timeout--) {
+		ret = no_os_gpio_get_value(iiodev->ad5940->gp0_gpio, &gpio);
+		if (ret)
+			return ret;
+		if (!gpio)
+			return 0;
+		no_os_mdelay(1);
+	}
+
+	return -ETIMEDOUT;
+}
+
 static int ad5940_iio_read_chan_raw(void *device, char *buf, uint32_t len,
 				    const struct iio_ch_info *channel,
 				    intptr_t priv)
@@ -65,9 +84,8 @@ static int ad5940_iio_read_chan_raw(void *device, char *buf, uint32_t len,
 	fImpCar_Type fCarZval;
 	iImpCar_Type iCarVval;
 	float fMagVal;
-	uint32_t timeout = 100;
-	uint8_t gpio;
-	uint32_t count = 0;
+	uint32_t count = 512;
+	int ret;
 
 	AppBiaGetCfg(&pBiaCfg);
 	if(pBiaCfg->bParamsChanged)
@@ -75,17 +93,10 @@ static int ad5940_iio_read_chan_raw(void *device, char *buf, uint32_t len,
 
 	AppBiaCtrl(iiodev->ad5940, BIACTRL_START, 0);
 
-	while (timeout--) {
-		no_os_gpio_get_value(iiodev->ad5940->gp0_gpio, &gpio);
-		if (gpio)
-			no_os_mdelay(1);
-		else
-			break;
-	}
-
-	if (!timeout) {
+	ret = ad5940_iio_wait_data(iiodev, 100);
+	if (ret) {
 		AppBiaCtrl(iiodev->ad5940, BIACTRL_STOPNOW, 0);
-		return -ETIMEDOUT;
+		return ret;
 	}
 
 	AppBiaISR(iiodev->ad5940, iiodev->AppBuff, &count);
@@ -231,6 +242,110 @@ int ad5940_iio_set_attr(void *device, char *buf, uint32_t len,
 	return 0;
 }
 
+/**
+ * @brief Start the measurement sequence for buffered DFT capture.
+ * @param iiodev - The iio device structure.
+ * @param mask - Mask of the enabled channels.
+ * @return 0 in case of success, errno errors otherwise
+ */
+static int ad5940_iio_buffer_enable(struct ad5940_iio_dev *iiodev,
+				    uint32_t mask)
+{
+	AppBiaCfg_Type *pBiaCfg;
+	int ret;
+
+	/* DFT channels come first, their index is also their scan index */
+	iiodev->dft_mask = mask & NO_OS_GENMASK(AD5940_IIO_DFT_NUM_CH - 1, 0);
+
+	AppBiaGetCfg(&pBiaCfg);
+	if (!pBiaCfg->bImpedanceReadMode &&
+	    (iiodev->dft_mask & (NO_OS_BIT(AD5940_IIO_DFT_CURR_REAL) |
+				 NO_OS_BIT(AD5940_IIO_DFT_CURR_IMAG))))
+		return -EINVAL;
+
+	if (pBiaCfg->bParamsChanged) {
+		ret = AppBiaInit(iiodev->ad5940, iiodev->AppBuff, 512);
+		if (ret < 0)
+			return ret;
+	}
+
+	return AppBiaCtrl(iiodev->ad5940, BIACTRL_START, 0);
+}
+
+/**
+ * @brief Stop the measurement sequence.
+ * @param iiodev - The iio device structure.
+ * @return 0 in case of success, errno errors otherwise
+ */
+static int ad5940_iio_buffer_disable(struct ad5940_iio_dev *iiodev)
+{
+	return AppBiaCtrl(iiodev->ad5940, BIACTRL_STOPNOW, 0);
+}
+
+/**
+ * @brief Fill the IIO buffer with raw DFT results. Every FIFO threshold
+ *	  interrupt is drained in one burst and the complete measurements it
+ *	  holds are pushed with a single circular buffer write.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success, errno errors otherwise
+ */
+static int ad5940_iio_submit(struct iio_device_data *dev_data)
+{
+	struct ad5940_iio_dev *iiodev = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	AppBiaCfg_Type *pBiaCfg;
+	uint32_t words, count, nb_scans, samples = 0;
+	uint32_t i, j, k;
+	int ret;
+
+	AppBiaGetCfg(&pBiaCfg);
+	words = pBiaCfg->bImpedanceReadMode ? 4 : 2;
+
+	while (samples < buffer->samples) {
+		ret = ad5940_iio_wait_data(iiodev, 1000);
+		if (ret)
+			return ret;
+
+		count = NO_OS_ARRAY_SIZE(iiodev->AppBuff);
+		ret = AppBiaISR(iiodev->ad5940, iiodev->AppBuff, &count);
+		if (ret)
+			return ret;
+
+		nb_scans = no_os_min(count / words, buffer->samples - samples);
+		if (!nb_scans)
+			continue;
+
+		signExtend18To32(iiodev->AppBuff, nb_scans * words);
+
+		/* Pack the enabled channels in place, scans never grow */
+		k = 0;
+		for (i = 0; i < nb_scans; i++) {
+			for (j = 0; j < words; j++) {
+				if (!(iiodev->dft_mask & NO_OS_BIT(j)))
+					continue;
+				iiodev->AppBuff[k++] = iiodev->AppBuff[i * words + j];
+			}
+		}
+
+		ret = no_os_cb_write(buffer->buf, iiodev->AppBuff,
+				     nb_scans * buffer->bytes_per_scan);
+		if (ret)
+			return ret;
+
+		samples += nb_scans;
+	}
+
+	return 0;
+}
+
+static struct scan_type ad5940_iio_dft_scan_type = {
+	.sign = 's',
+	.realbits = 18,
+	.storagebits = 32,
+	.shift = 0,
+	.is_big_endian = false,
+};
+
 struct iio_attribute ad5940_iio_global_attr[] = {
 	{
 		.name = "impedance_mode",
@@ -269,13 +384,21 @@ static struct iio_device ad5940_iio_device = {
 	.attributes = ad5940_iio_global_attr,
 	.debug_attributes = NULL,
 	.buffer_attributes = NULL,
-	.pre_enable = NULL,
-	.post_disable = NULL,
+	.pre_enable = (int32_t (*)())ad5940_iio_buffer_enable,
+	.post_disable = (int32_t (*)())ad5940_iio_buffer_disable,
+	.submit = ad5940_iio_submit,
 	.read_dev = NULL,
 	.debug_reg_read = (int32_t (*)())_ad5940_read_register2,
 	.debug_reg_write = (int32_t (*)())_ad5940_write_register2
 };
 
+static const char *const ad5940_iio_dft_names[] = {
+	[AD5940_IIO_DFT_VOLT_REAL] = "dft_voltage_real",
+	[AD5940_IIO_DFT_VOLT_IMAG] = "dft_voltage_imag",
+	[AD5940_IIO_DFT_CURR_REAL] = "dft_current_real",
+	[AD5940_IIO_DFT_CURR_IMAG] = "dft_current_imag",
+};
+
 static struct iio_attribute ad5940_channel_attributes[] = {
 	{
 		.name = "raw",
@@ -301,13 +424,29 @@ int32_t ad5940_iio_init(struct ad5940_iio_dev **iio_dev,
 
 	desc->iio = &ad5940_iio_device;
 
-	desc->iio->channels = (struct iio_channel *)no_os_calloc(1,
-			      sizeof(struct iio_channel));
+	desc->iio->channels = (struct iio_channel *)no_os_calloc(
+				      1 + AD5940_IIO_DFT_NUM_CH,
+				      sizeof(struct iio_channel));
 	if (!desc->iio->channels)
 		goto error_1;
-	desc->iio->num_ch = 1;
+	desc->iio->num_ch = 1 + AD5940_IIO_DFT_NUM_CH;
+
+	/*
+	 * Raw DFT results, only available through the buffer. They are placed
+	 * first so that the channel index matches the scan index, which is
+	 * how the buffer channel mask is decoded.
+	 */
+	for (ch = 0; ch < AD5940_IIO_DFT_NUM_CH; ch++) {
+		desc->iio->channels[ch].name = ad5940_iio_dft_names[ch];
+		desc->iio->channels[ch].ch_type = ch <= AD5940_IIO_DFT_VOLT_IMAG ?
+						  IIO_VOLTAGE : IIO_CURRENT;
+		desc->iio->channels[ch].channel = ch <= AD5940_IIO_DFT_VOLT_IMAG ?
+						  ch + 1 : ch - AD5940_IIO_DFT_CURR_REAL;
+		desc->iio->channels[ch].indexed = true;
+		desc->iio->channels[ch].scan_index = ch;
+		desc->iio->channels[ch].scan_type = &ad5940_iio_dft_scan_type;
+	}
 
-	ch = 0;
 	desc->iio->channels[ch].name = "bia";
 	desc->iio->channels[ch].ch_type = IIO_VOLTAGE;
 	desc->iio->channels[ch].indexed = true;
@@ -44,11 +44,22 @@ enum ad5940_iio_attr {
 	AD5940_IIO_GPIO1_TOGGLE,
 };
 
+/* Buffered DFT result channels, placed before the "bia" channel */
+enum ad5940_iio_dft_chan {
+	AD5940_IIO_DFT_VOLT_REAL,
+	AD5940_IIO_DFT_VOLT_IMAG,
+	AD5940_IIO_DFT_CURR_REAL,
+	AD5940_IIO_DFT_CURR_IMAG,
+	AD5940_IIO_DFT_NUM_CH,
+};
+
 struct ad5940_iio_dev {
 	struct ad5940_dev *ad5940;
 	struct iio_device *iio;
 	bool magnitude_mode;
 	bool gpio1;
+	/* DFT channels enabled for buffered capture */
+	uint32_t dft_mask;
 	uint32_t AppBuff[512];
 };
 
@@ -108,6 +108,32 @@ uint32_t no_os_uart_get_errors(struct no_os_uart_desc *desc)
 	return desc->platform_ops->get_errors(desc);
 }
 
+/**
+ * @brief Change the baud rate of an initialized UART, keeping the other
+ * settings. The data still being sent may be corrupted.
+ * @param desc - The UART descriptor.
+ * @param baud_rate - The new baud rate.
+ * @return 0 in case of success, error code otherwise.
+ */
+int32_t no_os_uart_set_baud(struct no_os_uart_desc *desc, uint32_t baud_rate)
+{
+	int32_t ret;
+
+	if (!desc || !desc->platform_ops || !baud_rate)
+		return -EINVAL;
+
+	if (!desc->platform_ops->set_baud)
+		return -ENOSYS;
+
+	no_os_mutex_lock(desc->mutex);
+	ret = desc->platform_ops->set_baud(desc, baud_rate);
+	if (!ret)
+		desc->baud_rate = baud_rate;
+	no_os_mutex_unlock(desc->mutex);
+
+	return ret;
+}
+
 /**
  * @brief Read data from UART.
  * @param desc - The UART descriptor.
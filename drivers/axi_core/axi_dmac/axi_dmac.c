@@ -295,6 +295,13 @@ static int32_t axi_dmac_detect_caps(struct axi_dmac *dmac)
 	/* Restore initial value for AXI_DMAC_REG_FLAGS register */
 	axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, initial_reg_val);
 
+	/* The SG address register only exists if the core supports hardware
+	 * scatter-gather. */
+	axi_dmac_write(dmac, AXI_DMAC_REG_SG_ADDRESS, 0xffffffff);
+	axi_dmac_read(dmac, AXI_DMAC_REG_SG_ADDRESS, &reg_val);
+	dmac->hw_sg = !!reg_val;
+	axi_dmac_write(dmac, AXI_DMAC_REG_SG_ADDRESS, 0x0);
+
 	/* Get maximum burst size and set value. */
 	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, dmac->max_length);
 	axi_dmac_read(dmac, AXI_DMAC_REG_X_LENGTH, &dmac->max_length);
@@ -343,6 +350,8 @@ int32_t axi_dmac_init(struct axi_dmac **dmac_core,
 	dmac->name = init->name;
 	dmac->base = init->base;
 	dmac->irq_option = init->irq_option;
+	dmac->dcache_flush_range = init->dcache_flush_range;
+	dmac->dcache_invalidate_range = init->dcache_invalidate_range;
 
 	int32_t status = axi_dmac_detect_caps(dmac);
 	if (status < 0)
@@ -565,3 +574,449 @@ void axi_dmac_transfer_stop(struct axi_dmac *dmac)
 {
 	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_DISABLE);
 }
+
+/*******************************************************************************
+ * @brief Check that the addresses of a request are aligned with the data path
+ *        widths of the core.
+ *
+ * @param dmac - DMAC istance.
+ * @param req - The request.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+static int32_t axi_dmac_request_check(struct axi_dmac *dmac,
+				      struct axi_dmac_request *req)
+{
+	if (!req->size)
+		return -EINVAL;
+
+	switch (dmac->direction) {
+	case DMA_DEV_TO_MEM:
+		if (req->dest_addr % (dmac->width_dst / 8))
+			return -EINVAL;
+		break;
+	case DMA_MEM_TO_DEV:
+		if (req->src_addr % (dmac->width_src / 8))
+			return -EINVAL;
+		break;
+	case DMA_MEM_TO_MEM:
+		if ((req->dest_addr % (dmac->width_dst / 8)) ||
+		    (req->src_addr % (dmac->width_src / 8)))
+			return -EINVAL;
+		break;
+	default:
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Mark the scatter-gather descriptors of a request as not completed
+ *        and flush them to memory.
+ *
+ * @param dmac - DMAC istance.
+ * @param req - The request.
+ *
+ * @return None.
+*******************************************************************************/
+static void axi_dmac_sg_arm(struct axi_dmac *dmac, struct axi_dmac_request *req)
+{
+	uint32_t i;
+
+	for (i = 0; i < req->num_hw_desc; i++)
+		req->hw_desc[i].id = AXI_DMAC_SG_UNUSED;
+
+	if (dmac->dcache_flush_range)
+		dmac->dcache_flush_range((uintptr_t)req->hw_desc,
+					 req->num_hw_desc * sizeof(*req->hw_desc));
+}
+
+/*******************************************************************************
+ * @brief Build the scatter-gather descriptor chain of a request, splitting it
+ *        into segments of at most max_length + 1 bytes.
+ *
+ * @param dmac - DMAC istance.
+ * @param req - The request.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+static int32_t axi_dmac_sg_prepare(struct axi_dmac *dmac,
+				   struct axi_dmac_request *req)
+{
+	uint32_t seg_max = dmac->max_length + 1;
+	uint32_t i, len, offset = 0;
+	struct axi_dmac_hw_desc *hw;
+
+	req->num_hw_desc = NO_OS_DIV_ROUND_UP(req->size, seg_max);
+	req->hw_desc_mem = no_os_calloc(1, req->num_hw_desc * sizeof(*hw) +
+					AXI_DMAC_HW_DESC_ALIGN - 1);
+	if (!req->hw_desc_mem)
+		return -ENOMEM;
+
+	req->hw_desc = (struct axi_dmac_hw_desc *)
+		       (((uintptr_t)req->hw_desc_mem + AXI_DMAC_HW_DESC_ALIGN - 1) &
+			~(uintptr_t)(AXI_DMAC_HW_DESC_ALIGN - 1));
+
+	for (i = 0; i < req->num_hw_desc; i++) {
+		hw = &req->hw_desc[i];
+		len = no_os_min(req->size - offset, seg_max);
+
+		if (dmac->direction != DMA_MEM_TO_DEV)
+			hw->dest_addr = req->dest_addr + offset;
+		if (dmac->direction != DMA_DEV_TO_MEM)
+			hw->src_addr = req->src_addr + offset;
+		hw->x_len = len - 1;
+
+		if (i == req->num_hw_desc - 1)
+			hw->flags = AXI_DMAC_HW_FLAG_LAST | AXI_DMAC_HW_FLAG_IRQ;
+		else
+			hw->next_sg_addr = (uintptr_t)&req->hw_desc[i + 1];
+
+		offset += len;
+	}
+
+	axi_dmac_sg_arm(dmac, req);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Release the scatter-gather descriptors of a request.
+ *
+ * @param req - The request.
+ *
+ * @return None.
+*******************************************************************************/
+static void axi_dmac_sg_release(struct axi_dmac_request *req)
+{
+	no_os_free(req->hw_desc_mem);
+	req->hw_desc_mem = NULL;
+	req->hw_desc = NULL;
+	req->num_hw_desc = 0;
+}
+
+/*******************************************************************************
+ * @brief Hand pending requests to the core until its transfer queue is full.
+ *
+ * With hardware scatter-gather a whole request takes a single queue entry,
+ * otherwise each request is split into segments of at most max_length + 1
+ * bytes, one queue entry each.
+ *
+ * @param dmac - DMAC istance.
+ *
+ * @return None.
+*******************************************************************************/
+static void axi_dmac_queue_fill(struct axi_dmac *dmac)
+{
+	struct axi_dmac_request *req;
+	uint32_t reg_val, id, len, slot;
+	bool last;
+
+	while (dmac->queue_pending && dmac->num_inflight < AXI_DMAC_MAX_IDS) {
+		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_SUBMIT, &reg_val);
+		if (reg_val & AXI_DMAC_QUEUE_FULL)
+			break;
+
+		req = dmac->queue_pending;
+		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &id);
+		id %= AXI_DMAC_MAX_IDS;
+
+		if (dmac->hw_sg) {
+			axi_dmac_write(dmac, AXI_DMAC_REG_SG_ADDRESS,
+				       (uintptr_t)req->hw_desc);
+			req->submitted = req->size;
+		} else {
+			len = no_os_min(req->size - req->submitted,
+					dmac->max_length + 1);
+			if (dmac->direction != DMA_MEM_TO_DEV) {
+				axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS,
+					       req->dest_addr + req->submitted);
+				axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
+			}
+			if (dmac->direction != DMA_DEV_TO_MEM) {
+				axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS,
+					       req->src_addr + req->submitted);
+				axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
+			}
+			axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, len - 1);
+			axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+			req->submitted += len;
+		}
+
+		last = req->submitted == req->size;
+		axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, last ? DMA_LAST : 0);
+		axi_dmac_write(dmac, AXI_DMAC_REG_TRANSFER_SUBMIT,
+			       AXI_DMAC_TRANSFER_SUBMIT);
+
+		slot = (dmac->inflight_head + dmac->num_inflight) % AXI_DMAC_MAX_IDS;
+		dmac->inflight_id[slot] = id;
+		dmac->inflight_req[slot] = req;
+		dmac->inflight_last[slot] = last;
+		dmac->num_inflight++;
+
+		if (last)
+			dmac->queue_pending = req->next;
+	}
+}
+
+/*******************************************************************************
+ * @brief Append a request to the software queue.
+ *
+ * @param dmac - DMAC istance.
+ * @param req - The request.
+ *
+ * @return None.
+*******************************************************************************/
+static void axi_dmac_queue_add(struct axi_dmac *dmac,
+			       struct axi_dmac_request *req)
+{
+	req->submitted = 0;
+	req->next = NULL;
+
+	if (dmac->queue_tail)
+		dmac->queue_tail->next = req;
+	else
+		dmac->queue_head = req;
+	dmac->queue_tail = req;
+
+	if (!dmac->queue_pending)
+		dmac->queue_pending = req;
+}
+
+/*******************************************************************************
+ * @brief Mask the completion interrupt while the queues are being updated
+ *        outside of the interrupt handler.
+ *
+ * @param dmac - DMAC istance.
+ * @param lock - true to mask, false to unmask.
+ *
+ * @return None.
+*******************************************************************************/
+static void axi_dmac_queue_lock(struct axi_dmac *dmac, bool lock)
+{
+	if (dmac->irq_option != IRQ_ENABLED)
+		return;
+
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK,
+		       lock ? (AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT) :
+		       AXI_DMAC_IRQ_SOT);
+}
+
+/*******************************************************************************
+ * @brief Queue an asynchronous transfer.
+ *
+ * The request is handed to the core as soon as its transfer queue has room,
+ * behind the requests already queued. Completion is reported through
+ * req->complete, from axi_dmac_async_isr() or axi_dmac_process(). The request
+ * must stay valid until then. Must not be mixed with
+ * axi_dmac_transfer_start() on the same core.
+ *
+ * @param dmac - DMAC istance.
+ * @param req - The request.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+int32_t axi_dmac_submit(struct axi_dmac *dmac, struct axi_dmac_request *req)
+{
+	uint32_t reg_val;
+	int32_t ret;
+
+	if (!dmac || !req)
+		return -EINVAL;
+
+	ret = axi_dmac_request_check(dmac, req);
+	if (ret)
+		return ret;
+
+	if (dmac->hw_sg && !req->hw_desc) {
+		ret = axi_dmac_sg_prepare(dmac, req);
+		if (ret)
+			return ret;
+	}
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
+	if (!(reg_val & AXI_DMAC_CTRL_ENABLE)) {
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE |
+			       (dmac->hw_sg ? AXI_DMAC_CTRL_ENABLE_SG : 0));
+	}
+
+	axi_dmac_queue_lock(dmac, true);
+	axi_dmac_queue_add(dmac, req);
+	axi_dmac_queue_fill(dmac);
+	axi_dmac_queue_lock(dmac, false);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Retire the completed transfers, call the completion callbacks and
+ *        refill the transfer queue of the core.
+ *
+ * Called by axi_dmac_async_isr(); when the DMAC interrupt is not used it has
+ * to be called periodically instead.
+ *
+ * @param dmac - DMAC istance.
+ *
+ * @return Number of requests completed.
+*******************************************************************************/
+int32_t axi_dmac_process(struct axi_dmac *dmac)
+{
+	struct axi_dmac_request *req;
+	struct axi_dmac_hw_desc *hw;
+	uint32_t transfer_done = 0;
+	int32_t completed = 0;
+	bool stream;
+
+	if (!dmac->hw_sg)
+		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &transfer_done);
+
+	while (dmac->num_inflight) {
+		req = dmac->inflight_req[dmac->inflight_head];
+
+		if (dmac->hw_sg) {
+			/* The core writes the transfer id back on completion */
+			hw = &req->hw_desc[req->num_hw_desc - 1];
+			if (dmac->dcache_invalidate_range)
+				dmac->dcache_invalidate_range((uintptr_t)hw, sizeof(*hw));
+			if (hw->id == AXI_DMAC_SG_UNUSED)
+				break;
+		} else if (!(transfer_done &
+			     NO_OS_BIT(dmac->inflight_id[dmac->inflight_head]))) {
+			break;
+		}
+
+		dmac->num_inflight--;
+		if (!dmac->inflight_last[dmac->inflight_head]) {
+			dmac->inflight_head = (dmac->inflight_head + 1) % AXI_DMAC_MAX_IDS;
+			continue;
+		}
+		dmac->inflight_head = (dmac->inflight_head + 1) % AXI_DMAC_MAX_IDS;
+
+		/* Requests complete in order */
+		dmac->queue_head = req->next;
+		if (!dmac->queue_head)
+			dmac->queue_tail = NULL;
+
+		/* The callback may resubmit the request or stop the stream */
+		stream = dmac->streaming;
+		if (!stream && dmac->hw_sg)
+			axi_dmac_sg_release(req);
+
+		if (req->complete)
+			req->complete(dmac, req);
+
+		/* Streaming requests go back to the queue once consumed */
+		if (stream && dmac->streaming) {
+			if (dmac->hw_sg)
+				axi_dmac_sg_arm(dmac, req);
+			axi_dmac_queue_add(dmac, req);
+		} else if (stream && dmac->hw_sg) {
+			axi_dmac_sg_release(req);
+		}
+
+		completed++;
+	}
+
+	axi_dmac_queue_fill(dmac);
+
+	return completed;
+}
+
+/*******************************************************************************
+ * @brief ISR for the asynchronous API.
+ *
+ * @param instance - the instance that triggered the ISR.
+ *
+ * @return None.
+*******************************************************************************/
+void axi_dmac_async_isr(void *instance)
+{
+	struct axi_dmac *dmac = (struct axi_dmac *)instance;
+	uint32_t reg_val;
+
+	/* Get interrupt sources and clear interrupts. */
+	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+
+	if (reg_val & AXI_DMAC_IRQ_EOT)
+		axi_dmac_process(dmac);
+}
+
+/*******************************************************************************
+ * @brief Start streaming into (or from) a set of requests.
+ *
+ * Every completed request is resubmitted right after its completion callback
+ * returns, so the transfer queue of the core never runs dry as long as the
+ * callbacks keep up. The callback of a DEV_TO_MEM stream has to consume the
+ * buffer before returning.
+ *
+ * @param dmac - DMAC istance.
+ * @param reqs - Array of requests, at least two for gap-free streaming.
+ * @param num_reqs - Number of requests.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+int32_t axi_dmac_stream_start(struct axi_dmac *dmac,
+			      struct axi_dmac_request *reqs,
+			      uint32_t num_reqs)
+{
+	uint32_t i;
+	int32_t ret;
+
+	if (!dmac || !reqs || !num_reqs)
+		return -EINVAL;
+
+	dmac->streaming = true;
+
+	for (i = 0; i < num_reqs; i++) {
+		ret = axi_dmac_submit(dmac, &reqs[i]);
+		if (ret) {
+			axi_dmac_terminate(dmac);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Stop resubmitting the streaming requests. The requests already queued
+ *        still complete.
+ *
+ * @param dmac - DMAC istance.
+ *
+ * @return None.
+*******************************************************************************/
+void axi_dmac_stream_stop(struct axi_dmac *dmac)
+{
+	dmac->streaming = false;
+}
+
+/*******************************************************************************
+ * @brief Abort all the asynchronous transfers. Completion callbacks are not
+ *        called.
+ *
+ * @param dmac - DMAC istance.
+ *
+ * @return None.
+*******************************************************************************/
+void axi_dmac_terminate(struct axi_dmac *dmac)
+{
+	struct axi_dmac_request *req;
+
+	axi_dmac_queue_lock(dmac, true);
+	axi_dmac_transfer_stop(dmac);
+
+	for (req = dmac->queue_head; req; req = req->next)
+		axi_dmac_sg_release(req);
+
+	dmac->streaming = false;
+	dmac->queue_head = NULL;
+	dmac->queue_pending = NULL;
+	dmac->queue_tail = NULL;
+	dmac->inflight_head = 0;
+	dmac->num_inflight = 0;
+	axi_dmac_queue_lock(dmac, false);
+}
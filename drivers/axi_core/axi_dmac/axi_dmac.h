@@ -58,6 +58,7 @@
 #define AXI_DMAC_CTRL_ENABLE		NO_OS_BIT(0)
 #define AXI_DMAC_CTRL_DISABLE		0u
 #define AXI_DMAC_CTRL_PAUSE			NO_OS_BIT(1)
+#define AXI_DMAC_CTRL_ENABLE_SG		NO_OS_BIT(2)
 
 #define AXI_DMAC_REG_TRANSFER_ID		0x404
 #define AXI_DMAC_REG_TRANSFER_SUBMIT	0x408
@@ -71,6 +72,17 @@
 #define AXI_DMAC_REG_DEST_STRIDE		0x420
 #define AXI_DMAC_REG_SRC_STRIDE			0x424
 #define AXI_DMAC_REG_TRANSFER_DONE		0x428
+#define AXI_DMAC_REG_SG_ADDRESS			0x47c
+
+/* Hardware scatter-gather descriptor flags */
+#define AXI_DMAC_HW_FLAG_LAST			NO_OS_BIT(0)
+#define AXI_DMAC_HW_FLAG_IRQ			NO_OS_BIT(1)
+/* Descriptor id until the core writes it back on completion */
+#define AXI_DMAC_SG_UNUSED				32U
+#define AXI_DMAC_HW_DESC_ALIGN			64U
+
+/* Transfer ids allocated by the core */
+#define AXI_DMAC_MAX_IDS				32U
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -107,6 +119,44 @@ struct axi_dma_transfer {
 	uint32_t dest_addr;
 };
 
+/* Hardware scatter-gather descriptor, as fetched by the core. */
+struct axi_dmac_hw_desc {
+	uint32_t flags;
+	uint32_t id;
+	uint64_t dest_addr;
+	uint64_t src_addr;
+	uint64_t next_sg_addr;
+	uint32_t y_len;
+	uint32_t x_len;
+	uint32_t src_stride;
+	uint32_t dst_stride;
+	uint64_t pad[2];
+};
+
+struct axi_dmac;
+
+/* Asynchronous transfer request, see axi_dmac_submit(). */
+struct axi_dmac_request {
+	/* Source address, for MEM_TO_DEV and MEM_TO_MEM transfers */
+	uint32_t src_addr;
+	/* Destination address, for DEV_TO_MEM and MEM_TO_MEM transfers */
+	uint32_t dest_addr;
+	/* Transfer size in bytes */
+	uint32_t size;
+	/* Called once the whole request completed, optional */
+	void (*complete)(struct axi_dmac *dmac, struct axi_dmac_request *req);
+	/* Caller context, not used by the driver */
+	void *ctx;
+	/* Driver private: bytes already handed to the core */
+	uint32_t submitted;
+	/* Driver private: scatter-gather descriptor chain */
+	struct axi_dmac_hw_desc *hw_desc;
+	void *hw_desc_mem;
+	uint32_t num_hw_desc;
+	/* Driver private: software queue link */
+	struct axi_dmac_request *next;
+};
+
 struct axi_dmac {
 	const char *name;
 	uint32_t base;
@@ -122,12 +172,30 @@ struct axi_dmac {
 	uint32_t remaining_size;
 	uint32_t next_src_addr;
 	uint32_t next_dest_addr;
+	//Asynchronous API state
+	bool hw_sg;
+	bool streaming;
+	struct axi_dmac_request *queue_head;
+	struct axi_dmac_request *queue_pending;
+	struct axi_dmac_request *queue_tail;
+	struct axi_dmac_request *inflight_req[AXI_DMAC_MAX_IDS];
+	uint8_t inflight_id[AXI_DMAC_MAX_IDS];
+	bool inflight_last[AXI_DMAC_MAX_IDS];
+	uint32_t inflight_head;
+	uint32_t num_inflight;
+	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
 };
 
 struct axi_dmac_init {
 	const char *name;
 	uint32_t base;
 	enum use_irq irq_option;
+	/* Flush the data cache for the given range, needed when the
+	 * scatter-gather descriptors live in cached memory. Optional. */
+	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	/* Invalidate the data cache for the given range. Optional. */
+	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
 };
 
 /******************************************************************************/
@@ -150,5 +218,13 @@ int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
 int32_t axi_dmac_transfer_wait_completion(struct axi_dmac *dmac,
 		uint32_t timeout_ms);
 void axi_dmac_transfer_stop(struct axi_dmac *dmac);
+int32_t axi_dmac_submit(struct axi_dmac *dmac, struct axi_dmac_request *req);
+int32_t axi_dmac_process(struct axi_dmac *dmac);
+void axi_dmac_async_isr(void *instance);
+int32_t axi_dmac_stream_start(struct axi_dmac *dmac,
+			      struct axi_dmac_request *reqs,
+			      uint32_t num_reqs);
+void axi_dmac_stream_stop(struct axi_dmac *dmac);
+void axi_dmac_terminate(struct axi_dmac *dmac);
 
 #endif
@@ -40,8 +40,10 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <inttypes.h>
+#include <string.h>
 #include "no_os_error.h"
 #include "no_os_alloc.h"
+#include "no_os_delay.h"
 #include "iio.h"
 #include "iio_axi_adc.h"
 
@@ -50,6 +52,7 @@
 /******************************************************************************/
 
 #define STORAGE_BITS 16
+#define DMA_TIMEOUT_MS 500
 
 /**
  * @brief get_cf_calibphase().
@@ -379,6 +382,181 @@ int32_t	iio_axi_adc_read_dev(void *dev, void *buff, uint32_t nb_samples)
 	return 0;
 }
 
+/**
+ * @brief DMA completion callback, one more block was filled.
+ * @param dmac - DMA device.
+ * @param req - Completed request.
+ * @return None.
+ */
+static void iio_axi_adc_dma_complete(struct axi_dmac *dmac,
+				     struct axi_dmac_request *req)
+{
+	struct iio_axi_adc_desc *iio_adc = req->ctx;
+
+	iio_adc->dma_completed++;
+}
+
+/**
+ * @brief Stop the DMA and free the DMA blocks.
+ * @param iio_adc - Instance of the iio_axi_adc
+ * @return None.
+ */
+static void iio_axi_adc_dma_release(struct iio_axi_adc_desc *iio_adc)
+{
+	if (iio_adc->dma_req)
+		axi_dmac_terminate(iio_adc->dmac);
+
+	no_os_free(iio_adc->dma_req);
+	no_os_free(iio_adc->dma_mem);
+	iio_adc->dma_req = NULL;
+	iio_adc->dma_mem = NULL;
+	iio_adc->dma_blocks = NULL;
+	iio_adc->dma_block_size = 0;
+	iio_adc->dma_completed = 0;
+	iio_adc->dma_consumed = 0;
+}
+
+/**
+ * @brief Allocate the DMA blocks and queue all of them.
+ * @param iio_adc - Instance of the iio_axi_adc
+ * @param block_size - Size in bytes of a block.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_adc_dma_start(struct iio_axi_adc_desc *iio_adc,
+				     uint32_t block_size)
+{
+	uint32_t stride = no_os_align(block_size, IIO_AXI_ADC_DMA_ALIGN);
+	uint32_t i;
+	int32_t ret;
+
+	iio_adc->dma_req = no_os_calloc(iio_adc->num_dma_blocks,
+					sizeof(*iio_adc->dma_req));
+	if (!iio_adc->dma_req)
+		return -ENOMEM;
+
+	iio_adc->dma_mem = no_os_calloc(1, iio_adc->num_dma_blocks * stride +
+					IIO_AXI_ADC_DMA_ALIGN - 1);
+	if (!iio_adc->dma_mem) {
+		iio_axi_adc_dma_release(iio_adc);
+		return -ENOMEM;
+	}
+
+	iio_adc->dma_blocks = (uint8_t *)no_os_align((uintptr_t)iio_adc->dma_mem,
+			      IIO_AXI_ADC_DMA_ALIGN);
+	iio_adc->dma_block_size = block_size;
+
+	for (i = 0; i < iio_adc->num_dma_blocks; i++) {
+		iio_adc->dma_req[i].dest_addr =
+			(uintptr_t)(iio_adc->dma_blocks + i * stride);
+		iio_adc->dma_req[i].size = block_size;
+		iio_adc->dma_req[i].complete = iio_axi_adc_dma_complete;
+		iio_adc->dma_req[i].ctx = iio_adc;
+
+		ret = axi_dmac_submit(iio_adc->dmac, &iio_adc->dma_req[i]);
+		if (ret) {
+			iio_axi_adc_dma_release(iio_adc);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Capture one block straight into the IIO buffer, used when the DMA
+ * blocks can not be allocated.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_adc_submit_single(struct iio_device_data *dev_data)
+{
+	struct iio_buffer *buffer = dev_data->buffer;
+	void *buff;
+	int32_t ret;
+
+	ret = iio_buffer_get_block(buffer, &buff);
+	if (ret)
+		return ret;
+
+	ret = iio_axi_adc_read_dev(dev_data->dev, buff, buffer->samples);
+	if (ret)
+		return ret;
+
+	return iio_buffer_block_done(buffer);
+}
+
+/**
+ * @brief Hand the oldest filled DMA block to the IIO buffer.
+ *
+ * All the DMA blocks stay queued to the DMA, so the capture goes on while a
+ * block is being copied and sent to the client. The block is queued again
+ * once copied.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_adc_submit(struct iio_device_data *dev_data)
+{
+	struct iio_axi_adc_desc *iio_adc = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	uint32_t timeout = 0;
+	uint32_t idx;
+	uint8_t *block;
+	void *buff;
+	int32_t ret;
+
+	if (iio_adc->dma_block_size != buffer->size) {
+		iio_axi_adc_dma_release(iio_adc);
+		ret = iio_axi_adc_dma_start(iio_adc, buffer->size);
+		/* The blocks do not fit, capture straight into the buffer */
+		if (ret == -ENOMEM)
+			return iio_axi_adc_submit_single(dev_data);
+		if (ret)
+			return ret;
+	}
+
+	while (iio_adc->dma_completed == iio_adc->dma_consumed) {
+		if (iio_adc->dmac->irq_option == IRQ_DISABLED)
+			axi_dmac_process(iio_adc->dmac);
+		if (iio_adc->dma_completed != iio_adc->dma_consumed)
+			break;
+		if (timeout++ == DMA_TIMEOUT_MS)
+			return -ETIMEDOUT;
+		no_os_mdelay(1);
+	}
+
+	idx = iio_adc->dma_consumed % iio_adc->num_dma_blocks;
+	block = iio_adc->dma_blocks +
+		idx * no_os_align(buffer->size, IIO_AXI_ADC_DMA_ALIGN);
+
+	if (iio_adc->dcache_invalidate_range)
+		iio_adc->dcache_invalidate_range((uintptr_t)block, buffer->size);
+
+	ret = iio_buffer_get_block(buffer, &buff);
+	if (ret)
+		return ret;
+
+	memcpy(buff, block, buffer->size);
+	iio_adc->dma_consumed++;
+
+	ret = axi_dmac_submit(iio_adc->dmac, &iio_adc->dma_req[idx]);
+	if (ret)
+		return ret;
+
+	return iio_buffer_block_done(buffer);
+}
+
+/**
+ * @brief Stop the capture when the buffer is closed.
+ * @param dev - Instance of the iio_axi_adc
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_adc_post_disable(void *dev)
+{
+	iio_axi_adc_dma_release(dev);
+
+	return 0;
+}
+
 /**
  * @brief Delete iio_device.
  * @param iio_device - Structure describing a device, channels and attributes.
@@ -445,7 +623,12 @@ static int32_t iio_axi_adc_create_device_descriptor(
 	}
 
 	iio_device->pre_enable = iio_axi_adc_prepare_transfer;
-	iio_device->read_dev = iio_axi_adc_read_dev;
+	if (desc->dmac && desc->num_dma_blocks >= 2) {
+		iio_device->submit = iio_axi_adc_submit;
+		iio_device->post_disable = iio_axi_adc_post_disable;
+	} else {
+		iio_device->read_dev = iio_axi_adc_read_dev;
+	}
 
 	return 0;
 error:
@@ -502,6 +685,7 @@ int32_t iio_axi_adc_init(struct iio_axi_adc_desc **desc,
 	if (init->rx_dmac) {
 		iio_axi_adc_inst->dmac = init->rx_dmac;
 		iio_axi_adc_inst->dcache_invalidate_range = init->dcache_invalidate_range;
+		iio_axi_adc_inst->num_dma_blocks = init->num_dma_blocks;
 	}
 	iio_axi_adc_inst->get_sampling_frequency = init->get_sampling_frequency;
 
@@ -534,6 +718,8 @@ int32_t iio_axi_adc_remove(struct iio_axi_adc_desc *desc)
 	if (!desc)
 		return -1;
 
+	iio_axi_adc_dma_release(desc);
+
 	status = iio_axi_adc_delete_device_descriptor(desc);
 	if (status < 0)
 		return status;
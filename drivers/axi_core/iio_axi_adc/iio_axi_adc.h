@@ -42,6 +42,13 @@
 #include "axi_adc_core.h"
 #include "axi_dmac.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Alignment of the DMA blocks, covers the data path and cache line widths */
+#define IIO_AXI_ADC_DMA_ALIGN		64
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -68,6 +75,20 @@ struct iio_axi_adc_desc {
 	char (*ch_names)[20];
 	/** Custom data format */
 	struct scan_type *scan_type_common;
+	/** Number of DMA blocks kept in flight by submit */
+	uint32_t num_dma_blocks;
+	/** Size in bytes of a DMA block */
+	uint32_t dma_block_size;
+	/** Memory backing the DMA blocks */
+	void *dma_mem;
+	/** First DMA block, aligned to IIO_AXI_ADC_DMA_ALIGN */
+	uint8_t *dma_blocks;
+	/** One DMA request per block */
+	struct axi_dmac_request *dma_req;
+	/** Number of blocks filled by the DMA */
+	volatile uint32_t dma_completed;
+	/** Number of blocks handed to the IIO buffer */
+	uint32_t dma_consumed;
 };
 
 /**
@@ -87,6 +108,10 @@ struct iio_axi_adc_init_param {
 	/** Custom data format (unpopulated if not used, set to default)
 	    Common to all channels */
 	struct scan_type *scan_type_common;
+	/** Number of DMA blocks used for gap-free capture (at least 2), taken
+	    from the heap when a buffer is opened. If they do not fit, or if
+	    left 0, one block at a time is captured. */
+	uint32_t num_dma_blocks;
 };
 
 /******************************************************************************/
@@ -50,6 +50,7 @@
 /******************************************************************************/
 
 #define STORAGE_BITS 16
+#define DMA_TIMEOUT_MS 500
 
 /**
  * @brief get_dds_calibscale().
@@ -468,6 +469,7 @@ int32_t iio_axi_dac_prepare_transfer(void *dev, uint32_t mask)
 	int32_t	ret;
 
 	iio_dac->mask = mask;
+	iio_dac->cyclic_running = false;
 
 	for (i = 0; i < iio_dac->dev_descriptor.num_ch; i++) {
 		if (NO_OS_BIT(i) & mask)
@@ -520,6 +522,77 @@ int32_t iio_axi_dac_write_data(void *dev, void *buff, uint32_t nb_samples)
 	return axi_dmac_transfer_start(iio_dac->dmac, &transfer);
 }
 
+/**
+ * @brief Send the IIO buffer to the DAC.
+ *
+ * A cyclic buffer is handed to the DMA once and replayed by the hardware, the
+ * following pushes of the same buffer return right away. Other buffers are
+ * sent once.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_dac_submit(struct iio_device_data *dev_data)
+{
+	struct iio_axi_dac_desc *iio_dac = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	bool cyclic = buffer->cyclic_info.is_cyclic;
+	void *buff;
+	int32_t ret;
+
+	if (cyclic && iio_dac->cyclic_running)
+		return 0;
+
+	ret = iio_buffer_get_block(buffer, &buff);
+	if (ret)
+		return ret;
+
+	if (iio_dac->dcache_flush_range)
+		iio_dac->dcache_flush_range((uintptr_t)buff, buffer->size);
+
+	struct axi_dma_transfer transfer = {
+		// Number of bytes to writen/read
+		.size = buffer->size,
+		// Transfer done flag
+		.transfer_done = 0,
+		// Signal transfer mode
+		.cyclic = cyclic ? CYCLIC : NO,
+		// Address of data source
+		.src_addr = (uintptr_t)buff,
+		// Address of data destination
+		.dest_addr = 0
+	};
+
+	ret = axi_dmac_transfer_start(iio_dac->dmac, &transfer);
+	if (ret)
+		return ret;
+
+	if (cyclic) {
+		iio_dac->cyclic_running = true;
+	} else {
+		ret = axi_dmac_transfer_wait_completion(iio_dac->dmac,
+							DMA_TIMEOUT_MS);
+		if (ret)
+			return ret;
+	}
+
+	return iio_buffer_block_done(buffer);
+}
+
+/**
+ * @brief Stop the DMA when the buffer is closed.
+ * @param dev - Instance of the iio_axi_dac
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_dac_post_disable(void *dev)
+{
+	struct iio_axi_dac_desc *iio_dac = dev;
+
+	axi_dmac_transfer_stop(iio_dac->dmac);
+	iio_dac->cyclic_running = false;
+
+	return 0;
+}
+
 enum ch_type {
 	CH_VOLTGE,
 	CH_ALTVOLTGE,
@@ -626,7 +699,10 @@ static int32_t iio_axi_dac_create_device_descriptor(
 			goto error;
 	}
 	iio_device->pre_enable = iio_axi_dac_prepare_transfer;
-	iio_device->write_dev = iio_axi_dac_write_data;
+	if (desc->dmac) {
+		iio_device->submit = iio_axi_dac_submit;
+		iio_device->post_disable = iio_axi_dac_post_disable;
+	}
 
 	return 0;
 
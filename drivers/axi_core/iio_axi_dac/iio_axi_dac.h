@@ -58,6 +58,8 @@ struct iio_axi_dac_desc {
 	uint32_t mask;
 	/** flush contents of instruction and/or data cache */
 	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	/** A cyclic buffer is being replayed by the DMA */
+	bool cyclic_running;
 	/** iio device descriptor */
 	struct iio_device dev_descriptor;
 	/** Channel names */
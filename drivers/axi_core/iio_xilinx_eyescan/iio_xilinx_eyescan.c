@@ -0,0 +1,229 @@
+/***************************************************************************//**
+ *   @file   iio_xilinx_eyescan.c
+ *   @brief  IIO interface of the Xilinx transceiver eye scan.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "iio.h"
+#include "axi_adxcvr.h"
+#include "iio_xilinx_eyescan.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+enum iio_xilinx_eyescan_attr {
+	EYESCAN_ATTR_LANE,
+	EYESCAN_ATTR_RUN,
+	EYESCAN_ATTR_SIZE,
+	EYESCAN_ATTR_OFFSET,
+	EYESCAN_ATTR_DATA,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Read an eye scan attribute.
+ *
+ * eye_scan_data returns the next slice of the binary eye map (see
+ * struct xilinx_eyescan_hdr), starting at eye_scan_offset, and advances
+ * eye_scan_offset so that consecutive reads return the whole map.
+ * @param device - Physical instance of a iio_xilinx_eyescan_desc device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @param priv - Attribute identifier.
+ * @return Length of bytes written in buf, or negative value on failure.
+ */
+static int iio_xilinx_eyescan_show(void *device, char *buf, uint32_t len,
+				   const struct iio_ch_info *channel,
+				   intptr_t priv)
+{
+	struct iio_xilinx_eyescan_desc *desc = device;
+	int32_t val;
+	int ret;
+
+	switch (priv) {
+	case EYESCAN_ATTR_LANE:
+		val = desc->lane;
+		break;
+	case EYESCAN_ATTR_RUN:
+		val = desc->es->hdr.measurements;
+		break;
+	case EYESCAN_ATTR_SIZE:
+		val = xilinx_eyescan_map_size(desc->es);
+		break;
+	case EYESCAN_ATTR_OFFSET:
+		val = desc->offset;
+		break;
+	case EYESCAN_ATTR_DATA:
+		ret = xilinx_eyescan_map_read(desc->es, desc->offset, buf, len);
+		if (ret > 0)
+			desc->offset += ret;
+
+		return ret;
+	default:
+		return -EINVAL;
+	}
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/**
+ * @brief Write an eye scan attribute.
+ *
+ * Writing eye_scan_run scans the selected lane and rewinds eye_scan_offset.
+ * @param device - Physical instance of a iio_xilinx_eyescan_desc device.
+ * @param buf - Value to be written.
+ * @param len - Length of the value.
+ * @param channel - Channel properties.
+ * @param priv - Attribute identifier.
+ * @return Length of bytes consumed, or negative value on failure.
+ */
+static int iio_xilinx_eyescan_store(void *device, char *buf, uint32_t len,
+				    const struct iio_ch_info *channel,
+				    intptr_t priv)
+{
+	struct iio_xilinx_eyescan_desc *desc = device;
+	int32_t val;
+	int ret;
+
+	ret = iio_parse_value(buf, IIO_VAL_INT, &val, NULL);
+	if (ret)
+		return ret;
+
+	switch (priv) {
+	case EYESCAN_ATTR_LANE:
+		if (val < 0 || (uint32_t)val >= desc->num_lanes)
+			return -EINVAL;
+		desc->lane = val;
+		break;
+	case EYESCAN_ATTR_RUN:
+		desc->offset = 0;
+		ret = xilinx_eyescan_run(desc->es,
+					 ADXCVR_DRP_PORT_CHANNEL(desc->lane));
+		if (ret)
+			return ret;
+		break;
+	case EYESCAN_ATTR_OFFSET:
+		if (val < 0)
+			return -EINVAL;
+		desc->offset = val;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return len;
+}
+
+static struct iio_attribute iio_xilinx_eyescan_attrs[] = {
+	{
+		.name = "eye_scan_lane",
+		.priv = EYESCAN_ATTR_LANE,
+		.show = iio_xilinx_eyescan_show,
+		.store = iio_xilinx_eyescan_store,
+	},
+	{
+		.name = "eye_scan_run",
+		.priv = EYESCAN_ATTR_RUN,
+		.show = iio_xilinx_eyescan_show,
+		.store = iio_xilinx_eyescan_store,
+	},
+	{
+		.name = "eye_scan_size",
+		.priv = EYESCAN_ATTR_SIZE,
+		.show = iio_xilinx_eyescan_show,
+	},
+	{
+		.name = "eye_scan_offset",
+		.priv = EYESCAN_ATTR_OFFSET,
+		.show = iio_xilinx_eyescan_show,
+		.store = iio_xilinx_eyescan_store,
+	},
+	{
+		.name = "eye_scan_data",
+		.priv = EYESCAN_ATTR_DATA,
+		.show = iio_xilinx_eyescan_show,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+/**
+ * @brief Create the IIO interface of an eye scan engine.
+ * @param desc - Descriptor.
+ * @param param - Configuration structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int iio_xilinx_eyescan_init(struct iio_xilinx_eyescan_desc **desc,
+			    struct iio_xilinx_eyescan_init_param *param)
+{
+	struct iio_xilinx_eyescan_desc *iio_es;
+
+	if (!desc || !param || !param->es || !param->num_lanes)
+		return -EINVAL;
+
+	iio_es = (struct iio_xilinx_eyescan_desc *)no_os_calloc(1,
+			sizeof(*iio_es));
+	if (!iio_es)
+		return -ENOMEM;
+
+	iio_es->es = param->es;
+	iio_es->num_lanes = param->num_lanes;
+	iio_es->dev_descriptor.attributes = iio_xilinx_eyescan_attrs;
+
+	*desc = iio_es;
+
+	return 0;
+}
+
+/**
+ * @brief Release resources.
+ * @param desc - Descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int iio_xilinx_eyescan_remove(struct iio_xilinx_eyescan_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	no_os_free(desc);
+
+	return 0;
+}
@@ -0,0 +1,86 @@
+/***************************************************************************//**
+ *   @file   iio_xilinx_eyescan.h
+ *   @brief  Header file of the IIO interface of the Xilinx transceiver eye scan.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef IIO_XILINX_EYESCAN_H_
+#define IIO_XILINX_EYESCAN_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "iio_types.h"
+#include "xilinx_eyescan.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_xilinx_eyescan_desc
+ * @brief iio_xilinx_eyescan descriptor
+ */
+struct iio_xilinx_eyescan_desc {
+	/** Eye scan engine */
+	struct xilinx_eyescan *es;
+	/** Number of lanes that can be scanned */
+	uint32_t num_lanes;
+	/** Selected lane */
+	uint32_t lane;
+	/** Byte offset of the next eye_scan_data read */
+	uint32_t offset;
+	/** iio device descriptor */
+	struct iio_device dev_descriptor;
+};
+
+/**
+ * @struct iio_xilinx_eyescan_init_param
+ * @brief iio_xilinx_eyescan configuration.
+ */
+struct iio_xilinx_eyescan_init_param {
+	/** Eye scan engine */
+	struct xilinx_eyescan *es;
+	/** Number of lanes that can be scanned */
+	uint32_t num_lanes;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/** Init iio. */
+int iio_xilinx_eyescan_init(struct iio_xilinx_eyescan_desc **desc,
+			    struct iio_xilinx_eyescan_init_param *param);
+
+/** Free the resources allocated by iio_xilinx_eyescan_init(). */
+int iio_xilinx_eyescan_remove(struct iio_xilinx_eyescan_desc *desc);
+
+#endif // IIO_XILINX_EYESCAN_H_
@@ -84,9 +84,6 @@
 #define ADXCVR_DRP_PORT_ADDR_COMMON		0x00
 #define ADXCVR_DRP_PORT_ADDR_CHANNEL	0x20
 
-#define ADXCVR_DRP_PORT_COMMON(x)		(x)
-#define ADXCVR_DRP_PORT_CHANNEL(x)		(0x100 + (x))
-
 #define ADXCVR_BROADCAST				0xff
 
 #define ADI_AXI_PCORE_VER(major, minor, patch)	\
@@ -222,6 +219,59 @@ int adxcvr_drp_write(struct adxcvr *xcvr,
 	return 0;
 }
 
+/**
+ * @brief AXI ADXCVR DRP Port batched accesses
+ *
+ * Selects the DRP port once and then issues the accesses back to back, each
+ * one waiting only for the previous DRP transaction to complete. Writes are
+ * not read back.
+ * @param xcvr - The device structure.
+ * @param drp_port - The DRP Port.
+ * @param ops - Accesses to perform, in order. Read values are stored in the
+ *              val field of the corresponding entry.
+ * @param num_ops - Number of entries in ops.
+ * @return Returns 0 in case of success or negative error code otherwise.
+ */
+int adxcvr_drp_batch(struct adxcvr *xcvr,
+		     unsigned int drp_port,
+		     struct adxcvr_drp_op *ops,
+		     unsigned int num_ops)
+{
+	uint32_t drp_sel, drp_addr, ctrl;
+	unsigned int i;
+	int32_t ret;
+
+	if (!ops && num_ops)
+		return -EINVAL;
+
+	if (drp_port < ADXCVR_DRP_PORT_CHANNEL(0))
+		drp_addr = ADXCVR_DRP_PORT_ADDR_COMMON;
+	else
+		drp_addr = ADXCVR_DRP_PORT_ADDR_CHANNEL;
+
+	drp_sel = drp_port & 0xFF;
+
+	adxcvr_write(xcvr, ADXCVR_REG_DRP_SEL(drp_addr), drp_sel);
+
+	for (i = 0; i < num_ops; i++) {
+		ctrl = ADXCVR_DRP_CTRL_ADDR(ops[i].reg);
+		if (ops[i].write)
+			ctrl |= ADXCVR_DRP_CTRL_WR |
+				ADXCVR_DRP_CTRL_WDATA(ops[i].val);
+
+		adxcvr_write(xcvr, ADXCVR_REG_DRP_CTRL(drp_addr), ctrl);
+
+		ret = adxcvr_drp_wait_idle(xcvr, drp_addr);
+		if (ret < 0)
+			return ret;
+
+		if (!ops[i].write)
+			ops[i].val = ret & 0xffff;
+	}
+
+	return 0;
+}
+
 static const struct xilinx_xcvr_drp_ops adxcvr_drp_ops = {
 	.read = adxcvr_drp_read,
 	.write = adxcvr_drp_write,
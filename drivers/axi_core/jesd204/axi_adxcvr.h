@@ -56,6 +56,10 @@
 #define ADXCVR_REFCLK_DIV2	4
 #define ADXCVR_PROGDIV_CLK	5 /* GTHE3, GTHE4, GTYE4 only */
 
+// DRP port selection
+#define ADXCVR_DRP_PORT_COMMON(x)		(x)
+#define ADXCVR_DRP_PORT_CHANNEL(x)		(0x100 + (x))
+
 /**
  * @struct adxcvr
  * @brief ADI JESD204B/C AXI_ADXCVR Highspeed Transceiver Device structure.
@@ -121,6 +125,19 @@ struct adxcvr_init {
 	bool export_no_os_clk;
 };
 
+/**
+ * @struct adxcvr_drp_op
+ * @brief One access of a batched DRP transaction.
+ */
+struct adxcvr_drp_op {
+	/** DRP register address */
+	unsigned int reg;
+	/** Value to be written, or value read back */
+	unsigned int val;
+	/** Write access if true, read access otherwise */
+	bool write;
+};
+
 /**
  * @brief adxcvr clock ops
  */
@@ -139,6 +156,11 @@ int adxcvr_drp_write(struct adxcvr *xcvr,
 		     unsigned int drp_port,
 		     unsigned int reg,
 		     unsigned int val);
+/** AXI ADXCVR DRP Port batched accesses */
+int adxcvr_drp_batch(struct adxcvr *xcvr,
+		     unsigned int drp_port,
+		     struct adxcvr_drp_op *ops,
+		     unsigned int num_ops);
 /** AXI ADXCVRS Status Read */
 int32_t adxcvr_status_error(struct adxcvr *xcvr);
 /** AXI ADXCVR Clock Enable */
@@ -79,6 +79,8 @@
 
 #define JESD204_RX_REG_LINK_STATUS		0x280
 #define JESD204_LINK_STATUS_DATA		3
+/* Link status polls, ~1 ms apart, before giving up on DATA state */
+#define AXI_JESD204_RX_LINK_STATUS_POLLS	100
 
 #define JESD204_RX_REG_LANE_STATUS(x)	(((x) * 32) + 0x300)
 #define JESD204_EMB_STATE_MASK		NO_OS_GENMASK(10, 8)
@@ -146,6 +148,7 @@ const char *axi_jesd204_rx_emb_state_label[] = {
 
 struct axi_jesd204_rx_jesd204_priv {
 	struct axi_jesd204_rx *jesd;
+	unsigned int link_status_polls;
 };
 
 /******************************************************************************/
@@ -778,18 +781,20 @@ static int axi_jesd204_rx_jesd204_link_running(struct jesd204_dev *jdev,
 	struct axi_jesd204_rx_jesd204_priv *priv = jesd204_dev_priv(jdev);
 	struct axi_jesd204_rx *jesd = priv->jesd;
 	unsigned int link_status;
-	int retry = 20;
 
 	pr_debug("%s:%d link_num %u reason %s\n", __func__, __LINE__,
 		 lnk->link_id, jesd204_state_op_reason_str(reason));
 
 	if (reason == JESD204_STATE_OP_REASON_INIT) {
-		do {
-			no_os_mdelay(4);
-			axi_jesd204_rx_read(jesd, JESD204_RX_REG_LINK_STATUS, &link_status);
-			link_status &= 0x3;
-		} while (link_status != JESD204_LINK_STATUS_DATA && retry--);
+		axi_jesd204_rx_read(jesd, JESD204_RX_REG_LINK_STATUS, &link_status);
+		link_status &= 0x3;
 
+		/* let the FSM bring up the other links while this one settles */
+		if (link_status != JESD204_LINK_STATUS_DATA &&
+		    ++priv->link_status_polls < AXI_JESD204_RX_LINK_STATUS_POLLS)
+			return JESD204_STATE_CHANGE_DEFER;
+
+		priv->link_status_polls = 0;
 		if (link_status != JESD204_LINK_STATUS_DATA) {
 			const char *_status = (jesd->encoder == JESD204_ENCODER_8B10B) ?
 					      axi_jesd204_rx_link_status_label[link_status] :
@@ -800,6 +805,9 @@ static int axi_jesd204_rx_jesd204_link_running(struct jesd204_dev *jdev,
 
 			return JESD204_STATE_CHANGE_ERROR;
 		}
+	} else {
+		/* the FSM may have given up while this op was deferring */
+		priv->link_status_polls = 0;
 	}
 
 	return JESD204_STATE_CHANGE_DONE;
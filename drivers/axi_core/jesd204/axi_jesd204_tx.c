@@ -76,6 +76,8 @@
 
 #define JESD204_TX_REG_LINK_STATUS		0x280
 #define JESD204_LINK_STATUS_DATA		3
+/* Link status polls, ~1 ms apart, before giving up on DATA state */
+#define AXI_JESD204_TX_LINK_STATUS_POLLS	100
 
 #define JESD204_TX_REG_ILAS(x, y)		\
 	(((x) * 32 + (y) * 4) + 0x310)
@@ -103,6 +105,7 @@ const char *axi_jesd204_tx_link_status_label[] = {
 
 struct axi_jesd204_tx_jesd204_priv {
 	struct axi_jesd204_tx *jesd;
+	unsigned int link_status_polls;
 };
 
 /******************************************************************************/
@@ -675,18 +678,20 @@ static int axi_jesd204_tx_jesd204_link_running(struct jesd204_dev *jdev,
 	struct axi_jesd204_tx_jesd204_priv *priv = jesd204_dev_priv(jdev);
 	struct axi_jesd204_tx *jesd = priv->jesd;
 	unsigned int link_status;
-	int retry = 20;
 
 	pr_debug("%s:%d link_num %u reason %s\n", __func__, __LINE__,
 		 lnk->link_id, jesd204_state_op_reason_str(reason));
 
 	if (reason == JESD204_STATE_OP_REASON_INIT) {
-		do {
-			no_os_mdelay(4);
-			axi_jesd204_tx_read(jesd, JESD204_TX_REG_LINK_STATUS, &link_status);
-			link_status &= 0x3;
-		} while (link_status != JESD204_LINK_STATUS_DATA && retry--);
+		axi_jesd204_tx_read(jesd, JESD204_TX_REG_LINK_STATUS, &link_status);
+		link_status &= 0x3;
 
+		/* let the FSM bring up the other links while this one settles */
+		if (link_status != JESD204_LINK_STATUS_DATA &&
+		    ++priv->link_status_polls < AXI_JESD204_TX_LINK_STATUS_POLLS)
+			return JESD204_STATE_CHANGE_DEFER;
+
+		priv->link_status_polls = 0;
 		if (link_status != JESD204_LINK_STATUS_DATA) {
 			pr_err("%s: Link%u status failed (%s)\n",
 			       __func__, lnk->link_id,
@@ -694,6 +699,9 @@ static int axi_jesd204_tx_jesd204_link_running(struct jesd204_dev *jdev,
 
 			return JESD204_STATE_CHANGE_ERROR;
 		}
+	} else {
+		/* the FSM may have given up while this op was deferring */
+		priv->link_status_polls = 0;
 	}
 
 	return JESD204_STATE_CHANGE_DONE;
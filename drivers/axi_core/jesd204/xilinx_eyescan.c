@@ -0,0 +1,772 @@
+/***************************************************************************//**
+ *   @file   xilinx_eyescan.c
+ *   @brief  Statistical eye scan engine for the Xilinx High-speed transceivers.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "no_os_util.h"
+#include "no_os_alloc.h"
+#include "no_os_delay.h"
+#include "no_os_error.h"
+#include "no_os_print_log.h"
+#include "axi_adxcvr.h"
+#include "xilinx_eyescan.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define ES_MASK_WORDS			5
+#define ES_MASK_BITS			(ES_MASK_WORDS * 16)
+
+#define ES_EYE_SCAN_EN			NO_OS_BIT(8)
+#define ES_ERRDET_EN			NO_OS_BIT(9)
+#define ES_CONTROL_RUN			NO_OS_BIT(0)
+#define ES_CONTROL_MASK			NO_OS_GENMASK(5, 0)
+#define ES_STATUS_DONE			NO_OS_BIT(0)
+
+/* 7 Series: ES_PRESCALE shares the register with ES_VERT_OFFSET */
+#define GTX_ES_PRESCALE_MASK		NO_OS_GENMASK(15, 11)
+#define GTX_ES_VERT_UT_SIGN		NO_OS_BIT(8)
+#define GTX_ES_VERT_NEG			NO_OS_BIT(7)
+#define GTX_ES_VERT_MASK		NO_OS_GENMASK(8, 0)
+#define GTX_ES_HORZ_MASK		NO_OS_GENMASK(11, 0)
+
+/* UltraScale: ES_PRESCALE shares the register with ES_CONTROL */
+#define US_ES_PRESCALE_MASK		NO_OS_GENMASK(4, 0)
+#define US_ES_CONTROL_SHIFT		10
+#define US_ES_VERT_NEG			NO_OS_BIT(10)
+#define US_ES_VERT_UT_SIGN		NO_OS_BIT(9)
+#define US_ES_VERT_CODE_MASK		NO_OS_GENMASK(8, 2)
+#define US_ES_VERT_MASK			NO_OS_GENMASK(10, 2)
+#define US_ES_HORZ_MASK			NO_OS_GENMASK(15, 4)
+#define US_ES_HORZ_PHASE_UNIFICATION	NO_OS_BIT(11)
+
+#define ES_VERT_CODE_MAX		0x7F
+
+/**
+ * @struct xilinx_eyescan_regs
+ * @brief ES_* DRP register map of a transceiver type.
+ */
+struct xilinx_eyescan_regs {
+	/** First ES_QUALIFIER_MASK word */
+	uint16_t qual_mask;
+	/** First ES_SDATA_MASK word */
+	uint16_t sdata_mask;
+	/** ES_CONTROL, ES_EYE_SCAN_EN, ES_ERRDET_EN (and ES_PRESCALE) */
+	uint16_t ctrl;
+	/** Vertical offset (and ES_PRESCALE on 7 Series) */
+	uint16_t vert;
+	/** ES_HORZ_OFFSET */
+	uint16_t horz;
+	/** ES_CONTROL_STATUS */
+	uint16_t status;
+	/** ES_ERROR_COUNT */
+	uint16_t err_cnt;
+	/** ES_SAMPLE_COUNT */
+	uint16_t sample_cnt;
+	/** UltraScale register layout */
+	bool ultrascale;
+};
+
+static const struct xilinx_eyescan_regs gtx2_es_regs = {
+	.qual_mask = 0x031,
+	.sdata_mask = 0x036,
+	.ctrl = 0x03D,
+	.vert = 0x03B,
+	.horz = 0x03C,
+	.status = 0x151,
+	.err_cnt = 0x14F,
+	.sample_cnt = 0x150,
+	.ultrascale = false,
+};
+
+static const struct xilinx_eyescan_regs gth3_es_regs = {
+	.qual_mask = 0x044,
+	.sdata_mask = 0x049,
+	.ctrl = 0x03C,
+	.vert = 0x097,
+	.horz = 0x04F,
+	.status = 0x153,
+	.err_cnt = 0x151,
+	.sample_cnt = 0x152,
+	.ultrascale = true,
+};
+
+static const struct xilinx_eyescan_regs gth4_es_regs = {
+	.qual_mask = 0x044,
+	.sdata_mask = 0x049,
+	.ctrl = 0x03C,
+	.vert = 0x097,
+	.horz = 0x04F,
+	.status = 0x253,
+	.err_cnt = 0x251,
+	.sample_cnt = 0x252,
+	.ultrascale = true,
+};
+
+/******************************************************************************/
+/************************** Functions Implementation **************************/
+/******************************************************************************/
+
+/*******************************************************************************
+ * @brief Encode the ES_CONTROL field into the control register value.
+ *
+ * @param es - The eye scan engine structure.
+ * @param control - ES_CONTROL value.
+ * @param prescale - ES_PRESCALE value, UltraScale only.
+ *
+ * @return The control register value.
+*******************************************************************************/
+static uint32_t xilinx_eyescan_ctrl_val(struct xilinx_eyescan *es,
+					uint32_t control, uint8_t prescale)
+{
+	uint32_t val = es->ctrl;
+
+	if (es->regs->ultrascale) {
+		val &= ~((ES_CONTROL_MASK << US_ES_CONTROL_SHIFT) |
+			 US_ES_PRESCALE_MASK);
+		val |= (control << US_ES_CONTROL_SHIFT) |
+		       no_os_field_prep(US_ES_PRESCALE_MASK, prescale);
+	} else {
+		val &= ~ES_CONTROL_MASK;
+		val |= control;
+	}
+
+	return val;
+}
+
+/*******************************************************************************
+ * @brief Encode a vertical offset into the vertical offset register value.
+ *
+ * @param es - The eye scan engine structure.
+ * @param v_offset - Signed vertical offset code.
+ * @param ut_sign - UT sign, selects the DFE unrolled tap being scanned.
+ * @param prescale - ES_PRESCALE value, 7 Series only.
+ *
+ * @return The vertical offset register value.
+*******************************************************************************/
+static uint32_t xilinx_eyescan_vert_val(struct xilinx_eyescan *es,
+					int16_t v_offset, bool ut_sign,
+					uint8_t prescale)
+{
+	uint32_t code = no_os_min(abs(v_offset), ES_VERT_CODE_MAX);
+	uint32_t val = es->vert;
+
+	if (es->regs->ultrascale) {
+		val &= ~US_ES_VERT_MASK;
+		val |= no_os_field_prep(US_ES_VERT_CODE_MASK, code);
+		if (v_offset < 0)
+			val |= US_ES_VERT_NEG;
+		if (ut_sign)
+			val |= US_ES_VERT_UT_SIGN;
+	} else {
+		val &= ~(GTX_ES_PRESCALE_MASK | GTX_ES_VERT_MASK);
+		val |= no_os_field_prep(GTX_ES_PRESCALE_MASK, prescale) | code;
+		if (v_offset < 0)
+			val |= GTX_ES_VERT_NEG;
+		if (ut_sign)
+			val |= GTX_ES_VERT_UT_SIGN;
+	}
+
+	return val;
+}
+
+/*******************************************************************************
+ * @brief Encode a horizontal offset into the ES_HORZ_OFFSET register value.
+ *
+ * @param es - The eye scan engine structure.
+ * @param h_offset - Signed horizontal offset.
+ *
+ * @return The ES_HORZ_OFFSET register value.
+*******************************************************************************/
+static uint32_t xilinx_eyescan_horz_val(struct xilinx_eyescan *es,
+					int16_t h_offset)
+{
+	uint32_t val = es->horz;
+	uint32_t code;
+
+	if (es->regs->ultrascale) {
+		/* 11-bit two's complement, bit 11 set for negative offsets */
+		code = (uint16_t)h_offset & NO_OS_GENMASK(10, 0);
+		if (h_offset < 0)
+			code |= US_ES_HORZ_PHASE_UNIFICATION;
+
+		val &= ~US_ES_HORZ_MASK;
+		val |= no_os_field_prep(US_ES_HORZ_MASK, code);
+	} else {
+		val &= ~GTX_ES_HORZ_MASK;
+		val |= (uint16_t)h_offset & GTX_ES_HORZ_MASK;
+	}
+
+	return val;
+}
+
+/*******************************************************************************
+ * @brief Prepare a lane for eye scan.
+ *
+ * Enables the eye scan and error detection logic, stops any pending
+ * measurement and programs the qualifier and data masks for a statistical
+ * (pattern independent) scan, in a single batched DRP transaction.
+ *
+ * @param es - The eye scan engine structure.
+ * @param drp_port - DRP port of the lane.
+ *
+ * @return ret - Result of the operation (0 - success, negative value
+ *               for failure).
+*******************************************************************************/
+static int xilinx_eyescan_lane_setup(struct xilinx_eyescan *es,
+				     uint32_t drp_port)
+{
+	struct adxcvr_drp_op ops[3 + 2 * ES_MASK_WORDS];
+	const struct xilinx_eyescan_regs *regs = es->regs;
+	uint32_t masked = ES_MASK_BITS - es->hdr.data_width;
+	uint32_t i, bit, word;
+	int ret;
+
+	ops[0] = (struct adxcvr_drp_op) {
+		.reg = regs->ctrl
+	};
+	ops[1] = (struct adxcvr_drp_op) {
+		.reg = regs->vert
+	};
+	ops[2] = (struct adxcvr_drp_op) {
+		.reg = regs->horz
+	};
+
+	ret = adxcvr_drp_batch(es->xcvr->ad_xcvr, drp_port, ops, 3);
+	if (ret)
+		return ret;
+
+	es->ctrl = ops[0].val | ES_EYE_SCAN_EN | ES_ERRDET_EN;
+	es->vert = ops[1].val;
+	es->horz = ops[2].val;
+	es->ctrl = xilinx_eyescan_ctrl_val(es, 0, 0);
+
+	ops[0] = (struct adxcvr_drp_op) {
+		.reg = regs->ctrl, .val = es->ctrl, .write = true
+	};
+
+	for (i = 0; i < ES_MASK_WORDS; i++) {
+		/* Every received bit qualifies */
+		ops[1 + i] = (struct adxcvr_drp_op) {
+			.reg = regs->qual_mask + i, .val = 0xFFFF, .write = true
+		};
+
+		/* Only the top data_width bits of the 80-bit window are compared */
+		word = 0;
+		for (bit = 0; bit < 16; bit++)
+			if (i * 16 + bit < masked)
+				word |= NO_OS_BIT(bit);
+
+		ops[1 + ES_MASK_WORDS + i] = (struct adxcvr_drp_op) {
+			.reg = regs->sdata_mask + i, .val = word, .write = true
+		};
+	}
+
+	return adxcvr_drp_batch(es->xcvr->ad_xcvr, drp_port, ops,
+				1 + 2 * ES_MASK_WORDS);
+}
+
+/*******************************************************************************
+ * @brief Run a single eye scan measurement.
+ *
+ * Only the registers whose value changes are written, so scanning down a
+ * column costs one vertical offset write and the start/stop of ES_CONTROL.
+ *
+ * @param es - The eye scan engine structure.
+ * @param drp_port - DRP port of the lane.
+ * @param h_offset - Signed horizontal offset.
+ * @param v_offset - Signed vertical offset code.
+ * @param ut_sign - UT sign.
+ * @param prescale - ES_PRESCALE value.
+ * @param err - Error count.
+ * @param samples - Sample count.
+ *
+ * @return ret - Result of the operation (0 - success, negative value
+ *               for failure).
+*******************************************************************************/
+static int xilinx_eyescan_measure(struct xilinx_eyescan *es,
+				  uint32_t drp_port, int16_t h_offset,
+				  int16_t v_offset, bool ut_sign,
+				  uint8_t prescale, uint32_t *err,
+				  uint32_t *samples)
+{
+	const struct xilinx_eyescan_regs *regs = es->regs;
+	struct adxcvr_drp_op ops[3];
+	uint32_t horz, vert, timeout;
+	unsigned int n = 0;
+	int ret;
+
+	horz = xilinx_eyescan_horz_val(es, h_offset);
+	if (horz != es->horz) {
+		ops[n].reg = regs->horz;
+		ops[n].val = horz;
+		ops[n++].write = true;
+	}
+
+	vert = xilinx_eyescan_vert_val(es, v_offset, ut_sign, prescale);
+	if (vert != es->vert) {
+		ops[n].reg = regs->vert;
+		ops[n].val = vert;
+		ops[n++].write = true;
+	}
+
+	ops[n++] = (struct adxcvr_drp_op) {
+		.reg = regs->ctrl,
+		.val = xilinx_eyescan_ctrl_val(es, ES_CONTROL_RUN, prescale),
+		.write = true
+	};
+
+	ret = adxcvr_drp_batch(es->xcvr->ad_xcvr, drp_port, ops, n);
+	if (ret)
+		return ret;
+
+	es->horz = horz;
+	es->vert = vert;
+
+	timeout = XILINX_EYESCAN_POLL_MAX << no_os_min(prescale, 12);
+	ops[0] = (struct adxcvr_drp_op) {
+		.reg = regs->status
+	};
+	do {
+		ret = adxcvr_drp_batch(es->xcvr->ad_xcvr, drp_port, ops, 1);
+		if (ret)
+			return ret;
+
+		if (ops[0].val & ES_STATUS_DONE)
+			break;
+
+		no_os_udelay(10);
+	} while (--timeout);
+
+	ops[0] = (struct adxcvr_drp_op) {
+		.reg = regs->err_cnt
+	};
+	ops[1] = (struct adxcvr_drp_op) {
+		.reg = regs->sample_cnt
+	};
+	ops[2] = (struct adxcvr_drp_op) {
+		.reg = regs->ctrl,
+		.val = xilinx_eyescan_ctrl_val(es, 0, prescale),
+		.write = true
+	};
+
+	ret = adxcvr_drp_batch(es->xcvr->ad_xcvr, drp_port, ops, 3);
+	if (ret)
+		return ret;
+
+	if (!timeout) {
+		pr_err("%s: Measurement timeout on port %#" PRIx32 "\n",
+		       __func__, drp_port);
+		return -ETIMEDOUT;
+	}
+
+	*err = ops[0].val;
+	*samples = ops[1].val;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Measure the bit error ratio at a given offset.
+ *
+ * In DFE mode both UT signs are scanned and accumulated. The lane must have
+ * been prepared by xilinx_eyescan_lane_setup().
+ *
+ * @param es - The eye scan engine structure.
+ * @param drp_port - DRP port of the lane.
+ * @param h_offset - Signed horizontal offset.
+ * @param v_offset - Signed vertical offset code.
+ * @param prescale - ES_PRESCALE value.
+ * @param ber - Measured bit error ratio.
+ *
+ * @return ret - Result of the operation (0 - success, negative value
+ *               for failure).
+*******************************************************************************/
+static int xilinx_eyescan_point_ber(struct xilinx_eyescan *es,
+				    uint32_t drp_port, int16_t h_offset,
+				    int16_t v_offset, uint8_t prescale,
+				    float *ber)
+{
+	uint32_t err, samples, err_sum = 0, samples_sum = 0;
+	bool dfe = !es->xcvr->ad_xcvr->lpm_enable;
+	int ut, ret;
+
+	for (ut = 0; ut <= dfe; ut++) {
+		ret = xilinx_eyescan_measure(es, drp_port, h_offset, v_offset,
+					     ut, prescale, &err, &samples);
+		if (ret)
+			return ret;
+
+		err_sum += err;
+		samples_sum += samples;
+	}
+
+	if (!samples_sum)
+		return -EIO;
+
+	*ber = (float)err_sum / ((float)samples_sum *
+				 (float)(2ULL << prescale) *
+				 (float)es->hdr.data_width);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Measure the bit error ratio at a given offset.
+ *
+ * @param es - The eye scan engine structure.
+ * @param drp_port - DRP port of the lane.
+ * @param h_offset - Signed horizontal offset, 0 for the eye center.
+ * @param v_offset - Signed vertical offset code, 0 for the eye center.
+ * @param prescale - ES_PRESCALE value, sets the measurement length to
+ *                   2^(1 + prescale) * 65535 words.
+ * @param ber - Measured bit error ratio.
+ *
+ * @return ret - Result of the operation (0 - success, negative value
+ *               for failure).
+*******************************************************************************/
+int xilinx_eyescan_ber_get(struct xilinx_eyescan *es, uint32_t drp_port,
+			   int16_t h_offset, int16_t v_offset,
+			   uint8_t prescale, float *ber)
+{
+	int ret;
+
+	if (!es || !ber || prescale > XILINX_EYESCAN_PRESCALE_MAX)
+		return -EINVAL;
+
+	ret = xilinx_eyescan_lane_setup(es, drp_port);
+	if (ret)
+		return ret;
+
+	return xilinx_eyescan_point_ber(es, drp_port, h_offset, v_offset,
+					prescale, ber);
+}
+
+/*******************************************************************************
+ * @brief Measure one point of the eye map, unless it already was measured
+ *        with at least the same accuracy.
+ *
+ * @param es - The eye scan engine structure.
+ * @param drp_port - DRP port of the lane.
+ * @param h - Column index.
+ * @param v - Row index.
+ * @param level - XILINX_EYESCAN_POINT_COARSE or XILINX_EYESCAN_POINT_FINE.
+ *
+ * @return ret - Result of the operation (0 - success, negative value
+ *               for failure).
+*******************************************************************************/
+static int xilinx_eyescan_map_point(struct xilinx_eyescan *es,
+				    uint32_t drp_port, uint32_t h, uint32_t v,
+				    enum xilinx_eyescan_point level)
+{
+	struct xilinx_eyescan_hdr *hdr = &es->hdr;
+	uint32_t idx = h * hdr->v_num + v;
+	uint8_t prescale;
+	int ret;
+
+	if (es->point[idx] >= level)
+		return 0;
+
+	prescale = (level == XILINX_EYESCAN_POINT_FINE) ? es->fine_prescale :
+		   es->coarse_prescale;
+
+	ret = xilinx_eyescan_point_ber(es, drp_port,
+				       hdr->h_start + h * hdr->h_step,
+				       hdr->v_start + v * hdr->v_step,
+				       prescale, &es->ber[idx]);
+	if (ret)
+		return ret;
+
+	es->point[idx] = level;
+	hdr->measurements++;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Index of the next coarse grid point.
+ *
+ * @param idx - Current coarse grid point.
+ * @param num - Number of points on the axis.
+ *
+ * @return The next coarse grid point, the last point being always included.
+*******************************************************************************/
+static uint32_t xilinx_eyescan_coarse_next(uint32_t idx, uint32_t num)
+{
+	return no_os_min(idx + XILINX_EYESCAN_COARSE_STRIDE, num - 1);
+}
+
+/*******************************************************************************
+ * @brief Run an adaptive eye scan on a lane.
+ *
+ * A coarse grid is measured first using the coarse prescale. Each cell of the
+ * coarse grid whose corners are either all open (no errors) or all closed is
+ * filled in from its corners; the cells crossed by the eye edge are measured
+ * point by point using the fine prescale. Points are visited column by column
+ * so that the horizontal offset is written once per column.
+ *
+ * @param es - The eye scan engine structure.
+ * @param drp_port - DRP port of the lane.
+ *
+ * @return ret - Result of the operation (0 - success, negative value
+ *               for failure).
+*******************************************************************************/
+int xilinx_eyescan_run(struct xilinx_eyescan *es, uint32_t drp_port)
+{
+	struct xilinx_eyescan_hdr *hdr;
+	uint32_t h0, h1, v0, v1, h, v, open;
+	float corner[4], fill;
+	int ret, i;
+
+	if (!es)
+		return -EINVAL;
+
+	hdr = &es->hdr;
+	hdr->drp_port = drp_port;
+	hdr->measurements = 0;
+	memset(es->point, XILINX_EYESCAN_POINT_FILLED, hdr->h_num * hdr->v_num);
+
+	ret = xilinx_eyescan_lane_setup(es, drp_port);
+	if (ret)
+		return ret;
+
+	for (h = 0; ; h = xilinx_eyescan_coarse_next(h, hdr->h_num)) {
+		for (v = 0; ; v = xilinx_eyescan_coarse_next(v, hdr->v_num)) {
+			ret = xilinx_eyescan_map_point(es, drp_port, h, v,
+						       XILINX_EYESCAN_POINT_COARSE);
+			if (ret)
+				return ret;
+			if (v == hdr->v_num - 1U)
+				break;
+		}
+		if (h == hdr->h_num - 1U)
+			break;
+	}
+
+	for (h0 = 0; h0 < hdr->h_num - 1U; h0 = h1) {
+		h1 = xilinx_eyescan_coarse_next(h0, hdr->h_num);
+		for (v0 = 0; v0 < hdr->v_num - 1U; v0 = v1) {
+			v1 = xilinx_eyescan_coarse_next(v0, hdr->v_num);
+
+			corner[0] = es->ber[h0 * hdr->v_num + v0];
+			corner[1] = es->ber[h0 * hdr->v_num + v1];
+			corner[2] = es->ber[h1 * hdr->v_num + v0];
+			corner[3] = es->ber[h1 * hdr->v_num + v1];
+
+			open = 0;
+			fill = 0;
+			for (i = 0; i < 4; i++) {
+				open += corner[i] == 0.0f;
+				fill += corner[i] / 4;
+			}
+
+			for (h = h0; h <= h1; h++) {
+				for (v = v0; v <= v1; v++) {
+					if (open == 0 || open == 4) {
+						if (es->point[h * hdr->v_num + v] ==
+						    XILINX_EYESCAN_POINT_FILLED)
+							es->ber[h * hdr->v_num + v] = fill;
+						continue;
+					}
+
+					ret = xilinx_eyescan_map_point(es, drp_port, h, v,
+								       XILINX_EYESCAN_POINT_FINE);
+					if (ret)
+						return ret;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Size in bytes of the exported eye map.
+ *
+ * @param es - The eye scan engine structure.
+ *
+ * @return Header size plus the size of the BER values.
+*******************************************************************************/
+uint32_t xilinx_eyescan_map_size(struct xilinx_eyescan *es)
+{
+	return sizeof(es->hdr) +
+	       es->hdr.h_num * es->hdr.v_num * sizeof(*es->ber);
+}
+
+/*******************************************************************************
+ * @brief Copy a slice of the exported eye map.
+ *
+ * The eye map is the xilinx_eyescan_hdr header followed by the BER values.
+ *
+ * @param es - The eye scan engine structure.
+ * @param offset - Offset in bytes into the eye map.
+ * @param buf - Destination buffer.
+ * @param len - Number of bytes to copy.
+ *
+ * @return ret - Number of bytes copied, negative value for failure.
+*******************************************************************************/
+int xilinx_eyescan_map_read(struct xilinx_eyescan *es, uint32_t offset,
+			    void *buf, uint32_t len)
+{
+	uint32_t size, n, copied = 0;
+	uint8_t *dst = buf;
+
+	if (!es || !buf)
+		return -EINVAL;
+
+	size = xilinx_eyescan_map_size(es);
+	if (offset >= size)
+		return 0;
+
+	len = no_os_min(len, size - offset);
+
+	if (offset < sizeof(es->hdr)) {
+		n = no_os_min(len, sizeof(es->hdr) - offset);
+		memcpy(dst, (uint8_t *)&es->hdr + offset, n);
+		copied += n;
+		offset += n;
+	}
+
+	if (copied < len)
+		memcpy(dst + copied,
+		       (uint8_t *)es->ber + offset - sizeof(es->hdr),
+		       len - copied);
+
+	return len;
+}
+
+/*******************************************************************************
+ * @brief Initialize the eye scan engine.
+ *
+ * @param es - The eye scan engine structure.
+ * @param init - Initialization parameters.
+ *
+ * @return ret - Result of the operation (0 - success, negative value
+ *               for failure).
+*******************************************************************************/
+int xilinx_eyescan_init(struct xilinx_eyescan **es,
+			const struct xilinx_eyescan_init *init)
+{
+	struct xilinx_eyescan *dev;
+	uint32_t h_half, v_half, points;
+
+	if (!es || !init || !init->xcvr || !init->xcvr->ad_xcvr)
+		return -EINVAL;
+
+	if (!init->h_step || !init->v_step ||
+	    init->v_range > ES_VERT_CODE_MAX ||
+	    !init->data_width || init->data_width > ES_MASK_BITS ||
+	    init->coarse_prescale > XILINX_EYESCAN_PRESCALE_MAX ||
+	    init->fine_prescale > XILINX_EYESCAN_PRESCALE_MAX)
+		return -EINVAL;
+
+	dev = (struct xilinx_eyescan *)no_os_calloc(1, sizeof(*dev));
+	if (!dev)
+		return -ENOMEM;
+
+	switch (init->xcvr->type) {
+	case XILINX_XCVR_TYPE_S7_GTX2:
+		dev->regs = &gtx2_es_regs;
+		break;
+	case XILINX_XCVR_TYPE_US_GTH3:
+		dev->regs = &gth3_es_regs;
+		break;
+	case XILINX_XCVR_TYPE_US_GTH4:
+	case XILINX_XCVR_TYPE_US_GTY4:
+		dev->regs = &gth4_es_regs;
+		break;
+	default:
+		no_os_free(dev);
+		return -EINVAL;
+	}
+
+	h_half = init->h_range / init->h_step;
+	v_half = init->v_range / init->v_step;
+	points = (2 * h_half + 1) * (2 * v_half + 1);
+
+	dev->ber = (float *)no_os_calloc(points, sizeof(*dev->ber));
+	if (!dev->ber)
+		goto error_dev;
+
+	dev->point = (uint8_t *)no_os_calloc(points, sizeof(*dev->point));
+	if (!dev->point)
+		goto error_ber;
+
+	dev->xcvr = init->xcvr;
+	dev->coarse_prescale = init->coarse_prescale;
+	dev->fine_prescale = init->fine_prescale;
+	dev->hdr.magic = XILINX_EYESCAN_MAGIC;
+	dev->hdr.data_width = init->data_width;
+	dev->hdr.h_start = -(int16_t)(h_half * init->h_step);
+	dev->hdr.h_step = init->h_step;
+	dev->hdr.h_num = 2 * h_half + 1;
+	dev->hdr.v_start = -(int16_t)(v_half * init->v_step);
+	dev->hdr.v_step = init->v_step;
+	dev->hdr.v_num = 2 * v_half + 1;
+
+	*es = dev;
+
+	return 0;
+
+error_ber:
+	no_os_free(dev->ber);
+error_dev:
+	no_os_free(dev);
+
+	return -ENOMEM;
+}
+
+/*******************************************************************************
+ * @brief Free the resources allocated by xilinx_eyescan_init().
+ *
+ * @param es - The eye scan engine structure.
+ *
+ * @return ret - Result of the operation (0 - success, negative value
+ *               for failure).
+*******************************************************************************/
+int xilinx_eyescan_remove(struct xilinx_eyescan *es)
+{
+	if (!es)
+		return -EINVAL;
+
+	no_os_free(es->point);
+	no_os_free(es->ber);
+	no_os_free(es);
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+/***************************************************************************//**
+ *   @file   xilinx_eyescan.h
+ *   @brief  Statistical eye scan engine for the Xilinx High-speed transceivers.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef XILINX_EYESCAN_H_
+#define XILINX_EYESCAN_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "xilinx_transceiver.h"
+
+/******************************************************************************/
+/************************ Macros and Types Declarations ***********************/
+/******************************************************************************/
+/* Grid points skipped between two coarse measurements */
+#define XILINX_EYESCAN_COARSE_STRIDE	4
+/* Maximum value of the ES_PRESCALE field */
+#define XILINX_EYESCAN_PRESCALE_MAX	31
+/* Status polls before a single measurement is considered stuck */
+#define XILINX_EYESCAN_POLL_MAX		100000
+/* Magic number of the exported eye map ("EYE1") */
+#define XILINX_EYESCAN_MAGIC		0x31455945
+
+/**
+ * @enum xilinx_eyescan_point
+ * @brief How the BER of an eye map point was obtained.
+ */
+enum xilinx_eyescan_point {
+	/** Filled in from the surrounding coarse measurements */
+	XILINX_EYESCAN_POINT_FILLED,
+	/** Measured using the coarse prescale */
+	XILINX_EYESCAN_POINT_COARSE,
+	/** Measured using the fine prescale */
+	XILINX_EYESCAN_POINT_FINE,
+};
+
+/**
+ * @struct xilinx_eyescan_init
+ * @brief Eye scan engine initialization structure.
+ */
+struct xilinx_eyescan_init {
+	/** Transceiver the scanned lanes belong to */
+	struct xilinx_xcvr *xcvr;
+	/** Internal RX data width in bits (16, 20, 32, 40, 64 or 80) */
+	uint32_t data_width;
+	/** Horizontal range, in UI/64 (7 Series) or UI/128 (UltraScale) steps,
+	 *  scanned symmetrically around the eye center */
+	uint16_t h_range;
+	/** Horizontal step between two points */
+	uint16_t h_step;
+	/** Vertical range, in offset codes (0 - 127), scanned symmetrically
+	 *  around the eye center */
+	uint16_t v_range;
+	/** Vertical step between two points */
+	uint16_t v_step;
+	/** Prescale used for the coarse grid */
+	uint8_t coarse_prescale;
+	/** Prescale used when refining the eye edges */
+	uint8_t fine_prescale;
+};
+
+/**
+ * @struct xilinx_eyescan_hdr
+ * @brief Header of an exported eye map. It is followed by h_num * v_num
+ *        float BER values, in column (horizontal offset) major order.
+ */
+struct xilinx_eyescan_hdr {
+	/** XILINX_EYESCAN_MAGIC */
+	uint32_t magic;
+	/** DRP port of the scanned lane */
+	uint32_t drp_port;
+	/** Internal RX data width in bits */
+	uint32_t data_width;
+	/** Number of measurements performed by the last scan */
+	uint32_t measurements;
+	/** Horizontal offset of the first column */
+	int16_t h_start;
+	/** Horizontal step between two columns */
+	uint16_t h_step;
+	/** Number of columns */
+	uint16_t h_num;
+	/** Vertical offset of the first row */
+	int16_t v_start;
+	/** Vertical step between two rows */
+	uint16_t v_step;
+	/** Number of rows */
+	uint16_t v_num;
+};
+
+struct xilinx_eyescan_regs;
+
+/**
+ * @struct xilinx_eyescan
+ * @brief Eye scan engine structure.
+ */
+struct xilinx_eyescan {
+	/** Transceiver the scanned lanes belong to */
+	struct xilinx_xcvr *xcvr;
+	/** ES_* register map of the transceiver type */
+	const struct xilinx_eyescan_regs *regs;
+	/** Eye map header, describing the content of ber */
+	struct xilinx_eyescan_hdr hdr;
+	/** Prescale used for the coarse grid */
+	uint8_t coarse_prescale;
+	/** Prescale used when refining the eye edges */
+	uint8_t fine_prescale;
+	/** Cached value of the control register */
+	uint32_t ctrl;
+	/** Cached value of the vertical offset register */
+	uint32_t vert;
+	/** Cached value of the horizontal offset register */
+	uint32_t horz;
+	/** Bit error ratio of each point */
+	float *ber;
+	/** How each point was obtained, see enum xilinx_eyescan_point */
+	uint8_t *point;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+/** Initialize the eye scan engine. */
+int xilinx_eyescan_init(struct xilinx_eyescan **es,
+			const struct xilinx_eyescan_init *init);
+
+/** Free the resources allocated by xilinx_eyescan_init(). */
+int xilinx_eyescan_remove(struct xilinx_eyescan *es);
+
+/** Measure the bit error ratio at a given offset. */
+int xilinx_eyescan_ber_get(struct xilinx_eyescan *es, uint32_t drp_port,
+			   int16_t h_offset, int16_t v_offset,
+			   uint8_t prescale, float *ber);
+
+/** Run an adaptive eye scan on a lane. */
+int xilinx_eyescan_run(struct xilinx_eyescan *es, uint32_t drp_port);
+
+/** Size in bytes of the exported eye map. */
+uint32_t xilinx_eyescan_map_size(struct xilinx_eyescan *es);
+
+/** Copy a slice of the exported eye map. */
+int xilinx_eyescan_map_read(struct xilinx_eyescan *es, uint32_t offset,
+			    void *buf, uint32_t len);
+
+#endif
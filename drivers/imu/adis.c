@@ -394,6 +394,170 @@ int adis_write_reg(struct adis_dev *adis, uint32_t reg, uint32_t val,
 	return 0;
 }
 
+/**
+ * @brief Perform several register accesses in one chained transfer.
+ *
+ * The accesses are stably sorted by page, so that PAGE_ID is written at most
+ * once per page, and every 16-bit frame is emitted in a single SPI transfer.
+ * Since the device answers a read request in the following frame, each frame
+ * also carries the answer of the previous one and only one trailing frame is
+ * added at the end. Accesses to different pages are therefore not performed
+ * in the order given by the caller.
+ * @param adis   - The adis device.
+ * @param ops    - The register accesses. Read values are stored in ops[i].val.
+ * @param nb_ops - Number of register accesses.
+ * @return 0 in case of success, error code otherwise.
+ */
+int adis_reg_batch(struct adis_dev *adis, struct adis_reg_op *ops,
+		   uint32_t nb_ops)
+{
+	struct no_os_spi_msg *msgs;
+	uint32_t *order;
+	uint32_t nb_frames = 1;
+	uint32_t page, frame, i, j, k;
+	uint8_t *buf;
+	int ret;
+
+	if (!nb_ops)
+		return 0;
+
+	for (i = 0; i < nb_ops; i++) {
+		if (ops[i].write) {
+			if (ops[i].size != ADIS_1_BYTE_SIZE && ops[i].size != ADIS_2_BYTES_SIZE
+			    && ops[i].size != ADIS_4_BYTES_SIZE)
+				return -EINVAL;
+			/* If device is locked, no writes are allowed, except for software reset. */
+			if (adis->is_locked && ops[i].reg != adis->info->field_map->sw_res.reg_addr)
+				return -EPERM;
+		} else if (ops[i].size != ADIS_2_BYTES_SIZE && ops[i].size != ADIS_4_BYTES_SIZE) {
+			return -EINVAL;
+		}
+	}
+
+	/* Chip specific register access cannot be chained. */
+	if (adis->info->read_reg || adis->info->write_reg) {
+		for (i = 0; i < nb_ops; i++) {
+			if (ops[i].write)
+				ret = adis_write_reg(adis, ops[i].reg, ops[i].val, ops[i].size);
+			else
+				ret = adis_read_reg(adis, ops[i].reg, &ops[i].val, ops[i].size);
+			if (ret)
+				return ret;
+		}
+
+		return 0;
+	}
+
+	order = no_os_calloc(nb_ops, sizeof(*order));
+	if (!order)
+		return -ENOMEM;
+
+	/* Stable insertion sort by page */
+	for (i = 0; i < nb_ops; i++) {
+		page = ops[i].reg / ADIS_PAGE_SIZE;
+		for (j = i; j && ops[order[j - 1]].reg / ADIS_PAGE_SIZE > page; j--)
+			order[j] = order[j - 1];
+		order[j] = i;
+	}
+
+	page = adis->current_page;
+	for (i = 0; i < nb_ops; i++) {
+		if (ops[order[i]].reg / ADIS_PAGE_SIZE != page) {
+			page = ops[order[i]].reg / ADIS_PAGE_SIZE;
+			nb_frames++;
+		}
+		if (ops[order[i]].write)
+			nb_frames += ops[order[i]].size;
+		else
+			nb_frames += ops[order[i]].size / 2;
+	}
+
+	msgs = no_os_calloc(nb_frames, sizeof(*msgs) + 2);
+	if (!msgs) {
+		ret = -ENOMEM;
+		goto free_order;
+	}
+	buf = (uint8_t *)&msgs[nb_frames];
+
+	frame = 0;
+	page = adis->current_page;
+	for (i = 0; i < nb_ops; i++) {
+		struct adis_reg_op *op = &ops[order[i]];
+
+		if (op->reg / ADIS_PAGE_SIZE != page) {
+			page = op->reg / ADIS_PAGE_SIZE;
+			buf[frame * 2] = ADIS_WRITE_REG(ADIS_REG_PAGE_ID);
+			buf[frame * 2 + 1] = page;
+			msgs[frame++].cs_delay_last = adis->info->write_delay;
+		}
+
+		if (op->write) {
+			for (k = 0; k < op->size; k++) {
+				buf[frame * 2] = ADIS_WRITE_REG(op->reg + k);
+				buf[frame * 2 + 1] = (op->val >> (8 * k)) & 0xff;
+				msgs[frame++].cs_delay_last = adis->info->write_delay;
+			}
+		} else {
+			if (op->size == ADIS_4_BYTES_SIZE) {
+				buf[frame * 2] = ADIS_READ_REG(op->reg + 2);
+				msgs[frame++].cs_delay_last = adis->info->read_delay;
+			}
+			buf[frame * 2] = ADIS_READ_REG(op->reg);
+			msgs[frame++].cs_delay_last = adis->info->read_delay;
+		}
+	}
+	/* Trailing frame, clocking out the answer of the last read request. */
+	msgs[frame].cs_delay_last = adis->info->read_delay;
+
+	for (frame = 0; frame < nb_frames; frame++) {
+		msgs[frame].tx_buff = &buf[frame * 2];
+		msgs[frame].rx_buff = &buf[frame * 2];
+		msgs[frame].bytes_number = 2;
+		msgs[frame].cs_change = 1;
+		if (frame != nb_frames - 1)
+			msgs[frame].cs_change_delay = adis->info->cs_change_delay;
+	}
+
+	ret = no_os_spi_transfer(adis->spi_desc, msgs, nb_frames);
+	if (ret)
+		goto free_msgs;
+
+	/* Walk the frames again to collect the read values. */
+	frame = 0;
+	page = adis->current_page;
+	for (i = 0; i < nb_ops; i++) {
+		struct adis_reg_op *op = &ops[order[i]];
+
+		if (op->reg / ADIS_PAGE_SIZE != page) {
+			page = op->reg / ADIS_PAGE_SIZE;
+			frame++;
+		}
+
+		if (op->write) {
+			frame += op->size;
+			continue;
+		}
+
+		if (op->size == ADIS_4_BYTES_SIZE) {
+			op->val = (uint32_t)no_os_get_unaligned_be16(&buf[(frame + 1) * 2]) << 16;
+			op->val |= no_os_get_unaligned_be16(&buf[(frame + 2) * 2]);
+			frame += 2;
+		} else {
+			op->val = no_os_get_unaligned_be16(&buf[(frame + 1) * 2]);
+			frame++;
+		}
+	}
+
+	adis->current_page = page;
+
+free_msgs:
+	no_os_free(msgs);
+free_order:
+	no_os_free(order);
+
+	return ret;
+}
+
 /**
  * @brief Read field to uint32 value.
  * @param adis      - The adis device.
@@ -590,6 +754,57 @@ int adis_read_diag_stat(struct adis_dev *adis,
 	return 0;
 }
 
+/**
+ * @brief Read diag status register once and serve the diag flags from it.
+ *
+ * Until adis_diag_snapshot_release() is called, the adis_read_diag_*()
+ * accessors return the flags of this snapshot without accessing the device.
+ * @param adis - The adis device.
+ * @return 0 in case of success, error code otherwise.
+ */
+int adis_diag_snapshot(struct adis_dev *adis)
+{
+	struct adis_diag_flags diag_flags;
+	int ret;
+
+	adis->diag_snapshot = false;
+
+	ret = adis_read_diag_stat(adis, &diag_flags);
+	if (ret)
+		return ret;
+
+	adis->diag_snapshot = true;
+
+	return 0;
+}
+
+/**
+ * @brief Release the diag status snapshot taken by adis_diag_snapshot().
+ * @param adis - The adis device.
+ */
+void adis_diag_snapshot_release(struct adis_dev *adis)
+{
+	adis->diag_snapshot = false;
+}
+
+/**
+ * @brief Get the diag flags, either from the current snapshot or by reading
+ *        the diag status register.
+ * @param adis       - The adis device.
+ * @param diag_flags - The diag flags.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int adis_get_diag_flags(struct adis_dev *adis,
+			       struct adis_diag_flags *diag_flags)
+{
+	if (adis->diag_snapshot) {
+		*diag_flags = adis->diag_flags;
+		return 0;
+	}
+
+	return adis_read_diag_stat(adis, diag_flags);
+}
+
 /**
  * @brief Read temperature flags. Currently this implementation is valid only for
  * adis16550. If further other devices support this feature, it should be checked
@@ -653,7 +868,7 @@ int adis_read_diag_snsr_init_failure(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -674,7 +889,7 @@ int adis_read_diag_data_path_overrun(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -695,7 +910,7 @@ int adis_read_diag_fls_mem_update_failure(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -715,7 +930,7 @@ int adis_read_diag_spi_comm_err(struct adis_dev *adis, uint32_t *spi_comm_err)
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -736,7 +951,7 @@ int adis_read_diag_standby_mode(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -756,7 +971,7 @@ int adis_read_diag_snsr_failure(struct adis_dev *adis, uint32_t *snsr_failure)
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -776,7 +991,7 @@ int adis_read_diag_mem_failure(struct adis_dev *adis, uint32_t *mem_failure)
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -796,7 +1011,7 @@ int adis_read_diag_clk_err(struct adis_dev *adis, uint32_t *clk_err)
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -816,7 +1031,7 @@ int adis_read_diag_gyro1_failure(struct adis_dev *adis, uint32_t *gyro1_failure)
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -836,7 +1051,7 @@ int adis_read_diag_gyro2_failure(struct adis_dev *adis, uint32_t *gyro2_failure)
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -856,7 +1071,7 @@ int adis_read_diag_accl_failure(struct adis_dev *adis, uint32_t *accl_failure)
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -877,7 +1092,7 @@ int adis_read_diag_x_axis_gyro_failure(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -898,7 +1113,7 @@ int adis_read_diag_y_axis_gyro_failure(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -919,7 +1134,7 @@ int adis_read_diag_z_axis_gyro_failure(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -940,7 +1155,7 @@ int adis_read_diag_x_axis_accl_failure(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -961,7 +1176,7 @@ int adis_read_diag_y_axis_accl_failure(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -982,7 +1197,7 @@ int adis_read_diag_z_axis_accl_failure(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1003,7 +1218,7 @@ int adis_read_diag_aduc_mcu_fault(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1024,7 +1239,7 @@ int adis_read_diag_config_calib_crc_error(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1045,7 +1260,7 @@ int adis_read_diag_overrange(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1066,7 +1281,7 @@ int adis_read_diag_temp_err(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1087,7 +1302,7 @@ int adis_read_diag_power_supply_failure(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1108,7 +1323,7 @@ int adis_read_diag_boot_memory_failure(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1129,7 +1344,7 @@ int adis_read_diag_reg_nvm_err(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1150,7 +1365,7 @@ int adis_read_diag_wdg_timer_flag(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1171,7 +1386,7 @@ int adis_read_diag_int_proc_supply_err(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1192,7 +1407,7 @@ int adis_read_diag_ext_5v_supply_err(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1213,7 +1428,7 @@ int adis_read_diag_int_snsr_supply_err(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -1234,7 +1449,7 @@ int adis_read_diag_int_reg_err(struct adis_dev *adis,
 	struct adis_diag_flags diag_flags;
 	int ret;
 
-	ret = adis_read_diag_stat(adis, &diag_flags);
+	ret = adis_get_diag_flags(adis, &diag_flags);
 	if (ret)
 		return ret;
 
@@ -4085,6 +4300,62 @@ int adis_read_burst_data(struct adis_dev *adis, struct adis_burst_data *data,
 	return 0;
 }
 
+/**
+ * @brief Read several FIFO entries using one chained burst transfer.
+ * @param adis       - The adis device.
+ * @param data       - Array of at least nb_samples burst data structures.
+ * @param nb_samples - Number of FIFO entries to pop, at most
+ *		       ADIS_MAX_FIFO_BURST_SAMPLES.
+ * @param burst32    - True if 32-bit data is requested for accel
+ *		       and gyro (or delta angle and delta velocity)
+ *		       measurements, false if 16-bit data is requested.
+ * @param burst_sel  - 0 if accel and gyro data is requested, 1
+ *		       if delta angle and delta velocity is requested.
+ * @param crc_check  - If true frames with an invalid checksum are dropped.
+ * @param nb_read    - Number of valid entries stored in data.
+ * @return 0 in case of success, error code otherwise.
+ * -EAGAIN in case the request has to be sent again due to burst32 or burst
+ * select being changed, -ENOSYS if the device cannot chain FIFO reads.
+ */
+int adis_read_burst_fifo(struct adis_dev *adis, struct adis_burst_data *data,
+			 uint16_t nb_samples, bool burst32, uint8_t burst_sel,
+			 bool crc_check, uint16_t *nb_read)
+{
+	int ret = 0;
+
+	if (!(adis->info->flags & ADIS_HAS_FIFO) || !adis->info->read_burst_fifo)
+		return -ENOSYS;
+
+	/* Device does not support delta data readings with burst method */
+	if (!(adis->info->flags & ADIS_HAS_BURST_DELTA_DATA) && burst_sel)
+		return -EINVAL;
+
+	/* Device does not support burst32 readings with burst method */
+	if (!(adis->info->flags & ADIS_HAS_BURST32) && burst32)
+		return -EINVAL;
+
+	if (adis->info->flags & ADIS_HAS_BURST32) {
+		if (adis->burst32 != burst32) {
+			ret = adis_write_burst32(adis, burst32);
+			if (ret)
+				return ret;
+			ret = -EAGAIN;
+		}
+		if (adis->burst_sel != burst_sel) {
+			ret = adis_write_burst_sel(adis, burst_sel);
+			if (ret)
+				return ret;
+			ret = -EAGAIN;
+		}
+	}
+
+	if (ret == -EAGAIN)
+		return ret;
+
+	return adis->info->read_burst_fifo(adis, data, nb_samples, burst32,
+					   burst_sel, crc_check, nb_read);
+}
+
 /**
  * @brief Update external clock frequency.
  * @param adis     - The adis device.
@@ -64,6 +64,9 @@
 #define ADIS_SYNC_OUTPUT	3
 #define ADIS_SYNC_PULSE		5
 
+/* Maximum number of FIFO entries drained by one adis_read_burst_fifo() call */
+#define ADIS_MAX_FIFO_BURST_SAMPLES	16
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -242,6 +245,20 @@ struct adis_scale_fractional_log2 {
 };
 
 
+/** @struct adis_reg_op
+ *  @brief Register access performed by adis_reg_batch()
+ */
+struct adis_reg_op {
+	/** Register address. */
+	uint32_t	reg;
+	/** Register size in bytes: 1, 2 or 4 for writes, 2 or 4 for reads. */
+	uint32_t	size;
+	/** True for a register write, false for a register read. */
+	bool		write;
+	/** Value to be written or value read back from the device. */
+	uint32_t	val;
+};
+
 /** @struct adis_burst_data
  *  @brief ADIS burst data structure
  */
@@ -298,6 +315,8 @@ struct adis_dev {
 	uint8_t				burst_sel;
 	/** Device is locked, only data readings are allowed, no configuration allowed. */
 	bool				is_locked;
+	/** Set to true while diag flags are served from a DIAG_STAT snapshot. */
+	bool				diag_snapshot;
 };
 
 /** @struct adis_init_param
@@ -339,6 +358,9 @@ int adis_read_reg(struct adis_dev *adis,  uint32_t reg, uint32_t *val,
 /*! Write N bytes to register. */
 int adis_write_reg(struct adis_dev *adis, uint32_t reg, uint32_t value,
 		   uint32_t size);
+/*! Perform several register accesses, grouped by page, in one transfer. */
+int adis_reg_batch(struct adis_dev *adis, struct adis_reg_op *ops,
+		   uint32_t nb_ops);
 /*! Update the desired bits of reg in accordance with mask and val. */
 int adis_update_bits_base(struct adis_dev *adis, uint32_t reg,
 			  const uint32_t mask, const uint32_t val, uint8_t size);
@@ -346,6 +368,10 @@ int adis_update_bits_base(struct adis_dev *adis, uint32_t reg,
 /*! Read diag status register and update device diag flags. */
 int adis_read_diag_stat(struct adis_dev *adis,
 			struct adis_diag_flags *diag_flags);
+/*! Read diag status register once and serve the diag flags from it. */
+int adis_diag_snapshot(struct adis_dev *adis);
+/*! Release the diag status snapshot taken by adis_diag_snapshot(). */
+void adis_diag_snapshot_release(struct adis_dev *adis);
 
 /*! Read temperature register and update temperature flags. */
 int adis_read_temp_flags(struct adis_dev *adis,
@@ -908,6 +934,11 @@ int adis_write_fir_coef(struct adis_dev *adis, uint8_t coef_idx, uint32_t coef);
 int adis_read_burst_data(struct adis_dev *adis,struct adis_burst_data *data,
 			 bool burst32, uint8_t burst_sel, bool fifo_pop, bool crc_check);
 
+/*! Read several FIFO entries using one chained burst transfer */
+int adis_read_burst_fifo(struct adis_dev *adis, struct adis_burst_data *data,
+			 uint16_t nb_samples, bool burst32, uint8_t burst_sel,
+			 bool crc_check, uint16_t *nb_read);
+
 /*! Update external clock frequency. */
 int adis_update_ext_clk_freq(struct adis_dev *adis, uint32_t clk_freq);
 
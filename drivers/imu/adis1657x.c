@@ -49,6 +49,9 @@
 #define ADIS1657X_MSG_SIZE_32_BIT_BURST_FIFO	34 /* in bytes */
 #define ADIS1657X_READ_BURST_DATA_NO_POP	0x00
 #define ADIS1657X_CHECKSUM_BUF_IDX_FIFO		2
+#define ADIS1657X_FIFO_READ_DELAY_US		10
+#define ADIS1657X_FRAME_SIZE_32_BIT_BURST_FIFO	(ADIS1657X_MSG_SIZE_32_BIT_BURST_FIFO + \
+						 ADIS_READ_BURST_DATA_CMD_SIZE)
 
 /******************************************************************************/
 /************************** Variable Definitions ******************************/
@@ -250,6 +253,57 @@ static int adis1657x_get_scale(struct adis_dev *adis,
 	}
 }
 
+/**
+ * @brief Decode one burst frame.
+ * @param frame   - Burst frame, without the command bytes.
+ * @param burst32 - True if the frame holds 32-bit accel and gyro (or delta
+ *		    angle and delta velocity) data.
+ * @param data    - The burst read data structure to be populated.
+ */
+static void adis1657x_parse_burst(uint8_t *frame, bool burst32,
+				  struct adis_burst_data *data)
+{
+	uint8_t axis_data_size = burst32 ? 24 : 12;
+	uint8_t axis_data_offset = 2;
+	uint8_t temp_offset = axis_data_offset + axis_data_size;
+	uint8_t data_cntr_offset = temp_offset + 2;
+
+	if (burst32) {
+		memcpy(&data->x_gyro_lsb, &frame[axis_data_offset], 2);
+		memcpy(&data->x_gyro_msb, &frame[axis_data_offset + 2], 2);
+		memcpy(&data->y_gyro_lsb, &frame[axis_data_offset + 4], 2);
+		memcpy(&data->y_gyro_msb, &frame[axis_data_offset + 6], 2);
+		memcpy(&data->z_gyro_lsb, &frame[axis_data_offset + 8], 2);
+		memcpy(&data->z_gyro_msb, &frame[axis_data_offset + 10], 2);
+		memcpy(&data->x_accel_lsb, &frame[axis_data_offset + 12], 2);
+		memcpy(&data->x_accel_msb, &frame[axis_data_offset + 14], 2);
+		memcpy(&data->y_accel_lsb, &frame[axis_data_offset + 16], 2);
+		memcpy(&data->y_accel_msb, &frame[axis_data_offset + 18], 2);
+		memcpy(&data->z_accel_lsb, &frame[axis_data_offset + 20], 2);
+		memcpy(&data->z_accel_msb, &frame[axis_data_offset + 22], 2);
+	} else {
+		data->x_gyro_lsb = 0;
+		memcpy(&data->x_gyro_msb, &frame[axis_data_offset], 2);
+		data->y_gyro_lsb = 0;
+		memcpy(&data->y_gyro_msb, &frame[axis_data_offset + 2], 2);
+		data->z_gyro_lsb = 0;
+		memcpy(&data->z_gyro_msb, &frame[axis_data_offset + 4], 2);
+		data->x_accel_lsb = 0;
+		memcpy(&data->x_accel_msb, &frame[axis_data_offset + 6], 2);
+		data->y_accel_lsb = 0;
+		memcpy(&data->y_accel_msb, &frame[axis_data_offset + 8], 2);
+		data->z_accel_lsb = 0;
+		memcpy(&data->z_accel_msb, &frame[axis_data_offset + 10], 2);
+	}
+
+	data->temp_msb = 0;
+	/* Temp data */
+	memcpy(&data->temp_lsb, &frame[temp_offset], 2);
+	/* Counter data - aligned */
+	data->data_cntr_lsb = no_os_get_unaligned_be16(&frame[data_cntr_offset]);
+	data->data_cntr_msb = 0;
+}
+
 /**
  * @brief Read burst data.
  * @param adis      - The adis device.
@@ -330,50 +384,101 @@ int adis1657x_read_burst_data(struct adis_dev *adis,
 
 	adis->diag_flags.checksum_err = false;
 
-	uint8_t axis_data_size = 12;
-	if (burst32)
-		axis_data_size = 24;
+	adis1657x_parse_burst(&buffer[ADIS_READ_BURST_DATA_CMD_SIZE], burst32, data);
 
-	uint8_t axis_data_offset = ADIS_READ_BURST_DATA_CMD_SIZE + 2;
-	uint8_t temp_offset = axis_data_offset + axis_data_size;
-	uint8_t data_cntr_offset = temp_offset + 2;
+	/* Update diagnosis flags at each reading */
+	adis_update_diag_flags(adis, buffer[ADIS_READ_BURST_DATA_CMD_SIZE]);
 
-	if (burst32) {
-		memcpy(&data->x_gyro_lsb, &buffer[axis_data_offset], 2);
-		memcpy(&data->x_gyro_msb, &buffer[axis_data_offset + 2], 2);
-		memcpy(&data->y_gyro_lsb, &buffer[axis_data_offset + 4], 2);
-		memcpy(&data->y_gyro_msb, &buffer[axis_data_offset + 6], 2);
-		memcpy(&data->z_gyro_lsb, &buffer[axis_data_offset + 8], 2);
-		memcpy(&data->z_gyro_msb, &buffer[axis_data_offset + 10], 2);
-		memcpy(&data->x_accel_lsb, &buffer[axis_data_offset + 12], 2);
-		memcpy(&data->x_accel_msb, &buffer[axis_data_offset + 14], 2);
-		memcpy(&data->y_accel_lsb, &buffer[axis_data_offset + 16], 2);
-		memcpy(&data->y_accel_msb, &buffer[axis_data_offset + 18], 2);
-		memcpy(&data->z_accel_lsb, &buffer[axis_data_offset + 20], 2);
-		memcpy(&data->z_accel_msb, &buffer[axis_data_offset + 22], 2);
-	} else {
-		data->x_gyro_lsb = 0;
-		memcpy(&data->x_gyro_msb, &buffer[axis_data_offset], 2);
-		data->y_gyro_lsb = 0;
-		memcpy(&data->y_gyro_msb, &buffer[axis_data_offset + 2], 2);
-		data->z_gyro_lsb = 0;
-		memcpy(&data->z_gyro_msb, &buffer[axis_data_offset + 4], 2);
-		data->x_accel_lsb = 0;
-		memcpy(&data->x_accel_msb, &buffer[axis_data_offset + 6], 2);
-		data->y_accel_lsb = 0;
-		memcpy(&data->y_accel_msb, &buffer[axis_data_offset + 8], 2);
-		data->z_accel_lsb = 0;
-		memcpy(&data->z_accel_msb, &buffer[axis_data_offset + 10], 2);
+	return 0;
+}
+
+/**
+ * @brief Read several FIFO entries using one chained SPI transfer.
+ *
+ * The transfer holds nb_samples popping burst frames followed by one non
+ * popping frame. Each frame returns the entry loaded by the previous pop, so
+ * the first frame (the output registers before draining) is dropped and the
+ * last one returns the entry popped by the last popping frame. Checksums are
+ * validated once the whole transfer is done and invalid or empty frames are
+ * dropped.
+ * @param adis       - The adis device.
+ * @param data       - Array of at least nb_samples burst data structures.
+ * @param nb_samples - Number of FIFO entries to pop, at most
+ *		       ADIS_MAX_FIFO_BURST_SAMPLES.
+ * @param burst32    - True if 32-bit data is requested for accel and gyro (or
+ *		       delta angle and delta velocity) measurements.
+ * @param burst_sel  - 0 if accel and gyro data is requested, 1 if delta angle
+ *		       and delta velocity is requested.
+ * @param crc_check  - If true frames with an invalid checksum are dropped.
+ * @param nb_read    - Number of valid entries stored in data.
+ * @return 0 in case of success, error code otherwise.
+ */
+int adis1657x_read_burst_fifo(struct adis_dev *adis,
+			      struct adis_burst_data *data, uint16_t nb_samples,
+			      bool burst32, uint8_t burst_sel, bool crc_check,
+			      uint16_t *nb_read)
+{
+	uint8_t msg_size = burst32 ? ADIS1657X_MSG_SIZE_32_BIT_BURST_FIFO :
+			   ADIS1657X_MSG_SIZE_16_BIT_BURST_FIFO;
+	uint8_t frame_size = msg_size + ADIS_READ_BURST_DATA_CMD_SIZE;
+	uint8_t buffer[(ADIS_MAX_FIFO_BURST_SAMPLES + 1) *
+		       ADIS1657X_FRAME_SIZE_32_BIT_BURST_FIFO];
+	struct no_os_spi_msg msgs[ADIS_MAX_FIFO_BURST_SAMPLES + 1];
+	uint8_t *frame;
+	uint8_t diag = 0;
+	uint16_t i, idx;
+	bool crc_err = false;
+	int ret;
+
+	*nb_read = 0;
+
+	if (!nb_samples || nb_samples > ADIS_MAX_FIFO_BURST_SAMPLES)
+		return -EINVAL;
+
+	memset(buffer, 0, (nb_samples + 1) * frame_size);
+	memset(msgs, 0, (nb_samples + 1) * sizeof(*msgs));
+
+	for (i = 0; i <= nb_samples; i++) {
+		frame = &buffer[i * frame_size];
+		frame[0] = i < nb_samples ? ADIS_READ_BURST_DATA_CMD_MSB :
+			   ADIS1657X_READ_BURST_DATA_NO_POP;
+		frame[1] = ADIS_READ_BURST_DATA_CMD_LSB;
+		msgs[i].tx_buff = frame;
+		msgs[i].rx_buff = frame;
+		msgs[i].bytes_number = frame_size;
+		msgs[i].cs_change = 1;
+		/* From data-sheet, minimum time between reads */
+		msgs[i].cs_change_delay = ADIS1657X_FIFO_READ_DELAY_US;
 	}
 
-	data->temp_msb = 0;
-	/* Temp data */
-	memcpy(&data->temp_lsb, &buffer[temp_offset], 2);
-	/* Counter data - aligned */
-	data->data_cntr_lsb = no_os_get_unaligned_be16(&buffer[data_cntr_offset]);;
-	data->data_cntr_msb = 0;
-	/* Update diagnosis flags at each reading */
-	adis_update_diag_flags(adis, buffer[ADIS_READ_BURST_DATA_CMD_SIZE]);
+	ret = no_os_spi_transfer(adis->spi_desc, msgs, nb_samples + 1);
+	if (ret)
+		return ret;
+
+	for (i = 1; i <= nb_samples; i++) {
+		frame = &buffer[i * frame_size + ADIS_READ_BURST_DATA_CMD_SIZE];
+
+		for (idx = 0; idx < msg_size; idx++)
+			if (frame[idx])
+				break;
+		/* Empty FIFO */
+		if (idx == msg_size)
+			continue;
+
+		if (crc_check && !adis_validate_checksum(frame, msg_size,
+				ADIS1657X_CHECKSUM_BUF_IDX_FIFO)) {
+			crc_err = true;
+			continue;
+		}
+
+		adis1657x_parse_burst(frame, burst32, &data[*nb_read]);
+		diag |= frame[0];
+		(*nb_read)++;
+	}
+
+	adis->diag_flags.checksum_err = crc_err;
+	if (*nb_read)
+		adis_update_diag_flags(adis, diag);
 
 	return 0;
 }
@@ -395,4 +500,5 @@ const struct adis_chip_info adis1657x_chip_info = {
 	.flags			= ADIS_HAS_BURST32 | ADIS_HAS_BURST_DELTA_DATA | ADIS_HAS_FIFO,
 	.get_scale		= &adis1657x_get_scale,
 	.read_burst_data	= &adis1657x_read_burst_data,
+	.read_burst_fifo	= &adis1657x_read_burst_fifo,
 };
@@ -40,6 +40,7 @@
 #include "no_os_units.h"
 #include <stdio.h>
 #include <string.h>
+#include <stddef.h>
 #include "adis.h"
 #include "adis_internals.h"
 #include "iio_trigger.h"
@@ -51,10 +52,69 @@
 #define ADIS_BURST_DATA_SEL_0_CHN_MASK	NO_OS_GENMASK(5, 0)
 #define ADIS_BURST_DATA_SEL_1_CHN_MASK	NO_OS_GENMASK(12, 7)
 
+/* Index of a 16-bit word in struct adis_burst_data */
+#define ADIS_IIO_BURST_WORD(field)	(offsetof(struct adis_burst_data, field) / \
+					 sizeof(uint16_t))
+#define ADIS_IIO_BURST_WORDS		(sizeof(struct adis_burst_data) / \
+					 sizeof(uint16_t))
+/* Scan layout entry for a word which is always 0 */
+#define ADIS_IIO_SCAN_ZERO		ADIS_IIO_BURST_WORDS
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/** @struct adis_iio_scan_src
+ *  @brief Burst data words holding one 32-bit channel.
+ */
+struct adis_iio_scan_src {
+	/** Upper 16 bits. */
+	uint8_t msb;
+	/** Lower 16 bits. */
+	uint8_t lsb;
+	/** Burst data selection the channel is available with. */
+	uint8_t burst_sel;
+};
+
+static const struct adis_iio_scan_src adis_iio_scan_src[] = {
+	[ADIS_GYRO_X] = {
+		ADIS_IIO_BURST_WORD(x_gyro_msb), ADIS_IIO_BURST_WORD(x_gyro_lsb), 0
+	},
+	[ADIS_GYRO_Y] = {
+		ADIS_IIO_BURST_WORD(y_gyro_msb), ADIS_IIO_BURST_WORD(y_gyro_lsb), 0
+	},
+	[ADIS_GYRO_Z] = {
+		ADIS_IIO_BURST_WORD(z_gyro_msb), ADIS_IIO_BURST_WORD(z_gyro_lsb), 0
+	},
+	[ADIS_ACCEL_X] = {
+		ADIS_IIO_BURST_WORD(x_accel_msb), ADIS_IIO_BURST_WORD(x_accel_lsb), 0
+	},
+	[ADIS_ACCEL_Y] = {
+		ADIS_IIO_BURST_WORD(y_accel_msb), ADIS_IIO_BURST_WORD(y_accel_lsb), 0
+	},
+	[ADIS_ACCEL_Z] = {
+		ADIS_IIO_BURST_WORD(z_accel_msb), ADIS_IIO_BURST_WORD(z_accel_lsb), 0
+	},
+	[ADIS_DELTA_ANGL_X] = {
+		ADIS_IIO_BURST_WORD(x_gyro_msb), ADIS_IIO_BURST_WORD(x_gyro_lsb), 1
+	},
+	[ADIS_DELTA_ANGL_Y] = {
+		ADIS_IIO_BURST_WORD(y_gyro_msb), ADIS_IIO_BURST_WORD(y_gyro_lsb), 1
+	},
+	[ADIS_DELTA_ANGL_Z] = {
+		ADIS_IIO_BURST_WORD(z_gyro_msb), ADIS_IIO_BURST_WORD(z_gyro_lsb), 1
+	},
+	[ADIS_DELTA_VEL_X] = {
+		ADIS_IIO_BURST_WORD(x_accel_msb), ADIS_IIO_BURST_WORD(x_accel_lsb), 1
+	},
+	[ADIS_DELTA_VEL_Y] = {
+		ADIS_IIO_BURST_WORD(y_accel_msb), ADIS_IIO_BURST_WORD(y_accel_lsb), 1
+	},
+	[ADIS_DELTA_VEL_Z] = {
+		ADIS_IIO_BURST_WORD(z_accel_msb), ADIS_IIO_BURST_WORD(z_accel_lsb), 1
+	},
+};
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -1403,6 +1463,140 @@ int adis_iio_write_debug_attrs(void *dev, char *buf, uint32_t len,
 	}
 }
 
+/**
+ * @brief Check the data counter of a burst reading and update the number of
+ *        lost samples.
+ * @param iio_adis - The iio adis structure.
+ * @param data     - The burst data.
+ * @return true if the burst data holds a new sample-set, false otherwise.
+ */
+static bool adis_iio_update_data_cntr(struct adis_iio_dev *iio_adis,
+				      struct adis_burst_data *data)
+{
+	uint32_t current_data_cntr = data->data_cntr_lsb | data->data_cntr_msb << 16;
+	uint32_t res1;
+	uint32_t res2;
+
+	if (iio_adis->data_cntr) {
+		if(current_data_cntr > iio_adis->data_cntr) {
+			if (iio_adis->sync_mode != ADIS_SYNC_SCALED)
+				iio_adis->samples_lost += current_data_cntr - iio_adis->data_cntr - 1;
+			else {
+				if (iio_adis->sample_period_freq != iio_adis->sampling_frequency) {
+					iio_adis->sample_period_freq = iio_adis->sampling_frequency;
+					iio_adis->sample_period_us = NO_OS_DIV_ROUND_CLOSEST(1000000,
+								     iio_adis->sampling_frequency);
+				}
+				res1 = (current_data_cntr - iio_adis->data_cntr) * 49;
+				res2 = iio_adis->sample_period_us;
+
+				if(res1 > res2) {
+					iio_adis->samples_lost += res1 / res2;
+					if(res1 % res2 < res2 / 2)
+						iio_adis->samples_lost--;
+				}
+			}
+
+		} else if (current_data_cntr == iio_adis->data_cntr) {
+			/* No new data, nothing else to do */
+			return false;
+		}
+
+		else { /* data counter overflowed occurred */
+			if (iio_adis->sync_mode != ADIS_SYNC_SCALED)
+				iio_adis->samples_lost += NO_OS_U16_MAX - iio_adis->data_cntr +
+							  current_data_cntr;
+		}
+	}
+
+	iio_adis->data_cntr = current_data_cntr;
+
+	return true;
+}
+
+/**
+ * @brief Compute which burst data word goes in each word of a sample-set for
+ *        the given mask, so that sample-sets are built without going through
+ *        the channels for every sample.
+ * @param iio_adis - The iio adis structure.
+ * @param mask     - The active channels mask.
+ */
+static void adis_iio_build_scan_layout(struct adis_iio_dev *iio_adis,
+				       uint32_t mask)
+{
+	const struct adis_iio_scan_src *src;
+	uint8_t largest_storagebits = 16;
+	uint8_t storagebits;
+	uint8_t i = 0;
+	uint8_t chan;
+
+	for (chan = 0; chan < ADIS_NUM_CHAN; chan++) {
+		if (!(mask & NO_OS_BIT(chan)))
+			continue;
+
+		storagebits = iio_adis->iio_dev->channels[chan].scan_type->storagebits;
+		if (storagebits > largest_storagebits)
+			largest_storagebits = storagebits;
+
+		if (chan == ADIS_TEMP) {
+			if (storagebits == 32)
+				iio_adis->scan_layout[i++] = ADIS_IIO_BURST_WORD(temp_msb);
+
+			iio_adis->scan_layout[i++] = ADIS_IIO_BURST_WORD(temp_lsb);
+			/*
+			 * The temperature channel has 16-bit storage size.
+			 * We need to perform the padding to have the buffer
+			 * elements naturally aligned in case there are any
+			 * 32-bit storage size channels enabled which have a
+			 * scan index higher than the temperature channel scan
+			 * index.
+			 */
+			if (mask & NO_OS_GENMASK(ADIS_DELTA_VEL_Z, ADIS_DELTA_ANGL_X)
+			    && storagebits == 16)
+				iio_adis->scan_layout[i++] = ADIS_IIO_SCAN_ZERO;
+			continue;
+		}
+
+		src = &adis_iio_scan_src[chan];
+		if (src->burst_sel == iio_adis->burst_sel) {
+			iio_adis->scan_layout[i++] = src->msb;
+			iio_adis->scan_layout[i++] = src->lsb;
+		} else {
+			iio_adis->scan_layout[i++] = ADIS_IIO_SCAN_ZERO;
+			iio_adis->scan_layout[i++] = ADIS_IIO_SCAN_ZERO;
+		}
+	}
+
+	/*
+	 * The sample-set size is rounded up to the largest storage size, so
+	 * pad the end of the sample-set as well to keep consecutive sample-sets
+	 * naturally aligned.
+	 */
+	if (largest_storagebits == 32 && (i % 2))
+		iio_adis->scan_layout[i++] = ADIS_IIO_SCAN_ZERO;
+
+	iio_adis->scan_words = i;
+}
+
+/**
+ * @brief Build one sample-set from burst data, using the scan layout.
+ * @param iio_adis - The iio adis structure.
+ * @param data     - The burst data.
+ * @param scan     - The sample-set to be populated.
+ */
+static void adis_iio_build_scan(struct adis_iio_dev *iio_adis,
+				struct adis_burst_data *data, uint16_t *scan)
+{
+	uint16_t words[ADIS_IIO_BURST_WORDS + 1];
+	uint8_t i;
+
+	memcpy(words, data, sizeof(*data));
+	words[ADIS_IIO_SCAN_ZERO] = 0;
+
+	for (i = 0; i < iio_adis->scan_words; i++)
+		scan[i] = words[iio_adis->scan_layout[i]];
+}
+
 /**
  * @brief API to be called before trigger is enabled.
  * @param dev  - The iio device structure.
@@ -1445,6 +1639,8 @@ int adis_iio_pre_enable(void* dev, uint32_t mask)
 	iio_adis->samples_lost = 0;
 	iio_adis->data_cntr = 0;
 
+	adis_iio_build_scan_layout(iio_adis, mask);
+
 	if (iio_adis->has_fifo) {
 		/* Set FIFO overflow behavior to overwrite old data when FIFO is full. */
 		ret = adis_cmd_fifo_flush(adis);
@@ -1491,26 +1687,20 @@ int adis_iio_post_disable(void* dev, uint32_t mask)
 }
 
 /**
- * @brief API to be called to get one single sample-set based on the given mask.
+ * @brief API to be called to get one single sample-set based on the scan
+ *        layout computed for the active channels.
  * @param iio_adis - The iio adis structure.
- * @param mask     - The active channels mask.
  * @param buffer   - IIO buffer to push the sample set to.
+ * @param pop      - True to pop the FIFO, if present.
  * @return 0 in case of success, error code otherwise.
  */
 static int adis_iio_trigger_push_single_sample(struct adis_iio_dev *iio_adis,
-		uint32_t mask, struct iio_buffer *buffer, bool pop)
+		struct iio_buffer *buffer, bool pop)
 {
-	struct adis_dev *adis;
-	int ret;
 	struct adis_burst_data data;
-	uint8_t i = 0;
-	uint32_t res1;
-	uint32_t res2;
-	uint8_t chan;
-
-	adis = iio_adis->adis_dev;
+	int ret;
 
-	ret = adis_read_burst_data(adis, &data, iio_adis->burst_size,
+	ret = adis_read_burst_data(iio_adis->adis_dev, &data, iio_adis->burst_size,
 				   iio_adis->burst_sel, pop, false);
 
 	/* If ret ==  EAGAIN then no data is available to read (will happen
@@ -1521,197 +1711,72 @@ static int adis_iio_trigger_push_single_sample(struct adis_iio_dev *iio_adis,
 	if (ret)
 		return ret;
 
-	uint32_t current_data_cntr = data.data_cntr_lsb | data.data_cntr_msb << 16;
+	if (!adis_iio_update_data_cntr(iio_adis, &data))
+		return 0;
 
-	if (iio_adis->data_cntr) {
-		if(current_data_cntr > iio_adis->data_cntr) {
-			if (iio_adis->sync_mode != ADIS_SYNC_SCALED)
-				iio_adis->samples_lost += current_data_cntr - iio_adis->data_cntr - 1;
-			else {
-				res1 = (current_data_cntr - iio_adis->data_cntr) * 49;
-				res2 = NO_OS_DIV_ROUND_CLOSEST(1000000, iio_adis->sampling_frequency);
+	adis_iio_build_scan(iio_adis, &data, iio_adis->data);
 
-				if(res1 > res2) {
-					iio_adis->samples_lost += res1 / res2;
-					if(res1 % res2 < res2 / 2)
-						iio_adis->samples_lost--;
-				}
-			}
+	return iio_buffer_push_scan(buffer, &iio_adis->data[0]);
+}
 
-		} else if (current_data_cntr == iio_adis->data_cntr) {
-			/* No new data, nothing else to do */
+/**
+ * @brief Drain FIFO entries using chained burst transfers and write all the
+ *        resulting sample-sets to the buffer at once.
+ * @param iio_adis - The iio adis structure.
+ * @param buffer   - IIO buffer to push the sample sets to.
+ * @param fifo_cnt - Number of FIFO entries to drain.
+ * @return 0 in case of success, -ENOSYS if the device cannot chain FIFO reads,
+ *         error code otherwise.
+ */
+static int adis_iio_trigger_push_fifo(struct adis_iio_dev *iio_adis,
+				      struct iio_buffer *buffer, uint32_t fifo_cnt)
+{
+	uint16_t nb_samples;
+	uint16_t nb_scans;
+	uint16_t nb_read;
+	uint16_t *scan;
+	uint16_t stride;
+	uint16_t i;
+	int ret;
+
+	/* Sample-sets are written back to back, bytes_per_scan apart */
+	stride = buffer->bytes_per_scan / sizeof(*scan);
+	if (stride != iio_adis->scan_words)
+		return -EINVAL;
+
+	while (fifo_cnt) {
+		nb_samples = no_os_min(fifo_cnt, ADIS_MAX_FIFO_BURST_SAMPLES);
+
+		ret = adis_read_burst_fifo(iio_adis->adis_dev, iio_adis->fifo_data,
+					   nb_samples, iio_adis->burst_size,
+					   iio_adis->burst_sel, true, &nb_read);
+		if (ret == -EAGAIN)
 			return 0;
-		}
+		if (ret)
+			return ret;
 
-		else { /* data counter overflowed occurred */
-			if (iio_adis->sync_mode != ADIS_SYNC_SCALED)
-				iio_adis->samples_lost += NO_OS_U16_MAX - iio_adis->data_cntr +
-							  current_data_cntr;
-		}
-	}
+		scan = iio_adis->fifo_scans;
+		nb_scans = 0;
+		for (i = 0; i < nb_read; i++) {
+			if (!adis_iio_update_data_cntr(iio_adis, &iio_adis->fifo_data[i]))
+				continue;
 
-	iio_adis->data_cntr = current_data_cntr;
+			adis_iio_build_scan(iio_adis, &iio_adis->fifo_data[i], scan);
+			scan += stride;
+			nb_scans++;
+		}
 
-	for (chan = 0; chan < ADIS_NUM_CHAN; chan++) {
-		if (mask & (1 << chan)) {
-			switch(chan) {
-			case ADIS_TEMP:
-
-				if (iio_adis->iio_dev->channels[chan].scan_type->storagebits == 32)
-					iio_adis->data[i++] = data.temp_msb;
-
-				iio_adis->data[i++] = data.temp_lsb;
-				/*
-				 * The temperature channel has 16-bit storage size.
-				 * We need to perform the padding to have the buffer
-				 * elements naturally aligned in case there are any
-				 * 32-bit storage size channels enabled which have a
-				 * scan index higher than the temperature channel scan
-				 * index.
-				 */
-				if (mask & NO_OS_GENMASK(ADIS_DELTA_VEL_Z, ADIS_DELTA_ANGL_X)
-				    && iio_adis->iio_dev->channels[chan].scan_type->storagebits == 16)
-					iio_adis->data[i++] = 0;
-				break;
-			case ADIS_GYRO_X:
-				if(iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.x_gyro_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.x_gyro_lsb;
-				}
-				break;
-			case ADIS_GYRO_Y:
-				if(iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.y_gyro_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.y_gyro_lsb;
-				}
-				break;
-			case ADIS_GYRO_Z:
-				if(iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.z_gyro_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.z_gyro_lsb;
-				}
-				break;
-			case ADIS_ACCEL_X:
-				if(iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.x_accel_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.x_accel_lsb;
-				}
-				break;
-			case ADIS_ACCEL_Y:
-				if(iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.y_accel_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.y_accel_lsb;
-				}
-				break;
-			case ADIS_ACCEL_Z:
-				if(iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.z_accel_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.z_accel_lsb;
-				}
-				break;
-			case ADIS_DELTA_ANGL_X:
-				if(!iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.x_gyro_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.x_gyro_lsb;
-				}
-				break;
-			case ADIS_DELTA_ANGL_Y:
-				if(!iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.y_gyro_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.y_gyro_lsb;
-				}
-				break;
-			case ADIS_DELTA_ANGL_Z:
-				if(!iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.z_gyro_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.z_gyro_lsb;
-				}
-				break;
-			case ADIS_DELTA_VEL_X:
-				if(!iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.x_accel_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.x_accel_lsb;
-				}
-				break;
-			case ADIS_DELTA_VEL_Y:
-				if(!iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.y_accel_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.y_accel_lsb;
-				}
-				break;
-			case ADIS_DELTA_VEL_Z:
-				if(!iio_adis->burst_sel) {
-					iio_adis->data[i++] = 0;
-					iio_adis->data[i++] = 0;
-				} else {
-					/* upper 16 */
-					iio_adis->data[i++] = data.z_accel_msb;
-					/* lower 16 */
-					iio_adis->data[i++] =  data.z_accel_lsb;
-				}
-				break;
-			default:
-				break;
-			}
+		if (nb_scans) {
+			ret = no_os_cb_write(buffer->buf, iio_adis->fifo_scans,
+					     nb_scans * stride * sizeof(*scan));
+			if (ret)
+				return ret;
 		}
+
+		fifo_cnt -= nb_samples;
 	}
 
-	return iio_buffer_push_scan(buffer, &iio_adis->data[0]);
+	return 0;
 }
 
 /**
@@ -1731,8 +1796,8 @@ int adis_iio_trigger_handler(struct iio_device_data *dev_data)
 	if (!iio_adis->adis_dev)
 		return -EINVAL;
 
-	return adis_iio_trigger_push_single_sample(iio_adis,
-			dev_data->buffer->active_mask, dev_data->buffer, false);
+	return adis_iio_trigger_push_single_sample(iio_adis, dev_data->buffer,
+			false);
 }
 
 /**
@@ -1771,9 +1836,13 @@ int adis_iio_trigger_handler_with_fifo(struct iio_device_data *dev_data)
 		fifo_cnt = dev_data->buffer->samples;
 
 	if (fifo_cnt > 2) {
+		ret = adis_iio_trigger_push_fifo(iio_adis, dev_data->buffer, fifo_cnt);
+		if (ret != -ENOSYS)
+			goto trig_enable;
+
 		/* Burst request */
 		ret = adis_iio_trigger_push_single_sample(iio_adis,
-				dev_data->buffer->active_mask, dev_data->buffer, true);
+				dev_data->buffer, true);
 		if (ret)
 			goto trig_enable;
 
@@ -1782,7 +1851,7 @@ int adis_iio_trigger_handler_with_fifo(struct iio_device_data *dev_data)
 
 		for (j = 0; j < fifo_cnt - 1; j++) {
 			ret = adis_iio_trigger_push_single_sample(iio_adis,
-					dev_data->buffer->active_mask, dev_data->buffer, true);
+					dev_data->buffer, true);
 			if (ret)
 				goto trig_enable;
 
@@ -1790,7 +1859,7 @@ int adis_iio_trigger_handler_with_fifo(struct iio_device_data *dev_data)
 			no_os_udelay(10);
 		}
 		ret = adis_iio_trigger_push_single_sample(iio_adis,
-				dev_data->buffer->active_mask, dev_data->buffer, false);
+				dev_data->buffer, false);
 		/* From data-sheet, minimum time between reads */
 		no_os_udelay(10);
 	}
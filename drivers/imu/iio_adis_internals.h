@@ -40,6 +40,7 @@
 /******************************************************************************/
 
 #include "iio.h"
+#include "adis.h"
 #include <errno.h>
 
 /******************************************************************************/
@@ -234,6 +235,18 @@ struct adis_iio_dev {
 	uint32_t sync_mode;
 	/** Data buffer to store one sample-set. */
 	uint16_t data[26];
+	/** Burst data word copied to each word of a sample-set. */
+	uint8_t scan_layout[26];
+	/** Number of 16-bit words in one sample-set. */
+	uint8_t scan_words;
+	/** Sampling frequency used to compute sample_period_us. */
+	uint32_t sample_period_freq;
+	/** Sample period in us, used for lost samples in scaled sync mode. */
+	uint32_t sample_period_us;
+	/** Burst data drained from the FIFO. */
+	struct adis_burst_data fifo_data[ADIS_MAX_FIFO_BURST_SAMPLES];
+	/** Sample-sets built from fifo_data, written to the buffer at once. */
+	uint16_t fifo_scans[ADIS_MAX_FIFO_BURST_SAMPLES * 26];
 	/** True if iio device offers FIFO support for buffer reading. */
 	bool has_fifo;
 	/** Gyroscope measurement range value in text. */
@@ -4200,6 +4200,65 @@ int ade9153a_rms_vals(struct ade9153a_dev *dev,
 	return 0;
 }
 
+/**
+ * @brief Read the waveform samples. With burst enabled, the AI_WAV_1, AV_WAV_1
+ *        and BI_WAV_1 block is read in a single transfer, without CRC, so all
+ *        the samples belong to the same DREADY period.
+ * @param dev - The device structure.
+ * @param data - Structure to store the waveform values
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ade9153a_wav_vals(struct ade9153a_dev *dev,
+		      struct ade9153a_wav_values *data)
+{
+	int ret;
+	/* temporary value read from register */
+	uint32_t temp_val;
+	/* command followed by the three 32 bit waveform registers */
+	uint8_t buff[14] = { 0 };
+	/* register address */
+	uint16_t addr;
+
+	if (!dev)
+		return -ENODEV;
+	if (!data)
+		return -EINVAL;
+
+	if (dev->burst_en) {
+		addr = (uint16_t)no_os_field_prep(NO_OS_GENMASK(16, 4),
+						  ADE9153A_REG_AI_WAV_1);
+		no_os_put_unaligned_be16(addr, buff);
+		buff[1] = buff[1] | ADE9153A_SPI_READ;
+
+		ret = no_os_spi_write_and_read(dev->spi_desc, buff, sizeof(buff));
+		if (ret)
+			return ret;
+
+		data->ai_wav_reg_val = (int32_t)no_os_get_unaligned_be32(&buff[2]);
+		data->av_wav_reg_val = (int32_t)no_os_get_unaligned_be32(&buff[6]);
+		data->bi_wav_reg_val = (int32_t)no_os_get_unaligned_be32(&buff[10]);
+
+		return 0;
+	}
+
+	ret = ade9153a_read(dev, ADE9153A_REG_AI_WAV_1, &temp_val);
+	if (ret)
+		return ret;
+	data->ai_wav_reg_val = (int32_t)temp_val;
+
+	ret = ade9153a_read(dev, ADE9153A_REG_AV_WAV_1, &temp_val);
+	if (ret)
+		return ret;
+	data->av_wav_reg_val = (int32_t)temp_val;
+
+	ret = ade9153a_read(dev, ADE9153A_REG_BI_WAV_1, &temp_val);
+	if (ret)
+		return ret;
+	data->bi_wav_reg_val = (int32_t)temp_val;
+
+	return 0;
+}
+
 /**
  * @brief Read half rms values
  * @param dev - The device structure.
@@ -766,6 +766,19 @@ struct ade9153a_rms_values {
 	/** Current rms value */
 };
 
+/**
+ * @struct ade9153a_wav_values
+ * @brief ADE9153A instantaneous waveform registers values
+ */
+struct ade9153a_wav_values {
+	/** Phase A current waveform register value */
+	int32_t ai_wav_reg_val;
+	/** Phase A voltage waveform register value */
+	int32_t av_wav_reg_val;
+	/** Phase B current waveform register value */
+	int32_t bi_wav_reg_val;
+};
+
 /**
  * @struct ade9153a_half_rms_values
  * @brief ADE9153A half rms registers values
@@ -1437,6 +1450,10 @@ int ade9153a_power_vals(struct ade9153a_dev *dev,
 int ade9153a_rms_vals(struct ade9153a_dev *dev,
 		      struct ade9153a_rms_values *data);
 
+// Read the waveform samples, in a single transfer if burst is enabled
+int ade9153a_wav_vals(struct ade9153a_dev *dev,
+		      struct ade9153a_wav_values *data);
+
 // Read half rms values
 int ade9153a_half_rms_vals(struct ade9153a_dev *dev,
 			   struct ade9153a_half_rms_values *data);
@@ -274,6 +274,239 @@ int ade9430_set_egy_model(struct ade9430_dev *dev, enum ade9430_egy_model model,
 	return ade9430_write(dev, ADE9430_REG_RUN, 1);
 }
 
+/**
+ * @brief Configure the waveform buffer for streaming. The buffer is filled
+ * 	  continuously (no trigger events) and PAGE_FULL is unmasked so the
+ * 	  IRQ0 pin can be used to schedule the page reads.
+ * @param dev - The device structure.
+ * @param cfg - The waveform buffer configuration.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ade9430_wfb_config(struct ade9430_dev *dev, struct ade9430_wfb_cfg *cfg)
+{
+	uint32_t wfb_cfg;
+	int ret;
+
+	if (!dev || !cfg)
+		return -EINVAL;
+
+	if (!dev->wfb_buff) {
+		/* 2 bytes command header followed by the burst data */
+		dev->wfb_buff = no_os_calloc(2 + ADE9430_WFB_BURST_PAGES *
+					     ADE9430_WFB_PAGE_WORDS * 4, 1);
+		if (!dev->wfb_buff)
+			return -ENOMEM;
+	}
+
+	/* Stop the capture before changing its configuration */
+	ret = ade9430_update_bits(dev, ADE9430_REG_WFB_CFG, ADE9430_WF_CAP_EN, 0);
+	if (ret)
+		return ret;
+
+	ret = ade9430_write(dev, ADE9430_REG_WFB_TRG_CFG, 0);
+	if (ret)
+		return ret;
+
+	ret = ade9430_write(dev, ADE9430_REG_WFB_PG_IRQEN,
+			    cfg->pg_irqen ? cfg->pg_irqen : ADE9430_WFB_HALF_IRQEN);
+	if (ret)
+		return ret;
+
+	wfb_cfg = no_os_field_prep(ADE9430_WF_IN_EN, cfg->in_en) |
+		  no_os_field_prep(ADE9430_WF_MODE, ADE9430_WF_MODE_CONT) |
+		  no_os_field_prep(ADE9430_WF_CAP_SEL, cfg->cap);
+	if (cfg->cap == ADE9430_WFB_FIXED_RATE)
+		wfb_cfg |= no_os_field_prep(ADE9430_WF_SRC, cfg->src);
+
+	ret = ade9430_write(dev, ADE9430_REG_WFB_CFG, wfb_cfg);
+	if (ret)
+		return ret;
+
+	ret = ade9430_update_bits(dev, ADE9430_REG_MASK0, ADE9430_MASK0_PAGE_FULL,
+				  ADE9430_MASK0_PAGE_FULL);
+	if (ret)
+		return ret;
+
+	dev->wfb_cap = cfg->cap;
+
+	return 0;
+}
+
+/**
+ * @brief Start/stop the waveform buffer capture.
+ * @param dev - The device structure.
+ * @param enable - true to start the capture, false to stop it.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ade9430_wfb_enable(struct ade9430_dev *dev, bool enable)
+{
+	int ret;
+
+	if (!dev)
+		return -EINVAL;
+
+	if (enable) {
+		/* Filling restarts from page 0, drop any stale status */
+		ret = ade9430_write(dev, ADE9430_REG_STATUS0,
+				    ADE9430_STATUS0_PAGE_FULL);
+		if (ret)
+			return ret;
+
+		dev->wfb_page = 0;
+	}
+
+	return ade9430_update_bits(dev, ADE9430_REG_WFB_CFG, ADE9430_WF_CAP_EN,
+				   no_os_field_prep(ADE9430_WF_CAP_EN, enable));
+}
+
+/**
+ * @brief Check and clear the page full status.
+ * @param dev - The device structure.
+ * @param full - true if one of the pages enabled in WFB_PG_IRQEN was filled.
+ * @param last_page - The last page filled, valid only if full is true.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ade9430_wfb_page_full(struct ade9430_dev *dev, bool *full,
+			  uint8_t *last_page)
+{
+	uint32_t reg_val;
+	int ret;
+
+	if (!dev || !full || !last_page)
+		return -EINVAL;
+
+	ret = ade9430_read(dev, ADE9430_REG_STATUS0, &reg_val);
+	if (ret)
+		return ret;
+
+	*full = reg_val & ADE9430_STATUS0_PAGE_FULL;
+	if (!*full)
+		return 0;
+
+	ret = ade9430_write(dev, ADE9430_REG_STATUS0, ADE9430_STATUS0_PAGE_FULL);
+	if (ret)
+		return ret;
+
+	ret = ade9430_read(dev, ADE9430_REG_WFB_TRG_STAT, &reg_val);
+	if (ret)
+		return ret;
+
+	*last_page = no_os_field_get(ADE9430_WFB_LAST_PAGE, reg_val);
+
+	return 0;
+}
+
+/**
+ * @brief Burst read consecutive waveform buffer pages. Up to
+ * 	  ADE9430_WFB_BURST_PAGES pages are read in a single SPI transfer.
+ * @param dev - The device structure.
+ * @param page - The first page to be read.
+ * @param nb_pages - The number of pages to be read.
+ * @param data - Buffer of nb_pages * ADE9430_WFB_PAGE_WORDS samples. In
+ * 		 resampled mode the 16-bit samples are sign extended.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ade9430_wfb_read(struct ade9430_dev *dev, uint8_t page, uint8_t nb_pages,
+		     int32_t *data)
+{
+	uint32_t i, nb_words, word_bytes;
+	uint16_t addr;
+	uint8_t chunk;
+	int ret;
+
+	if (!dev || !dev->wfb_buff || !data || !nb_pages ||
+	    page + nb_pages > ADE9430_WFB_PAGES)
+		return -EINVAL;
+
+	word_bytes = dev->wfb_cap == ADE9430_WFB_FIXED_RATE ? 4 : 2;
+
+	while (nb_pages) {
+		chunk = no_os_min(nb_pages, ADE9430_WFB_BURST_PAGES);
+		nb_words = chunk * ADE9430_WFB_PAGE_WORDS;
+		addr = ADE9430_WFB_ADDR + page * ADE9430_WFB_PAGE_WORDS;
+
+		memset(dev->wfb_buff, 0, 2 + nb_words * word_bytes);
+		dev->wfb_buff[0] = addr >> 4;
+		dev->wfb_buff[1] = ADE9430_SPI_READ | addr << 4;
+
+		ret = no_os_spi_write_and_read(dev->spi_desc, dev->wfb_buff,
+					       2 + nb_words * word_bytes);
+		if (ret)
+			return ret;
+
+		if (word_bytes == 4) {
+			for (i = 0; i < nb_words; i++)
+				data[i] = no_os_get_unaligned_be32(&dev->wfb_buff[2 + i * 4]);
+		} else {
+			for (i = 0; i < nb_words; i++)
+				data[i] = (int16_t)no_os_get_unaligned_be16(&dev->wfb_buff[2 + i * 2]);
+		}
+
+		data += nb_words;
+		page += chunk;
+		nb_pages -= chunk;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read all the pages filled since the previous drain. Does nothing
+ * 	  if no page full event is pending.
+ * @param dev - The device structure.
+ * @param data - Buffer of ADE9430_WFB_PAGES * ADE9430_WFB_PAGE_WORDS samples.
+ * @param nb_pages - The number of pages read.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ade9430_wfb_drain(struct ade9430_dev *dev, int32_t *data,
+		      uint8_t *nb_pages)
+{
+	uint8_t last_page, count, first;
+	bool full;
+	int ret;
+
+	if (!dev || !data || !nb_pages)
+		return -EINVAL;
+
+	*nb_pages = 0;
+
+	ret = ade9430_wfb_page_full(dev, &full, &last_page);
+	if (ret || !full)
+		return ret;
+
+	/* A count of 0 means the whole buffer was filled since the last drain */
+	count = (last_page + 1 + ADE9430_WFB_PAGES - dev->wfb_page) %
+		ADE9430_WFB_PAGES;
+	if (!count)
+		count = ADE9430_WFB_PAGES;
+
+	first = no_os_min(count, ADE9430_WFB_PAGES - dev->wfb_page);
+	ret = ade9430_wfb_read(dev, dev->wfb_page, first, data);
+	if (ret)
+		return ret;
+
+	if (count > first) {
+		ret = ade9430_wfb_read(dev, 0, count - first,
+				       data + first * ADE9430_WFB_PAGE_WORDS);
+		if (ret)
+			return ret;
+	}
+
+	dev->wfb_page = (last_page + 1) % ADE9430_WFB_PAGES;
+	*nb_pages = count;
+
+	/* The resampled capture stops once the buffer is full, restart it */
+	if (dev->wfb_cap == ADE9430_WFB_RESAMPLED && !dev->wfb_page) {
+		ret = ade9430_wfb_enable(dev, false);
+		if (ret)
+			return ret;
+
+		return ade9430_wfb_enable(dev, true);
+	}
+
+	return 0;
+}
+
 /**
  * @brief Initialize the device.
  * @param device - The device structure.
@@ -348,6 +581,7 @@ int ade9430_remove(struct ade9430_dev *dev)
 	if (ret)
 		return ret;
 
+	no_os_free(dev->wfb_buff);
 	no_os_free(dev);
 
 	return 0;
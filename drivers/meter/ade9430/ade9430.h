@@ -760,7 +760,7 @@
 /* ADE9430_REG_WFB_CFG Bit Definition */
 #define ADE9430_WF_IN_EN		NO_OS_BIT(12)
 #define ADE9430_WF_SRC			NO_OS_GENMASK(9, 8)
-#define ADE9430_WF_MODE			NO_OS_BIT(7, 6)
+#define ADE9430_WF_MODE			NO_OS_GENMASK(7, 6)
 #define ADE9430_WF_CAP_SEL		NO_OS_BIT(5)
 #define ADE9430_WF_CAP_EN		NO_OS_BIT(4)
 #define ADE9430_BURST_CHAN		NO_OS_GENMASK(3, 0)
@@ -845,6 +845,20 @@
 #define ADE9430_V_RES_NV		13357ULL
 #define ADE9430_W_RES_UW		7203ULL
 
+/* Waveform buffer */
+#define ADE9430_WFB_ADDR		0x0800
+#define ADE9430_WFB_PAGES		16
+#define ADE9430_WFB_PAGE_WORDS		128
+#define ADE9430_WFB_SET_WORDS		8
+#define ADE9430_WFB_PAGE_SETS		(ADE9430_WFB_PAGE_WORDS / \
+					 ADE9430_WFB_SET_WORDS)
+#define ADE9430_WFB_BURST_PAGES		8
+#define ADE9430_WFB_HALF_IRQEN		(NO_OS_BIT(7) | NO_OS_BIT(15))
+/* Continuous fill, stop only on enabled trigger events */
+#define ADE9430_WF_MODE_CONT		1
+#define ADE9430_WFB_SINC4_RATE		32000
+#define ADE9430_WFB_DSP_RATE		8000
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -869,6 +883,60 @@ enum ade9430_egy_model {
 	ADE9430_EGY_NR_SAMPLES
 };
 
+/**
+ * @enum ade9430_wfb_cap
+ * @brief ADE9430 waveform buffer capture type (WF_CAP_SEL).
+ */
+enum ade9430_wfb_cap {
+	/** 64 resampled 16-bit points per line cycle */
+	ADE9430_WFB_RESAMPLED,
+	/** 32-bit samples at a fixed data rate */
+	ADE9430_WFB_FIXED_RATE
+};
+
+/**
+ * @enum ade9430_wf_src
+ * @brief ADE9430 fixed data rate waveform source (WF_SRC).
+ */
+enum ade9430_wf_src {
+	/** Sinc4 output, 32 kSPS */
+	ADE9430_WF_SRC_SINC4,
+	/** Sinc4 and IIR low-pass filter output, 8 kSPS */
+	ADE9430_WF_SRC_SINC4_IIR_LPF = 2,
+	/** DSP processed current and voltage waveforms, 8 kSPS */
+	ADE9430_WF_SRC_DSP
+};
+
+/**
+ * @enum ade9430_wfb_chan
+ * @brief Position of each channel in a waveform buffer sample set.
+ */
+enum ade9430_wfb_chan {
+	ADE9430_WFB_IA,
+	ADE9430_WFB_VA,
+	ADE9430_WFB_IB,
+	ADE9430_WFB_VB,
+	ADE9430_WFB_IC,
+	ADE9430_WFB_VC,
+	ADE9430_WFB_IN,
+	ADE9430_WFB_NUM_CH
+};
+
+/**
+ * @struct ade9430_wfb_cfg
+ * @brief ADE9430 waveform buffer streaming configuration.
+ */
+struct ade9430_wfb_cfg {
+	/** Capture type */
+	enum ade9430_wfb_cap		cap;
+	/** Fixed data rate source, ignored in resampled mode */
+	enum ade9430_wf_src		src;
+	/** Also capture the neutral current */
+	bool				in_en;
+	/** Pages raising PAGE_FULL, ADE9430_WFB_HALF_IRQEN when 0 */
+	uint16_t			pg_irqen;
+};
+
 /**
  * @struct ade9430_init_param
  * @brief ADE9430 Device initialization parameters.
@@ -895,6 +963,12 @@ struct ade9430_dev {
 	uint32_t			vrms_val;
 	/** Variable storing the temperature value in degrees */
 	int32_t				temp_deg;
+	/** Waveform buffer capture type */
+	enum ade9430_wfb_cap		wfb_cap;
+	/** Next waveform buffer page to be read */
+	uint8_t				wfb_page;
+	/** Waveform buffer burst read scratch buffer */
+	uint8_t				*wfb_buff;
 };
 
 /******************************************************************************/
@@ -923,6 +997,24 @@ int ade9430_read_data_ph(struct ade9430_dev *dev, enum ade9430_phase phase);
 int ade9430_set_egy_model(struct ade9430_dev *dev, enum ade9430_egy_model model,
 			  uint16_t value);
 
+/* Configure the waveform buffer for streaming. */
+int ade9430_wfb_config(struct ade9430_dev *dev, struct ade9430_wfb_cfg *cfg);
+
+/* Start/stop the waveform buffer capture. */
+int ade9430_wfb_enable(struct ade9430_dev *dev, bool enable);
+
+/* Check and clear the page full status. */
+int ade9430_wfb_page_full(struct ade9430_dev *dev, bool *full,
+			  uint8_t *last_page);
+
+/* Burst read consecutive waveform buffer pages. */
+int ade9430_wfb_read(struct ade9430_dev *dev, uint8_t page, uint8_t nb_pages,
+		     int32_t *data);
+
+/* Read all the pages filled since the previous drain. */
+int ade9430_wfb_drain(struct ade9430_dev *dev, int32_t *data,
+		      uint8_t *nb_pages);
+
 /* Initialize the device. */
 int ade9430_init(struct ade9430_dev **device,
 		 struct ade9430_init_param init_param);
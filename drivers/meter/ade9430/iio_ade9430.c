@@ -0,0 +1,392 @@
+/***************************************************************************//**
+ *   @file   iio_ade9430.c
+ *   @brief  Implementation of IIO ADE9430 Driver.
+ *   @author Antoniu Miclaus (antoniu.miclaus@analog.com)
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <errno.h>
+#include "no_os_util.h"
+#include "no_os_delay.h"
+#include "no_os_alloc.h"
+#include "no_os_circular_buffer.h"
+#include "iio_ade9430.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Page full polls done by submit before giving up, 1 ms apart */
+#define ADE9430_IIO_WFB_POLL_MAX	1000
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Read the scale of a waveform channel. The DSP processed waveforms
+ * 	  share the full scale of the RMS registers.
+ * @param dev - The iio device structure.
+ * @param buf - Command buffer to be filled with requested data.
+ * @param len - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv - Command attribute id.
+ * @return The size of the read data in case of success, error code otherwise.
+ */
+static int ade9430_iio_read_scale(void *dev, char *buf, uint32_t len,
+				  const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct ade9430_iio_dev *desc = dev;
+	int32_t vals[2];
+
+	if (desc->wfb_cfg.cap != ADE9430_WFB_FIXED_RATE ||
+	    desc->wfb_cfg.src != ADE9430_WF_SRC_DSP)
+		return -EINVAL;
+
+	switch (channel->type) {
+	case IIO_CURRENT:
+		/* mA */
+		vals[0] = ADE9430_I_RES_NA;
+		vals[1] = 1000000;
+		break;
+	case IIO_VOLTAGE:
+		/* mV */
+		vals[0] = ADE9430_V_RES_NV;
+		vals[1] = 1000000;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return iio_format_value(buf, len, IIO_VAL_FRACTIONAL, 2, vals);
+}
+
+/**
+ * @brief Read the waveform buffer sampling frequency.
+ * @param dev - The iio device structure.
+ * @param buf - Command buffer to be filled with requested data.
+ * @param len - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv - Command attribute id.
+ * @return The size of the read data in case of success, error code otherwise.
+ */
+static int ade9430_iio_read_sampling_freq(void *dev, char *buf, uint32_t len,
+		const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct ade9430_iio_dev *desc = dev;
+	int32_t val;
+
+	/* Resampled captures follow the line frequency */
+	if (desc->wfb_cfg.cap != ADE9430_WFB_FIXED_RATE)
+		return -EINVAL;
+
+	if (desc->wfb_cfg.src == ADE9430_WF_SRC_SINC4)
+		val = ADE9430_WFB_SINC4_RATE;
+	else
+		val = ADE9430_WFB_DSP_RATE;
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/**
+ * @brief Read a device register.
+ * @param dev - The iio device structure.
+ * @param reg - The register address.
+ * @param readval - The register value.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int ade9430_iio_read_reg(struct ade9430_iio_dev *dev, uint32_t reg,
+				uint32_t *readval)
+{
+	return ade9430_read(dev->ade9430_dev, reg, readval);
+}
+
+/**
+ * @brief Write a device register.
+ * @param dev - The iio device structure.
+ * @param reg - The register address.
+ * @param writeval - The register value.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int ade9430_iio_write_reg(struct ade9430_iio_dev *dev, uint32_t reg,
+				 uint32_t writeval)
+{
+	return ade9430_write(dev->ade9430_dev, reg, writeval);
+}
+
+/**
+ * @brief Start the waveform capture for the requested channels.
+ * @param dev - The iio device structure.
+ * @param mask - Mask of the active channels.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int ade9430_iio_buffer_enable(void *dev, uint32_t mask)
+{
+	struct ade9430_iio_dev *desc = dev;
+
+	if ((mask & NO_OS_BIT(ADE9430_WFB_IN)) && !desc->wfb_cfg.in_en)
+		return -EINVAL;
+
+	desc->active_channels = mask;
+	desc->wfb_scans = 0;
+	desc->wfb_pos = 0;
+
+	return ade9430_wfb_enable(desc->ade9430_dev, true);
+}
+
+/**
+ * @brief Stop the waveform capture.
+ * @param dev - The iio device structure.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int ade9430_iio_buffer_disable(void *dev)
+{
+	struct ade9430_iio_dev *desc = dev;
+
+	return ade9430_wfb_enable(desc->ade9430_dev, false);
+}
+
+/**
+ * @brief Read the filled waveform buffer pages and keep only the enabled
+ * 	  channels of every sample set.
+ * @param desc - The iio device structure.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int ade9430_iio_wfb_fill(struct ade9430_iio_dev *desc)
+{
+	uint32_t i, j, k = 0;
+	uint8_t nb_pages;
+	int32_t *set;
+	int ret;
+
+	ret = ade9430_wfb_drain(desc->ade9430_dev, desc->wfb_data, &nb_pages);
+	if (ret)
+		return ret;
+
+	/* Pack the enabled channels in place, scans never grow */
+	set = desc->wfb_data;
+	for (i = 0; i < nb_pages * ADE9430_WFB_PAGE_SETS; i++) {
+		for (j = 0; j < ADE9430_WFB_NUM_CH; j++)
+			if (desc->active_channels & NO_OS_BIT(j))
+				desc->wfb_data[k++] = set[j];
+		set += ADE9430_WFB_SET_WORDS;
+	}
+
+	desc->wfb_scans = nb_pages * ADE9430_WFB_PAGE_SETS;
+	desc->wfb_pos = 0;
+
+	return 0;
+}
+
+/**
+ * @brief Push the whole pages filled since the previous call. Meant to be
+ * 	  used with a trigger driven by the PAGE_FULL interrupt on IRQ0.
+ * @param dev_data - The iio device data structure.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int ade9430_iio_trigger_handler(struct iio_device_data *dev_data)
+{
+	struct ade9430_iio_dev *desc = dev_data->dev;
+	int ret;
+
+	ret = ade9430_iio_wfb_fill(desc);
+	if (ret || !desc->wfb_scans)
+		return ret;
+
+	return no_os_cb_write(dev_data->buffer->buf, desc->wfb_data,
+			      desc->wfb_scans * dev_data->buffer->bytes_per_scan);
+}
+
+/**
+ * @brief Fill the IIO buffer by polling the page full status. Scans left
+ * 	  over from a drain are kept for the next request.
+ * @param dev_data - The iio device data structure.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int ade9430_iio_submit(struct iio_device_data *dev_data)
+{
+	struct ade9430_iio_dev *desc = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	uint32_t nb_scans, nb_words, samples = 0;
+	uint32_t polls = 0;
+	int ret;
+
+	nb_words = buffer->bytes_per_scan / sizeof(int32_t);
+
+	while (samples < buffer->samples) {
+		if (desc->wfb_pos == desc->wfb_scans) {
+			ret = ade9430_iio_wfb_fill(desc);
+			if (ret)
+				return ret;
+
+			if (!desc->wfb_scans) {
+				if (++polls == ADE9430_IIO_WFB_POLL_MAX)
+					return -ETIMEDOUT;
+				no_os_mdelay(1);
+				continue;
+			}
+			polls = 0;
+		}
+
+		nb_scans = no_os_min(desc->wfb_scans - desc->wfb_pos,
+				     buffer->samples - samples);
+
+		ret = no_os_cb_write(buffer->buf,
+				     &desc->wfb_data[desc->wfb_pos * nb_words],
+				     nb_scans * buffer->bytes_per_scan);
+		if (ret)
+			return ret;
+
+		desc->wfb_pos += nb_scans;
+		samples += nb_scans;
+	}
+
+	return 0;
+}
+
+static struct iio_attribute ade9430_iio_wfb_attrs[] = {
+	{
+		.name = "scale",
+		.shared = IIO_SHARED_BY_TYPE,
+		.show = ade9430_iio_read_scale,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct iio_attribute ade9430_iio_dev_attrs[] = {
+	{
+		.name = "sampling_frequency",
+		.show = ade9430_iio_read_sampling_freq,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct scan_type ade9430_iio_wfb_scan_type = {
+	.sign = 's',
+	.realbits = 32,
+	.storagebits = 32,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+#define ADE9430_IIO_WFB_CHANNEL(_type, _ch, _idx, _name) { \
+	.name = _name,					\
+	.ch_type = _type,				\
+	.channel = _ch,					\
+	.scan_index = _idx,				\
+	.scan_type = &ade9430_iio_wfb_scan_type,	\
+	.attributes = ade9430_iio_wfb_attrs,		\
+	.ch_out = false					\
+}
+
+/* Ordered as the sample sets stored in the waveform buffer */
+static struct iio_channel ade9430_iio_channels[] = {
+	ADE9430_IIO_WFB_CHANNEL(IIO_CURRENT, 0, ADE9430_WFB_IA, "ia"),
+	ADE9430_IIO_WFB_CHANNEL(IIO_VOLTAGE, 0, ADE9430_WFB_VA, "va"),
+	ADE9430_IIO_WFB_CHANNEL(IIO_CURRENT, 1, ADE9430_WFB_IB, "ib"),
+	ADE9430_IIO_WFB_CHANNEL(IIO_VOLTAGE, 1, ADE9430_WFB_VB, "vb"),
+	ADE9430_IIO_WFB_CHANNEL(IIO_CURRENT, 2, ADE9430_WFB_IC, "ic"),
+	ADE9430_IIO_WFB_CHANNEL(IIO_VOLTAGE, 2, ADE9430_WFB_VC, "vc"),
+	ADE9430_IIO_WFB_CHANNEL(IIO_CURRENT, 3, ADE9430_WFB_IN, "in"),
+};
+
+static struct iio_device ade9430_iio_dev = {
+	.num_ch = NO_OS_ARRAY_SIZE(ade9430_iio_channels),
+	.channels = ade9430_iio_channels,
+	.attributes = ade9430_iio_dev_attrs,
+	.pre_enable = ade9430_iio_buffer_enable,
+	.post_disable = ade9430_iio_buffer_disable,
+	.submit = ade9430_iio_submit,
+	.trigger_handler = ade9430_iio_trigger_handler,
+	.debug_reg_read = (int32_t (*)())ade9430_iio_read_reg,
+	.debug_reg_write = (int32_t (*)())ade9430_iio_write_reg
+};
+
+/**
+ * @brief Initialize the ADE9430 IIO driver.
+ * @param iio_dev - The iio device structure.
+ * @param init_param - The structure that contains the device initial
+ * 		       parameters.
+ * @return 0 in case of success, error code otherwise.
+ */
+int ade9430_iio_init(struct ade9430_iio_dev **iio_dev,
+		     struct ade9430_iio_dev_init_param *init_param)
+{
+	struct ade9430_iio_dev *desc;
+	int ret;
+
+	if (!init_param || !init_param->ade9430_dev_init || !init_param->wfb_cfg)
+		return -EINVAL;
+
+	desc = no_os_calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	desc->iio_dev = &ade9430_iio_dev;
+	desc->wfb_cfg = *init_param->wfb_cfg;
+
+	ret = ade9430_init(&desc->ade9430_dev, *init_param->ade9430_dev_init);
+	if (ret)
+		goto error_dev;
+
+	ret = ade9430_wfb_config(desc->ade9430_dev, &desc->wfb_cfg);
+	if (ret)
+		goto error_ade9430;
+
+	*iio_dev = desc;
+
+	return 0;
+
+error_ade9430:
+	ade9430_remove(desc->ade9430_dev);
+error_dev:
+	no_os_free(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by ade9430_iio_init().
+ * @param desc - The iio device structure.
+ * @return 0 in case of success, error code otherwise.
+ */
+int ade9430_iio_remove(struct ade9430_iio_dev *desc)
+{
+	int ret;
+
+	ret = ade9430_remove(desc->ade9430_dev);
+	if (ret)
+		return ret;
+
+	no_os_free(desc);
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+/***************************************************************************//**
+ *   @file   iio_ade9430.h
+ *   @brief  Header file of IIO ADE9430 Driver.
+ *   @author Antoniu Miclaus (antoniu.miclaus@analog.com)
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef IIO_ADE9430_H
+#define IIO_ADE9430_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "iio.h"
+#include "ade9430.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/**
+ * @struct ade9430_iio_dev
+ * @brief ADE9430 IIO device structure.
+ */
+struct ade9430_iio_dev {
+	/** ADE9430 device structure */
+	struct ade9430_dev *ade9430_dev;
+	/** IIO device structure */
+	struct iio_device *iio_dev;
+	/** Waveform buffer configuration */
+	struct ade9430_wfb_cfg wfb_cfg;
+	/** Buffer channels mask */
+	uint32_t active_channels;
+	/** Packed scans read from the waveform buffer */
+	int32_t wfb_data[ADE9430_WFB_PAGES * ADE9430_WFB_PAGE_WORDS];
+	/** Number of scans in wfb_data */
+	uint32_t wfb_scans;
+	/** Next scan of wfb_data to be pushed */
+	uint32_t wfb_pos;
+};
+
+/**
+ * @struct ade9430_iio_dev_init_param
+ * @brief ADE9430 IIO device initialization parameters.
+ */
+struct ade9430_iio_dev_init_param {
+	/** ADE9430 device initialization parameters */
+	struct ade9430_init_param *ade9430_dev_init;
+	/** Waveform buffer configuration */
+	struct ade9430_wfb_cfg *wfb_cfg;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+/* Initialize the ADE9430 IIO driver. */
+int ade9430_iio_init(struct ade9430_iio_dev **iio_dev,
+		     struct ade9430_iio_dev_init_param *init_param);
+
+/* Free the resources allocated by ade9430_iio_init(). */
+int ade9430_iio_remove(struct ade9430_iio_dev *desc);
+
+#endif /* IIO_ADE9430_H */
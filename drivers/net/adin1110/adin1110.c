@@ -626,6 +626,239 @@ int adin1110_read_fifo(struct adin1110_desc *desc, uint32_t port,
 	return 0;
 }
 
+/**
+ * @brief Write a frame, stored in multiple memory segments, to the TX FIFO.
+ * The segments are sent straight from the caller's memory, chained in a single
+ * SPI transfer, without being copied to the descriptor's buffer.
+ * @param desc - the device descriptor
+ * @param port - the port for the frame to be transmitted on.
+ * @param frags - the memory segments of the frame, in order.
+ * @param nb_frags - the number of segments (at most ADIN1110_MAX_FRAGS).
+ * @return 0 in case of success, negative error code otherwise
+ */
+int adin1110_write_fifo_sg(struct adin1110_desc *desc, uint32_t port,
+			   struct adin1110_frag *frags, uint32_t nb_frags)
+{
+	/* Zero bytes sent after the frame, for padding and 4 byte alignment */
+	static uint8_t padding_buff[64];
+	struct no_os_spi_msg xfer[ADIN1110_MAX_FRAGS + 2] = {0};
+	uint32_t header_len = ADIN1110_WR_HEADER_LEN;
+	uint32_t frame_len = 0;
+	uint32_t padding = 0;
+	uint32_t padded_len;
+	uint32_t round_len;
+	uint32_t tx_space;
+	uint32_t nb_xfer;
+	uint32_t i;
+	int ret;
+
+	if (port >= driver_data[desc->chip_type].num_ports || !frags ||
+	    !nb_frags || nb_frags > ADIN1110_MAX_FRAGS)
+		return -EINVAL;
+
+	for (i = 0; i < nb_frags; i++)
+		frame_len += frags[i].len;
+
+	/* The minimum frame length is 64 bytes */
+	if (frame_len + ADIN1110_FCS_LEN < 64)
+		padding = 64 - (frame_len + ADIN1110_FCS_LEN);
+
+	padded_len = frame_len + padding + ADIN1110_FRAME_HEADER_LEN;
+
+	/** Align the frame length to 4 bytes */
+	round_len = no_os_align(padded_len, 4);
+
+	ret = adin1110_reg_read(desc, ADIN1110_TX_SPACE_REG, &tx_space);
+	if (ret)
+		return ret;
+
+	/* The tx_space value is expressed in 16 bit words. */
+	if (padded_len > 2 * (tx_space - ADIN1110_FRAME_HEADER_LEN))
+		return -EAGAIN;
+
+	ret = adin1110_reg_write(desc, ADIN1110_TX_FSIZE_REG, padded_len);
+	if (ret)
+		return ret;
+
+	no_os_put_unaligned_be16(ADIN1110_TX_REG, &desc->data[0]);
+	desc->data[0] |= ADIN1110_SPI_CD | ADIN1110_SPI_RW;
+
+	if (desc->append_crc) {
+		desc->data[2] = no_os_crc8(_crc_table, desc->data, 2, 0);
+		header_len++;
+	}
+
+	/* Set the port on which to send the frame */
+	no_os_put_unaligned_be16(port, &desc->data[header_len]);
+	xfer[0].tx_buff = desc->data;
+	xfer[0].bytes_number = header_len + ADIN1110_FRAME_HEADER_LEN;
+	nb_xfer = 1;
+
+	for (i = 0; i < nb_frags; i++) {
+		if (!frags[i].len)
+			continue;
+
+		xfer[nb_xfer].tx_buff = frags[i].data;
+		xfer[nb_xfer].bytes_number = frags[i].len;
+		nb_xfer++;
+	}
+
+	if (round_len > frame_len + ADIN1110_FRAME_HEADER_LEN) {
+		xfer[nb_xfer].tx_buff = padding_buff;
+		xfer[nb_xfer].bytes_number = round_len - frame_len -
+					     ADIN1110_FRAME_HEADER_LEN;
+		nb_xfer++;
+	}
+
+	xfer[nb_xfer - 1].cs_change = 1;
+
+	return no_os_spi_transfer(desc->comm_desc, xfer, nb_xfer);
+}
+
+/**
+ * @brief Get the length of the next frame in the RX FIFO.
+ * @param desc - the device descriptor
+ * @param port - the port from which the frame shall be received.
+ * @param len - the frame length (without the frame header), 0 if the FIFO is
+ * 		empty.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int adin1110_rx_frame_len(struct adin1110_desc *desc, uint32_t port,
+			  uint32_t *len)
+{
+	uint32_t frame_size;
+	int ret;
+
+	if (port >= driver_data[desc->chip_type].num_ports)
+		return -EINVAL;
+
+	ret = adin1110_reg_read(desc, port ? ADIN2111_RX_P2_FSIZE_REG :
+				ADIN1110_RX_FSIZE_REG, &frame_size);
+	if (ret)
+		return ret;
+
+	if (frame_size < ADIN1110_FRAME_HEADER_LEN + ADIN1110_FEC_LEN)
+		*len = 0;
+	else
+		*len = frame_size - ADIN1110_FRAME_HEADER_LEN;
+
+	return 0;
+}
+
+/**
+ * @brief Read the next frame from the RX FIFO straight into multiple memory
+ * segments. Since the FIFO is read in multiples of 4 bytes, the segments
+ * have to hold up to ADIN1110_RD_SLACK bytes more than the frame length.
+ * @param desc - the device descriptor
+ * @param port - the port from which the frame shall be received.
+ * @param frags - the memory segments to be filled, in order.
+ * @param nb_frags - the number of segments (at most ADIN1110_MAX_FRAGS).
+ * @param len - the frame length returned by adin1110_rx_frame_len().
+ * @return 0 in case of success, negative error code otherwise
+ */
+int adin1110_read_fifo_sg(struct adin1110_desc *desc, uint32_t port,
+			  struct adin1110_frag *frags, uint32_t nb_frags,
+			  uint32_t len)
+{
+	struct no_os_spi_msg xfer[ADIN1110_MAX_FRAGS + 1] = {0};
+	uint32_t field_offset = ADIN1110_RD_HEADER_LEN;
+	uint32_t remaining;
+	uint32_t nb_xfer;
+	uint32_t i;
+
+	if (port >= driver_data[desc->chip_type].num_ports || !frags ||
+	    !nb_frags || nb_frags > ADIN1110_MAX_FRAGS || !len)
+		return -EINVAL;
+
+	/* Can only read multiples of 4 bytes (the last bytes might be 0) */
+	remaining = no_os_align(len + ADIN1110_FRAME_HEADER_LEN, 4) -
+		    ADIN1110_FRAME_HEADER_LEN;
+
+	no_os_put_unaligned_be16(port ? ADIN2111_RX_P2_REG : ADIN1110_RX_REG,
+				 &desc->data[0]);
+	desc->data[0] |= ADIN1110_SPI_CD;
+	desc->data[2] = 0x0;
+
+	if (desc->append_crc) {
+		desc->data[2] = no_os_crc8(_crc_table, desc->data, 2, 0);
+		desc->data[3] = 0x0;
+		field_offset++;
+	}
+
+	/* The frame header is read in the descriptor's buffer and dropped */
+	no_os_put_unaligned_be16(port, &desc->data[field_offset]);
+	xfer[0].tx_buff = desc->data;
+	xfer[0].rx_buff = desc->data;
+	xfer[0].bytes_number = field_offset + ADIN1110_FRAME_HEADER_LEN;
+	nb_xfer = 1;
+
+	for (i = 0; i < nb_frags && remaining; i++) {
+		if (!frags[i].len)
+			continue;
+
+		xfer[nb_xfer].tx_buff = frags[i].data;
+		xfer[nb_xfer].rx_buff = frags[i].data;
+		xfer[nb_xfer].bytes_number = no_os_min(frags[i].len, remaining);
+		remaining -= xfer[nb_xfer].bytes_number;
+		nb_xfer++;
+	}
+
+	if (remaining)
+		return -EINVAL;
+
+	xfer[nb_xfer - 1].cs_change = 1;
+
+	return no_os_spi_transfer(desc->comm_desc, xfer, nb_xfer);
+}
+
+/**
+ * @brief Check whether the RX FIFO has to be drained. Without an INT pin, the
+ * FIFO always has to be checked. Otherwise, only after an RX_RDY interrupt.
+ * @param desc - the device descriptor
+ * @param pending - true if the RX FIFO has to be drained.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int adin1110_rx_pending(struct adin1110_desc *desc, bool *pending)
+{
+	uint32_t status = ADIN1110_RX_RDY;
+	int ret;
+
+	if (!desc->irq_ctrl) {
+		*pending = true;
+		return 0;
+	}
+
+	*pending = desc->rx_irq;
+	if (!*pending)
+		return 0;
+
+	desc->rx_irq = false;
+
+	if (desc->chip_type == ADIN2111)
+		status |= ADIN2111_P2_RX_RDY;
+
+	/*
+	 * Clear RX_RDY before the FIFO is drained, so that a frame received in
+	 * the meantime asserts the INT pin again.
+	 */
+	ret = adin1110_reg_write(desc, ADIN1110_STATUS1_REG, status);
+	if (ret)
+		adin1110_rx_restore(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Flag the RX FIFO to be drained again. To be called when draining
+ * stopped on an error, since the frames left in the FIFO will not assert the
+ * INT pin again.
+ * @param desc - the device descriptor
+ */
+void adin1110_rx_restore(struct adin1110_desc *desc)
+{
+	desc->rx_irq = true;
+}
+
 /**
  * @brief Reset the MAC device.
  * @param desc - the device descriptor
@@ -840,6 +1073,82 @@ static int adin1110_setup_mac(struct adin1110_desc *desc)
 	return adin1110_set_mac_addr(desc, desc->mac_address);
 }
 
+/**
+ * @brief INT pin interrupt handler. Only flags the RX FIFO to be drained.
+ * @param ctx - the device descriptor
+ */
+static void adin1110_irq_handler(void *ctx)
+{
+	struct adin1110_desc *desc = ctx;
+
+	desc->rx_irq = true;
+}
+
+/**
+ * @brief Route only the RX_RDY interrupts to the INT pin and register its
+ * interrupt handler.
+ * @param desc - the device descriptor
+ * @param param - the device's parameter
+ * @return 0 in case of success, negative error code otherwise
+ */
+static int adin1110_setup_irq(struct adin1110_desc *desc,
+			      struct adin1110_init_param *param)
+{
+	uint32_t reg_val = ADIN1110_RX_RDY_IRQ;
+	int ret;
+
+	if (desc->chip_type == ADIN2111)
+		reg_val |= ADIN2111_RX_RDY_IRQ;
+
+	ret = adin1110_reg_write(desc, ADIN1110_IMASK1_REG, ~reg_val);
+	if (ret)
+		return ret;
+
+	ret = no_os_gpio_get(&desc->int_gpio, param->int_param);
+	if (ret)
+		return ret;
+
+	ret = no_os_gpio_direction_input(desc->int_gpio);
+	if (ret)
+		goto free_int_gpio;
+
+	desc->irq_cb.callback = adin1110_irq_handler;
+	desc->irq_cb.ctx = desc;
+	desc->irq_cb.event = NO_OS_EVT_GPIO;
+	desc->irq_cb.peripheral = NO_OS_GPIO_IRQ;
+
+	ret = no_os_irq_register_callback(param->irq_ctrl, desc->int_gpio->number,
+					  &desc->irq_cb);
+	if (ret)
+		goto free_int_gpio;
+
+	ret = no_os_irq_trigger_level_set(param->irq_ctrl, desc->int_gpio->number,
+					  NO_OS_IRQ_EDGE_FALLING);
+	if (ret)
+		goto unregister_cb;
+
+	/* Frames might have been received before the handler was registered */
+	desc->rx_irq = true;
+	desc->irq_ctrl = param->irq_ctrl;
+
+	ret = no_os_irq_enable(param->irq_ctrl, desc->int_gpio->number);
+	if (ret)
+		goto clear_irq_ctrl;
+
+	return 0;
+
+clear_irq_ctrl:
+	desc->irq_ctrl = NULL;
+unregister_cb:
+	no_os_irq_unregister_callback(param->irq_ctrl, desc->int_gpio->number,
+				      &desc->irq_cb);
+free_int_gpio:
+	no_os_gpio_remove(desc->int_gpio);
+	desc->int_gpio = NULL;
+
+	return ret;
+}
+
 /**
  * @brief Initialize the device
  * @param desc - the device descriptor to be initialized
@@ -915,6 +1224,12 @@ int adin1110_init(struct adin1110_desc **desc,
 	if (ret)
 		goto free_spi;
 
+	if (param->int_param && param->irq_ctrl) {
+		ret = adin1110_setup_irq(descriptor, param);
+		if (ret)
+			goto free_spi;
+	}
+
 	*desc = descriptor;
 
 	return 0;
@@ -941,6 +1256,22 @@ int adin1110_remove(struct adin1110_desc *desc)
 	if (!desc)
 		return -EINVAL;
 
+	if (desc->irq_ctrl) {
+		ret = no_os_irq_disable(desc->irq_ctrl, desc->int_gpio->number);
+		if (ret)
+			return ret;
+
+		ret = no_os_irq_unregister_callback(desc->irq_ctrl,
+						    desc->int_gpio->number,
+						    &desc->irq_cb);
+		if (ret)
+			return ret;
+
+		ret = no_os_gpio_remove(desc->int_gpio);
+		if (ret)
+			return ret;
+	}
+
 	ret = no_os_spi_remove(desc->comm_desc);
 	if (ret)
 		return ret;
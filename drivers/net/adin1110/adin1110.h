@@ -37,6 +37,7 @@
 #include <stdbool.h>
 #include "no_os_spi.h"
 #include "no_os_gpio.h"
+#include "no_os_irq.h"
 #include "no_os_util.h"
 
 #define ADIN1110_BUFF_LEN			1530
@@ -179,6 +180,11 @@
 #define ADIN1110_CRC_LEN			1
 #define ADIN1110_FEC_LEN			4
 
+/* Maximum number of memory segments of a scatter-gather FIFO access */
+#define ADIN1110_MAX_FRAGS			8
+/* Bytes a FIFO read may write past the end of the frame (4 byte bursts) */
+#define ADIN1110_RD_SLACK			3
+
 #define ADIN_MAC_MULTICAST_ADDR_SLOT		0
 #define ADIN_MAC_BROADCAST_ADDR_SLOT		1
 #define ADIN_MAC_P1_ADDR_SLOT			2
@@ -203,6 +209,14 @@ struct adin1110_desc {
 	uint8_t data[ADIN1110_BUFF_LEN];
 	struct no_os_gpio_desc *reset_gpio;
 	bool append_crc;
+	struct no_os_gpio_desc *int_gpio;
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	struct no_os_callback_desc irq_cb;
+	/*
+	 * Set by the INT pin interrupt and by adin1110_rx_restore(), cleared by
+	 * adin1110_rx_pending()
+	 */
+	volatile bool rx_irq;
 };
 
 /**
@@ -214,6 +228,12 @@ struct adin1110_init_param {
 	struct no_os_gpio_init_param reset_param;
 	uint8_t mac_address[ADIN1110_ETH_ALEN];
 	bool append_crc;
+	/*
+	 * Optional INT pin. When set together with irq_ctrl, the RX FIFO is
+	 * only accessed after an RX_RDY interrupt.
+	 */
+	struct no_os_gpio_init_param *int_param;
+	struct no_os_irq_ctrl_desc *irq_ctrl;
 };
 
 /**
@@ -227,6 +247,14 @@ struct adin1110_eth_buff {
 	uint8_t *payload;
 };
 
+/**
+ * @brief Memory segment of a frame, used for scatter-gather FIFO accesses.
+ */
+struct adin1110_frag {
+	uint8_t *data;
+	uint32_t len;
+};
+
 /* Reset both the MAC and PHY. */
 int adin1110_sw_reset(struct adin1110_desc *);
 
@@ -247,6 +275,23 @@ int adin1110_write_fifo(struct adin1110_desc *, uint32_t,
 int adin1110_read_fifo(struct adin1110_desc *, uint32_t,
 		       struct adin1110_eth_buff *);
 
+/* Write a frame, stored in multiple memory segments, to the TX FIFO */
+int adin1110_write_fifo_sg(struct adin1110_desc *, uint32_t,
+			   struct adin1110_frag *, uint32_t);
+
+/* Get the length of the next frame in the RX FIFO (0 if empty) */
+int adin1110_rx_frame_len(struct adin1110_desc *, uint32_t, uint32_t *);
+
+/* Read the next frame from the RX FIFO into multiple memory segments */
+int adin1110_read_fifo_sg(struct adin1110_desc *, uint32_t,
+			  struct adin1110_frag *, uint32_t, uint32_t);
+
+/* Check whether the RX FIFO has to be drained */
+int adin1110_rx_pending(struct adin1110_desc *, bool *);
+
+/* Flag the RX FIFO to be drained again after a failed drain */
+void adin1110_rx_restore(struct adin1110_desc *);
+
 /* Write a PHY register using clause 22 */
 int adin1110_mdio_write(struct adin1110_desc *, uint32_t, uint32_t, uint16_t);
 
@@ -35,6 +35,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <sys/alt_alarm.h>
 #include "no_os_delay.h"
 
 /******************************************************************************/
@@ -60,3 +61,19 @@ void no_os_mdelay(uint32_t msecs)
 {
 	usleep(msecs * 1000);
 }
+
+/**
+ * @brief Get current time.
+ * @return Current time structure from system start (seconds, microseconds).
+ */
+struct no_os_time no_os_get_time(void)
+{
+	struct no_os_time t;
+	uint64_t ticks = alt_nticks();
+	uint32_t rate = alt_ticks_per_second();
+
+	t.s = ticks / rate;
+	t.us = (ticks % rate) * 1000000 / rate;
+
+	return t;
+}
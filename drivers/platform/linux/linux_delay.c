@@ -36,7 +36,9 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include <time.h>
 #include <unistd.h>
+#include "no_os_delay.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -61,3 +63,19 @@ void no_os_mdelay(uint32_t msecs)
 {
 	usleep(msecs * 1000);
 }
+
+/**
+ * @brief Get current time.
+ * @return Current time structure from system start (seconds, microseconds).
+ */
+struct no_os_time no_os_get_time(void)
+{
+	struct no_os_time t;
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t.s = ts.tv_sec;
+	t.us = ts.tv_nsec / 1000;
+
+	return t;
+}
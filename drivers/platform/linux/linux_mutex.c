@@ -0,0 +1,103 @@
+/***************************************************************************//**
+ *   @file   linux/linux_mutex.c
+ *   @brief  Implementation of the no-OS mutex API using POSIX threads.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <pthread.h>
+#include "no_os_mutex.h"
+#include "no_os_alloc.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize mutex.
+ * @param mutex - Pointer toward the mutex.
+ * @return None.
+ */
+void no_os_mutex_init(void **mutex)
+{
+	pthread_mutex_t *lmutex;
+
+	if (*mutex)
+		return;
+
+	lmutex = (pthread_mutex_t *)no_os_calloc(1, sizeof(*lmutex));
+	if (!lmutex)
+		return;
+
+	if (pthread_mutex_init(lmutex, NULL)) {
+		no_os_free(lmutex);
+		return;
+	}
+
+	*mutex = lmutex;
+}
+
+/**
+ * @brief Lock mutex.
+ * @param mutex - Pointer toward the mutex.
+ * @return None.
+ */
+void no_os_mutex_lock(void *mutex)
+{
+	if (mutex)
+		pthread_mutex_lock((pthread_mutex_t *)mutex);
+}
+
+/**
+ * @brief Unlock mutex.
+ * @param mutex - Pointer toward the mutex.
+ * @return None.
+ */
+void no_os_mutex_unlock(void *mutex)
+{
+	if (mutex)
+		pthread_mutex_unlock((pthread_mutex_t *)mutex);
+}
+
+/**
+ * @brief Remove mutex.
+ * @param mutex - Pointer toward the mutex.
+ * @return None.
+ */
+void no_os_mutex_remove(void *mutex)
+{
+	if (mutex) {
+		pthread_mutex_destroy((pthread_mutex_t *)mutex);
+		no_os_free(mutex);
+	}
+}
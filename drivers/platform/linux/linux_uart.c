@@ -36,14 +36,24 @@
 /******************************************************************************/
 #include "no_os_error.h"
 #include "no_os_alloc.h"
+#include "no_os_util.h"
 #include "linux_uart.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <termios.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <asm/termbits.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Maximum difference between the requested and the set baud rate (%) */
+#define LINUX_UART_BAUD_TOLERANCE	2
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -57,7 +67,9 @@ struct linux_uart_desc {
 	/** /dev/"device_id" file descriptor */
 	int fd;
 	/** structure containing the terminal flags/settings */
-	struct termios *terminal;
+	struct termios2 *terminal;
+	/** If set, reads return the available data instead of blocking */
+	bool asynchronous_rx;
 };
 
 /******************************************************************************/
@@ -66,6 +78,8 @@ struct linux_uart_desc {
 
 /**
  * @brief Initialize the UART communication peripheral.
+ * The baud rate is set with BOTHER, so any rate supported by the UART
+ * driver can be used, not only the standard termios ones.
  * @param desc - The UART descriptor.
  * @param param - The structure that contains the UART parameters.
  * @return 0 in case of success, error code otherwise.
@@ -76,34 +90,43 @@ static int32_t linux_uart_init(struct no_os_uart_desc **desc,
 	struct linux_uart_init_param *linux_init;
 	struct linux_uart_desc *linux_desc;
 	struct no_os_uart_desc *descriptor;
-	speed_t speed;
+	struct termios2 *terminal;
+	uint32_t diff;
 	char path[64];
 	int ret;
 
-	descriptor = no_os_malloc(sizeof(*descriptor));
+	if (!param->baud_rate)
+		return -EINVAL;
+
+	descriptor = no_os_calloc(1, sizeof(*descriptor));
 	if (!descriptor)
 		return -ENOMEM;
 
-	linux_desc = (struct linux_uart_desc*) no_os_malloc(sizeof(
+	linux_desc = (struct linux_uart_desc*) no_os_calloc(1, sizeof(
 				struct linux_uart_desc));
 	if (!linux_desc) {
 		ret = -ENOMEM;
 		goto free_desc;
 	}
 
-	linux_desc->terminal = (struct termios*) no_os_malloc(sizeof(struct termios));
+	linux_desc->terminal = (struct termios2*) no_os_malloc(sizeof(
+				       struct termios2));
 	if (!linux_desc->terminal) {
 		ret = -ENOMEM;
 		goto free_linux_desc;
 	}
+	terminal = linux_desc->terminal;
 
 	descriptor->extra = linux_desc;
+	descriptor->device_id = param->device_id;
+	descriptor->baud_rate = param->baud_rate;
+	linux_desc->asynchronous_rx = param->asynchronous_rx;
 	linux_init = param->extra;
 
 	ret = snprintf(path, sizeof(path), "/dev/%s", linux_init->device_id);
 	if (ret < 0 || ret >= (int)sizeof(path)) {
 		ret = -ENOMEM;
-		goto free_linux_desc;
+		goto free_terminal;
 	}
 
 	linux_desc->fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
@@ -113,92 +136,54 @@ static int32_t linux_uart_init(struct no_os_uart_desc **desc,
 		goto free_terminal;
 	}
 
-	tcgetattr(linux_desc->fd, linux_desc->terminal);
-
-	cfmakeraw(linux_desc->terminal);
-
-	switch(param->baud_rate) {
-	case 50:
-		speed = B50;
-		break;
-	case 75:
-		speed = B75;
-		break;
-	case 110:
-		speed = B110;
-		break;
-	case 134:
-		speed = B134;
-		break;
-	case 150:
-		speed = B150;
-		break;
-	case 200:
-		speed = B200;
-		break;
-	case 300:
-		speed = B300;
-		break;
-	case 600:
-		speed = B600;
-		break;
-	case 1200:
-		speed = B1200;
-		break;
-	case 1800:
-		speed = B1800;
-		break;
-	case 2400:
-		speed = B2400;
-		break;
-	case 4800:
-		speed = B4800;
-		break;
-	case 9600:
-		speed = B9600;
-		break;
-	case 19200:
-		speed = B19200;
-		break;
-	case 38400:
-		speed = B38400;
-		break;
-	default:
-		ret = -EINVAL;
+	ret = ioctl(linux_desc->fd, TCGETS2, terminal);
+	if (ret < 0) {
+		ret = -errno;
 		goto free;
 	}
-	cfsetispeed(linux_desc->terminal, speed);
-	cfsetospeed(linux_desc->terminal, speed);
 
-	linux_desc->terminal->c_cflag &= ~CSIZE;
+	/* Raw mode */
+	terminal->c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR |
+			       IGNCR | ICRNL | IXON);
+	terminal->c_oflag &= ~OPOST;
+	terminal->c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+	terminal->c_cc[VMIN] = 1;
+	terminal->c_cc[VTIME] = 0;
+
+	terminal->c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+	terminal->c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+	terminal->c_ispeed = param->baud_rate;
+	terminal->c_ospeed = param->baud_rate;
+
+	terminal->c_cflag &= ~CSIZE;
 	switch(param->size) {
 	case NO_OS_UART_CS_5:
-		linux_desc->terminal->c_cflag |= CS5;
+		terminal->c_cflag |= CS5;
 		break;
 	case NO_OS_UART_CS_6:
-		linux_desc->terminal->c_cflag |= CS6;
+		terminal->c_cflag |= CS6;
 		break;
 	case NO_OS_UART_CS_7:
-		linux_desc->terminal->c_cflag |= CS7;
+		terminal->c_cflag |= CS7;
 		break;
 	case NO_OS_UART_CS_8:
-		linux_desc->terminal->c_cflag |= CS8;
+		terminal->c_cflag |= CS8;
 		break;
 	default:
 		ret = -EINVAL;
 		goto free;
 	}
 
-	linux_desc->terminal->c_cflag &= ~PARENB;
-	linux_desc->terminal->c_cflag &= ~PARODD;
+	terminal->c_cflag &= ~PARENB;
+	terminal->c_cflag &= ~PARODD;
 	switch(param->parity) {
 	case NO_OS_UART_PAR_NO:
 		break;
 	case NO_OS_UART_PAR_ODD:
-		linux_desc->terminal->c_cflag |= PARODD;
+		terminal->c_cflag |= PARENB | PARODD;
 		break;
 	case NO_OS_UART_PAR_EVEN:
-		linux_desc->terminal->c_cflag |= PARENB;
+		terminal->c_cflag |= PARENB;
 		break;
 	default:
 		ret = -EINVAL;
@@ -206,15 +191,33 @@ static int32_t linux_uart_init(struct no_os_uart_desc **desc,
 	}
 
 	if (param->stop == NO_OS_UART_STOP_1_BIT)
-		linux_desc->terminal->c_cflag &= ~CSTOPB;
+		terminal->c_cflag &= ~CSTOPB;
 	else
-		linux_desc->terminal->c_cflag |= CSTOPB;
+		terminal->c_cflag |= CSTOPB;
 
-	linux_desc->terminal->c_cflag |= CREAD;
+	terminal->c_cflag |= CREAD | CLOCAL;
 
-	tcsetattr(linux_desc->fd, TCSANOW, linux_desc->terminal);
+	ret = ioctl(linux_desc->fd, TCSETS2, terminal);
+	if (ret < 0) {
+		ret = -errno;
+		goto free;
+	}
 
-	tcflush(linux_desc->fd, TCIOFLUSH);
+	/* The driver may round the rate, check that it is still usable */
+	ret = ioctl(linux_desc->fd, TCGETS2, terminal);
+	if (ret < 0) {
+		ret = -errno;
+		goto free;
+	}
+	diff = abs((int)terminal->c_ospeed - (int)param->baud_rate);
+	if (diff * 100 > param->baud_rate * LINUX_UART_BAUD_TOLERANCE) {
+		printf("%s: Can't set %u baud\n\r", __func__,
+		       (unsigned)param->baud_rate);
+		ret = -EINVAL;
+		goto free;
+	}
+
+	ioctl(linux_desc->fd, TCFLSH, TCIOFLUSH);
 
 	*desc = descriptor;
 
@@ -232,6 +235,52 @@ free_desc:
 	return ret;
 };
 
+/**
+ * @brief Change the baud rate, keeping the other terminal settings.
+ * @param desc - The UART descriptor.
+ * @param baud_rate - The new baud rate.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int32_t linux_uart_set_baud(struct no_os_uart_desc *desc,
+				   uint32_t baud_rate)
+{
+	struct linux_uart_desc *linux_desc = desc->extra;
+	struct termios2 *terminal = linux_desc->terminal;
+	uint32_t diff;
+	int ret;
+
+	ret = ioctl(linux_desc->fd, TCGETS2, terminal);
+	if (ret < 0)
+		return -errno;
+
+	terminal->c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+	terminal->c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+	terminal->c_ispeed = baud_rate;
+	terminal->c_ospeed = baud_rate;
+
+	ret = ioctl(linux_desc->fd, TCSETS2, terminal);
+	if (ret < 0)
+		return -errno;
+
+	/* The driver may round the rate, check that it is still usable */
+	ret = ioctl(linux_desc->fd, TCGETS2, terminal);
+	if (ret < 0)
+		return -errno;
+
+	diff = abs((int)terminal->c_ospeed - (int)baud_rate);
+	if (diff * 100 <= baud_rate * LINUX_UART_BAUD_TOLERANCE)
+		return 0;
+
+	printf("%s: Can't set %u baud\n\r", __func__, (unsigned)baud_rate);
+
+	/* Go back to the current rate */
+	terminal->c_ispeed = desc->baud_rate;
+	terminal->c_ospeed = desc->baud_rate;
+	ioctl(linux_desc->fd, TCSETS2, terminal);
+
+	return -EINVAL;
+}
+
 /**
  * @brief Free the resources allocated by linux_uart_init().
  * @param desc - The UART descriptor.
@@ -248,18 +297,36 @@ static int32_t linux_uart_remove(struct no_os_uart_desc *desc)
 	if (ret < 0)
 		printf("%s: Can't close device\n\r", __func__);
 
+	no_os_free(linux_desc->terminal);
 	no_os_free(desc->extra);
 	no_os_free(desc);
 
 	return 0;
 };
 
+/* Wait until the file descriptor is ready for the given events */
+static int32_t linux_uart_poll(struct linux_uart_desc *linux_desc,
+			       short events)
+{
+	struct pollfd pfd = {
+		.fd = linux_desc->fd,
+		.events = events
+	};
+	int ret;
+
+	do {
+		ret = poll(&pfd, 1, -1);
+	} while (ret < 0 && errno == EINTR);
+
+	return ret < 0 ? -errno : 0;
+}
+
 /**
  * @brief Write data to UART device.
  * @param desc - Instance of UART.
  * @param data - Pointer to buffer containing data.
- * @param bytes_number - Number of bytes to read.
- * @return 0 in case of success, -1 otherwise.
+ * @param bytes_number - Number of bytes to write.
+ * @return Number of bytes written in case of success, error code otherwise.
  */
 static int32_t linux_uart_write(struct no_os_uart_desc *desc,
 				const uint8_t *data,
@@ -272,20 +339,30 @@ static int32_t linux_uart_write(struct no_os_uart_desc *desc,
 	linux_desc = desc->extra;
 
 	while (count < bytes_number) {
-		ret = write(linux_desc->fd, data, bytes_number);
-		if (ret > 0)
+		ret = write(linux_desc->fd, data + count, bytes_number - count);
+		if (ret > 0) {
 			count += ret;
+			continue;
+		}
+		if (ret < 0 && errno != EAGAIN && errno != EINTR)
+			return -errno;
+
+		ret = linux_uart_poll(linux_desc, POLLOUT);
+		if (ret)
+			return ret;
 	}
 
-	return 0;
+	return count;
 };
 
 /**
  * @brief Read data from UART device.
+ * With asynchronous_rx set, only the data already received is returned.
  * @param desc - Instance of UART.
  * @param data - Pointer to buffer containing data.
  * @param bytes_number - Number of bytes to read.
- * @return 0 in case of success, -1 otherwise.
+ * @return Number of bytes read in case of success, -EAGAIN if asynchronous_rx
+ * is set and no data is available, error code otherwise.
  */
 static int32_t linux_uart_read(struct no_os_uart_desc *desc, uint8_t *data,
 			       uint32_t bytes_number)
@@ -298,11 +375,24 @@ static int32_t linux_uart_read(struct no_os_uart_desc *desc, uint8_t *data,
 
 	while (count < bytes_number) {
 		ret = read(linux_desc->fd, &data[count], bytes_number - count);
-		if (ret > 0)
+		if (ret > 0) {
 			count += ret;
+			if (linux_desc->asynchronous_rx)
+				break;
+			continue;
+		}
+		if (ret < 0 && errno != EAGAIN && errno != EINTR)
+			return -errno;
+
+		if (linux_desc->asynchronous_rx)
+			return -EAGAIN;
+
+		ret = linux_uart_poll(linux_desc, POLLIN);
+		if (ret)
+			return ret;
 	}
 
-	return 0;
+	return count;
 };
 
 /**
@@ -312,5 +402,6 @@ const struct no_os_uart_platform_ops linux_uart_ops = {
 	.init = &linux_uart_init,
 	.read = &linux_uart_read,
 	.write = &linux_uart_write,
-	.remove = &linux_uart_remove
+	.remove = &linux_uart_remove,
+	.set_baud = &linux_uart_set_baud
 };
@@ -41,6 +41,7 @@
 #include "no_os_delay.h"
 #include "no_os_error.h"
 #include "no_os_alloc.h"
+#include "no_os_util.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -54,6 +55,7 @@
 
 #define CMD0_RETRY_NUMBER		(5u)
 #define WAIT_RESP_TIMEOUT		(1000u) //1000ms
+#define FAST_POLL_NUMBER		(512u)  //Polls before sleeping
 
 #define R1_READY_STATE			(0x00u)
 #define R1_IDLE_STATE			(0x01u)
@@ -70,6 +72,7 @@
 #define STUFF_ARG			(0x00000000u)
 #define CMD8_ARG			(0x000001AAu)
 #define ACMD41_ARG			(0x40000000u)
+#define ACMD23_ARG_MASK			(0x007FFFFFu)
 
 #define DATA_BLOCK_BITS			(9u)
 #define MASK_ADDR_IN_BLOCK		(DATA_BLOCK_LEN - 1u)
@@ -95,22 +98,26 @@
 static int32_t wait_for_response(struct sd_desc *sd_desc, uint8_t *data_out)
 {
 	uint32_t	not_timeout;
-	int32_t		ret;
+	uint32_t	fast_polls;
 
-	ret = -1;
 	not_timeout = WAIT_RESP_TIMEOUT;
-	do {
+	fast_polls = FAST_POLL_NUMBER;
+	while (true) {
+		*data_out = 0xFF;
 		if (0 != no_os_spi_write_and_read(sd_desc->spi_desc,
 						  data_out, 1))
-			break;
-		if (*data_out != 0xFF) {
-			ret = 0;
-			break;
+			return -1;
+		if (*data_out != 0xFF)
+			return 0;
+		/* Most answers come in a few bytes, don't sleep for them */
+		if (fast_polls) {
+			fast_polls--;
+			continue;
 		}
+		if (!not_timeout--)
+			return -1;
 		no_os_mdelay(1);
-	} while (not_timeout--);
-
-	return ret;
+	}
 }
 
 /**
@@ -121,23 +128,76 @@ static int32_t wait_for_response(struct sd_desc *sd_desc, uint8_t *data_out)
 static int32_t wait_until_not_busy(struct sd_desc *sd_desc)
 {
 	uint32_t	not_timeout;
-	int32_t		ret;
+	uint32_t	fast_polls;
 	uint8_t		data;
 
-	ret = -1;
 	not_timeout = WAIT_RESP_TIMEOUT;
-	do {
+	fast_polls = FAST_POLL_NUMBER;
+	while (true) {
 		data = 0xFF;
 		if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, &data, 1))
-			break;
-		if (data != 0x00) {
-			ret = 0;
-			break;
+			return -1;
+		if (data != 0x00)
+			return 0;
+		/* Programming a block usually takes less than a millisecond */
+		if (fast_polls) {
+			fast_polls--;
+			continue;
 		}
+		if (!not_timeout--)
+			return -1;
 		no_os_mdelay(1);
-	} while (not_timeout--);
+	}
+}
 
-	return ret;
+/**
+ * Wait for the card to finish programming the last written block. The wait
+ * is deferred until the next access, so the card programs while the caller
+ * prepares the next data.
+ * @param sd_desc - Instance of the SD card
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t wait_ready(struct sd_desc *sd_desc)
+{
+	if (!sd_desc->busy)
+		return 0;
+
+	if (0 != wait_until_not_busy(sd_desc))
+		return -1;
+	sd_desc->busy = false;
+
+	return 0;
+}
+
+/**
+ * Exchange a data buffer with the SD card, using DMA if enabled. DMA is
+ * disabled at the first transfer if the platform doesn't implement it.
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Data sent, overwritten with the received data
+ * @param len		- Length of data
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t transfer_data(struct sd_desc *sd_desc, uint8_t *data,
+			     uint32_t len)
+{
+	struct no_os_spi_msg	msg = {
+		.tx_buff = data,
+		.rx_buff = data,
+		.bytes_number = len,
+	};
+	int32_t			ret;
+
+	if (sd_desc->dma) {
+		ret = no_os_spi_transfer_dma_sync(sd_desc->spi_desc, &msg, 1);
+		if (ret != -ENOSYS)
+			return ret ? -1 : 0;
+		sd_desc->dma = false;
+	}
+
+	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, data, len))
+		return -1;
+
+	return 0;
 }
 
 /**
@@ -170,12 +230,16 @@ static int32_t send_command(struct sd_desc *sd_desc, struct cmd_desc *cmd_desc)
 		cmd_desc_local.response_len = R1_LEN;
 		if (0 != send_command(sd_desc, &cmd_desc_local))
 			return -1;
-		if (cmd_desc_local.response[0] != R1_IDLE_STATE) {
+		/* Idle during the initialization, ready afterwards */
+		if (cmd_desc_local.response[0] & ~R1_IDLE_STATE) {
 			DEBUG_MSG("Not the expected response for CMD55\n");
 			return -1;
 		}
 	}
 
+	if (0 != wait_ready(sd_desc))
+		return -1;
+
 	/* Prepare command in buffer */
 	memset((uint8_t *)sd_desc->buff, 0xFF, CMD_LEN);
 	sd_desc->buff[1] = cmd_desc->cmd & (~BIT_APPLICATION_CMD);	/* Set cmd */
@@ -206,27 +270,28 @@ static int32_t send_command(struct sd_desc *sd_desc, struct cmd_desc *cmd_desc)
 }
 
 /**
- * Send one block of data to the SD card
+ * Send one block of data to the SD card. The function doesn't wait for the
+ * card to program the block, the next access does.
  * @param sd_desc	- Instance of the SD card
  * @param data		- Data to be written
  * @param nb_of_blocks	- Number of blocks written in the executing command
  * @return 0 in case of success, -1 otherwise.
  */
-static int32_t write_block(struct sd_desc *sd_desc, uint8_t *data,
+static int32_t write_block(struct sd_desc *sd_desc, const uint8_t *data,
 			   uint32_t nb_of_blocks)
 {
-	/* Send start block token */
-	sd_desc->buff[0] = START_N_BLOCK_TOKEN;
-	if (nb_of_blocks == 1)
-		sd_desc->buff[0] = START_1_BLOCK_TOKEN;
-	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 1))
+	if (0 != wait_ready(sd_desc))
 		return -1;
 
-	/* Send data with CRC */
-	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, data, DATA_BLOCK_LEN))
-		return -1;
-	*((uint16_t *)sd_desc->buff) = 0xFFFF;
-	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, CRC_LEN))
+	/* Send start block token, data and CRC at once. The copy keeps the
+	 * SPI from overwriting the user data with the received bytes. */
+	sd_desc->block[0] = START_N_BLOCK_TOKEN;
+	if (nb_of_blocks == 1)
+		sd_desc->block[0] = START_1_BLOCK_TOKEN;
+	memcpy(sd_desc->block + 1, data, DATA_BLOCK_LEN);
+	sd_desc->block[DATA_BLOCK_LEN + 1] = 0xFF;
+	sd_desc->block[DATA_BLOCK_LEN + 2] = 0xFF;
+	if (0 != transfer_data(sd_desc, sd_desc->block, sizeof(sd_desc->block)))
 		return -1;
 
 	/* Read response and check if write was ok */
@@ -246,8 +311,7 @@ static int32_t write_block(struct sd_desc *sd_desc, uint8_t *data,
 		DEBUG_MSG("Other problem\n");
 		return -1;
 	}
-	if (0 != wait_until_not_busy(sd_desc))
-		return -1;
+	sd_desc->busy = true;
 
 	return 0;
 }
@@ -292,7 +356,7 @@ static int32_t read_block(struct sd_desc *sd_desc, uint8_t *data)
 
 	/* Read data block */
 	memset(data, 0xff, DATA_BLOCK_LEN);
-	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, data, DATA_BLOCK_LEN))
+	if (0 != transfer_data(sd_desc, data, DATA_BLOCK_LEN))
 		return -1;
 
 	/* Read crc*/
@@ -303,6 +367,29 @@ static int32_t read_block(struct sd_desc *sd_desc, uint8_t *data)
 	return 0;
 }
 
+/**
+ * Send the stop transmission token of an open multiple block write
+ * @param sd_desc	- Instance of the SD card
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t stop_write(struct sd_desc *sd_desc)
+{
+	if (!sd_desc->wr_open)
+		return 0;
+
+	sd_desc->wr_open = false;
+	if (0 != wait_ready(sd_desc))
+		return -1;
+
+	sd_desc->buff[0] = STOP_TRANSMISSION_TOKEN;
+	sd_desc->buff[1] = 0xFF;
+	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 2))
+		return -1;
+	sd_desc->busy = true;
+
+	return 0;
+}
+
 /**
  * Prepare and write data block by block
  * @param sd_desc	- Instance of the SD card
@@ -420,6 +507,10 @@ int32_t sd_read(struct sd_desc *sd_desc,
 	    address + len > sd_desc->memory_size)
 		return -1;
 
+	/* Close an open multiple block write */
+	if (0 != sd_sync(sd_desc))
+		return -1;
+
 	/* Send read command */
 	cmd_desc.cmd = (get_nb_of_blocks(address, len) == 1) ? CMD(17): CMD(18);
 	cmd_desc.arg = address >> DATA_BLOCK_BITS;;
@@ -472,6 +563,10 @@ int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 	    len > sd_desc->memory_size || address + len > sd_desc->memory_size)
 		return -1;
 
+	/* Close an open multiple block write */
+	if (0 != sd_sync(sd_desc))
+		return -1;
+
 	/* Read first and last block in memory if needed to be updated with user data and then written back                                                                        */
 	/* If not writing from the beginning of a block or */
 	if ((address & MASK_ADDR_IN_BLOCK) != 0 ||
@@ -503,14 +598,128 @@ int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 
 	/* Send stop transmission token */
 	if (get_nb_of_blocks(address, len) != 1) {
-		sd_desc->buff[0] = STOP_TRANSMISSION_TOKEN;
-		sd_desc->buff[1] = 0xFF;
-		if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 2))
+		sd_desc->wr_open = true;
+		if (0 != stop_write(sd_desc))
 			return -1;
-		if (0 != wait_until_not_busy(sd_desc))
+	}
+
+	return wait_ready(sd_desc);
+}
+
+/**
+ * Write whole blocks to the SD card. The multiple block write (CMD25) is
+ * left open, so a following call writing the next blocks continues it
+ * without any command overhead. Any other access, or sd_sync(), closes it.
+ * Only the blocks written are pre-erased, unless the write starts in the
+ * region set with sd_pre_erase().
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Data to write, count * DATA_BLOCK_LEN bytes
+ * @param block		- First block to be written
+ * @param count		- Number of blocks
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t sd_write_blocks(struct sd_desc *sd_desc, const uint8_t *data,
+			uint32_t block, uint32_t count)
+{
+	struct cmd_desc	cmd_desc;
+	uint32_t	i;
+
+	/* Initial checks */
+	if (data == NULL || count == 0 ||
+	    ((uint64_t)block + count) << DATA_BLOCK_BITS > sd_desc->memory_size)
+		return -1;
+
+	if (sd_desc->wr_open && sd_desc->wr_next != block)
+		if (0 != stop_write(sd_desc))
+			return -1;
+
+	if (!sd_desc->wr_open) {
+		/*
+		 * Let the card erase the blocks ahead of the data. Blocks
+		 * pre-erased but not written are undefined, so only the
+		 * blocks of the write or of the region set by sd_pre_erase()
+		 * are given.
+		 */
+		cmd_desc.arg = count;
+		if (block >= sd_desc->pre_erase_block &&
+		    block < sd_desc->pre_erase_end)
+			cmd_desc.arg = no_os_max(count,
+						 sd_desc->pre_erase_end - block);
+		if (cmd_desc.arg > 1) {
+			cmd_desc.cmd = ACMD(23);
+			cmd_desc.arg &= ACMD23_ARG_MASK;
+			cmd_desc.response_len = R1_LEN;
+			if (0 != send_command(sd_desc, &cmd_desc))
+				return -1;
+			if (cmd_desc.response[0] != R1_READY_STATE) {
+				DEBUG_MSG("Failed to set the pre-erase count\n");
+				return -1;
+			}
+		}
+
+		cmd_desc.cmd = CMD(25);
+		cmd_desc.arg = block;
+		cmd_desc.response_len = R1_LEN;
+		if (0 != send_command(sd_desc, &cmd_desc))
 			return -1;
+		if (cmd_desc.response[0] != R1_READY_STATE) {
+			DEBUG_MSG("Failed to write Data command\n");
+			return -1;
+		}
+		sd_desc->wr_open = true;
+		sd_desc->wr_next = block;
 	}
 
+	for (i = 0; i < count; i++) {
+		if (0 != write_block(sd_desc, data + i * DATA_BLOCK_LEN, 0)) {
+			stop_write(sd_desc);
+			return -1;
+		}
+		sd_desc->wr_next++;
+	}
+
+	return 0;
+}
+
+/**
+ * Close the open multiple block write, if any, and wait for the card to
+ * program the written data.
+ * @param sd_desc	- Instance of the SD card
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t sd_sync(struct sd_desc *sd_desc)
+{
+	if (!sd_desc)
+		return -1;
+
+	if (0 != stop_write(sd_desc))
+		return -1;
+
+	return wait_ready(sd_desc);
+}
+
+/**
+ * Set the region pre-erased (ACMD23) by a multiple block write starting in it.
+ * A write starting at a block of the region lets the card erase up to the end
+ * of the region ahead of the data, instead of only the blocks written.
+ * The content of the blocks pre-erased but never written is undefined (erased
+ * or old data), so the region must only cover blocks the caller has reserved
+ * and whose content doesn't matter, such as a file area allocated with
+ * f_expand(). Clear the region once it isn't reserved anymore.
+ * @param sd_desc	- Instance of the SD card
+ * @param block		- First block of the region
+ * @param count		- Number of blocks, 0 to clear the region
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t sd_pre_erase(struct sd_desc *sd_desc, uint32_t block, uint32_t count)
+{
+	if (!sd_desc ||
+	    ((uint64_t)block + count) << DATA_BLOCK_BITS > sd_desc->memory_size)
+		return -1;
+
+	sd_desc->pre_erase_block = block;
+	sd_desc->pre_erase_end = count ? block + count : 0;
+
 	return 0;
 }
 
@@ -534,6 +743,7 @@ int32_t sd_init(struct sd_desc **sd_desc, const struct sd_init_param *param)
 	if (!local_desc)
 		return -1;
 	local_desc->spi_desc = param->spi_desc;
+	local_desc->dma = param->dma;
 
 	/* Synchronize SD card frequency: Send 10 dummy bytes*/
 	memset(local_desc->buff, 0xFF, 10);
@@ -636,6 +846,7 @@ int32_t sd_remove(struct sd_desc *desc)
 	if (desc == NULL)
 		return -1;
 
+	sd_sync(desc);
 	no_os_free(desc);
 	return 0;
 }
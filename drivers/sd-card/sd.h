@@ -79,6 +79,8 @@
 struct sd_init_param {
 	/** Descriptor of an initialized SPI channel */
 	struct no_os_spi_desc *spi_desc;
+	/** Transfer the data blocks using SPI DMA, if the platform supports it */
+	bool			dma;
 };
 
 /**
@@ -94,6 +96,20 @@ struct sd_desc {
 	uint8_t		high_capacity;
 	/** Buffer used for the driver implementation */
 	uint8_t		buff[18];
+	/** Transfer the data blocks using SPI DMA */
+	bool		dma;
+	/** First block of the region set with sd_pre_erase() */
+	uint32_t	pre_erase_block;
+	/** Block following the region set with sd_pre_erase(), 0 if none */
+	uint32_t	pre_erase_end;
+	/** Set while a multiple block write (CMD25) is open */
+	bool		wr_open;
+	/** Block expected next by the open multiple block write */
+	uint32_t	wr_next;
+	/** Set while the card programs the last written block */
+	bool		busy;
+	/** Start token, data block and CRC sent in a single transfer */
+	uint8_t		block[DATA_BLOCK_LEN + 3] __attribute__ ((aligned));
 };
 
 /**
@@ -126,6 +142,12 @@ int32_t sd_write(struct sd_desc *desc,
 		 uint8_t *data,
 		 uint64_t address,
 		 uint64_t len);
+int32_t sd_write_blocks(struct sd_desc *desc,
+			const uint8_t *data,
+			uint32_t block,
+			uint32_t count);
+int32_t sd_sync(struct sd_desc *desc);
+int32_t sd_pre_erase(struct sd_desc *desc, uint32_t block, uint32_t count);
 
 #endif /* __SD_H__ */
 
@@ -46,13 +46,15 @@
 /************************** Macros Definitions ********************************/
 /******************************************************************************/
 
-#define LTC2983_CHAN(_type, _index) ({ \
+#define LTC2983_CHAN(_type, _index, _scan_index) ({ \
 	struct iio_channel __chan = { \
 		.ch_type = _type, \
 		.indexed = true, \
 		.channel = _index, \
 		.attributes = ltc2983_iio_attrs, \
 		.address = _index, \
+		.scan_index = _scan_index, \
+		.scan_type = &ltc2983_iio_scan_type, \
 	}; \
 	__chan; \
 })
@@ -71,11 +73,24 @@ static int ltc2983_iio_reg_read(struct ltc2983_iio_desc *dev, uint32_t reg,
 				uint32_t *readval);
 static int ltc2983_iio_reg_write(struct ltc2983_iio_desc *dev, uint32_t reg,
 				 uint32_t writeval);
+static int ltc2983_iio_buffer_enable(struct ltc2983_iio_desc *dev,
+				     uint32_t mask);
+static int ltc2983_iio_buffer_disable(struct ltc2983_iio_desc *dev);
+static int ltc2983_iio_submit(struct iio_device_data *dev_data);
+static int ltc2983_iio_trigger_handler(struct iio_device_data *dev_data);
 
 /******************************************************************************/
 /************************ Variable Declarations ******************************/
 /******************************************************************************/
 
+static struct scan_type ltc2983_iio_scan_type = {
+	.sign = 's',
+	.realbits = 24,
+	.storagebits = 32,
+	.shift = 0,
+	.is_big_endian = false,
+};
+
 static struct iio_attribute ltc2983_iio_attrs[] = {
 	{
 		.name = "raw",
@@ -95,6 +110,10 @@ static struct iio_attribute ltc2983_iio_attrs[] = {
 static struct iio_device ltc2983_iio_dev = {
 	.debug_reg_read = (int32_t (*)())ltc2983_iio_reg_read,
 	.debug_reg_write = (int32_t (*)())ltc2983_iio_reg_write,
+	.pre_enable = (int32_t (*)())ltc2983_iio_buffer_enable,
+	.post_disable = (int32_t (*)())ltc2983_iio_buffer_disable,
+	.submit = ltc2983_iio_submit,
+	.trigger_handler = ltc2983_iio_trigger_handler,
 };
 
 /******************************************************************************/
@@ -147,7 +166,9 @@ int ltc2983_iio_init(struct ltc2983_iio_desc **iio_dev,
 			else
 				ch_type = IIO_TEMP;
 
-			ltc2983_channels[chan++] = LTC2983_CHAN(ch_type, i + 1);
+			ltc2983_channels[chan] = LTC2983_CHAN(ch_type, i + 1,
+							      chan);
+			chan++;
 		}
 	}
 
@@ -263,3 +284,102 @@ static int ltc2983_iio_reg_write(struct ltc2983_iio_desc *dev, uint32_t reg,
 	return ltc2983_reg_write(dev->ltc2983_dev, (uint16_t)reg,
 				 (uint8_t)writeval);
 }
+
+/**
+ * @brief Translate the IIO channel mask into a LTC2983 multiple channel
+ *	  conversion mask and start the first conversion.
+ * @param dev - The iio device structure.
+ * @param mask - Mask of the enabled IIO channels.
+ * @return 0 in case of success, errno errors otherwise
+ */
+static int ltc2983_iio_buffer_enable(struct ltc2983_iio_desc *dev,
+				     uint32_t mask)
+{
+	uint32_t i;
+	int ret;
+
+	dev->scan_mask = 0;
+	for (i = 0; i < dev->iio_dev->num_ch; i++)
+		if (mask & NO_OS_BIT(i))
+			dev->scan_mask |=
+				NO_OS_BIT(dev->iio_dev->channels[i].address - 1);
+
+	ret = ltc2983_scan_start(dev->ltc2983_dev, dev->scan_mask);
+	if (ret)
+		return ret;
+
+	dev->scan_pending = true;
+
+	return 0;
+}
+
+/**
+ * @brief Stop the buffered acquisition.
+ * @param dev - The iio device structure.
+ * @return 0 in case of success, errno errors otherwise
+ */
+static int ltc2983_iio_buffer_disable(struct ltc2983_iio_desc *dev)
+{
+	dev->scan_pending = false;
+
+	return 0;
+}
+
+/**
+ * @brief Fill the IIO buffer, each sample being a multiple channel conversion.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success, errno errors otherwise
+ */
+static int ltc2983_iio_submit(struct iio_device_data *dev_data)
+{
+	struct ltc2983_iio_desc *dev = dev_data->dev;
+	int32_t vals[LTC2983_MAX_CHANNELS_NR];
+	uint32_t i;
+	int ret;
+
+	/* The conversion started by the buffer enable is discarded */
+	dev->scan_pending = false;
+
+	for (i = 0; i < dev_data->buffer->samples; i++) {
+		ret = ltc2983_scan(dev->ltc2983_dev, dev->scan_mask, vals);
+		if (ret)
+			return ret;
+
+		ret = iio_buffer_push_scan(dev_data->buffer, vals);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Push the last multiple channel conversion into the IIO buffer and
+ *	  start the next one. Meant to be triggered by the INTERRUPT pin.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success, errno errors otherwise
+ */
+static int ltc2983_iio_trigger_handler(struct iio_device_data *dev_data)
+{
+	struct ltc2983_iio_desc *dev = dev_data->dev;
+	int32_t vals[LTC2983_MAX_CHANNELS_NR];
+	bool done;
+	int ret;
+
+	if (!dev->scan_pending)
+		return 0;
+
+	ret = ltc2983_conv_done(dev->ltc2983_dev, &done);
+	if (ret || !done)
+		return ret;
+
+	ret = ltc2983_scan_read(dev->ltc2983_dev, vals);
+	if (ret)
+		return ret;
+
+	ret = iio_buffer_push_scan(dev_data->buffer, vals);
+	if (ret)
+		return ret;
+
+	return ltc2983_scan_start(dev->ltc2983_dev, dev->scan_mask);
+}
@@ -47,6 +47,10 @@
 struct ltc2983_iio_desc {
 	struct ltc2983_desc *ltc2983_dev;
 	struct iio_device *iio_dev;
+	/** LTC2983 channels converted in buffered mode, bit 0 for channel 1 */
+	uint32_t scan_mask;
+	/** A multiple channel conversion was started and not yet read */
+	bool scan_pending;
 };
 
 struct ltc2983_iio_desc_init_param {
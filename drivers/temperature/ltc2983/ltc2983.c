@@ -36,6 +36,7 @@
 /******************************************************************************/
 
 #include <errno.h>
+#include <string.h>
 #include "ltc2983.h"
 #include "no_os_alloc.h"
 #include "no_os_delay.h"
@@ -100,19 +101,29 @@ int ltc2983_init(struct ltc2983_desc **device,
 	if (ret)
 		goto gpio_err;
 
+	ret = no_os_gpio_get_optional(&descriptor->gpio_int,
+				      init_param->gpio_int);
+	if (ret)
+		goto gpio_err;
+	ret = no_os_gpio_direction_input(descriptor->gpio_int);
+	if (ret)
+		goto gpio_int_err;
+
 	/* bring the device out of reset */
 	no_os_udelay(1200);
 	ret = no_os_gpio_set_value(descriptor->gpio_rstn, NO_OS_GPIO_HIGH);
 	if (ret)
-		goto gpio_err;
+		goto gpio_int_err;
 
 	ret = ltc2983_setup(descriptor);
 	if (ret)
-		goto gpio_err;
+		goto gpio_int_err;
 
 	*device = descriptor;
 	return 0;
 
+gpio_int_err:
+	no_os_gpio_remove(descriptor->gpio_int);
 gpio_err:
 	no_os_gpio_remove(descriptor->gpio_rstn);
 spi_err:
@@ -133,6 +144,10 @@ int ltc2983_remove(struct ltc2983_desc *device)
 	if (!device)
 		return -ENODEV;
 
+	ret = no_os_gpio_remove(device->gpio_int);
+	if (ret)
+		return -EINVAL;
+
 	ret = no_os_gpio_remove(device->gpio_rstn);
 	if (ret)
 		return -EINVAL;
@@ -314,6 +329,177 @@ int ltc2983_setup(struct ltc2983_desc *device)
 	return 0;
 }
 
+/**
+ * @brief Check whether the last conversion is complete. The INTERRUPT pin is
+ * used when available, the status register otherwise.
+ * @param device - LTC2983 descriptor
+ * @param done - true if the conversion is complete
+ * @return 0 in case of success, errno errors otherwise
+ */
+int ltc2983_conv_done(struct ltc2983_desc *device, bool *done)
+{
+	uint8_t status;
+	int ret;
+
+	if (device->gpio_int) {
+		ret = no_os_gpio_get_value(device->gpio_int, &status);
+		if (ret)
+			return ret;
+
+		*done = status == NO_OS_GPIO_HIGH;
+
+		return 0;
+	}
+
+	ret = ltc2983_reg_read(device, LTC2983_STATUS_REG, &status);
+	if (ret)
+		return ret;
+
+	/* start bit (7) is 0 and done bit (6) is 1 */
+	*done = LTC2983_STATUS_UP(status) == 1;
+
+	return 0;
+}
+
+/**
+ * @brief Wait for the end of the current conversion
+ * @param device - LTC2983 descriptor
+ * @param timeout_ms - maximum time to wait
+ * @return 0 in case of success, errno errors otherwise
+ */
+static int ltc2983_conv_wait(struct ltc2983_desc *device, uint32_t timeout_ms)
+{
+	uint32_t timeout = timeout_ms * 1000 / LTC2983_CONV_POLL_US;
+	bool done;
+	int ret;
+
+	do {
+		ret = ltc2983_conv_done(device, &done);
+		if (ret)
+			return ret;
+		if (done)
+			return 0;
+
+		no_os_udelay(LTC2983_CONV_POLL_US);
+	} while (timeout--);
+
+	return -ETIMEDOUT;
+}
+
+/**
+ * @brief Start the conversion of a set of channels using the multiple channel
+ * conversion mask. The mask registers are only written when the channel set
+ * changes.
+ * @param device - LTC2983 descriptor
+ * @param chan_mask - channels to convert, bit 0 for channel 1
+ * @return 0 in case of success, errno errors otherwise
+ */
+int ltc2983_scan_start(struct ltc2983_desc *device, uint32_t chan_mask)
+{
+	uint8_t raw_array[7];
+	int ret;
+
+	if (!chan_mask ||
+	    (chan_mask & ~NO_OS_GENMASK(device->max_channels_nr - 1, 0)))
+		return -EINVAL;
+
+	if (chan_mask != device->scan_mask) {
+		raw_array[0] = LTC2983_SPI_WRITE_BYTE;
+		no_os_put_unaligned_be16(LTC2983_MULT_CHAN_START_REG,
+					 raw_array + 1);
+		no_os_put_unaligned_be32(chan_mask, raw_array + 3);
+		ret = no_os_spi_write_and_read(device->comm_desc, raw_array,
+					       NO_OS_ARRAY_SIZE(raw_array));
+		if (ret)
+			return ret;
+
+		device->scan_mask = chan_mask;
+	}
+
+	/* channel 0 selects the multiple channel conversion mask */
+	return ltc2983_reg_write(device, LTC2983_STATUS_REG,
+				 LTC2983_STATUS_START(true));
+}
+
+/**
+ * @brief Read the results of the last multiple channel conversion in a single
+ * burst, from the first to the last channel of the scan mask.
+ * @param device - LTC2983 descriptor
+ * @param vals - sign extended results, one for each channel of the scan mask,
+ *		 in ascending channel order
+ * @return 0 in case of success, errno errors otherwise. All the results are
+ *	   read even if some of them are invalid or faulty.
+ */
+int ltc2983_scan_read(struct ltc2983_desc *device, int32_t *vals)
+{
+	uint8_t raw_array[3 + 4 * LTC2983_MAX_CHANNELS_NR];
+	uint32_t first, last, chan, len, res;
+	int ret, err = 0;
+
+	if (!device->scan_mask)
+		return -EINVAL;
+
+	first = no_os_find_first_set_bit(device->scan_mask) + 1;
+	last = no_os_find_last_set_bit(device->scan_mask) + 1;
+	len = 3 + 4 * (last - first + 1);
+
+	memset(raw_array, 0, len);
+	raw_array[0] = LTC2983_SPI_READ_BYTE;
+	no_os_put_unaligned_be16(LTC2983_CHAN_RES_ADDR(first), raw_array + 1);
+	ret = no_os_spi_write_and_read(device->comm_desc, raw_array, len);
+	if (ret)
+		return ret;
+
+	for (chan = first; chan <= last; chan++) {
+		if (!(device->scan_mask & NO_OS_BIT(chan - 1)))
+			continue;
+
+		res = no_os_get_unaligned_be32(raw_array + 3 + 4 * (chan - first));
+		*vals++ = no_os_sign_extend32(res & LTC2983_DATA_MASK,
+					      LTC2983_DATA_SIGN_BIT);
+
+		if (!(LTC2983_RES_VALID_MASK & res)) {
+			pr_err("Channel %d: Invalid conversion detected\r\n", chan);
+			ret = -EIO;
+		} else if (device->sensors[chan - 1] &&
+			   device->sensors[chan - 1]->type <=
+			   LTC2983_THERMOCOUPLE_CUSTOM) {
+			ret = ltc2983_thermocouple_fault_handler(res);
+		} else {
+			ret = ltc2983_common_fault_handler(res);
+		}
+		if (ret && !err)
+			err = ret;
+	}
+
+	return err;
+}
+
+/**
+ * @brief Convert a set of channels with a single command and read the results.
+ * The end of conversion is detected as soon as it happens.
+ * @param device - LTC2983 descriptor
+ * @param chan_mask - channels to convert, bit 0 for channel 1
+ * @param vals - sign extended results, see ltc2983_scan_read()
+ * @return 0 in case of success, errno errors otherwise
+ */
+int ltc2983_scan(struct ltc2983_desc *device, uint32_t chan_mask,
+		 int32_t *vals)
+{
+	int ret;
+
+	ret = ltc2983_scan_start(device, chan_mask);
+	if (ret)
+		return ret;
+
+	ret = ltc2983_conv_wait(device, no_os_hweight32(chan_mask) *
+				LTC2983_CONV_TIMEOUT_MS);
+	if (ret)
+		return ret;
+
+	return ltc2983_scan_read(device, vals);
+}
+
 /**
  * @brief Read channel data / temperature
  * @param device - LTC2983 descriptor
@@ -365,7 +551,9 @@ int ltc2983_chan_read_raw(struct ltc2983_desc *device, const int chan,
 	if (ret)
 		return ret;
 
-	no_os_mdelay(300);
+	ret = ltc2983_conv_wait(device, LTC2983_CONV_TIMEOUT_MS);
+	if (ret)
+		return ret;
 
 	/* read the converted data */
 	raw_array[0] = LTC2983_SPI_READ_BYTE;
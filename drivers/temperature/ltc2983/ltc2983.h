@@ -52,6 +52,7 @@
 #define LTC2983_EEPROM_KEY_REG			0x00B0
 #define LTC2983_EEPROM_READ_STATUS_REG		0x00D0
 #define LTC2983_GLOBAL_CONFIG_REG 		0x00F0
+#define LTC2983_MULT_CHAN_START_REG		0x00F4
 #define LTC2986_EEPROM_STATUS_REG		0x00F9
 #define LTC2983_MUX_CONFIG_REG 			0x00FF
 #define LTC2983_CHAN_ASSIGN_START_REG 	0x0200
@@ -72,6 +73,12 @@
 #define LTC2983_EEPROM_WRITE_TIME_MS	2600
 #define LTC2983_EEPROM_READ_TIME_MS		20
 
+/* Worst case conversion time of a single channel */
+#define LTC2983_CONV_TIMEOUT_MS			300
+#define LTC2983_CONV_POLL_US			1000
+
+#define LTC2983_MAX_CHANNELS_NR			20
+
 #define LTC2983_CHAN_START_ADDR(chan) \
 			(((chan - 1) * 4) + LTC2983_CHAN_ASSIGN_START_REG)
 #define LTC2983_CHAN_RES_ADDR(chan) \
@@ -230,6 +237,9 @@ struct ltc2983_init_param {
 	struct no_os_spi_init_param spi_init;
 	/** Reset GPIO configuration */
 	struct no_os_gpio_init_param gpio_rstn;
+	/** INTERRUPT pin GPIO configuration (optional). When not set, the end
+	 *  of conversion is detected by polling the status register. */
+	struct no_os_gpio_init_param *gpio_int;
 	/** MUX configuration delay in us */
 	uint32_t mux_delay_config_us;
 	/** Notch frequency of the digital filter */
@@ -250,6 +260,10 @@ struct ltc2983_desc {
 	struct no_os_spi_desc *comm_desc;
 	/** Reset GPIO descriptor */
 	struct no_os_gpio_desc *gpio_rstn;
+	/** INTERRUPT pin GPIO descriptor */
+	struct no_os_gpio_desc *gpio_int;
+	/** Channel mask programmed in the multiple conversion mask registers */
+	uint32_t scan_mask;
 	/** MUX configuration delay in us */
 	uint32_t mux_delay_config_us;
 	/** Notch frequency of the digital filter */
@@ -428,6 +442,18 @@ int ltc2983_chan_read_raw(struct ltc2983_desc *, const int, uint32_t *);
 int ltc2983_chan_read_scale(struct ltc2983_desc *, const int, uint32_t *,
 			    uint32_t *);
 
+/** Check whether the last conversion is complete */
+int ltc2983_conv_done(struct ltc2983_desc *, bool *);
+
+/** Start the conversion of a set of channels */
+int ltc2983_scan_start(struct ltc2983_desc *, uint32_t);
+
+/** Read the results of the last multiple channel conversion */
+int ltc2983_scan_read(struct ltc2983_desc *, int32_t *);
+
+/** Convert a set of channels and read the results */
+int ltc2983_scan(struct ltc2983_desc *, uint32_t, int32_t *);
+
 /** Channel assignment for thermocouple sensors */
 int ltc2983_thermocouple_assign_chan(struct ltc2983_desc *,
 				     const struct ltc2983_sensor *);
@@ -47,6 +47,7 @@
 #include "no_os_error.h"
 #include "no_os_alloc.h"
 #include "no_os_circular_buffer.h"
+#include "no_os_mutex.h"
 #include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
@@ -62,6 +63,11 @@
 #include "lwip_socket.h"
 #endif
 
+#ifdef IIO_THREADED
+#include <pthread.h>
+#include "no_os_delay.h"
+#endif
+
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
@@ -71,6 +77,18 @@
 #define REG_ACCESS_ATTRIBUTE	"direct_reg_access"
 #define IIOD_CONN_BUFFER_SIZE	0x1000
 #define NO_TRIGGER				(uint32_t)-1
+/* Time iio_step() waits for network activity once all connections are idle */
+#ifndef IIO_NETWORK_WAIT_MS
+#define IIO_NETWORK_WAIT_MS	1
+#endif
+/* Pieces sent at once by iio_sendv(), a result line and its payload */
+#define IIO_SENDV_MAX		4
+#ifdef IIO_THREADED
+/* Connection workers started when iio_init_param.nb_workers is 0 */
+#define IIO_DEFAULT_WORKERS	4
+/* Time a stream thread sleeps while its buffer wasn't read yet */
+#define IIO_STREAM_POLL_US	100
+#endif
 
 #define NO_OS_STRINGIFY(x) #x
 #define NO_OS_TOSTRING(x) NO_OS_STRINGIFY(x)
@@ -181,6 +199,16 @@ struct iio_dev_priv {
 	struct iio_buffer_priv buffer;
 	/* Set to -1 when no trigger is set*/
 	uint32_t		trig_idx;
+	/* Serializes the attribute and buffer operations on the device */
+	void			*lock;
+#ifdef IIO_THREADED
+	/* Reference to the parent IIO descriptor */
+	struct iio_desc		*desc;
+	/* Thread keeping the input buffer filled while it is open */
+	pthread_t		stream_thread;
+	/* Set while stream_thread runs */
+	volatile bool		streaming;
+#endif
 };
 
 /**
@@ -214,6 +242,10 @@ struct iio_desc {
 	struct iio_trig_priv	*trigs;
 	uint32_t		nb_trigs;
 	struct no_os_uart_desc	*uart_desc;
+#ifdef IIO_UART_TRANSPORT
+	/* UART transport, NULL if the UART is used directly */
+	struct iio_uart_desc	*uart_transport;
+#endif
 	int (*recv)(void *conn, uint8_t *buf, uint32_t len);
 	int (*send)(void *conn, uint8_t *buf, uint32_t len);
 	/* FIFO for socket descriptors */
@@ -222,6 +254,21 @@ struct iio_desc {
 	struct tcp_socket_desc	*current_sock;
 	/* Instance of server socket */
 	struct tcp_socket_desc	*server;
+	/* Connection steps in a row which made no progress */
+	uint32_t		idle_steps;
+#ifdef IIO_THREADED
+	/* Threads stepping the connections, NULL in single thread mode */
+	pthread_t		*workers;
+	uint32_t		nb_workers;
+	/* Cleared to stop the workers */
+	volatile bool		running;
+	/* Protects conns and the iiod connection slots */
+	void			*conns_lock;
+#endif
+#ifdef IIO_UDP_STREAM
+	/* Data plane of the input buffers, NULL if not used */
+	struct udp_stream_desc	*udp_stream;
+#endif
 #endif
 };
 
@@ -269,6 +316,23 @@ static int iio_send(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len)
 	return desc->send(ctx->conn, buf, len);
 }
 
+#if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING)
+static int iio_sendv(struct iiod_ctx *ctx, const struct iiod_iovec *iov,
+		     uint32_t nb)
+{
+	struct socket_iov siov[IIO_SENDV_MAX];
+	uint32_t i;
+
+	nb = no_os_min(nb, (uint32_t)IIO_SENDV_MAX);
+	for (i = 0; i < nb; i++) {
+		siov[i].data = iov[i].buf;
+		siov[i].len = iov[i].len;
+	}
+
+	return socket_sendv(ctx->conn, siov, nb);
+}
+#endif
+
 static inline void _print_ch_id(char *buff, struct iio_channel *ch)
 {
 	if(ch->modified) {
@@ -766,8 +830,8 @@ static struct iio_attribute *get_trig_attributes(enum iio_attr_type type,
  * @param len - Maximum length of value to be stored in buf.
  * @return Number of bytes read.
  */
-static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
-			 struct iiod_attr *attr, char *buf, uint32_t len)
+static int __iio_read_attr(struct iiod_ctx *ctx, const char *device,
+			   struct iiod_attr *attr, char *buf, uint32_t len)
 {
 	struct iio_dev_priv *dev;
 	struct iio_trig_priv *trig_dev;
@@ -841,8 +905,8 @@ static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
  * @param len - Length of data.
  * @return Number of written bytes.
  */
-static int iio_write_attr(struct iiod_ctx *ctx, const char *device,
-			  struct iiod_attr *attr, char *buf, uint32_t len)
+static int __iio_write_attr(struct iiod_ctx *ctx, const char *device,
+			    struct iiod_attr *attr, char *buf, uint32_t len)
 {
 	struct iio_dev_priv	*dev;
 	struct iio_trig_priv *trig_dev;
@@ -995,8 +1059,8 @@ static int iio_get_trigger(struct iiod_ctx *ctx, const char *device,
  * @param len     - Maximum length of value to be returned.
  * @return Positive if index was set, negative if not.
  */
-static int iio_set_trigger(struct iiod_ctx *ctx, const char *device,
-			   const char *trigger, uint32_t len)
+static int __iio_set_trigger(struct iiod_ctx *ctx, const char *device,
+			     const char *trigger, uint32_t len)
 {
 	struct iio_dev_priv	*dev;
 	struct iio_trig_priv	*trig;
@@ -1047,7 +1111,9 @@ static void iio_process_async_triggers(struct iio_desc *desc)
 			continue;
 
 		if (dev->dev_descriptor->trigger_handler) {
+			no_os_mutex_lock(dev->lock);
 			dev->dev_descriptor->trigger_handler(&dev->dev_data);
+			no_os_mutex_unlock(dev->lock);
 			desc->trigs[i].triggered = 0;
 		}
 	}
@@ -1127,8 +1193,8 @@ static uint32_t bytes_per_scan(struct iio_channel *channels, uint32_t mask)
  * @param mask - Channels to be opened.
  * @return 0, negative value in case of failure.
  */
-static int iio_open_dev(struct iiod_ctx *ctx, const char *device,
-			uint32_t samples, uint32_t mask, bool cyclic)
+static int __iio_open_dev(struct iiod_ctx *ctx, const char *device,
+			  uint32_t samples, uint32_t mask, bool cyclic)
 {
 	struct iio_desc *desc;
 	struct iio_dev_priv *dev;
@@ -1215,7 +1281,7 @@ static int iio_open_dev(struct iiod_ctx *ctx, const char *device,
  * @param device - String containing device name.
  * @return 0, negative value in case of failure.
  */
-static int iio_close_dev(struct iiod_ctx *ctx, const char *device)
+static int __iio_close_dev(struct iiod_ctx *ctx, const char *device)
 {
 	struct iio_desc *desc;
 	struct iio_dev_priv *dev;
@@ -1292,16 +1358,145 @@ static int iio_call_submit(struct iiod_ctx *ctx, const char *device,
 	return 0;
 }
 
+/**
+ * @brief Take the lock of the device an operation is addressed to.
+ * @param desc - IIO descriptor.
+ * @param device - Device name, triggers have no lock.
+ * @return The taken lock, NULL if there is none to release.
+ */
+static void *iio_dev_lock(struct iio_desc *desc, const char *device)
+{
+	struct iio_dev_priv *dev;
+
+	dev = get_iio_device(desc, device);
+	if (!dev)
+		return NULL;
+
+	no_os_mutex_lock(dev->lock);
+
+	return dev->lock;
+}
+
 static int iio_push_buffer(struct iiod_ctx *ctx, const char *device)
 {
-	return iio_call_submit(ctx, device, IIO_DIRECTION_OUTPUT);
+	void *lock;
+	int ret;
+
+	lock = iio_dev_lock(ctx->instance, device);
+	ret = iio_call_submit(ctx, device, IIO_DIRECTION_OUTPUT);
+	no_os_mutex_unlock(lock);
+
+	return ret;
 }
 
 static int iio_refill_buffer(struct iiod_ctx *ctx, const char *device)
 {
-	return iio_call_submit(ctx, device, IIO_DIRECTION_INPUT);
+	void *lock;
+	int ret;
+
+#ifdef IIO_THREADED
+	struct iio_dev_priv *dev;
+
+	dev = get_iio_device(ctx->instance, device);
+	/* The stream thread keeps the buffer filled */
+	if (dev && dev->streaming)
+		return 0;
+#endif
+
+	lock = iio_dev_lock(ctx->instance, device);
+	ret = iio_call_submit(ctx, device, IIO_DIRECTION_INPUT);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+#ifdef IIO_THREADED
+/**
+ * @brief Refill the input buffer of a device as soon as it was read, so that
+ * the acquisition doesn't wait for the connection workers.
+ * @param arg - IIO device.
+ * @return NULL.
+ */
+static void *iio_stream_thread(void *arg)
+{
+	struct iio_dev_priv *dev = arg;
+	struct iiod_ctx ctx = { .instance = dev->desc };
+	uint32_t size;
+	int ret;
+
+	while (dev->streaming) {
+		ret = 0;
+		no_os_mutex_lock(dev->lock);
+		no_os_cb_size(&dev->buffer.cb, &size);
+		if (!size)
+			ret = iio_call_submit(&ctx, dev->dev_id, IIO_DIRECTION_INPUT);
+		no_os_mutex_unlock(dev->lock);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			break;
+
+		if (size)
+			no_os_udelay(IIO_STREAM_POLL_US);
+	}
+
+	dev->streaming = false;
+
+	return NULL;
+}
+
+/**
+ * @brief Start the stream thread of a device whose input buffer was opened.
+ * Triggered and cyclic buffers are filled by their own means.
+ * @param dev - IIO device.
+ */
+static void iio_stream_start(struct iio_dev_priv *dev)
+{
+	struct iio_channel *ch;
+
+	if (!dev || dev->streaming)
+		return;
+
+	/* A thread which stopped by itself, on an error, is still joinable */
+	if (dev->stream_thread) {
+		pthread_join(dev->stream_thread, NULL);
+		dev->stream_thread = 0;
+	}
+
+	if (dev->trig_idx != NO_TRIGGER ||
+	    dev->buffer.public.cyclic_info.is_cyclic ||
+	    !dev->buffer.public.active_mask)
+		return;
+
+	if (!dev->dev_descriptor->submit && !dev->dev_descriptor->read_dev)
+		return;
+
+	ch = &dev->dev_descriptor->channels[
+		     no_os_find_first_set_bit(dev->buffer.public.active_mask)];
+	if (ch->ch_out)
+		return;
+
+	dev->streaming = true;
+	if (pthread_create(&dev->stream_thread, NULL, iio_stream_thread, dev)) {
+		/* Fall back to refilling on READBUF */
+		dev->streaming = false;
+		dev->stream_thread = 0;
+	}
 }
 
+/**
+ * @brief Stop the stream thread of a device.
+ * @param dev - IIO device.
+ */
+static void iio_stream_stop(struct iio_dev_priv *dev)
+{
+	if (!dev || !dev->stream_thread)
+		return;
+
+	dev->streaming = false;
+	pthread_join(dev->stream_thread, NULL);
+	dev->stream_thread = 0;
+}
+#endif
+
 /**
  * @brief Read chunk of data from RAM to pbuf. Call
  * "iio_transfer_dev_to_mem()" first.
@@ -1311,8 +1506,8 @@ static int iio_refill_buffer(struct iiod_ctx *ctx, const char *device)
  * @param bytes_count - Number of bytes to read.
  * @return: Bytes_count or negative value in case of error.
  */
-static int iio_read_buffer(struct iiod_ctx *ctx, const char *device, char *buf,
-			   uint32_t bytes)
+static int __iio_read_buffer(struct iiod_ctx *ctx, const char *device,
+			     char *buf, uint32_t bytes)
 {
 	struct iio_dev_priv	*dev;
 	int32_t			ret;
@@ -1354,8 +1549,8 @@ static int iio_read_buffer(struct iiod_ctx *ctx, const char *device, char *buf,
  * @param bytes_count - Number of bytes to write.
  * @return Bytes_count or negative value in case of error.
  */
-static int iio_write_buffer(struct iiod_ctx *ctx, const char *device,
-			    const char *buf, uint32_t bytes)
+static int __iio_write_buffer(struct iiod_ctx *ctx, const char *device,
+			      const char *buf, uint32_t bytes)
 {
 	struct iio_dev_priv	*dev;
 	int32_t			ret;
@@ -1379,6 +1574,106 @@ static int iio_write_buffer(struct iiod_ctx *ctx, const char *device,
 	return bytes;
 }
 
+static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
+			 struct iiod_attr *attr, char *buf, uint32_t len)
+{
+	void *lock;
+	int ret;
+
+	lock = iio_dev_lock(ctx->instance, device);
+	ret = __iio_read_attr(ctx, device, attr, buf, len);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_write_attr(struct iiod_ctx *ctx, const char *device,
+			  struct iiod_attr *attr, char *buf, uint32_t len)
+{
+	void *lock;
+	int ret;
+
+	lock = iio_dev_lock(ctx->instance, device);
+	ret = __iio_write_attr(ctx, device, attr, buf, len);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_set_trigger(struct iiod_ctx *ctx, const char *device,
+			   const char *trigger, uint32_t len)
+{
+	void *lock;
+	int ret;
+
+	lock = iio_dev_lock(ctx->instance, device);
+	ret = __iio_set_trigger(ctx, device, trigger, len);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_open_dev(struct iiod_ctx *ctx, const char *device,
+			uint32_t samples, uint32_t mask, bool cyclic)
+{
+	void *lock;
+	int ret;
+
+	lock = iio_dev_lock(ctx->instance, device);
+	ret = __iio_open_dev(ctx, device, samples, mask, cyclic);
+	no_os_mutex_unlock(lock);
+
+#ifdef IIO_THREADED
+	if (!NO_OS_IS_ERR_VALUE(ret))
+		iio_stream_start(get_iio_device(ctx->instance, device));
+#endif
+
+	return ret;
+}
+
+static int iio_close_dev(struct iiod_ctx *ctx, const char *device)
+{
+	void *lock;
+	int ret;
+
+#ifdef IIO_THREADED
+	/* Before taking the lock, the stream thread needs it to exit */
+	iio_stream_stop(get_iio_device(ctx->instance, device));
+#endif
+
+	lock = iio_dev_lock(ctx->instance, device);
+	ret = __iio_close_dev(ctx, device);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_read_buffer(struct iiod_ctx *ctx, const char *device, char *buf,
+			   uint32_t bytes)
+{
+	void *lock;
+	int ret;
+
+	lock = iio_dev_lock(ctx->instance, device);
+	ret = __iio_read_buffer(ctx, device, buf, bytes);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_write_buffer(struct iiod_ctx *ctx, const char *device,
+			    const char *buf, uint32_t bytes)
+{
+	void *lock;
+	int ret;
+
+	lock = iio_dev_lock(ctx->instance, device);
+	ret = __iio_write_buffer(ctx, device, buf, bytes);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
 int iio_buffer_get_block(struct iio_buffer *buffer, void **addr)
 {
 	uint32_t size;
@@ -1430,6 +1725,102 @@ int iio_buffer_pop_scan(struct iio_buffer *buffer, void *data)
 	return ret;
 }
 
+/**
+ * @brief Open the input buffer of a device for a local consumer, such as a
+ * recorder, without any client being connected.
+ * @param desc - IIO descriptor.
+ * @param device - Device id (iio:deviceX).
+ * @param samples - Number of scans acquired by a refill.
+ * @param mask - Channels to be enabled.
+ * @param buffer - Set to the opened buffer, describing the scan. May be NULL.
+ * @return 0 in case of success, -EBUSY if the buffer is already open or
+ * negative value otherwise.
+ */
+int iio_consumer_open(struct iio_desc *desc, const char *device,
+		      uint32_t samples, uint32_t mask,
+		      struct iio_buffer **buffer)
+{
+	struct iiod_ctx ctx = { .instance = desc };
+	struct iio_dev_priv *dev;
+	int ret;
+
+	if (!desc || !device)
+		return -EINVAL;
+
+	dev = get_iio_device(desc, device);
+	if (!dev)
+		return -ENODEV;
+
+	if (dev->buffer.public.active_mask)
+		return -EBUSY;
+
+	ret = iio_open_dev(&ctx, device, samples, mask, false);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	if (buffer)
+		*buffer = &dev->buffer.public;
+
+	return 0;
+}
+
+/**
+ * @brief Read data from a buffer opened by iio_consumer_open(). The buffer
+ * is refilled first if it is empty.
+ * @param desc - IIO descriptor.
+ * @param device - Device id (iio:deviceX).
+ * @param buf - Where the data is copied.
+ * @param len - Maximum number of bytes to read.
+ * @return Number of bytes read, -EAGAIN if no data is available yet or
+ * negative value otherwise.
+ */
+int iio_consumer_read(struct iio_desc *desc, const char *device, void *buf,
+		      uint32_t len)
+{
+	struct iiod_ctx ctx = { .instance = desc };
+	struct iio_dev_priv *dev;
+	uint32_t size;
+	int ret = 0;
+
+	if (!desc || !device || !buf)
+		return -EINVAL;
+
+	dev = get_iio_device(desc, device);
+	if (!dev || !dev->buffer.public.active_mask)
+		return -EINVAL;
+
+	no_os_mutex_lock(dev->lock);
+	no_os_cb_size(&dev->buffer.cb, &size);
+#ifdef IIO_THREADED
+	/* The stream thread refills it */
+	if (dev->streaming)
+		size = 1;
+#endif
+	if (!size)
+		ret = iio_call_submit(&ctx, device, IIO_DIRECTION_INPUT);
+	if (!NO_OS_IS_ERR_VALUE(ret))
+		ret = __iio_read_buffer(&ctx, device, buf, len);
+	no_os_mutex_unlock(dev->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Close a buffer opened by iio_consumer_open().
+ * @param desc - IIO descriptor.
+ * @param device - Device id (iio:deviceX).
+ * @return 0 in case of success or negative value otherwise.
+ */
+int iio_consumer_close(struct iio_desc *desc, const char *device)
+{
+	struct iiod_ctx ctx = { .instance = desc };
+
+	if (!desc || !device)
+		return -EINVAL;
+
+	return iio_close_dev(&ctx, device);
+}
+
 #if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING)
 
 static int32_t accept_network_clients(struct iio_desc *desc)
@@ -1473,6 +1864,231 @@ close_socket:
 
 	return ret;
 }
+
+#ifdef IIO_UDP_STREAM
+/**
+ * @brief Send the content of an open input buffer over the UDP stream,
+ * refilling it first if it was drained.
+ * @param desc - IIO descriptor.
+ * @param dev - IIO device, locked.
+ * @param idx - Index of the device, used as stream id.
+ * @param ctx - IIO instance.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_stream_buffer(struct iio_desc *desc, struct iio_dev_priv *dev,
+			     uint32_t idx, struct iiod_ctx *ctx)
+{
+	uint32_t size;
+	void *buf;
+	int ret;
+
+	ret = no_os_cb_size(&dev->buffer.cb, &size);
+	if (NO_OS_IS_ERR_VALUE(ret) && ret != -NO_OS_EOVERRUN)
+		return ret;
+
+	if (!size && dev->trig_idx == NO_TRIGGER) {
+#ifdef IIO_THREADED
+		/* The stream thread refills it */
+		if (dev->streaming)
+			return 0;
+#endif
+		ret = iio_call_submit(ctx, dev->dev_id, IIO_DIRECTION_INPUT);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		no_os_cb_size(&dev->buffer.cb, &size);
+	}
+	if (!size)
+		return 0;
+
+	/* Sent straight from the buffer memory */
+	ret = no_os_cb_prepare_async_read(&dev->buffer.cb, size, &buf, &size);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	ret = udp_stream_send(desc->udp_stream, idx, buf, size);
+	no_os_cb_end_async_read(&dev->buffer.cb);
+
+	return ret;
+}
+
+/**
+ * @brief Send the content of the open input buffers over the UDP stream,
+ * refilling them as soon as they are drained.
+ * @param desc - IIO descriptor.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_stream_buffers(struct iio_desc *desc)
+{
+	struct iiod_ctx ctx = { .instance = desc };
+	struct iio_dev_priv *dev;
+	struct iio_channel *ch;
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < desc->nb_devs; i++) {
+		dev = &desc->devs[i];
+		if (!dev->buffer.initalized || !dev->buffer.public.active_mask ||
+		    dev->buffer.public.cyclic_info.is_cyclic)
+			continue;
+
+		ch = &dev->dev_descriptor->channels[
+			     no_os_find_first_set_bit(dev->buffer.public.active_mask)];
+		if (ch->ch_out)
+			continue;
+
+		no_os_mutex_lock(dev->lock);
+		ret = iio_stream_buffer(desc, dev, i, &ctx);
+		no_os_mutex_unlock(dev->lock);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return 0;
+}
+#endif
+
+#ifdef IIO_THREADED
+/**
+ * @brief Serve the network connections from a worker thread. Each connection
+ * is owned by a single worker while it is stepped.
+ * @param arg - IIO descriptor.
+ * @return NULL.
+ */
+static void *iio_worker_thread(void *arg)
+{
+	struct iio_desc *desc = arg;
+	struct iiod_conn_data data;
+	bool removed = false;
+	uint32_t idle = 0;
+	uint32_t conn_id;
+	int32_t ret;
+
+	while (desc->running) {
+		no_os_mutex_lock(desc->conns_lock);
+		ret = _pop_conn(desc, &conn_id);
+		no_os_mutex_unlock(desc->conns_lock);
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			no_os_mdelay(IIO_NETWORK_WAIT_MS);
+			continue;
+		}
+
+		ret = iiod_conn_step(desc->iiod, conn_id);
+		if (ret == -EAGAIN && !iiod_conn_progress(desc->iiod, conn_id))
+			idle++;
+		else
+			idle = 0;
+
+		no_os_mutex_lock(desc->conns_lock);
+		if (ret == -ENOTCONN)
+			removed = !iiod_conn_remove(desc->iiod, conn_id, &data);
+		else
+			_push_conn(desc, conn_id);
+		no_os_mutex_unlock(desc->conns_lock);
+
+		/* Closing the socket may block, done outside of the lock */
+		if (removed) {
+			socket_remove(data.conn);
+			no_os_free(data.buf);
+			removed = false;
+		}
+
+		/* A whole round over the connections without progress */
+		if (idle > IIOD_MAX_CONNECTIONS) {
+			no_os_mdelay(IIO_NETWORK_WAIT_MS);
+			idle = 0;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Stop and join the connection workers.
+ * @param desc - IIO descriptor.
+ */
+static void iio_workers_stop(struct iio_desc *desc)
+{
+	uint32_t i;
+
+	if (!desc->workers)
+		return;
+
+	desc->running = false;
+	for (i = 0; i < desc->nb_workers; i++)
+		pthread_join(desc->workers[i], NULL);
+
+	no_os_free(desc->workers);
+	desc->workers = NULL;
+	desc->nb_workers = 0;
+	no_os_mutex_remove(desc->conns_lock);
+	desc->conns_lock = NULL;
+}
+
+/**
+ * @brief Start the threads serving the network connections.
+ * @param desc - IIO descriptor.
+ * @param nb - Number of threads, 0 for IIO_DEFAULT_WORKERS.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_workers_start(struct iio_desc *desc, uint32_t nb)
+{
+	if (!nb)
+		nb = IIO_DEFAULT_WORKERS;
+
+	no_os_mutex_init(&desc->conns_lock);
+	if (!desc->conns_lock)
+		return -ENOMEM;
+
+	desc->workers = no_os_calloc(nb, sizeof(*desc->workers));
+	if (!desc->workers) {
+		no_os_mutex_remove(desc->conns_lock);
+		desc->conns_lock = NULL;
+		return -ENOMEM;
+	}
+
+	desc->running = true;
+	for (desc->nb_workers = 0; desc->nb_workers < nb; desc->nb_workers++) {
+		if (pthread_create(&desc->workers[desc->nb_workers], NULL,
+				   iio_worker_thread, desc)) {
+			iio_workers_stop(desc);
+			return -EAGAIN;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief IIO step when the connections are served by the workers: accept the
+ * new clients and keep the UDP stream going.
+ * @param desc - IIO descriptor.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_threaded_step(struct iio_desc *desc)
+{
+	int32_t ret;
+
+	no_os_mutex_lock(desc->conns_lock);
+	ret = accept_network_clients(desc);
+	no_os_mutex_unlock(desc->conns_lock);
+	if (NO_OS_IS_ERR_VALUE(ret) && ret != -EAGAIN)
+		return ret;
+
+#ifdef IIO_UDP_STREAM
+	if (desc->udp_stream) {
+		ret = iio_stream_buffers(desc);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+#endif
+
+	if (ret == -EAGAIN)
+		socket_wait(desc->server, NULL, 0, IIO_NETWORK_WAIT_MS);
+
+	return ret;
+}
+#endif
 #endif
 
 /**
@@ -1488,6 +2104,12 @@ int iio_step(struct iio_desc *desc)
 
 	iio_process_async_triggers(desc);
 
+#if defined(IIO_THREADED) && \
+	(defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING))
+	if (desc->workers)
+		return iio_threaded_step(desc);
+#endif
+
 #if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING)
 	if (desc->server) {
 		ret = accept_network_clients(desc);
@@ -1497,11 +2119,24 @@ int iio_step(struct iio_desc *desc)
 		no_os_lwip_step(desc->server->net->net, desc->server->net->net);
 #endif
 	}
+#ifdef IIO_UDP_STREAM
+	if (desc->udp_stream) {
+		ret = iio_stream_buffers(desc);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+#endif
 #endif
 
 	ret = _pop_conn(desc, &conn_id);
-	if (NO_OS_IS_ERR_VALUE(ret))
+	if (NO_OS_IS_ERR_VALUE(ret)) {
+#if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING)
+		/* Sleep until a client connects instead of polling accept */
+		if (desc->server)
+			socket_wait(desc->server, NULL, 0, IIO_NETWORK_WAIT_MS);
+#endif
 		return ret;
+	}
 
 	ret = iiod_conn_step(desc->iiod, conn_id);
 	if (ret == -ENOTCONN) {
@@ -1514,6 +2149,21 @@ int iio_step(struct iio_desc *desc)
 		_push_conn(desc, conn_id);
 	}
 
+#if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING)
+	if (desc->server) {
+		/* Partial sends or reads still count as progress */
+		if (ret == -EAGAIN && !iiod_conn_progress(desc->iiod, conn_id))
+			desc->idle_steps++;
+		else
+			desc->idle_steps = 0;
+		/* A whole round over the connections without progress */
+		if (desc->idle_steps >= (uint32_t)_nb_active_conns(desc)) {
+			socket_wait(desc->server, NULL, 0, IIO_NETWORK_WAIT_MS);
+			desc->idle_steps = 0;
+		}
+	}
+#endif
+
 	return ret;
 }
 
@@ -1783,6 +2433,25 @@ static int32_t iio_init_xml(struct iio_desc *desc)
 	return 0;
 }
 
+/**
+ * @brief Stop the stream threads and free the device locks.
+ * @param desc - IIO descriptor.
+ */
+static void iio_remove_dev_locks(struct iio_desc *desc)
+{
+	uint32_t i;
+
+	if (!desc->devs)
+		return;
+
+	for (i = 0; i < desc->nb_devs; i++) {
+#ifdef IIO_THREADED
+		iio_stream_stop(&desc->devs[i]);
+#endif
+		no_os_mutex_remove(desc->devs[i].lock);
+	}
+}
+
 static int32_t iio_init_devs(struct iio_desc *desc,
 			     struct iio_device_init *devs, uint32_t n)
 {
@@ -1806,6 +2475,10 @@ static int32_t iio_init_devs(struct iio_desc *desc,
 		ldev->dev_data.dev = ndev->dev;
 		ldev->dev_data.buffer = &ldev->buffer.public;
 		ldev->name = ndev->name;
+		no_os_mutex_init(&ldev->lock);
+#ifdef IIO_THREADED
+		ldev->desc = desc;
+#endif
 		if (ndev->dev_descriptor->read_dev ||
 		    ndev->dev_descriptor->write_dev ||
 		    ndev->dev_descriptor->submit ||
@@ -1905,6 +2578,10 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 	ops->send = iio_send;
 	ops->recv = iio_recv;
 	ops->set_buffers_count = iio_set_buffers_count;
+#if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING)
+	if (init_param->phy_type == USE_NETWORK)
+		ops->sendv = iio_sendv;
+#endif
 
 	iiod_param.instance = ldesc;
 	iiod_param.ops = ops;
@@ -1931,9 +2608,20 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 			.buf = uart_buff,
 			.len = sizeof(uart_buff)
 		};
+#ifdef IIO_UART_TRANSPORT
+		if (init_param->uart_transport_param) {
+			ret = iio_uart_init(&ldesc->uart_transport,
+					    init_param->uart_transport_param);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				goto free_conns;
+			ldesc->send = (int (*)())iio_uart_send;
+			ldesc->recv = (int (*)())iio_uart_recv;
+			data.conn = ldesc->uart_transport;
+		}
+#endif
 		ret = iiod_conn_add(ldesc->iiod, &data, &conn_id);
 		if (NO_OS_IS_ERR_VALUE(ret))
-			goto free_conns;
+			goto free_uart;
 		_push_conn(ldesc, conn_id);
 	}
 #if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING)
@@ -1950,6 +2638,19 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 		ret = socket_listen(ldesc->server, MAX_BACKLOG);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			goto free_pylink;
+#ifdef IIO_UDP_STREAM
+		if (init_param->udp_stream_param) {
+			ret = udp_stream_init(&ldesc->udp_stream,
+					      init_param->udp_stream_param);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				goto free_pylink;
+		}
+#endif
+#ifdef IIO_THREADED
+		ret = iio_workers_start(ldesc, init_param->nb_workers);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			goto free_pylink;
+#endif
 	}
 #endif
 	else if (init_param->phy_type == USE_LOCAL_BACKEND) {
@@ -1976,8 +2677,17 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 
 free_pylink:
 #if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING)
+#ifdef IIO_UDP_STREAM
+	if (ldesc->udp_stream)
+		udp_stream_remove(ldesc->udp_stream);
+#endif
 	socket_remove(ldesc->server);
 #endif
+free_uart:
+#ifdef IIO_UART_TRANSPORT
+	if (ldesc->uart_transport)
+		iio_uart_remove(ldesc->uart_transport);
+#endif
 free_conns:
 	no_os_cb_remove(ldesc->conns);
 free_iiod:
@@ -1987,6 +2697,7 @@ free_xml:
 free_trigs:
 	no_os_free(ldesc->trigs);
 free_devs:
+	iio_remove_dev_locks(ldesc);
 	no_os_free(ldesc->devs);
 free_desc:
 	no_os_free(ldesc);
@@ -2008,6 +2719,9 @@ int iio_remove(struct iio_desc *desc)
 		return -EINVAL;
 
 #if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING)
+#ifdef IIO_THREADED
+	iio_workers_stop(desc);
+#endif
 	for (int i = 0; i < IIOD_MAX_CONNECTIONS; i++) {
 		ret = iiod_conn_remove(desc->iiod, i, &data);
 		if (!ret) {
@@ -2016,9 +2730,18 @@ int iio_remove(struct iio_desc *desc)
 		}
 	}
 	socket_remove(desc->server);
+#ifdef IIO_UDP_STREAM
+	if (desc->udp_stream)
+		udp_stream_remove(desc->udp_stream);
+#endif
+#endif
+#ifdef IIO_UART_TRANSPORT
+	if (desc->uart_transport)
+		iio_uart_remove(desc->uart_transport);
 #endif
 	no_os_cb_remove(desc->conns);
 	iiod_remove(desc->iiod);
+	iio_remove_dev_locks(desc);
 	no_os_free(desc->devs);
 	no_os_free(desc->trigs);
 	no_os_free(desc->xml_desc);
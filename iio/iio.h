@@ -41,8 +41,14 @@
 
 #include "iio_types.h"
 #include "no_os_uart.h"
+#ifdef IIO_UART_TRANSPORT
+#include "iio_uart.h"
+#endif
 #if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING)
 #include "tcp_socket.h"
+#ifdef IIO_UDP_STREAM
+#include "udp_stream.h"
+#endif
 #endif
 
 /******************************************************************************/
@@ -109,6 +115,11 @@ struct iio_init_param {
 		struct tcp_socket_init_param *tcp_socket_init_param;
 #endif
 	};
+#ifdef IIO_UART_TRANSPORT
+	/* When set, USE_UART is served through the UART transport, using
+	 * non-blocking writes and the baud rate negotiation if configured. */
+	struct iio_uart_init_param *uart_transport_param;
+#endif
 	struct iio_local_backend *local_backend;
 	struct iio_ctx_attr *ctx_attrs;
 	uint32_t nb_ctx_attr;
@@ -116,6 +127,17 @@ struct iio_init_param {
 	uint32_t nb_devs;
 	struct iio_trigger_init *trigs;
 	uint32_t nb_trigs;
+#if defined(IIO_UDP_STREAM) && \
+	(defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING))
+	/* When set, the input buffers opened by the clients are streamed as
+	 * datagrams to this peer instead of being read over TCP. */
+	struct udp_stream_init_param *udp_stream_param;
+#endif
+#if defined(IIO_THREADED) && \
+	(defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING))
+	/* Threads serving the network clients, 0 for the default count */
+	uint32_t nb_workers;
+#endif
 };
 
 /******************************************************************************/
@@ -152,4 +174,15 @@ int iio_buffer_push_scan(struct iio_buffer *buffer, void *data);
 /* Read from buffer iio_buffer.bytes_per_scan bytes into data */
 int iio_buffer_pop_scan(struct iio_buffer *buffer, void *data);
 
+/* Local consumer functions, reading an input buffer without a client. */
+/* Open the input buffer of a device */
+int iio_consumer_open(struct iio_desc *desc, const char *device,
+		      uint32_t samples, uint32_t mask,
+		      struct iio_buffer **buffer);
+/* Read up to len bytes, refilling the buffer if it is empty */
+int iio_consumer_read(struct iio_desc *desc, const char *device, void *buf,
+		      uint32_t len);
+/* Close the buffer opened by iio_consumer_open() */
+int iio_consumer_close(struct iio_desc *desc, const char *device);
+
 #endif /* IIO_H_ */
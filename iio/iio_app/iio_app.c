@@ -194,7 +194,15 @@ static int32_t network_setup(struct iio_init_param *iio_init_param,
 	static struct tcp_socket_init_param socket_param;
 
 #ifdef LINUX_PLATFORM
-	socket_param.net = &linux_net;
+	static struct linux_socket_desc *linux_sock;
+	int32_t ret;
+
+	ret = linux_socket_init(&linux_sock, NULL);
+	if (ret)
+		return ret;
+
+	socket_param.net = &linux_sock->net;
+	socket_param.opts.no_delay = true;
 #endif
 #ifdef ADUCM_PLATFORM
 	int32_t status;
@@ -297,7 +305,7 @@ int iio_app_init(struct iio_app_desc **app,
 		 struct iio_app_init_param app_init_param)
 {
 	struct iio_device_init *iio_init_devs = NULL;
-	struct iio_init_param iio_init_param;
+	struct iio_init_param iio_init_param = { 0 };
 	struct no_os_uart_desc *uart_desc;
 	struct iio_app_desc *application;
 	struct iio_data_buffer *buff;
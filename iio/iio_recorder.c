@@ -0,0 +1,617 @@
+/***************************************************************************//**
+ *   @file   iio_recorder.c
+ *   @brief  Record the input buffer of an IIO device to a file.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#ifndef IIO_RECORDER_FATFS
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+#include <errno.h>
+#include <string.h>
+#include "iio_recorder.h"
+#include "no_os_alloc.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+#ifdef IIO_RECORDER_FATFS
+#include "ff.h"
+#endif
+#ifdef IIO_THREADED
+#include <pthread.h>
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+#ifdef IIO_THREADED
+/**
+ * @struct iio_recorder_writer
+ * @brief Thread writing the full blocks while the next one is filled.
+ */
+struct iio_recorder_writer {
+	pthread_t	thread;
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+	/** Block to be written, -1 if none */
+	int32_t		pending;
+	/** Error of the last write */
+	int		err;
+	/** Set to stop the thread */
+	bool		stop;
+};
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+#ifdef IIO_RECORDER_FATFS
+/**
+ * @brief Create the file.
+ * @param rec - Recorder descriptor.
+ * @param path - File path.
+ * @param prealloc - Bytes to be allocated as a contiguous area.
+ * @param unit - Set to the cluster size.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_recorder_file_open(struct iio_recorder *rec, const char *path,
+				  uint64_t prealloc, uint32_t *unit)
+{
+	FIL *fil;
+	FRESULT res;
+
+	fil = no_os_calloc(1, sizeof(*fil));
+	if (!fil)
+		return -ENOMEM;
+
+	res = f_open(fil, path, FA_CREATE_ALWAYS | FA_WRITE);
+	if (res != FR_OK) {
+		no_os_free(fil);
+		return -EIO;
+	}
+
+	*unit = fil->obj.fs->csize * FF_MAX_SS;
+	rec->file = fil;
+
+#if FF_USE_EXPAND
+	/* Contiguous clusters, written without walking the FAT. The size is
+	 * trimmed to the written data when closing. */
+	if (prealloc) {
+		res = f_expand(fil, prealloc, 1);
+		if (res != FR_OK) {
+			f_close(fil);
+			no_os_free(fil);
+			return res == FR_DENIED ? -ENOSPC : -EIO;
+		}
+	}
+#endif
+
+	return 0;
+}
+
+/**
+ * @brief Write to the file.
+ * @param rec - Recorder descriptor.
+ * @param data - Data to be written.
+ * @param len - Length of data.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_recorder_file_write(struct iio_recorder *rec, const void *data,
+				   uint32_t len)
+{
+	UINT written;
+
+	if (f_write(rec->file, data, len, &written) != FR_OK)
+		return -EIO;
+	if (written != len)
+		return -ENOSPC;
+
+	return 0;
+}
+
+/**
+ * @brief Trim the file to the written data and close it.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_recorder_file_close(struct iio_recorder *rec)
+{
+	FRESULT res;
+
+	res = f_truncate(rec->file);
+	if (f_close(rec->file) != FR_OK)
+		res = FR_DISK_ERR;
+	no_os_free(rec->file);
+
+	return res == FR_OK ? 0 : -EIO;
+}
+#else
+/**
+ * @brief Create the file.
+ * @param rec - Recorder descriptor.
+ * @param path - File path.
+ * @param prealloc - Bytes to be allocated up front.
+ * @param unit - Set to the preferred I/O size.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_recorder_file_open(struct iio_recorder *rec, const char *path,
+				  uint64_t prealloc, uint32_t *unit)
+{
+	struct stat st;
+	int ret;
+
+	rec->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (rec->fd < 0)
+		return -errno;
+
+	*unit = IIO_RECORDER_SECTOR_SIZE;
+	if (!fstat(rec->fd, &st) && st.st_blksize > 0)
+		*unit = st.st_blksize;
+
+	/* Reserve the space without changing the file size */
+	if (prealloc && fallocate(rec->fd, FALLOC_FL_KEEP_SIZE, 0, prealloc)) {
+		ret = -errno;
+		/* Not supported by every file system */
+		if (ret != -EOPNOTSUPP) {
+			close(rec->fd);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write to the file.
+ * @param rec - Recorder descriptor.
+ * @param data - Data to be written.
+ * @param len - Length of data.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_recorder_file_write(struct iio_recorder *rec, const void *data,
+				   uint32_t len)
+{
+	const uint8_t *ptr = data;
+	ssize_t ret;
+
+	while (len) {
+		ret = write(rec->fd, ptr, len);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return -errno;
+		}
+		ptr += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Close the file.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_recorder_file_close(struct iio_recorder *rec)
+{
+	if (close(rec->fd))
+		return -errno;
+
+	return 0;
+}
+#endif
+
+/**
+ * @brief Write the file header, describing the recorded channels. It is
+ * padded to the allocation unit, so the blocks of samples which follow start
+ * on a cluster boundary.
+ * @param rec - Recorder descriptor.
+ * @param param - Initialization parameters.
+ * @param buffer - Opened device buffer.
+ * @param unit - Allocation unit of the file.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_recorder_write_header(struct iio_recorder *rec,
+				     struct iio_recorder_init_param *param,
+				     struct iio_buffer *buffer, uint32_t unit)
+{
+	struct iio_channel *ch;
+	uint32_t hdr_len;
+	uint8_t *hdr;
+	uint8_t *rcd;
+	uint16_t nb_ch;
+	uint8_t flags;
+	uint32_t i;
+	int ret;
+
+	nb_ch = no_os_hweight32(buffer->active_mask);
+	hdr_len = no_os_round_up(IIO_RECORDER_HDR_LEN +
+				 nb_ch * IIO_RECORDER_CH_LEN, unit) * unit;
+	hdr = no_os_calloc(1, hdr_len);
+	if (!hdr)
+		return -ENOMEM;
+
+	no_os_put_unaligned_le32(IIO_RECORDER_MAGIC, hdr);
+	no_os_put_unaligned_le16(IIO_RECORDER_VERSION, hdr + 4);
+	no_os_put_unaligned_le16(nb_ch, hdr + 6);
+	no_os_put_unaligned_le32(hdr_len, hdr + 8);
+	no_os_put_unaligned_le32(buffer->bytes_per_scan, hdr + 12);
+	no_os_put_unaligned_le32(buffer->samples, hdr + 16);
+	strncpy((char *)hdr + 20, param->device, IIO_RECORDER_ID_LEN - 1);
+
+	rcd = hdr + IIO_RECORDER_HDR_LEN;
+	for (i = 0; i < param->dev_descriptor->num_ch; i++) {
+		if (!(buffer->active_mask & NO_OS_BIT(i)))
+			continue;
+
+		ch = &param->dev_descriptor->channels[i];
+		if (ch->name)
+			strncpy((char *)rcd, ch->name, IIO_RECORDER_NAME_LEN - 1);
+		no_os_put_unaligned_le16(ch->scan_index, rcd + 16);
+		rcd[18] = ch->ch_type;
+		no_os_put_unaligned_le16(ch->channel, rcd + 20);
+		no_os_put_unaligned_le16(ch->channel2, rcd + 22);
+
+		flags = 0;
+		if (ch->scan_type) {
+			rcd[19] = ch->scan_type->sign;
+			rcd[24] = ch->scan_type->realbits;
+			rcd[25] = ch->scan_type->storagebits;
+			rcd[26] = ch->scan_type->shift;
+			if (ch->scan_type->is_big_endian)
+				flags |= IIO_RECORDER_CH_BIG_ENDIAN;
+		}
+		if (ch->modified)
+			flags |= IIO_RECORDER_CH_MODIFIED;
+		if (ch->indexed)
+			flags |= IIO_RECORDER_CH_INDEXED;
+		if (ch->diferential)
+			flags |= IIO_RECORDER_CH_DIFFERENTIAL;
+		rcd[27] = flags;
+
+		rcd += IIO_RECORDER_CH_LEN;
+	}
+
+	ret = iio_recorder_file_write(rec, hdr, hdr_len);
+	no_os_free(hdr);
+
+	return ret;
+}
+
+#ifdef IIO_THREADED
+/**
+ * @brief Write the blocks handed over by iio_recorder_step().
+ * @param arg - Recorder descriptor.
+ * @return NULL.
+ */
+static void *iio_recorder_writer_thread(void *arg)
+{
+	struct iio_recorder *rec = arg;
+	struct iio_recorder_writer *wr = rec->writer;
+	int32_t idx;
+	int ret;
+
+	pthread_mutex_lock(&wr->lock);
+	while (true) {
+		while (wr->pending < 0 && !wr->stop)
+			pthread_cond_wait(&wr->cond, &wr->lock);
+		if (wr->pending < 0)
+			break;
+
+		idx = wr->pending;
+		pthread_mutex_unlock(&wr->lock);
+
+		ret = iio_recorder_file_write(rec, rec->block[idx],
+					      rec->block_size);
+
+		pthread_mutex_lock(&wr->lock);
+		if (ret)
+			wr->err = ret;
+		wr->pending = -1;
+		pthread_cond_broadcast(&wr->cond);
+	}
+	pthread_mutex_unlock(&wr->lock);
+
+	return NULL;
+}
+
+/**
+ * @brief Hand the active block to the writer thread and switch to the other.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success, -EAGAIN if the other block is still being
+ * written or negative value otherwise.
+ */
+static int iio_recorder_flip(struct iio_recorder *rec)
+{
+	struct iio_recorder_writer *wr = rec->writer;
+	int ret;
+
+	pthread_mutex_lock(&wr->lock);
+	ret = wr->err;
+	if (!ret && wr->pending >= 0)
+		ret = -EAGAIN;
+	if (!ret) {
+		wr->pending = rec->active;
+		pthread_cond_broadcast(&wr->cond);
+	}
+	pthread_mutex_unlock(&wr->lock);
+	if (ret)
+		return ret;
+
+	rec->written += rec->fill;
+	rec->active ^= 1;
+	rec->fill = 0;
+
+	return 0;
+}
+
+/**
+ * @brief Wait for the writer thread to be idle.
+ * @param rec - Recorder descriptor.
+ * @return Error of the last write.
+ */
+static int iio_recorder_drain(struct iio_recorder *rec)
+{
+	struct iio_recorder_writer *wr = rec->writer;
+	int ret;
+
+	pthread_mutex_lock(&wr->lock);
+	while (wr->pending >= 0)
+		pthread_cond_wait(&wr->cond, &wr->lock);
+	ret = wr->err;
+	pthread_mutex_unlock(&wr->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Start the writer thread.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_recorder_writer_start(struct iio_recorder *rec)
+{
+	struct iio_recorder_writer *wr;
+
+	wr = no_os_calloc(1, sizeof(*wr));
+	if (!wr)
+		return -ENOMEM;
+
+	wr->pending = -1;
+	pthread_mutex_init(&wr->lock, NULL);
+	pthread_cond_init(&wr->cond, NULL);
+	rec->writer = wr;
+
+	if (pthread_create(&wr->thread, NULL, iio_recorder_writer_thread, rec)) {
+		pthread_cond_destroy(&wr->cond);
+		pthread_mutex_destroy(&wr->lock);
+		no_os_free(wr);
+		rec->writer = NULL;
+		return -EAGAIN;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Stop the writer thread, once the pending block is written.
+ * @param rec - Recorder descriptor.
+ */
+static void iio_recorder_writer_stop(struct iio_recorder *rec)
+{
+	struct iio_recorder_writer *wr = rec->writer;
+
+	pthread_mutex_lock(&wr->lock);
+	wr->stop = true;
+	pthread_cond_broadcast(&wr->cond);
+	pthread_mutex_unlock(&wr->lock);
+
+	pthread_join(wr->thread, NULL);
+	pthread_cond_destroy(&wr->cond);
+	pthread_mutex_destroy(&wr->lock);
+	no_os_free(wr);
+	rec->writer = NULL;
+}
+#else
+/**
+ * @brief Write the active block and switch to the other one.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_recorder_flip(struct iio_recorder *rec)
+{
+	int ret;
+
+	ret = iio_recorder_file_write(rec, rec->block[rec->active],
+				      rec->block_size);
+	if (ret)
+		return ret;
+
+	rec->written += rec->fill;
+	rec->active ^= 1;
+	rec->fill = 0;
+
+	return 0;
+}
+#endif
+
+/**
+ * @brief Open the device buffer and create the file. The header is written
+ * right away, the samples by iio_recorder_step().
+ * @param rec - Set to the recorder descriptor.
+ * @param param - Initialization parameters.
+ * @return 0 in case of success or negative value otherwise.
+ */
+int iio_recorder_init(struct iio_recorder **rec,
+		      struct iio_recorder_init_param *param)
+{
+	struct iio_recorder *lrec;
+	struct iio_buffer *buffer;
+	uint32_t unit;
+	int ret;
+
+	if (!rec || !param || !param->iio || !param->device ||
+	    !param->dev_descriptor || !param->path || !param->samples)
+		return -EINVAL;
+
+	lrec = no_os_calloc(1, sizeof(*lrec));
+	if (!lrec)
+		return -ENOMEM;
+
+	lrec->iio = param->iio;
+	lrec->device = param->device;
+
+	ret = iio_consumer_open(param->iio, param->device, param->samples,
+				param->mask, &buffer);
+	if (ret)
+		goto free_rec;
+
+	ret = iio_recorder_file_open(lrec, param->path, param->prealloc, &unit);
+	if (ret)
+		goto close_buffer;
+
+	ret = iio_recorder_write_header(lrec, param, buffer, unit);
+	if (ret)
+		goto close_file;
+
+	/* Whole allocation units, so the file system writes them directly */
+	lrec->block_size = param->block_size ? param->block_size :
+			   IIO_RECORDER_BLOCK_SIZE;
+	lrec->block_size = no_os_round_up(lrec->block_size, unit) * unit;
+	lrec->block[0] = no_os_calloc(2, lrec->block_size);
+	if (!lrec->block[0]) {
+		ret = -ENOMEM;
+		goto close_file;
+	}
+	lrec->block[1] = lrec->block[0] + lrec->block_size;
+
+#ifdef IIO_THREADED
+	ret = iio_recorder_writer_start(lrec);
+	if (ret)
+		goto free_blocks;
+#endif
+
+	*rec = lrec;
+
+	return 0;
+
+#ifdef IIO_THREADED
+free_blocks:
+	no_os_free(lrec->block[0]);
+#endif
+close_file:
+	iio_recorder_file_close(lrec);
+close_buffer:
+	iio_consumer_close(param->iio, param->device);
+free_rec:
+	no_os_free(lrec);
+
+	return ret;
+}
+
+/**
+ * @brief Move the samples available in the device buffer to the active
+ * block, up to a block per call. A full block is written while the other
+ * one is being filled.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success or negative value otherwise.
+ */
+int iio_recorder_step(struct iio_recorder *rec)
+{
+	int ret;
+
+	if (!rec)
+		return -EINVAL;
+
+	/* At most a block per step, the device may always have data */
+	while (rec->fill < rec->block_size) {
+		ret = iio_consumer_read(rec->iio, rec->device,
+					rec->block[rec->active] + rec->fill,
+					rec->block_size - rec->fill);
+		if (ret == -EAGAIN)
+			return 0;
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+		rec->fill += ret;
+	}
+
+	ret = iio_recorder_flip(rec);
+	/* Other block still being written, the samples wait in the device
+	 * buffer */
+	if (ret == -EAGAIN)
+		return 0;
+
+	return ret;
+}
+
+/**
+ * @brief Write the samples left in the active block, close the file and the
+ * device buffer.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success or negative value otherwise.
+ */
+int iio_recorder_remove(struct iio_recorder *rec)
+{
+	int ret = 0;
+	int err;
+
+	if (!rec)
+		return -EINVAL;
+
+#ifdef IIO_THREADED
+	ret = iio_recorder_drain(rec);
+	iio_recorder_writer_stop(rec);
+#endif
+	if (!ret && rec->fill) {
+		ret = iio_recorder_file_write(rec, rec->block[rec->active],
+					      rec->fill);
+		if (!ret)
+			rec->written += rec->fill;
+	}
+
+	err = iio_recorder_file_close(rec);
+	if (!ret)
+		ret = err;
+	err = iio_consumer_close(rec->iio, rec->device);
+	if (!ret)
+		ret = err;
+
+	no_os_free(rec->block[0]);
+	no_os_free(rec);
+
+	return ret;
+}
@@ -0,0 +1,163 @@
+/***************************************************************************//**
+ *   @file   iio_recorder.h
+ *   @brief  Record the input buffer of an IIO device to a file.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_RECORDER_H_
+#define IIO_RECORDER_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "iio.h"
+#include "iio_types.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Bytes written to the file at once when iio_recorder_init_param.block_size
+ * is 0. Always rounded up to the allocation unit of the file system. */
+#define IIO_RECORDER_BLOCK_SIZE		16384
+/* Allocation unit used when the file system doesn't report one. The header
+ * is padded to the allocation unit (the cluster size on FatFs), so the blocks
+ * of samples are written at cluster aligned offsets. */
+#define IIO_RECORDER_SECTOR_SIZE	512
+
+/*
+ * File layout, all the fields are little endian:
+ *
+ *  0  magic "IIOR"
+ *  4  u16 version (IIO_RECORDER_VERSION)
+ *  6  u16 number of channel records
+ *  8  u32 header length, offset of the first scan
+ * 12  u32 bytes per scan
+ * 16  u32 scans acquired per refill
+ * 20  char[IIO_RECORDER_ID_LEN] device id (iio:deviceX)
+ * 52  channel records of IIO_RECORDER_CH_LEN bytes, in scan order:
+ *	 0  char[IIO_RECORDER_NAME_LEN] channel name, may be empty
+ *	16  s16 scan_index
+ *	18  u8  channel type (enum iio_chan_type)
+ *	19  u8  sign ('s' or 'u')
+ *	20  s16 channel
+ *	22  s16 channel2
+ *	24  u8  realbits
+ *	25  u8  storagebits
+ *	26  u8  shift
+ *	27  u8  flags (IIO_RECORDER_CH_*)
+ *	28  u32 reserved
+ * The scans follow at the header length offset, as read from the buffer.
+ */
+#define IIO_RECORDER_MAGIC		0x524F4949
+#define IIO_RECORDER_VERSION		1
+#define IIO_RECORDER_ID_LEN		32
+#define IIO_RECORDER_NAME_LEN		16
+#define IIO_RECORDER_HDR_LEN		(20 + IIO_RECORDER_ID_LEN)
+#define IIO_RECORDER_CH_LEN		32
+
+#define IIO_RECORDER_CH_BIG_ENDIAN	NO_OS_BIT(0)
+#define IIO_RECORDER_CH_MODIFIED	NO_OS_BIT(1)
+#define IIO_RECORDER_CH_INDEXED		NO_OS_BIT(2)
+#define IIO_RECORDER_CH_DIFFERENTIAL	NO_OS_BIT(3)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/**
+ * @struct iio_recorder_init_param
+ * @brief Recorder initialization structure.
+ */
+struct iio_recorder_init_param {
+	/** IIO descriptor the device belongs to */
+	struct iio_desc		*iio;
+	/** Device id (iio:deviceX) */
+	const char		*device;
+	/** Descriptor of the device, describing the recorded channels */
+	struct iio_device	*dev_descriptor;
+	/** Channels to be recorded */
+	uint32_t		mask;
+	/** Scans acquired by a buffer refill */
+	uint32_t		samples;
+	/** File to be created. A FatFS path when built with
+	 *  IIO_RECORDER_FATFS, a Linux path otherwise. */
+	const char		*path;
+	/** Bytes written to the file at once, 0 for IIO_RECORDER_BLOCK_SIZE */
+	uint32_t		block_size;
+	/** Bytes allocated for the file up front, 0 to grow it on writes */
+	uint64_t		prealloc;
+};
+
+/**
+ * @struct iio_recorder
+ * @brief Recorder descriptor.
+ */
+struct iio_recorder {
+	/** IIO descriptor the device belongs to */
+	struct iio_desc		*iio;
+	/** Device id (iio:deviceX) */
+	const char		*device;
+#ifdef IIO_RECORDER_FATFS
+	/** FatFS file object */
+	void			*file;
+#else
+	/** File descriptor */
+	int			fd;
+#endif
+	/** Ping-pong buffers, one is filled while the other is written */
+	uint8_t			*block[2];
+	/** Size of a block */
+	uint32_t		block_size;
+	/** Block being filled */
+	uint32_t		active;
+	/** Bytes in the active block */
+	uint32_t		fill;
+	/** Bytes of samples written to the file */
+	uint64_t		written;
+#ifdef IIO_THREADED
+	/** Thread writing the full blocks */
+	void			*writer;
+#endif
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+/* Open the device buffer and create the file. */
+int iio_recorder_init(struct iio_recorder **rec,
+		      struct iio_recorder_init_param *param);
+/* Move the available samples from the device buffer to the file. */
+int iio_recorder_step(struct iio_recorder *rec);
+/* Write the remaining samples, close the file and the device buffer. */
+int iio_recorder_remove(struct iio_recorder *rec);
+
+#endif /* IIO_RECORDER_H_ */
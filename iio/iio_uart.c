@@ -0,0 +1,471 @@
+/***************************************************************************//**
+ *   @file   iio_uart.c
+ *   @brief  UART transport of the IIO daemon.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "iio_uart.h"
+#include "no_os_alloc.h"
+#include "no_os_delay.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Start writing the oldest contiguous chunk of the transmit ring */
+static void iio_uart_tx_start(struct iio_uart_desc *desc)
+{
+	uint32_t off, len;
+	int32_t ret;
+
+	len = desc->tx_head - desc->tx_tail;
+	if (!len) {
+		desc->tx_busy = 0;
+		return;
+	}
+
+	off = desc->tx_tail & (desc->tx_size - 1);
+	len = no_os_min(len, desc->tx_size - off);
+
+	desc->tx_busy = len;
+	ret = no_os_uart_write_nonblocking(desc->uart_desc, desc->tx_buf + off,
+					   len);
+	/* The data stays in the ring and is retried by the next send */
+	if (ret < 0)
+		desc->tx_busy = 0;
+}
+
+/* Called in interrupt context when a chunk was written */
+static void iio_uart_tx_done(void *ctx)
+{
+	struct iio_uart_desc *desc = ctx;
+
+	desc->tx_tail += desc->tx_busy;
+	iio_uart_tx_start(desc);
+}
+
+/* Time needed to send len bytes at the current rate, plus a guard time */
+static uint32_t iio_uart_tx_time_ms(struct iio_uart_desc *desc, uint32_t len)
+{
+	return len * 10 * 1000 / desc->uart_desc->baud_rate + IIO_UART_GUARD_MS;
+}
+
+/* Wait for the transmit ring to be empty */
+static int iio_uart_tx_drain(struct iio_uart_desc *desc)
+{
+	uint32_t ms;
+
+	if (!desc->tx_buf)
+		return 0;
+
+	ms = iio_uart_tx_time_ms(desc, desc->tx_size);
+	while (desc->tx_head != desc->tx_tail) {
+		if (!desc->tx_busy)
+			iio_uart_tx_start(desc);
+		if (!ms--)
+			return -ETIMEDOUT;
+		no_os_mdelay(1);
+	}
+
+	return 0;
+}
+
+/* Blocking write of a negotiation reply */
+static int iio_uart_reply(struct iio_uart_desc *desc, const char *str)
+{
+	int32_t ret;
+
+	ret = no_os_uart_write(desc->uart_desc, (const uint8_t *)str,
+			       strlen(str));
+
+	return ret < 0 ? ret : 0;
+}
+
+/*
+ * Copy the first complete line of the receive buffer to cmd, without the
+ * line terminator. Returns the length of the line in the buffer, 0 if there
+ * is no complete line.
+ */
+static uint32_t iio_uart_get_line(struct iio_uart_desc *desc, char *cmd)
+{
+	char *eol;
+	uint32_t n;
+
+	eol = memchr(desc->line, '\n', desc->line_len);
+	if (!eol)
+		return 0;
+
+	n = eol - desc->line;
+	memcpy(cmd, desc->line, n);
+	if (n && cmd[n - 1] == '\r')
+		n--;
+	cmd[n] = '\0';
+
+	return eol - desc->line + 1;
+}
+
+/* Remove the first len bytes of the receive buffer */
+static void iio_uart_drop_line(struct iio_uart_desc *desc, uint32_t len)
+{
+	desc->line_len -= len;
+	memmove(desc->line, desc->line + len, desc->line_len);
+}
+
+/* Read the available bytes into the line buffer */
+static int iio_uart_fill_line(struct iio_uart_desc *desc)
+{
+	int32_t ret;
+
+	ret = no_os_uart_read(desc->uart_desc,
+			      (uint8_t *)desc->line + desc->line_len,
+			      IIO_UART_LINE_LEN - desc->line_len);
+	if (ret < 0)
+		return ret;
+
+	desc->line_len += ret;
+
+	return 0;
+}
+
+/* Wait for the PING of the client at the new rate and answer it */
+static int iio_uart_verify(struct iio_uart_desc *desc)
+{
+	char cmd[IIO_UART_LINE_LEN + 1];
+	char reply[IIO_UART_LINE_LEN + 8];
+	uint32_t ms, len;
+	char *ping;
+	int ret;
+
+	desc->line_len = 0;
+	for (ms = 0; ms < IIO_UART_VERIFY_MS; ms++) {
+		ret = iio_uart_fill_line(desc);
+		if (ret && ret != -EAGAIN)
+			return ret;
+
+		/* Bytes received during the switch may prefix the line */
+		while ((len = iio_uart_get_line(desc, cmd))) {
+			iio_uart_drop_line(desc, len);
+			ping = strstr(cmd, "PING ");
+			if (!ping)
+				continue;
+
+			snprintf(reply, sizeof(reply), "PONG %s\n", ping + 5);
+
+			return iio_uart_reply(desc, reply);
+		}
+		if (desc->line_len == IIO_UART_LINE_LEN)
+			desc->line_len = 0;
+
+		if (ret == -EAGAIN)
+			no_os_mdelay(1);
+	}
+
+	return -ETIMEDOUT;
+}
+
+/* Switch to the rate requested by the client, fall back if it is not seen */
+static int iio_uart_set_baud(struct iio_uart_desc *desc, uint32_t baud_rate)
+{
+	uint32_t old = desc->uart_desc->baud_rate;
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < desc->nb_baud_rates; i++)
+		if (desc->baud_rates[i] == baud_rate)
+			break;
+	if (i == desc->nb_baud_rates)
+		return iio_uart_reply(desc, "ERROR\n");
+
+	ret = iio_uart_reply(desc, "OK\n");
+	if (ret)
+		return ret;
+
+	no_os_mdelay(iio_uart_tx_time_ms(desc, 3));
+
+	/*
+	 * The rate is unchanged if the UART can't use the new one. The client
+	 * then gets no PONG and goes back to the current rate by itself.
+	 */
+	ret = no_os_uart_set_baud(desc->uart_desc, baud_rate);
+	if (ret)
+		return 0;
+
+	ret = iio_uart_verify(desc);
+	if (ret != -ETIMEDOUT)
+		return ret;
+
+	return no_os_uart_set_baud(desc->uart_desc, old);
+}
+
+/* Handle a negotiation line */
+static int iio_uart_command(struct iio_uart_desc *desc, char *cmd)
+{
+	char reply[IIO_UART_LINE_LEN * 2];
+	uint32_t i, len;
+
+	if (!strcmp(cmd, "BAUD?")) {
+		len = snprintf(reply, sizeof(reply), "BAUD");
+		for (i = 0; i < desc->nb_baud_rates; i++) {
+			len += snprintf(reply + len, sizeof(reply) - len,
+					" %lu", (unsigned long)desc->baud_rates[i]);
+			if (len >= sizeof(reply) - 1)
+				return -ENOMEM;
+		}
+		reply[len] = '\n';
+		reply[len + 1] = '\0';
+
+		return iio_uart_reply(desc, reply);
+	}
+
+	if (!strncmp(cmd, "BAUD ", 5))
+		return iio_uart_set_baud(desc, strtoul(cmd + 5, NULL, 10));
+
+	if (!strncmp(cmd, "PING ", 5)) {
+		snprintf(reply, sizeof(reply), "PONG %s\n", cmd + 5);
+
+		return iio_uart_reply(desc, reply);
+	}
+
+	return iio_uart_reply(desc, "ERROR\n");
+}
+
+/* Handle the negotiation lines until the first IIOD command */
+static int iio_uart_negotiate(struct iio_uart_desc *desc)
+{
+	char cmd[IIO_UART_LINE_LEN + 1];
+	uint32_t len;
+	int ret;
+
+	ret = iio_uart_fill_line(desc);
+	if (ret)
+		return ret;
+
+	while (desc->negotiating) {
+		len = iio_uart_get_line(desc, cmd);
+		if (!len) {
+			if (desc->line_len < IIO_UART_LINE_LEN)
+				return -EAGAIN;
+			/* Too long for a negotiation line */
+			desc->negotiating = false;
+			break;
+		}
+
+		if (strncmp(cmd, "BAUD", 4) && strncmp(cmd, "PING ", 5)) {
+			/* The line is left in the buffer for IIOD */
+			desc->negotiating = false;
+			break;
+		}
+
+		iio_uart_drop_line(desc, len);
+		ret = iio_uart_command(desc, cmd);
+		if (ret)
+			return ret;
+	}
+
+	desc->line_idx = 0;
+
+	return 0;
+}
+
+/**
+ * @brief Receive callback of IIOD.
+ * @param desc - Transport descriptor.
+ * @param buf - Buffer to be filled.
+ * @param len - Size of the buffer.
+ * @return Number of bytes read, -EAGAIN if none is available, negative error
+ * code otherwise.
+ */
+int iio_uart_recv(struct iio_uart_desc *desc, uint8_t *buf, uint32_t len)
+{
+	int ret;
+
+	if (desc->negotiating) {
+		ret = iio_uart_negotiate(desc);
+		if (ret)
+			return ret;
+	}
+
+	/* Bytes read during the negotiation */
+	if (desc->line_idx < desc->line_len) {
+		len = no_os_min(len, desc->line_len - desc->line_idx);
+		memcpy(buf, desc->line + desc->line_idx, len);
+		desc->line_idx += len;
+
+		return len;
+	}
+
+	return no_os_uart_read(desc->uart_desc, buf, len);
+}
+
+/**
+ * @brief Send callback of IIOD.
+ * With non-blocking writes the data is queued in the transmit ring and the
+ * call returns the number of bytes which fit in it.
+ * @param desc - Transport descriptor.
+ * @param buf - Data to be sent.
+ * @param len - Number of bytes to be sent.
+ * @return Number of bytes sent or queued, -EAGAIN if the ring is full,
+ * negative error code otherwise.
+ */
+int iio_uart_send(struct iio_uart_desc *desc, uint8_t *buf, uint32_t len)
+{
+	uint32_t off, chunk, room;
+
+	if (!desc->tx_buf)
+		return no_os_uart_write(desc->uart_desc, buf, len);
+
+	room = desc->tx_size - (desc->tx_head - desc->tx_tail);
+	len = no_os_min(len, room);
+	if (!len) {
+		if (!desc->tx_busy)
+			iio_uart_tx_start(desc);
+		return -EAGAIN;
+	}
+
+	off = desc->tx_head & (desc->tx_size - 1);
+	chunk = no_os_min(len, desc->tx_size - off);
+	memcpy(desc->tx_buf + off, buf, chunk);
+	memcpy(desc->tx_buf, buf + chunk, len - chunk);
+	desc->tx_head += len;
+
+	if (!desc->tx_busy)
+		iio_uart_tx_start(desc);
+
+	return len;
+}
+
+/**
+ * @brief Initialize the UART transport.
+ * @param desc - Transport descriptor.
+ * @param param - Initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int iio_uart_init(struct iio_uart_desc **desc,
+		  struct iio_uart_init_param *param)
+{
+	struct iio_uart_desc *d;
+	int ret;
+
+	if (!desc || !param || !param->uart_desc)
+		return -EINVAL;
+
+	if (param->baud_rates && !param->nb_baud_rates)
+		return -EINVAL;
+
+	/* The negotiated rate is set without initializing the UART again */
+	if (param->baud_rates && !param->uart_desc->platform_ops->set_baud)
+		return -ENOSYS;
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	d->uart_desc = param->uart_desc;
+	d->baud_rates = param->baud_rates;
+	d->nb_baud_rates = param->nb_baud_rates;
+	d->negotiating = !!d->baud_rates;
+
+	if (param->tx_nonblocking) {
+		d->tx_size = param->tx_size ? param->tx_size : IIO_UART_TX_SIZE;
+		if (d->tx_size & (d->tx_size - 1)) {
+			ret = -EINVAL;
+			goto free_desc;
+		}
+
+		d->tx_buf = no_os_calloc(1, d->tx_size);
+		if (!d->tx_buf) {
+			ret = -ENOMEM;
+			goto free_desc;
+		}
+
+		d->irq_desc = param->irq_desc;
+		d->irq_id = param->irq_id;
+		d->tx_cb.callback = iio_uart_tx_done;
+		d->tx_cb.ctx = d;
+		d->tx_cb.event = NO_OS_EVT_UART_TX_COMPLETE;
+		d->tx_cb.peripheral = NO_OS_UART_IRQ;
+		d->tx_cb.handle = param->irq_handle;
+
+		ret = no_os_irq_register_callback(d->irq_desc, d->irq_id,
+						  &d->tx_cb);
+		if (ret)
+			goto free_tx;
+
+		ret = no_os_irq_enable(d->irq_desc, d->irq_id);
+		if (ret)
+			goto unregister;
+	}
+
+	*desc = d;
+
+	return 0;
+
+unregister:
+	no_os_irq_unregister_callback(d->irq_desc, d->irq_id, &d->tx_cb);
+free_tx:
+	no_os_free(d->tx_buf);
+free_desc:
+	no_os_free(d);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by iio_uart_init().
+ * The queued data is sent first. The UART is left to its owner.
+ * @param desc - Transport descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int iio_uart_remove(struct iio_uart_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->tx_buf) {
+		iio_uart_tx_drain(desc);
+		no_os_irq_unregister_callback(desc->irq_desc, desc->irq_id,
+					      &desc->tx_cb);
+		no_os_free(desc->tx_buf);
+	}
+
+	no_os_free(desc);
+
+	return 0;
+}
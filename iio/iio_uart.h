@@ -0,0 +1,151 @@
+/***************************************************************************//**
+ *   @file   iio_uart.h
+ *   @brief  UART transport of the IIO daemon.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_UART_H_
+#define IIO_UART_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "no_os_uart.h"
+#include "no_os_irq.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Size of the transmit ring when iio_uart_init_param.tx_size is 0 */
+#define IIO_UART_TX_SIZE		4096
+/* Longest negotiation line, longer lines end the negotiation */
+#define IIO_UART_LINE_LEN		64
+/* Time given to the client to switch and send PING at the new rate */
+#define IIO_UART_VERIFY_MS		500
+/* Guard time after the last byte sent at the old rate */
+#define IIO_UART_GUARD_MS		10
+
+/*
+ * Baud rate negotiation. It runs before the first IIOD command, every line
+ * is terminated by '\n':
+ *
+ *  client: BAUD?		server: BAUD <rate> <rate> ...
+ *  client: BAUD <rate>	server: OK (at the current rate), then switches
+ *  client: PING <text>	server: PONG <text> (at the new rate)
+ *
+ * If no PING is received in IIO_UART_VERIFY_MS, the server goes back to the
+ * previous rate. A rate which is not listed is answered with ERROR. The first
+ * line which is not part of the negotiation is passed to IIOD and ends it, so
+ * clients which do not negotiate are served at the initial rate.
+ */
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/**
+ * @struct iio_uart_init_param
+ * @brief UART transport initialization structure.
+ */
+struct iio_uart_init_param {
+	/** UART used by the transport, it stays owned by the caller */
+	struct no_os_uart_desc		*uart_desc;
+	/** Rates which can be negotiated, NULL disables the negotiation.
+	 *  The rate is changed with no_os_uart_set_baud() and uart_desc must
+	 *  be initialized with asynchronous_rx, so that reads don't block. */
+	const uint32_t			*baud_rates;
+	/** Number of entries in baud_rates */
+	uint32_t			nb_baud_rates;
+	/** Send through no_os_uart_write_nonblocking() from a ring buffer.
+	 *  The platform must support interrupt driven writes next to the
+	 *  receive mode of the UART. */
+	bool				tx_nonblocking;
+	/** Size of the transmit ring, a power of 2. 0 for IIO_UART_TX_SIZE */
+	uint32_t			tx_size;
+	/** Interrupt controller signaling NO_OS_EVT_UART_TX_COMPLETE */
+	struct no_os_irq_ctrl_desc	*irq_desc;
+	/** Interrupt id of the UART */
+	uint32_t			irq_id;
+	/** Platform specific handle of the UART, used to match the callback */
+	void				*irq_handle;
+};
+
+/**
+ * @struct iio_uart_desc
+ * @brief UART transport descriptor.
+ */
+struct iio_uart_desc {
+	/** UART used by the transport */
+	struct no_os_uart_desc		*uart_desc;
+	/** Rates which can be negotiated */
+	const uint32_t			*baud_rates;
+	/** Number of entries in baud_rates */
+	uint32_t			nb_baud_rates;
+	/** Set until the first IIOD command is received */
+	bool				negotiating;
+	/** Partially received negotiation line */
+	char				line[IIO_UART_LINE_LEN];
+	/** Bytes in line */
+	uint32_t			line_len;
+	/** Bytes of line already passed to IIOD */
+	uint32_t			line_idx;
+	/** Transmit ring, NULL for blocking writes */
+	uint8_t				*tx_buf;
+	/** Size of the transmit ring */
+	uint32_t			tx_size;
+	/** Free running write index of the ring */
+	volatile uint32_t		tx_head;
+	/** Free running read index of the ring */
+	volatile uint32_t		tx_tail;
+	/** Bytes of the write in progress, 0 if the UART is idle */
+	volatile uint32_t		tx_busy;
+	/** Interrupt controller signaling the end of the writes */
+	struct no_os_irq_ctrl_desc	*irq_desc;
+	/** Interrupt id of the UART */
+	uint32_t			irq_id;
+	/** End of write callback */
+	struct no_os_callback_desc	tx_cb;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+/* Initialize the UART transport. */
+int iio_uart_init(struct iio_uart_desc **desc,
+		  struct iio_uart_init_param *param);
+/* Free the resources allocated by iio_uart_init(). */
+int iio_uart_remove(struct iio_uart_desc *desc);
+/* Receive callback of IIOD, returns the bytes read or -EAGAIN. */
+int iio_uart_recv(struct iio_uart_desc *desc, uint8_t *buf, uint32_t len);
+/* Send callback of IIOD, returns the bytes queued or -EAGAIN. */
+int iio_uart_send(struct iio_uart_desc *desc, uint8_t *buf, uint32_t len);
+
+#endif /* IIO_UART_H_ */
@@ -324,6 +324,7 @@ int32_t iiod_copy_ops(struct iiod_ops *ops, struct iiod_ops *new_ops)
 
 	ops->recv = new_ops->recv;
 	ops->send = new_ops->send;
+	ops->sendv = new_ops->sendv;
 
 	ops->open = SET_DUMMY_IF_NULL(new_ops->open, dummy_open);
 	ops->close = SET_DUMMY_IF_NULL(new_ops->close, dummy_close);
@@ -484,6 +485,8 @@ static int32_t rw_iiod_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn,
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 
+		if (ret > 0)
+			conn->progress = true;
 		buf->idx += ret;
 		if (ret < len)
 			return -EAGAIN;
@@ -496,11 +499,72 @@ static int32_t rw_iiod_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn,
 
 		if (ret != 1)
 			return -EAGAIN;
+		conn->progress = true;
 	}
 
 	return 0;
 }
 
+/*
+ * Send the result value line followed by the result buffer line without
+ * blocking. With ops.sendv all the remaining pieces go in a single call.
+ * When done will return 0, if there is still data to be sent it will return
+ * -EAGAIN. On error, an negative error code is returned
+ */
+static int32_t iiod_write_result(struct iiod_desc *desc,
+				 struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_iovec iov[4];
+	char val[12];
+	uint32_t nb = 0;
+	uint32_t total = 0;
+	uint32_t skip;
+	uint32_t i;
+	int32_t ret;
+
+	if (conn->res.write_val) {
+		ret = sprintf(val, "%"PRIi32, conn->res.val);
+		iov[nb++] = (struct iiod_iovec) {val, ret};
+		iov[nb++] = (struct iiod_iovec) {"\n", 1};
+	}
+	if (conn->res.buf.buf && conn->res.buf.len) {
+		iov[nb++] = (struct iiod_iovec) {conn->res.buf.buf, conn->res.buf.len};
+		iov[nb++] = (struct iiod_iovec) {"\n", 1};
+	}
+
+	for (i = 0; i < nb; i++)
+		total += iov[i].len;
+
+	/* Skip what the previous steps already sent */
+	skip = conn->res.sent;
+	for (i = 0; i < nb && skip >= iov[i].len; i++)
+		skip -= iov[i].len;
+	if (i == nb)
+		return 0;
+
+	iov[i].buf = (const char *)iov[i].buf + skip;
+	iov[i].len -= skip;
+
+	for (; i < nb; i++) {
+		if (desc->ops.sendv)
+			ret = desc->ops.sendv(&ctx, iov + i, nb - i);
+		else
+			ret = desc->ops.send(&ctx, (uint8_t *)iov[i].buf,
+					     iov[i].len);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		if (ret > 0)
+			conn->progress = true;
+		conn->res.sent += ret;
+		if (desc->ops.sendv || (uint32_t)ret < iov[i].len)
+			break;
+	}
+
+	return conn->res.sent < total ? -EAGAIN : 0;
+}
+
 static int32_t do_read_buff_delayed(struct iiod_desc *desc,
 				    struct iiod_conn_priv *conn)
 {
@@ -718,6 +782,8 @@ static int32_t iiod_read_line(struct iiod_desc *desc,
 		if (NO_OS_IS_ERR_VALUE(ret))
 			goto end;
 
+		conn->progress = true;
+
 		if (conn->parser_idx == 0 && (*ch == '\n' || *ch == '\r'))
 			continue ;
 
@@ -786,31 +852,13 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 
 		return 0;
 	case IIOD_WRITING_CMD_RESULT:
-		/* Write result or the length of data to be sent*/
-		if (conn->res.write_val) {
-			if (conn->nb_buf.len == 0) {
-				conn->nb_buf.buf = conn->parser_buf;
-				ret = sprintf(conn->nb_buf.buf, "%"PRIi32,
-					      conn->res.val);
-				conn->nb_buf.len = ret;
-				conn->nb_buf.idx = 0;
-			}
-			/* Non-blocking. Will enter here until val is sent */
-			if (conn->nb_buf.idx < conn->nb_buf.len) {
-				ret = rw_iiod_buff(desc, conn, &conn->nb_buf,
-						   IIOD_WR | IIOD_ENDL);
-				if (NO_OS_IS_ERR_VALUE(ret))
-					return ret;
-			}
-		}
-		/* Send buf from result. Non blocking */
-		if (conn->res.buf.buf &&
-		    conn->res.buf.idx < conn->res.buf.len) {
-			ret = rw_iiod_buff(desc, conn, &conn->res.buf,
-					   IIOD_WR | IIOD_ENDL);
-			if (NO_OS_IS_ERR_VALUE(ret))
-				return ret;
-		}
+		/*
+		 * Write result or the length of data to be sent, then buf
+		 * from result. Non-blocking, will enter here until all is sent
+		 */
+		ret = iiod_write_result(desc, conn);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
 
 		if (conn->cmd_data.cmd != IIOD_CMD_READBUF &&
 		    conn->cmd_data.cmd != IIOD_CMD_WRITEBUF) {
@@ -843,6 +891,7 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 					return 0;
 				}
 				memset(&conn->res.buf, 0, sizeof(conn->res.buf));
+				conn->res.sent = 0;
 				conn->res.val = conn->cmd_data.bytes_count;
 				conn->cmd_data.cmd = IIOD_CMD_PRINT;
 				conn->state = IIOD_WRITING_CMD_RESULT;
@@ -912,6 +961,7 @@ int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id)
 		return -EINVAL;
 
 	conn = &desc->conns[conn_id];
+	conn->progress = false;
 	do {
 		ret = iiod_run_state(desc, conn);
 		if (ret == -EAGAIN)
@@ -925,3 +975,12 @@ int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id)
 
 	return ret;
 }
+
+bool iiod_conn_progress(struct iiod_desc *desc, uint32_t conn_id)
+{
+	if (!desc || conn_id >= IIOD_MAX_CONNECTIONS ||
+	    !desc->conns[conn_id].used)
+		return false;
+
+	return desc->conns[conn_id].progress;
+}
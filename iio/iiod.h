@@ -75,6 +75,12 @@ struct iiod_ctx {
 	void *conn;
 };
 
+/* Piece of data sent by iiod_ops.sendv */
+struct iiod_iovec {
+	const void *buf;
+	uint32_t len;
+};
+
 struct iiod_conn_data {
 	/* Value to be used in iiod_ctx */
 	void *conn;
@@ -97,6 +103,13 @@ struct iiod_ops {
 	 */
 	int (*send)(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len);
 	int (*recv)(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len);
+	/*
+	 * Optional. Send the nb pieces of iov in order with a single call.
+	 * Same return values as send, a command result line and its payload
+	 * are then sent together.
+	 */
+	int (*sendv)(struct iiod_ctx *ctx, const struct iiod_iovec *iov,
+		     uint32_t nb);
 
 	/*
 	 * This is the equivalent of libiio iio_device_create_buffer.
@@ -188,5 +201,7 @@ int32_t iiod_conn_remove(struct iiod_desc *desc, uint32_t conn_id,
 			 struct iiod_conn_data *data);
 /* Advance in the state machine of a connection. Will not block */
 int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id);
+/* True if the last iiod_conn_step of conn_id sent or received any data */
+bool iiod_conn_progress(struct iiod_desc *desc, uint32_t conn_id);
 
 #endif //IIOD_H
@@ -107,6 +107,8 @@ struct iiod_run_cmd_result {
 	bool write_val;
 	/* If buf.len != 0 buf has to be sent */
 	struct iiod_buff buf;
+	/* Bytes of the value and buf lines already sent */
+	uint32_t sent;
 };
 
 /* Internal structure to handle a connection state */
@@ -157,6 +159,8 @@ struct iiod_conn_priv {
 	char *strtok_ctx;
 	/* True if the device was open with cyclic buffer flag */
 	bool is_cyclic_buffer;
+	/* Set when data was sent or received during the current step */
+	bool progress;
 };
 
 /* Private iiod information */
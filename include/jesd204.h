@@ -244,11 +244,32 @@ struct jesd204_topology_dev {
 	unsigned int		links_number;
 };
 
+/* no-OS specific */
+/**
+ * @struct jesd204_fsm_stats
+ * @brief JESD204 FSM timing and error information of the last transition
+ * @param state_us:		wall time spent in each state, in microseconds
+ * @param dev_state_us:		time spent in the ops of each device, per state,
+ *				indexed [op * (devs_number + 1) + dev] with the
+ *				top device last
+ * @param error:		error returned by the failing op, 0 if none failed
+ * @param failed_op:		state in which the transition failed
+ * @param failed_dev:		device whose op failed
+ */
+struct jesd204_fsm_stats {
+	uint32_t			state_us[__JESD204_MAX_OPS];
+	uint32_t			*dev_state_us;
+	int				error;
+	enum jesd204_dev_op		failed_op;
+	struct jesd204_dev		*failed_dev;
+};
+
 /* no-OS specific */
 struct jesd204_topology {
 	struct jesd204_dev_top		*dev_top;
 	struct jesd204_topology_dev	*devs;
 	unsigned int			devs_number;
+	struct jesd204_fsm_stats	stats;
 };
 
 /* no-OS specific */
@@ -272,6 +293,11 @@ int jesd204_fsm_start(struct jesd204_topology *topology, unsigned int link_idx);
 /* no-OS specific */
 int jesd204_fsm_stop(struct jesd204_topology *topology, unsigned int link_idx);
 
+/* no-OS specific */
+int jesd204_fsm_state_duration(struct jesd204_topology *topology,
+			       struct jesd204_dev *jdev,
+			       enum jesd204_dev_op op, uint32_t *us);
+
 void *jesd204_dev_priv(struct jesd204_dev *jdev);
 
 int jesd204_link_get_lmfc_lemc_rate(struct jesd204_link *lnk,
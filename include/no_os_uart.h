@@ -168,6 +168,8 @@ struct no_os_uart_platform_ops {
 	int32_t (*remove)(struct no_os_uart_desc *);
 	/** UART get errors function pointer */
 	uint32_t (*get_errors)(struct no_os_uart_desc *);
+	/** UART set baud rate function pointer */
+	int32_t (*set_baud)(struct no_os_uart_desc *, uint32_t);
 };
 
 /******************************************************************************/
@@ -201,6 +203,9 @@ int32_t no_os_uart_remove(struct no_os_uart_desc *desc);
 /* Check if UART errors occurred. */
 uint32_t no_os_uart_get_errors(struct no_os_uart_desc *desc);
 
+/* Change the baud rate of an initialized UART. */
+int32_t no_os_uart_set_baud(struct no_os_uart_desc *desc, uint32_t baud_rate);
+
 /* Make stdio to use this UART. */
 void no_os_uart_stdio(struct no_os_uart_desc *desc);
 
@@ -96,6 +96,15 @@ int jesd204_topology_init(struct jesd204_topology **topology,
 	top->devs_number = devs_number - 1;
 	top->devs = (struct jesd204_topology_dev *)no_os_calloc(1,
 			top->devs_number * sizeof(*top->devs));
+	top->stats.dev_state_us = (uint32_t *)no_os_calloc(__JESD204_MAX_OPS *
+				  devs_number, sizeof(*top->stats.dev_state_us));
+	if (!top->devs || !top->stats.dev_state_us) {
+		no_os_free(top->stats.dev_state_us);
+		no_os_free(top->devs);
+		no_os_free(top->dev_top);
+		no_os_free(top);
+		return -ENOMEM;
+	}
 
 	for (i = 0; i < devs_number; i++) {
 		if (devs[i].is_top_device) {
@@ -125,6 +134,9 @@ int jesd204_topology_remove(struct jesd204_topology *topology)
 	if (!topology)
 		return -EINVAL;
 
+	no_os_free(topology->stats.dev_state_us);
+	no_os_free(topology->devs);
+	no_os_free(topology->dev_top->active_links);
 	no_os_free(topology->dev_top);
 	no_os_free(topology);
 
@@ -5,97 +5,494 @@
  */
 
 #include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_delay.h"
+#include "no_os_print_log.h"
 #include "jesd204-priv.h"
 
+/* Interval between polls of ops that deferred their state change */
+#define JESD204_FSM_DEFER_POLL_US	1000
+/* Give up on a state after this many polls without any op completing */
+#define JESD204_FSM_DEFER_MAX_POLLS	5000
+
 /* no-OS specific */
-int jesd204_fsm_start(struct jesd204_topology *topology, unsigned int link_idx)
+/**
+ * struct jesd204_fsm_item - one state op call within a transition
+ * @jdev		device the op belongs to
+ * @dev_idx		index of the device in the topology stats
+ * @ol			link the op is called for, NULL for per_device ops
+ * @dep			per_device item of the device planned in a previous
+ *			chain, -1 if none; the op waits for it to complete
+ * @done		the op completed in the current state
+ * @last_op		last state the op was called for without failing,
+ *			-1 if none; only these states are unwound
+ */
+struct jesd204_fsm_item {
+	struct jesd204_dev		*jdev;
+	unsigned int			dev_idx;
+	struct jesd204_link_opaque	*ol;
+	int				dep;
+	bool				done;
+	int				last_op;
+};
+
+/* no-OS specific */
+/**
+ * struct jesd204_fsm_plan - order of the op calls of a transition
+ * @items		op calls, grouped in one chain per link
+ * @chain_start		index of the first item of each chain, the last entry
+ *			marks the end of the last chain
+ * @pos			next item to be called in each chain
+ * @num_chains		number of link chains
+ * @top			per_device op call of the top device
+ *
+ * A link chain holds the ops in the order of the sequential bring-up: for
+ * each device on the link, its per_device op, if no previous link has it,
+ * then its per_link op, and last the per_link op of the top device. The
+ * items of a chain are called in order. The chains of different links are
+ * interleaved whenever an op defers, except that the per_link op of a device
+ * shared with a previous link waits for the per_device op of that device.
+ */
+struct jesd204_fsm_plan {
+	struct jesd204_fsm_item		*items;
+	unsigned int			*chain_start;
+	unsigned int			*pos;
+	unsigned int			num_chains;
+	struct jesd204_fsm_item		top;
+};
+
+static uint32_t jesd204_fsm_elapsed_us(struct no_os_time start)
+{
+	struct no_os_time now = no_os_get_time();
+
+	return (now.s - start.s) * 1000000 + now.us - start.us;
+}
+
+static uint32_t *jesd204_fsm_dev_us(struct jesd204_topology *topology,
+				    enum jesd204_dev_op op, unsigned int dev_idx)
+{
+	return &topology->stats.dev_state_us[op * (topology->devs_number + 1) +
+					     dev_idx];
+}
+
+static bool jesd204_fsm_dev_on_link(struct jesd204_topology_dev *tdev,
+				    unsigned int link_id)
+{
+	unsigned int lnk_dev;
+
+	for (lnk_dev = 0; lnk_dev < tdev->links_number; lnk_dev++)
+		if (tdev->link_ids[lnk_dev] == link_id)
+			return true;
+
+	return false;
+}
+
+static void jesd204_fsm_plan_add(struct jesd204_fsm_plan *plan,
+				 unsigned int *n, struct jesd204_dev *jdev,
+				 unsigned int dev_idx,
+				 struct jesd204_link_opaque *ol, int dep)
+{
+	plan->items[*n].jdev = jdev;
+	plan->items[*n].dev_idx = dev_idx;
+	plan->items[*n].ol = ol;
+	plan->items[*n].dep = dep;
+	plan->items[*n].last_op = -1;
+	(*n)++;
+}
+
+static void jesd204_fsm_plan_remove(struct jesd204_fsm_plan *plan)
+{
+	no_os_free(plan->items);
+	no_os_free(plan->chain_start);
+	no_os_free(plan->pos);
+}
+
+static int jesd204_fsm_plan_init(struct jesd204_topology *topology,
+				 unsigned int link_idx,
+				 struct jesd204_fsm_plan *plan)
 {
-	enum jesd204_state_op_reason reason = JESD204_STATE_OP_REASON_INIT;
 	struct jesd204_dev_top *jdev_top = topology->dev_top;
-	bool per_device_op_done[16];
-	enum jesd204_dev_op op;
-	int lnk_dev;
-	int lnk_id;
-	int dev;
+	struct jesd204_topology_dev *tdev;
+	unsigned int max_items;
+	unsigned int lnk_id;
+	unsigned int dev;
+	unsigned int n = 0;
+	int *dev_item;
+	int dep;
 
-	for (op = 0; op < __JESD204_MAX_OPS; op++) {
-		for (dev = 0; dev < topology->devs_number; dev++)
-			per_device_op_done[dev] = false;
-
-		for (lnk_id = 0; lnk_id < jdev_top->num_links; lnk_id++) {
-			for (dev = 0; dev < topology->devs_number; dev++) {
-				for (lnk_dev = 0; lnk_dev < topology->devs[dev].links_number; lnk_dev++) {
-					if (topology->devs[dev].link_ids[lnk_dev] == jdev_top->link_ids[lnk_id]) {
-						if (topology->devs[dev].jdev->dev_data->state_ops[op].per_device
-						    && !per_device_op_done[dev]) {
-							topology->devs[dev].jdev->dev_data->state_ops[op].per_device(
-								topology->devs[dev].jdev, reason);
-							per_device_op_done[dev] = true;
-						}
-						if (topology->devs[dev].jdev->dev_data->state_ops[op].per_link)
-							topology->devs[dev].jdev->dev_data->state_ops[op].per_link(
-								topology->devs[dev].jdev, reason,
-								&jdev_top->active_links[lnk_id].link);
-					}
-				}
+	if (link_idx != JESD204_LINKS_ALL && link_idx >= jdev_top->num_links)
+		return -EINVAL;
+
+	max_items = topology->devs_number + jdev_top->num_links;
+	for (dev = 0; dev < topology->devs_number; dev++)
+		max_items += topology->devs[dev].links_number;
+
+	plan->items = (struct jesd204_fsm_item *)no_os_calloc(max_items,
+			sizeof(*plan->items));
+	plan->chain_start = (unsigned int *)no_os_calloc(jdev_top->num_links + 1,
+			    sizeof(*plan->chain_start));
+	plan->pos = (unsigned int *)no_os_calloc(jdev_top->num_links,
+			sizeof(*plan->pos));
+	/* per_device item of each device, -1 until a chain plans it */
+	dev_item = (int *)no_os_calloc(topology->devs_number + 1,
+				       sizeof(*dev_item));
+	if (!plan->items || !plan->chain_start || !plan->pos || !dev_item) {
+		jesd204_fsm_plan_remove(plan);
+		no_os_free(dev_item);
+		return -ENOMEM;
+	}
+
+	for (dev = 0; dev < topology->devs_number; dev++)
+		dev_item[dev] = -1;
+
+	plan->num_chains = 0;
+
+	for (lnk_id = 0; lnk_id < jdev_top->num_links; lnk_id++) {
+		if (link_idx != JESD204_LINKS_ALL && link_idx != lnk_id)
+			continue;
+
+		plan->chain_start[plan->num_chains] = n;
+		for (dev = 0; dev < topology->devs_number; dev++) {
+			tdev = &topology->devs[dev];
+			if (!jesd204_fsm_dev_on_link(tdev, jdev_top->link_ids[lnk_id]))
+				continue;
+
+			if (dev_item[dev] < 0) {
+				dev_item[dev] = n;
+				jesd204_fsm_plan_add(plan, &n, tdev->jdev, dev,
+						     NULL, -1);
 			}
-			if (jdev_top->jdev->dev_data->state_ops[op].per_link) {
-				jdev_top->jdev->dev_data->state_ops[op].per_link(jdev_top->jdev, reason,
-						&jdev_top->active_links[lnk_id].link);
-				if (jdev_top->jdev->dev_data->state_ops[op].post_state_sysref)
-					jesd204_sysref_async(jdev_top->jdev);
+
+			/* the per_device op is in a previous chain */
+			if (dev_item[dev] < (int)plan->chain_start[plan->num_chains])
+				dep = dev_item[dev];
+			else
+				dep = -1;
+
+			jesd204_fsm_plan_add(plan, &n, tdev->jdev, dev,
+					     &jdev_top->active_links[lnk_id], dep);
+		}
+		jesd204_fsm_plan_add(plan, &n, jdev_top->jdev, topology->devs_number,
+				     &jdev_top->active_links[lnk_id], -1);
+		plan->num_chains++;
+	}
+	plan->chain_start[plan->num_chains] = n;
+
+	no_os_free(dev_item);
+
+	plan->top.jdev = jdev_top->jdev;
+	plan->top.dev_idx = topology->devs_number;
+	plan->top.ol = NULL;
+	plan->top.dep = -1;
+	plan->top.last_op = -1;
+
+	return 0;
+}
+
+static int jesd204_fsm_item_call(struct jesd204_topology *topology,
+				 struct jesd204_fsm_item *item,
+				 enum jesd204_dev_op op,
+				 enum jesd204_state_op_reason reason)
+{
+	const struct jesd204_state_op *state_op =
+			&item->jdev->dev_data->state_ops[op];
+	struct no_os_time start;
+	int ret = JESD204_STATE_CHANGE_DONE;
+
+	start = no_os_get_time();
+	if (item->ol && state_op->per_link)
+		ret = state_op->per_link(item->jdev, reason, &item->ol->link);
+	else if (!item->ol && state_op->per_device)
+		ret = state_op->per_device(item->jdev, reason);
+	else
+		return JESD204_STATE_CHANGE_DONE;
+	*jesd204_fsm_dev_us(topology, op, item->dev_idx) +=
+		jesd204_fsm_elapsed_us(start);
+
+	if (ret < 0)
+		return ret;
+
+	/* the op ran, even if it is still waiting for its state change */
+	item->last_op = op;
+
+	if (ret == JESD204_STATE_CHANGE_DEFER)
+		return ret;
+
+	if (item->jdev->is_top && state_op->post_state_sysref)
+		jesd204_sysref_async(item->jdev);
+
+	return JESD204_STATE_CHANGE_DONE;
+}
+
+static int jesd204_fsm_item_fail(struct jesd204_topology *topology,
+				 struct jesd204_fsm_item *item,
+				 enum jesd204_dev_op op, int ret)
+{
+	topology->stats.error = ret;
+	topology->stats.failed_op = op;
+	topology->stats.failed_dev = item->jdev;
+
+	if (item->ol)
+		pr_err("jesd204: link%u failed in state %d (%d)\n",
+		       item->ol->link.link_id, op, ret);
+	else
+		pr_err("jesd204: device op failed in state %d (%d)\n", op, ret);
+
+	return ret;
+}
+
+/*
+ * Run the link chains of a state. Every chain advances until one of its ops
+ * defers (e.g. waiting for a link status), then the next chain gets its turn,
+ * so the waits of independent links overlap instead of adding up.
+ */
+static int jesd204_fsm_run_chains(struct jesd204_topology *topology,
+				  struct jesd204_fsm_plan *plan,
+				  enum jesd204_dev_op op)
+{
+	enum jesd204_state_op_reason reason = JESD204_STATE_OP_REASON_INIT;
+	struct jesd204_fsm_item *item;
+	unsigned int *pos = plan->pos;
+	unsigned int polls = 0;
+	unsigned int c;
+	bool progress;
+	bool pending;
+	int ret;
+
+	for (c = 0; c < plan->num_chains; c++)
+		pos[c] = plan->chain_start[c];
+	for (c = 0; c < plan->chain_start[plan->num_chains]; c++)
+		plan->items[c].done = false;
+
+	do {
+		progress = false;
+		pending = false;
+		for (c = 0; c < plan->num_chains; c++) {
+			while (pos[c] < plan->chain_start[c + 1]) {
+				item = &plan->items[pos[c]];
+				/* the shared device isn't in this state yet */
+				if (item->dep >= 0 && !plan->items[item->dep].done)
+					break;
+
+				ret = jesd204_fsm_item_call(topology, item, op, reason);
+				if (ret < 0)
+					return jesd204_fsm_item_fail(topology, item,
+								     op, ret);
+				if (ret == JESD204_STATE_CHANGE_DEFER)
+					break;
+				item->done = true;
+				pos[c]++;
+				progress = true;
 			}
+			if (pos[c] < plan->chain_start[c + 1])
+				pending = true;
 		}
-		if (jdev_top->jdev->dev_data->state_ops[op].per_device) {
-			jdev_top->jdev->dev_data->state_ops[op].per_device(jdev_top->jdev, reason);
-			if (jdev_top->jdev->dev_data->state_ops[op].post_state_sysref)
-				jesd204_sysref_async(jdev_top->jdev);
+
+		if (pending && !progress) {
+			if (++polls > JESD204_FSM_DEFER_MAX_POLLS) {
+				for (c = 0; pos[c] == plan->chain_start[c + 1]; c++)
+					;
+				return jesd204_fsm_item_fail(topology,
+							     &plan->items[pos[c]], op, -ETIMEDOUT);
+			}
+			no_os_udelay(JESD204_FSM_DEFER_POLL_US);
 		}
+	} while (pending);
+
+	return 0;
+}
+
+/*
+ * Run one state: the link chains, then the per_device op of the top device.
+ */
+static int jesd204_fsm_run_state(struct jesd204_topology *topology,
+				 struct jesd204_fsm_plan *plan,
+				 enum jesd204_dev_op op)
+{
+	enum jesd204_state_op_reason reason = JESD204_STATE_OP_REASON_INIT;
+	unsigned int polls = 0;
+	int ret;
+
+	ret = jesd204_fsm_run_chains(topology, plan, op);
+	if (ret)
+		return ret;
+
+	/* the top device per_device op closes the state for all links */
+	while (1) {
+		ret = jesd204_fsm_item_call(topology, &plan->top, op, reason);
+		if (ret < 0)
+			return jesd204_fsm_item_fail(topology, &plan->top, op, ret);
+		if (ret != JESD204_STATE_CHANGE_DEFER)
+			break;
+		if (++polls > JESD204_FSM_DEFER_MAX_POLLS)
+			return jesd204_fsm_item_fail(topology, &plan->top, op,
+						     -ETIMEDOUT);
+		no_os_udelay(JESD204_FSM_DEFER_POLL_US);
 	}
 
 	return 0;
 }
 
-/* no-OS specific */
-int jesd204_fsm_stop(struct jesd204_topology *topology, unsigned int link_idx)
+static void jesd204_fsm_item_uninit(struct jesd204_fsm_item *item, int op)
 {
 	enum jesd204_state_op_reason reason = JESD204_STATE_OP_REASON_UNINIT;
-	struct jesd204_dev_top *jdev_top = topology->dev_top;
-	bool per_device_op_done[16];
-	int lnk_dev;
-	int lnk_id;
-	int dev;
+	const struct jesd204_state_op *state_op;
+	int ret;
+
+	if (item->last_op < op)
+		return;
+
+	state_op = &item->jdev->dev_data->state_ops[op];
+	if (item->ol && state_op->per_link)
+		ret = state_op->per_link(item->jdev, reason, &item->ol->link);
+	else if (!item->ol && state_op->per_device)
+		ret = state_op->per_device(item->jdev, reason);
+	else
+		ret = 0;
+
+	if (ret < 0)
+		pr_warning("jesd204: uninit failed in state %d (%d)\n", op, ret);
+
+	item->last_op = op - 1;
+}
+
+/*
+ * no-OS specific
+ * Bring down, in the reverse order of the bring-up, the states the planned
+ * ops reached. Ops which were never called are not uninitialized.
+ */
+static void jesd204_fsm_unwind(struct jesd204_fsm_plan *plan)
+{
+	unsigned int n = plan->chain_start[plan->num_chains];
+	unsigned int i;
 	int op;
 
 	for (op = __JESD204_MAX_OPS - 1; op >= 0; op--) {
-		for (dev = topology->devs_number - 1; dev >= 0 ; dev--)
-			per_device_op_done[dev] = false;
-
-		if (jdev_top->jdev->dev_data->state_ops[op].per_device)
-			jdev_top->jdev->dev_data->state_ops[op].per_device(jdev_top->jdev, reason);
-
-		for (lnk_id = jdev_top->num_links - 1; lnk_id >= 0; lnk_id--) {
-			if (jdev_top->jdev->dev_data->state_ops[op].per_link)
-				jdev_top->jdev->dev_data->state_ops[op].per_link(jdev_top->jdev, reason,
-						&jdev_top->active_links[lnk_id].link);
-			for (dev = topology->devs_number - 1; dev >= 0; dev--) {
-				for (lnk_dev = topology->devs[dev].links_number - 1; lnk_dev >= 0; lnk_dev--) {
-					if (topology->devs[dev].link_ids[lnk_dev] == jdev_top->link_ids[lnk_id]) {
-						if (topology->devs[dev].jdev->dev_data->state_ops[op].per_device
-						    && !per_device_op_done[dev]) {
-							topology->devs[dev].jdev->dev_data->state_ops[op].per_device(
-								topology->devs[dev].jdev, reason);
-							per_device_op_done[dev] = true;
-						}
-						if (topology->devs[dev].jdev->dev_data->state_ops[op].per_link)
-							topology->devs[dev].jdev->dev_data->state_ops[op].per_link(
-								topology->devs[dev].jdev, reason,
-								&jdev_top->active_links[lnk_id].link);
-					}
-				}
+		jesd204_fsm_item_uninit(&plan->top, op);
+		for (i = n; i > 0; i--)
+			jesd204_fsm_item_uninit(&plan->items[i - 1], op);
+	}
+}
+
+/* no-OS specific */
+int jesd204_fsm_start(struct jesd204_topology *topology, unsigned int link_idx)
+{
+	struct jesd204_fsm_plan plan;
+	struct no_os_time start;
+	enum jesd204_dev_op op;
+	int ret;
+
+	if (!topology || !topology->dev_top || !topology->dev_top->jdev)
+		return -EINVAL;
+
+	ret = jesd204_fsm_plan_init(topology, link_idx, &plan);
+	if (ret)
+		return ret;
+
+	topology->stats.error = 0;
+	topology->stats.failed_dev = NULL;
+	for (op = 0; op < __JESD204_MAX_OPS; op++)
+		topology->stats.state_us[op] = 0;
+	for (op = 0; op < __JESD204_MAX_OPS * (topology->devs_number + 1); op++)
+		topology->stats.dev_state_us[op] = 0;
+
+	for (op = 0; op < __JESD204_MAX_OPS; op++) {
+		start = no_os_get_time();
+		ret = jesd204_fsm_run_state(topology, &plan, op);
+		topology->stats.state_us[op] = jesd204_fsm_elapsed_us(start);
+		if (ret) {
+			/* bring back down what was reached so far */
+			jesd204_fsm_unwind(&plan);
+			break;
+		}
+	}
+
+	jesd204_fsm_plan_remove(&plan);
+
+	return ret;
+}
+
+/* no-OS specific */
+int jesd204_fsm_stop(struct jesd204_topology *topology, unsigned int link_idx)
+{
+	struct jesd204_dev_top *jdev_top;
+	struct jesd204_fsm_item *item;
+	struct jesd204_fsm_plan plan;
+	unsigned int lnk_id;
+	unsigned int i;
+	int ret;
+
+	if (!topology || !topology->dev_top || !topology->dev_top->jdev)
+		return -EINVAL;
+
+	jdev_top = topology->dev_top;
+
+	ret = jesd204_fsm_plan_init(topology, link_idx, &plan);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < plan.chain_start[plan.num_chains]; i++)
+		plan.items[i].last_op = __JESD204_MAX_OPS - 1;
+	plan.top.last_op = __JESD204_MAX_OPS - 1;
+
+	/* the other links still need the devices they share with this one */
+	if (link_idx != JESD204_LINKS_ALL) {
+		plan.top.last_op = -1;
+		for (i = 0; i < plan.chain_start[plan.num_chains]; i++) {
+			item = &plan.items[i];
+			if (item->ol)
+				continue;
+			for (lnk_id = 0; lnk_id < jdev_top->num_links; lnk_id++) {
+				if (lnk_id != link_idx &&
+				    jesd204_fsm_dev_on_link(&topology->devs[item->dev_idx],
+							    jdev_top->link_ids[lnk_id]))
+					item->last_op = -1;
 			}
 		}
 	}
 
+	jesd204_fsm_unwind(&plan);
+
+	jesd204_fsm_plan_remove(&plan);
+
 	return 0;
 }
+
+/* no-OS specific */
+/**
+ * @brief Get the time spent in a state during the last jesd204_fsm_start().
+ * @param topology - The JESD204 topology.
+ * @param jdev - Device to get the time of its ops for, NULL for the wall
+ *		 time of the whole state.
+ * @param op - The state.
+ * @param us - The duration, in microseconds.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int jesd204_fsm_state_duration(struct jesd204_topology *topology,
+			       struct jesd204_dev *jdev,
+			       enum jesd204_dev_op op, uint32_t *us)
+{
+	unsigned int dev;
+
+	if (!topology || !us || op >= __JESD204_MAX_OPS)
+		return -EINVAL;
+
+	if (!jdev) {
+		*us = topology->stats.state_us[op];
+		return 0;
+	}
+
+	if (jdev == topology->dev_top->jdev) {
+		*us = *jesd204_fsm_dev_us(topology, op, topology->devs_number);
+		return 0;
+	}
+
+	for (dev = 0; dev < topology->devs_number; dev++) {
+		if (topology->devs[dev].jdev == jdev) {
+			*us = *jesd204_fsm_dev_us(topology, op, dev);
+			return 0;
+		}
+	}
+
+	return -ENODEV;
+}
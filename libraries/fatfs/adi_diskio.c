@@ -40,6 +40,7 @@
 
 #include "sd.h"
 #include "no_os_error.h"
+#include "no_os_util.h"
 #include <stdio.h>
 
 /******************************************************************************/
@@ -51,9 +52,21 @@
 #define DEV_USB		2	/* Example: Map USB MSD to physical drive 2 */
 
 #define ERASE_SECTOR_SIZE	1u
+
+/* Sectors held back by the write cache, merged into a single write */
+#ifndef SD_CACHE_SECTORS
+#define SD_CACHE_SECTORS	8u
+#endif
+
 uint8_t			sd_init_var = false;
 extern struct sd_desc	*sd_desc;
 
+/* Write-behind cache of consecutive sectors */
+static uint8_t		sd_cache[SD_CACHE_SECTORS * DATA_BLOCK_LEN]
+__attribute__ ((aligned));
+static LBA_t		sd_cache_sector;
+static UINT		sd_cache_count;
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -61,7 +74,8 @@ extern struct sd_desc	*sd_desc;
 DSTATUS SD_disk_status();
 DSTATUS SD_disk_initialize();
 DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count);
-DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count);
+DRESULT SD_disk_write(const BYTE *buff, LBA_t sector, UINT count);
+DRESULT SD_disk_sync();
 
 /*-----------------------------------------------------------------------*/
 /* Get Drive Status                                                      */
@@ -162,7 +176,7 @@ DRESULT disk_ioctl (
 	switch(pdrv) {
 	case DEV_SD:
 		switch (cmd){
-		case CTRL_SYNC: return RES_OK;
+		case CTRL_SYNC: return SD_disk_sync();
 		case GET_SECTOR_COUNT:
 			*(LBA_t *)buff = sd_desc->memory_size / DATA_BLOCK_LEN;
 			return RES_OK;
@@ -204,21 +218,82 @@ DSTATUS SD_disk_initialize()
 	return 0;
 }
 
+/* Write the cached sectors. The SD card keeps the write open, so consecutive
+ * flushes are streamed into the same multiple block write. */
+static DRESULT SD_cache_flush()
+{
+	UINT count = sd_cache_count;
+
+	if (!count)
+		return RES_OK;
+
+	sd_cache_count = 0;
+	if (0 != sd_write_blocks(sd_desc, sd_cache, sd_cache_sector, count))
+		return RES_ERROR;
+
+	return RES_OK;
+}
+
 DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count)
 {
 	if (!sd_init_var)
 		return RES_NOTRDY;
+	/* Sectors still in the cache must be read back from the card */
+	if (sd_cache_count && sector < sd_cache_sector + sd_cache_count &&
+	    sector + count > sd_cache_sector)
+		if (RES_OK != SD_cache_flush())
+			return RES_ERROR;
 	if (0 != sd_read(sd_desc, buff, (uint64_t)sector * 512, (uint64_t)count * 512))
 		return RES_ERROR;
 
 	return RES_OK;
 }
 
-DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count)
+DRESULT SD_disk_write(const BYTE *buff, LBA_t sector, UINT count)
 {
+	UINT n;
+
 	if (!sd_init_var)
 		return RES_NOTRDY;
-	if (0 != sd_write(sd_desc, buff, (uint64_t)sector * 512, (uint64_t)count * 512))
+
+	while (count) {
+		/* Only consecutive sectors are merged */
+		if (sd_cache_count && sector != sd_cache_sector + sd_cache_count)
+			if (RES_OK != SD_cache_flush())
+				return RES_ERROR;
+
+		/* Large writes go straight to the card */
+		if (!sd_cache_count && count >= SD_CACHE_SECTORS) {
+			if (0 != sd_write_blocks(sd_desc, buff, sector, count))
+				return RES_ERROR;
+			return RES_OK;
+		}
+
+		if (!sd_cache_count)
+			sd_cache_sector = sector;
+		n = no_os_min(count, SD_CACHE_SECTORS - sd_cache_count);
+		memcpy(sd_cache + sd_cache_count * DATA_BLOCK_LEN, buff,
+		       n * DATA_BLOCK_LEN);
+		sd_cache_count += n;
+		sector += n;
+		buff += n * DATA_BLOCK_LEN;
+		count -= n;
+
+		if (sd_cache_count == SD_CACHE_SECTORS)
+			if (RES_OK != SD_cache_flush())
+				return RES_ERROR;
+	}
+
+	return RES_OK;
+}
+
+DRESULT SD_disk_sync()
+{
+	if (!sd_init_var)
+		return RES_NOTRDY;
+	if (RES_OK != SD_cache_flush())
+		return RES_ERROR;
+	if (0 != sd_sync(sd_desc))
 		return RES_ERROR;
 
 	return RES_OK;
@@ -36,6 +36,7 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include "mqtt_client.h"
 #include "MQTTClient.h"
@@ -45,9 +46,35 @@
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/* Fixed header of a PUBACK packet */
+#define MQTT_PUBACK_HEADER	(PUBACK << 4)
+/* DUP flag of a PUBLISH fixed header */
+#define MQTT_PUBLISH_DUP	0x08
+
+/* State of the parser watching the received packets for acknowledges */
+enum mqtt_rx_state {
+	MQTT_RX_HEADER,
+	MQTT_RX_LENGTH,
+	MQTT_RX_BODY
+};
+
 struct mqtt_desc {
 	MQTTClient		mqtt_client[1];
 	Network			network;
+	/** Called for each PUBACK received, with the packet id */
+	void			(*puback_handler)(void *, uint16_t);
+	void			*puback_ctx;
+	/** Received packet being parsed */
+	enum mqtt_rx_state	rx_state;
+	uint8_t			rx_header;
+	uint32_t		rx_len;
+	uint32_t		rx_shift;
+	uint32_t		rx_pos;
+	uint8_t			rx_id[2];
+	/** Publish partly sent by mqtt_publish_packet, NULL if none */
+	uint8_t			*tx_packet;
+	uint32_t		tx_len;
+	uint32_t		tx_sent;
 };
 
 /******************************************************************************/
@@ -85,6 +112,102 @@ static void mqtt_default_message_handler(MessageData *msg)
 	free(data.topic);
 }
 
+/*
+ * Follow the packets read by the paho client to catch the PUBACKs, which
+ * MQTTYield() drops. Works byte by byte, whatever the read sizes are.
+ */
+static void mqtt_rx_parse(struct mqtt_desc *desc, const uint8_t *buff,
+			  uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++) {
+		switch (desc->rx_state) {
+		case MQTT_RX_HEADER:
+			desc->rx_header = buff[i];
+			desc->rx_len = 0;
+			desc->rx_shift = 0;
+			desc->rx_state = MQTT_RX_LENGTH;
+			break;
+		case MQTT_RX_LENGTH:
+			desc->rx_len |= (uint32_t)(buff[i] & 0x7F) << desc->rx_shift;
+			desc->rx_shift += 7;
+			if (buff[i] & 0x80)
+				break;
+			desc->rx_pos = 0;
+			desc->rx_state = desc->rx_len ? MQTT_RX_BODY : MQTT_RX_HEADER;
+			break;
+		case MQTT_RX_BODY:
+			if (desc->rx_pos < sizeof(desc->rx_id))
+				desc->rx_id[desc->rx_pos] = buff[i];
+			if (++desc->rx_pos < desc->rx_len)
+				break;
+			desc->rx_state = MQTT_RX_HEADER;
+			if (desc->rx_header == MQTT_PUBACK_HEADER &&
+			    desc->rx_len == 2 && desc->puback_handler)
+				desc->puback_handler(desc->puback_ctx,
+						     (desc->rx_id[0] << 8) |
+						     desc->rx_id[1]);
+			break;
+		}
+	}
+}
+
+/*
+ * Send what is left of the publish given to mqtt_publish_packet, without
+ * waiting. A packet of which nothing was sent is given up, since the stream
+ * doesn't hold any part of it.
+ */
+static int32_t mqtt_tx_resume(struct mqtt_desc *desc)
+{
+	MQTTClient	*c = desc->mqtt_client;
+	int		rc;
+
+	if (!desc->tx_packet)
+		return 0;
+
+	while (desc->tx_sent < desc->tx_len) {
+		rc = desc->network.mqttwrite(&desc->network,
+					     desc->tx_packet + desc->tx_sent,
+					     desc->tx_len - desc->tx_sent, 0);
+		if (rc == -EAGAIN || !rc) {
+			if (!desc->tx_sent)
+				desc->tx_packet = NULL;
+			return -EAGAIN;
+		}
+		if (rc < 0) {
+			desc->tx_packet = NULL;
+			return rc;
+		}
+		desc->tx_sent += rc;
+	}
+
+	/* Retransmissions carry the DUP flag */
+	if (desc->tx_packet[0] & 0x06)
+		desc->tx_packet[0] |= MQTT_PUBLISH_DUP;
+	TimerCountdown(&c->last_sent, c->keepAliveInterval);
+	desc->tx_packet = NULL;
+
+	return 0;
+}
+
+/* Network read used by the paho client */
+static int mqtt_client_read(Network *net, unsigned char *buff, int len,
+			    int timeout)
+{
+	struct mqtt_desc	*desc;
+	int			ret;
+
+	desc = (struct mqtt_desc *)((char *)net -
+				    offsetof(struct mqtt_desc, network));
+
+	ret = mqtt_noos_read(net, buff, len, timeout);
+	if (ret > 0)
+		mqtt_rx_parse(desc, buff, ret);
+
+	return ret;
+}
+
 /**
  * @brief Initialize the MQTT client
  * @param desc - Address where to store the MQTT client reference
@@ -113,7 +236,7 @@ int32_t mqtt_init(struct mqtt_desc **desc,
 	}
 
 	ldesc->network.sock = param->sock;
-	ldesc->network.mqttread = mqtt_noos_read;
+	ldesc->network.mqttread = mqtt_client_read;
 	ldesc->network.mqttwrite = mqtt_noos_write;
 
 	app_handler = param->message_handler;
@@ -175,6 +298,8 @@ int32_t mqtt_connect(struct mqtt_desc *desc,
 	data.password.cstring = (char *)conf->password;
 	data.keepAliveInterval = (unsigned short)conf->keep_alive_ms;
 
+	/* A new connection doesn't carry the rest of a previous publish */
+	desc->tx_packet = NULL;
 	ret = MQTTConnectWithResults(desc->mqtt_client, &data, &res);
 	if (result_optional) {
 		result_optional->rc = res.rc;
@@ -196,6 +321,8 @@ int32_t mqtt_disconnect(struct mqtt_desc *desc)
 	if (!desc)
 		return -1;
 
+	desc->tx_packet = NULL;
+
 	return MQTTDisconnect(desc->mqtt_client);
 }
 
@@ -214,6 +341,10 @@ int32_t mqtt_publish(struct mqtt_desc *desc, const char *topic,
 	if (!desc || !msg)
 		return -1;
 
+	/* Nothing may be sent in the middle of another publish */
+	if (mqtt_tx_resume(desc))
+		return -1;
+
 	MQTTMessage message = { 0 };
 
 	message.payload = (void *)msg->payload;
@@ -224,6 +355,132 @@ int32_t mqtt_publish(struct mqtt_desc *desc, const char *topic,
 	return MQTTPublish(desc->mqtt_client, topic, &message);
 }
 
+/**
+ * @brief Serialize a publish packet. With a QoS above 0, the packet gets the
+ * next packet id of the client.
+ * @param desc - Reference to MQTT client
+ * @param buf - Where the packet is written
+ * @param size - Size of buf
+ * @param topic - Topic to publish to
+ * @param msg - Message to send
+ * @param packet_id - Set to the packet id. It can be NULL if not needed.
+ * @return
+ *  - Length of the packet : On success
+ *  - Negative error code : Otherwise
+ */
+int32_t mqtt_publish_prepare(struct mqtt_desc *desc, uint8_t *buf,
+			     uint32_t size, const char *topic,
+			     const struct mqtt_message *msg,
+			     uint16_t *packet_id)
+{
+	MQTTString	topic_name = MQTTString_initializer;
+	MQTTClient	*c;
+	uint16_t	id = 0;
+	int		len;
+
+	if (!desc || !buf || !topic || !msg)
+		return -EINVAL;
+
+	c = desc->mqtt_client;
+	if (msg->qos != MQTT_QOS0) {
+		c->next_packetid = (c->next_packetid == MAX_PACKET_ID) ? 1 :
+				   c->next_packetid + 1;
+		id = c->next_packetid;
+	}
+
+	topic_name.cstring = (char *)topic;
+	len = MQTTSerialize_publish(buf, size, 0, msg->qos, msg->retained, id,
+				    topic_name, (unsigned char *)msg->payload,
+				    msg->len);
+	if (len <= 0)
+		return -ENOBUFS;
+
+	if (packet_id)
+		*packet_id = id;
+
+	return len;
+}
+
+/**
+ * @brief Send a publish serialized by mqtt_publish_prepare, without waiting
+ * for the network or the acknowledge. The PUBACK is reported to the handler
+ * set by mqtt_set_puback_handler while mqtt_yield runs. Sending the packet
+ * again marks it as a duplicate.
+ * @param desc - Reference to MQTT client
+ * @param packet - Serialized packet
+ * @param len - Length of the packet
+ * @return
+ *  - 0 : On success
+ *  - -EAGAIN : Nothing of the packet was sent, it can be sent again later
+ *  - -EINPROGRESS : Only part of the packet was sent. The packet must be kept
+ *    unchanged and passed again until 0 is returned. Nothing else is sent on
+ *    the connection meanwhile.
+ *  - Negative error code : Otherwise
+ */
+int32_t mqtt_publish_packet(struct mqtt_desc *desc, uint8_t *packet,
+			    uint32_t len)
+{
+	int32_t		ret;
+
+	if (!desc || !packet || !len)
+		return -EINVAL;
+
+	if (!desc->mqtt_client->isconnected)
+		return -ENOTCONN;
+
+	/* The stream holds part of another publish, it goes first */
+	if (desc->tx_packet && desc->tx_packet != packet) {
+		ret = mqtt_tx_resume(desc);
+		if (ret)
+			return ret;
+	}
+
+	if (!desc->tx_packet) {
+		desc->tx_packet = packet;
+		desc->tx_len = len;
+		desc->tx_sent = 0;
+	}
+
+	ret = mqtt_tx_resume(desc);
+	if (ret == -EAGAIN && desc->tx_packet)
+		return -EINPROGRESS;
+
+	return ret;
+}
+
+/**
+ * @brief Check if a packet given to mqtt_publish_packet is still partly sent.
+ * Other calls of the client may complete it.
+ * @param desc - Reference to MQTT client
+ * @param packet - Serialized packet
+ * @return true if the packet must still be passed to mqtt_publish_packet
+ */
+bool mqtt_publish_pending(struct mqtt_desc *desc, const uint8_t *packet)
+{
+	return desc && packet && desc->tx_packet == packet;
+}
+
+/**
+ * @brief Set the callback called for each PUBACK received
+ * @param desc - Reference to MQTT client
+ * @param handler - Callback, called with ctx and the acknowledged packet id
+ * @param ctx - Context of the callback
+ * @return
+ *  - 0 : On success
+ *  - -1 : Otherwise
+ */
+int32_t mqtt_set_puback_handler(struct mqtt_desc *desc,
+				void (*handler)(void *, uint16_t), void *ctx)
+{
+	if (!desc)
+		return -1;
+
+	desc->puback_handler = handler;
+	desc->puback_ctx = ctx;
+
+	return 0;
+}
+
 /**
  * @brief Send subscribe to MQTT broker
  * @param desc - Reference to MQTT client
@@ -244,6 +501,9 @@ int32_t mqtt_subscribe(struct mqtt_desc *desc, const char *topic,
 	if (!desc)
 		return -1;
 
+	if (mqtt_tx_resume(desc))
+		return -1;
+
 	ret = MQTTSubscribeWithResults(desc->mqtt_client, topic,
 				       (enum QoS)qos,
 				       mqtt_default_message_handler,
@@ -267,6 +527,9 @@ int32_t mqtt_unsubscribe(struct mqtt_desc *desc, const char *topic)
 	if (!desc)
 		return -1;
 
+	if (mqtt_tx_resume(desc))
+		return -1;
+
 	return MQTTUnsubscribe(desc->mqtt_client, topic);
 }
 
@@ -276,14 +539,23 @@ int32_t mqtt_unsubscribe(struct mqtt_desc *desc, const char *topic)
  * A call to this API must be made within the
  * \ref mqtt_connect_config.keep_alive_ms interval to keep the MQTT connection
  * alive. \n
- * Yield can be called if no other MQTT operation is needed.
+ * Yield can be called if no other MQTT operation is needed. With a timeout_ms
+ * of 0, the packets already received are handled without waiting.
  * @param desc - Reference to MQTT client
  * @param timeout_ms - Time for yield to be executed
  * @return
  *  - 0 : On success
+ *  - -EAGAIN : A publish is still partly sent, nothing was done
  *  - -1 : Otherwise
  */
 int32_t mqtt_yield(struct mqtt_desc *desc, uint32_t timeout_ms)
 {
+	int32_t	ret;
+
+	/* Yield may send a PINGREQ or a PUBACK, the publish goes first */
+	ret = mqtt_tx_resume(desc);
+	if (ret)
+		return ret == -EAGAIN ? -EAGAIN : -1;
+
 	return MQTTYield(desc->mqtt_client, timeout_ms);
 }
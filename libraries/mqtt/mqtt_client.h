@@ -252,6 +252,19 @@ int32_t mqtt_disconnect(struct mqtt_desc *desc);
 /* Send publish to MQTT broker */
 int32_t mqtt_publish(struct mqtt_desc *desc, const char *topic,
 		     const struct mqtt_message* msg);
+/* Serialize a publish packet, to be sent with mqtt_publish_packet */
+int32_t mqtt_publish_prepare(struct mqtt_desc *desc, uint8_t *buf,
+			     uint32_t size, const char *topic,
+			     const struct mqtt_message *msg,
+			     uint16_t *packet_id);
+/* Send a serialized publish without waiting for the acknowledge */
+int32_t mqtt_publish_packet(struct mqtt_desc *desc, uint8_t *packet,
+			    uint32_t len);
+/* Check if a packet given to mqtt_publish_packet is still partly sent */
+bool mqtt_publish_pending(struct mqtt_desc *desc, const uint8_t *packet);
+/* Set the callback called for each PUBACK received */
+int32_t mqtt_set_puback_handler(struct mqtt_desc *desc,
+				void (*handler)(void *, uint16_t), void *ctx);
 /* Send subscribe to MQTT broker */
 int32_t mqtt_subscribe(struct mqtt_desc *desc, const char *topic,
 		       enum mqtt_qos qos, enum mqtt_qos *granted_qos_optional);
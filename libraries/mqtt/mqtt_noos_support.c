@@ -148,7 +148,7 @@ int mqtt_noos_read(Network* net, unsigned char* buff, int len, int timeout)
 		return 0;
 
 	sent = 0;
-	do {
+	while (true) {
 #ifdef NO_OS_LWIP_NETWORKING
 		/*
 		 * Currently, the LWIP networking layer doesn't implement packet RX
@@ -167,8 +167,12 @@ int mqtt_noos_read(Network* net, unsigned char* buff, int len, int timeout)
 				return sent;
 		}
 
+		/* A timeout of 0 or 1 ms only polls, without waiting */
+		if (--timeout <= 0)
+			break;
+
 		no_os_mdelay(1);
-	} while (--timeout);
+	}
 
 	/* 0 bytes have been read */
 	return 0;
@@ -0,0 +1,452 @@
+/***************************************************************************//**
+ *   @file   mqtt_telemetry.c
+ *   @brief  Batched MQTT telemetry publisher implementation
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include "mqtt_telemetry.h"
+#include "MQTTClient.h"
+#include "no_os_alloc.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Interval at which incoming packets are read while nothing is in flight */
+#define MQTT_TELEMETRY_POLL_MS		100
+/* Fixed header, topic length and packet id of a PUBLISH */
+#define MQTT_TELEMETRY_PUBLISH_OVERHEAD	9
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Serialized publish kept until it is sent and, with QoS1, acknowledged */
+struct mqtt_telemetry_slot {
+	uint8_t		*packet;
+	uint32_t	len;
+	uint16_t	packet_id;
+	bool		used;
+	/* Set while the packet is partly sent */
+	bool		sending;
+	/* PUBACK received while a retransmission was partly sent */
+	bool		acked;
+	/* Expires when the packet has to be sent again */
+	Timer		retry;
+};
+
+struct mqtt_telemetry_desc {
+	struct mqtt_desc		*mqtt;
+	const char			*topic;
+	enum mqtt_qos			qos;
+	uint32_t			max_payload;
+	uint32_t			max_delay_ms;
+	uint32_t			retry_ms;
+	/* Ring of publishes waiting for their PUBACK */
+	struct mqtt_telemetry_slot	*slots;
+	uint32_t			nb_slots;
+	uint32_t			next_slot;
+	uint32_t			inflight;
+	uint32_t			packet_size;
+	/* Payload being filled */
+	uint8_t				*payload;
+	uint32_t			payload_len;
+	uint16_t			count;
+	uint32_t			seq;
+	uint32_t			base_ts;
+	/* Expires when the payload has to be published */
+	Timer				deadline;
+	/* Expires when incoming packets have to be read */
+	Timer				poll;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Release a slot which doesn't have to be sent anymore */
+static void mqtt_telemetry_release(struct mqtt_telemetry_desc *desc,
+				   struct mqtt_telemetry_slot *slot)
+{
+	slot->used = false;
+	slot->acked = false;
+	desc->inflight--;
+}
+
+/*
+ * Release the slot of an acknowledged publish. A packet partly sent must be
+ * completed first, so its slot is released once it is sent.
+ */
+static void mqtt_telemetry_puback(void *ctx, uint16_t packet_id)
+{
+	struct mqtt_telemetry_desc	*desc = ctx;
+	struct mqtt_telemetry_slot	*slot;
+	uint32_t			i;
+
+	for (i = 0; i < desc->nb_slots; i++) {
+		slot = &desc->slots[i];
+		if (slot->used && slot->packet_id == packet_id) {
+			if (slot->sending)
+				slot->acked = true;
+			else
+				mqtt_telemetry_release(desc, slot);
+			return;
+		}
+	}
+}
+
+/* Get the oldest free slot of the ring */
+static struct mqtt_telemetry_slot *
+mqtt_telemetry_get_slot(struct mqtt_telemetry_desc *desc)
+{
+	struct mqtt_telemetry_slot	*slot;
+	uint32_t			i;
+
+	for (i = 0; i < desc->nb_slots; i++) {
+		slot = &desc->slots[(desc->next_slot + i) % desc->nb_slots];
+		if (!slot->used) {
+			desc->next_slot = (desc->next_slot + i + 1) %
+					  desc->nb_slots;
+			return slot;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Initialize the telemetry publisher. It takes over the PUBACK handler
+ * of the MQTT client.
+ * @param desc - Address where to store the publisher reference
+ * @param param - Initialization parameters
+ * @return
+ *  - 0 : On success
+ *  - Negative error code : Otherwise
+ */
+int32_t mqtt_telemetry_init(struct mqtt_telemetry_desc **desc,
+			    struct mqtt_telemetry_init_param *param)
+{
+	struct mqtt_telemetry_desc	*ldesc;
+	uint32_t			i;
+	int32_t				ret;
+
+	if (!desc || !param || !param->mqtt || !param->topic)
+		return -EINVAL;
+
+	if (param->qos == MQTT_QOS2 ||
+	    param->max_payload < MQTT_TELEMETRY_HDR_SIZE +
+	    MQTT_TELEMETRY_RECORD_SIZE ||
+	    param->max_payload > MQTT_TELEMETRY_HDR_SIZE +
+	    MQTT_TELEMETRY_RECORD_SIZE * UINT16_MAX)
+		return -EINVAL;
+
+	if (param->qos != MQTT_QOS0 && !param->nb_inflight)
+		return -EINVAL;
+
+	ldesc = (struct mqtt_telemetry_desc *)no_os_calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	ldesc->mqtt = param->mqtt;
+	ldesc->topic = param->topic;
+	ldesc->qos = param->qos;
+	ldesc->max_payload = param->max_payload;
+	ldesc->max_delay_ms = param->max_delay_ms;
+	ldesc->retry_ms = param->retry_ms;
+	/* QoS0 publishes are released as soon as they are sent */
+	ldesc->nb_slots = param->qos == MQTT_QOS0 ? 1 : param->nb_inflight;
+	ldesc->packet_size = param->max_payload + strlen(param->topic) +
+			     MQTT_TELEMETRY_PUBLISH_OVERHEAD;
+
+	ldesc->payload = (uint8_t *)no_os_calloc(1, param->max_payload);
+	if (!ldesc->payload) {
+		ret = -ENOMEM;
+		goto free_desc;
+	}
+
+	ldesc->slots = (struct mqtt_telemetry_slot *)no_os_calloc(ldesc->nb_slots,
+			sizeof(*ldesc->slots));
+	if (!ldesc->slots) {
+		ret = -ENOMEM;
+		goto free_payload;
+	}
+
+	ldesc->slots[0].packet = (uint8_t *)no_os_calloc(ldesc->nb_slots,
+				 ldesc->packet_size);
+	if (!ldesc->slots[0].packet) {
+		ret = -ENOMEM;
+		goto free_slots;
+	}
+	for (i = 1; i < ldesc->nb_slots; i++)
+		ldesc->slots[i].packet = ldesc->slots[0].packet +
+					 i * ldesc->packet_size;
+
+	ret = mqtt_set_puback_handler(ldesc->mqtt, mqtt_telemetry_puback,
+				      ldesc);
+	if (ret)
+		goto free_packets;
+
+	ldesc->payload_len = MQTT_TELEMETRY_HDR_SIZE;
+	TimerInit(&ldesc->deadline);
+	TimerInit(&ldesc->poll);
+	*desc = ldesc;
+
+	return 0;
+
+free_packets:
+	no_os_free(ldesc->slots[0].packet);
+free_slots:
+	no_os_free(ldesc->slots);
+free_payload:
+	no_os_free(ldesc->payload);
+free_desc:
+	no_os_free(ldesc);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by mqtt_telemetry_init. Samples not yet
+ * published and publishes not yet acknowledged are dropped.
+ * @param desc - Reference to the publisher
+ * @return
+ *  - 0 : On success
+ *  - -EBUSY : A publish is partly sent, call mqtt_telemetry_step first
+ *  - Negative error code : Otherwise
+ */
+int32_t mqtt_telemetry_remove(struct mqtt_telemetry_desc *desc)
+{
+	uint32_t	i;
+
+	if (!desc)
+		return -EINVAL;
+
+	for (i = 0; i < desc->nb_slots; i++)
+		if (desc->slots[i].sending &&
+		    mqtt_publish_pending(desc->mqtt, desc->slots[i].packet))
+			return -EBUSY;
+
+	mqtt_set_puback_handler(desc->mqtt, NULL, NULL);
+	no_os_free(desc->slots[0].packet);
+	no_os_free(desc->slots);
+	no_os_free(desc->payload);
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Publish the current payload. The publish is serialized in a free
+ * slot of the ring and sent without waiting for its PUBACK.
+ * @param desc - Reference to the publisher
+ * @return
+ *  - 0 : On success or if there is nothing to publish
+ *  - -EAGAIN : All the slots wait to be sent or acknowledged, try again
+ *    after mqtt_telemetry_step
+ *  - Negative error code : Otherwise. The publish is kept and sent again by
+ *    mqtt_telemetry_step.
+ */
+int32_t mqtt_telemetry_flush(struct mqtt_telemetry_desc *desc)
+{
+	struct mqtt_telemetry_slot	*slot;
+	struct mqtt_message		msg;
+	int32_t				ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->count)
+		return 0;
+
+	slot = mqtt_telemetry_get_slot(desc);
+	if (!slot)
+		return -EAGAIN;
+
+	desc->payload[0] = MQTT_TELEMETRY_VERSION;
+	desc->payload[1] = 0;
+	no_os_put_unaligned_le16(desc->count, &desc->payload[2]);
+	no_os_put_unaligned_le32(desc->seq, &desc->payload[4]);
+	no_os_put_unaligned_le32(desc->base_ts, &desc->payload[8]);
+
+	msg.qos = desc->qos;
+	msg.payload = (char *)desc->payload;
+	msg.len = desc->payload_len;
+	msg.retained = false;
+	ret = mqtt_publish_prepare(desc->mqtt, slot->packet, desc->packet_size,
+				   desc->topic, &msg, &slot->packet_id);
+	if (ret < 0)
+		return ret;
+	slot->len = ret;
+
+	desc->seq++;
+	desc->count = 0;
+	desc->payload_len = MQTT_TELEMETRY_HDR_SIZE;
+
+	ret = mqtt_publish_packet(desc->mqtt, slot->packet, slot->len);
+	/* QoS0 publishes are done once sent */
+	if (desc->qos == MQTT_QOS0 && !ret)
+		return 0;
+
+	slot->used = true;
+	slot->sending = ret == -EINPROGRESS;
+	slot->acked = false;
+	desc->inflight++;
+	/* A publish which couldn't be sent is retried by the next step */
+	TimerCountdownMS(&slot->retry, ret ? 0 : desc->retry_ms);
+
+	return ret == -EAGAIN || ret == -EINPROGRESS ? 0 : ret;
+}
+
+/**
+ * @brief Add a sample to the current payload. The payload is published when
+ * it is full or when the sample can't be stored relative to the first one.
+ * @param desc - Reference to the publisher
+ * @param channel - Channel of the sample
+ * @param timestamp - Time of the sample, in ms
+ * @param value - Value of the sample
+ * @return
+ *  - 0 : On success
+ *  - -EAGAIN : The sample was not stored because the payload couldn't be
+ *    published, try again after mqtt_telemetry_step
+ *  - Negative error code : Otherwise
+ */
+int32_t mqtt_telemetry_add(struct mqtt_telemetry_desc *desc, uint8_t channel,
+			   uint32_t timestamp, int32_t value)
+{
+	uint8_t		*record;
+	int32_t		ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->count && (timestamp - desc->base_ts > UINT16_MAX ||
+			    desc->payload_len + MQTT_TELEMETRY_RECORD_SIZE >
+			    desc->max_payload)) {
+		ret = mqtt_telemetry_flush(desc);
+		if (ret == -EAGAIN)
+			return ret;
+	}
+
+	if (!desc->count) {
+		desc->base_ts = timestamp;
+		TimerCountdownMS(&desc->deadline, desc->max_delay_ms);
+	}
+
+	record = &desc->payload[desc->payload_len];
+	record[0] = channel;
+	no_os_put_unaligned_le16(timestamp - desc->base_ts, &record[1]);
+	no_os_put_unaligned_le32(value, &record[3]);
+	desc->payload_len += MQTT_TELEMETRY_RECORD_SIZE;
+	desc->count++;
+
+	return 0;
+}
+
+/**
+ * @brief Read the incoming packets, publish the payload when its deadline is
+ * reached and send again the publishes not acknowledged in time. It doesn't
+ * wait for the broker, so it can be called from the acquisition loop.
+ * @param desc - Reference to the publisher
+ * @return
+ *  - 0 : On success
+ *  - Negative error code : Otherwise
+ */
+int32_t mqtt_telemetry_step(struct mqtt_telemetry_desc *desc)
+{
+	struct mqtt_telemetry_slot	*slot;
+	uint32_t			i;
+	int32_t				ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->inflight || TimerIsExpired(&desc->poll)) {
+		TimerCountdownMS(&desc->poll, MQTT_TELEMETRY_POLL_MS);
+		/* Only the packets already received are handled */
+		ret = mqtt_yield(desc->mqtt, 0);
+		if (ret && ret != -EAGAIN)
+			return -EIO;
+	}
+
+	if (desc->count && (TimerIsExpired(&desc->deadline) ||
+			    desc->payload_len + MQTT_TELEMETRY_RECORD_SIZE >
+			    desc->max_payload)) {
+		ret = mqtt_telemetry_flush(desc);
+		if (ret && ret != -EAGAIN)
+			return ret;
+	}
+
+	for (i = 0; i < desc->nb_slots; i++) {
+		slot = &desc->slots[i];
+		if (!slot->used)
+			continue;
+
+		if (slot->sending &&
+		    !mqtt_publish_pending(desc->mqtt, slot->packet))
+			/* Completed by another call of the client */
+			ret = 0;
+		else if (slot->sending || TimerIsExpired(&slot->retry))
+			ret = mqtt_publish_packet(desc->mqtt, slot->packet,
+						  slot->len);
+		else
+			continue;
+
+		slot->sending = ret == -EINPROGRESS;
+		/* The connection can't take more for now */
+		if (ret == -EAGAIN || ret == -EINPROGRESS)
+			break;
+		if (ret)
+			return ret;
+
+		if (desc->qos == MQTT_QOS0 || slot->acked)
+			mqtt_telemetry_release(desc, slot);
+		else
+			TimerCountdownMS(&slot->retry, desc->retry_ms);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Get the number of publishes waiting to be sent or for their PUBACK
+ * @param desc - Reference to the publisher
+ * @return Number of publishes in flight
+ */
+uint32_t mqtt_telemetry_inflight(struct mqtt_telemetry_desc *desc)
+{
+	return desc ? desc->inflight : 0;
+}
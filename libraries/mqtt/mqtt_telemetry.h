@@ -0,0 +1,108 @@
+/***************************************************************************//**
+ *   @file   mqtt_telemetry.h
+ *   @brief  Batched MQTT telemetry publisher
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef MQTT_TELEMETRY_H
+#define MQTT_TELEMETRY_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mqtt_client.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Version of the payload format */
+#define MQTT_TELEMETRY_VERSION		1
+/** Size of the payload header: version, reserved, count, sequence, time */
+#define MQTT_TELEMETRY_HDR_SIZE		12
+/** Size of a record: channel, time delta, value */
+#define MQTT_TELEMETRY_RECORD_SIZE	7
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct mqtt_telemetry_init_param
+ * @brief Parameters for the initialization of the telemetry publisher.
+ * Samples are packed in a payload which is published when it holds
+ * max_payload bytes or when its first sample is max_delay_ms old.
+ * All fields of the payload are little endian:
+ *  - u8 version, u8 reserved, u16 number of records, u32 sequence number,
+ *    u32 timestamp of the first record
+ *  - records of u8 channel, u16 time delta to the first record, i32 value
+ */
+struct mqtt_telemetry_init_param {
+	/** Connected MQTT client */
+	struct mqtt_desc	*mqtt;
+	/** Topic the payloads are published to */
+	const char		*topic;
+	/** QoS of the publishes. MQTT_QOS2 is not supported. */
+	enum mqtt_qos		qos;
+	/** Maximum payload size, in bytes */
+	uint32_t		max_payload;
+	/** Maximum time a sample waits before being published, in ms */
+	uint32_t		max_delay_ms;
+	/** Number of publishes which can wait for their PUBACK */
+	uint32_t		nb_inflight;
+	/** Time after which a publish without PUBACK is sent again, in ms */
+	uint32_t		retry_ms;
+};
+
+struct mqtt_telemetry_desc;
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the telemetry publisher */
+int32_t mqtt_telemetry_init(struct mqtt_telemetry_desc **desc,
+			    struct mqtt_telemetry_init_param *param);
+/* Free the resources allocated by mqtt_telemetry_init */
+int32_t mqtt_telemetry_remove(struct mqtt_telemetry_desc *desc);
+/* Add a sample to the current payload */
+int32_t mqtt_telemetry_add(struct mqtt_telemetry_desc *desc, uint8_t channel,
+			   uint32_t timestamp, int32_t value);
+/* Publish the current payload */
+int32_t mqtt_telemetry_flush(struct mqtt_telemetry_desc *desc);
+/* Process the acknowledges, deadlines and retries. Call it periodically. */
+int32_t mqtt_telemetry_step(struct mqtt_telemetry_desc *desc);
+/* Number of publishes waiting to be sent or for their PUBACK */
+uint32_t mqtt_telemetry_inflight(struct mqtt_telemetry_desc *desc);
+
+#endif
@@ -53,34 +53,243 @@
 #include <netdb.h>
 #include <string.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
+#include <linux/errqueue.h>
+#include "no_os_alloc.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Longest host name kept by the resolver cache */
+#define LINUX_SOCKET_HOST_MAX		256
+/* Datagrams handed to a single sendmmsg() call */
+#define LINUX_SOCKET_BATCH_MAX		32
+/* Bytes covered by the UDP-Lite checksum: UDP header + application header */
+#ifndef LINUX_SOCKET_UDPLITE_CSCOV
+#define LINUX_SOCKET_UDPLITE_CSCOV	NO_OS_UDPLITE_CSCOV
+#endif
+
+/* Pieces of data sent by a single sendmsg() call */
+#define LINUX_SOCKET_IOV_MAX		16
+/* Events returned by a single epoll_wait() call */
+#define LINUX_SOCKET_MAX_EVENTS		64
+/* Sends smaller than this are cheaper to copy than to pin */
+#define LINUX_SOCKET_ZEROCOPY_MIN	16384
+/* Longest wait for the peer to acknowledge a MSG_ZEROCOPY send */
+#define LINUX_SOCKET_ZEROCOPY_TIMEOUT_MS	10000
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY			60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY			0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY		5
+#endif
+
+#ifndef IPPROTO_UDPLITE
+#define IPPROTO_UDPLITE			136
+#endif
+#ifndef UDPLITE_SEND_CSCOV
+#define UDPLITE_SEND_CSCOV		10
+#endif
+
+/* Last host name resolved through gethostbyname() */
+static char linux_socket_host[LINUX_SOCKET_HOST_MAX];
+static struct in_addr linux_socket_host_addr;
 
 /******************************************************************************/
 /*************************** FUnctions Declarations *******************************/
 /******************************************************************************/
 
+/**
+ * @brief Resolve a host name, caching the last lookup so that datagram
+ * senders don't query the resolver for each packet.
+ * @param host - Dotted decimal address or host name.
+ * @param saddr - Socket address to fill in.
+ * @param port - Port of the socket address.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_socket_resolve(const char *host, struct sockaddr_in *saddr,
+				    uint16_t port)
+{
+	struct hostent *hptr;
+
+	if (!host)
+		return -EINVAL;
+
+	memset(saddr, 0, sizeof(*saddr));
+	saddr->sin_family = AF_INET;
+	saddr->sin_port = htons(port);
+
+	if (inet_pton(AF_INET, host, &saddr->sin_addr) == 1)
+		return 0;
+
+	if (!strncmp(host, linux_socket_host, LINUX_SOCKET_HOST_MAX)) {
+		saddr->sin_addr = linux_socket_host_addr;
+		return 0;
+	}
+
+	hptr = gethostbyname(host);
+	if (!hptr || !hptr->h_addr_list[0])
+		return -EHOSTUNREACH;
+
+	saddr->sin_addr = *(struct in_addr *)hptr->h_addr_list[0];
+	linux_socket_host_addr = saddr->sin_addr;
+	strncpy(linux_socket_host, host, LINUX_SOCKET_HOST_MAX - 1);
+
+	return 0;
+}
+
+/**
+ * @brief Get the MSG_ZEROCOPY state of a socket.
+ * @param desc - Network interface instance, NULL for linux_net.
+ * @param fd - Socket.
+ * @return The socket's entry, NULL if MSG_ZEROCOPY is not enabled on it.
+ */
+static struct linux_socket_zerocopy *
+linux_socket_zerocopy_get(struct linux_socket_desc *desc, int fd)
+{
+	uint32_t i;
+
+	if (!desc || !desc->zerocopy)
+		return NULL;
+
+	for (i = 0; i < LINUX_SOCKET_ZEROCOPY_SOCKETS; i++)
+		if (desc->zerocopy_socks[i].used && desc->zerocopy_socks[i].fd == fd)
+			return &desc->zerocopy_socks[i];
+
+	return NULL;
+}
+
+/**
+ * @brief Enable MSG_ZEROCOPY on a socket, if there is a free entry to track
+ * its completions. Otherwise the socket sends by copying.
+ * @param desc - Network interface instance.
+ * @param fd - Socket.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_socket_zerocopy_enable(struct linux_socket_desc *desc,
+		int fd)
+{
+	struct linux_socket_zerocopy *zc = NULL;
+	int one = 1;
+	uint32_t i;
+
+	for (i = 0; i < LINUX_SOCKET_ZEROCOPY_SOCKETS; i++) {
+		if (!desc->zerocopy_socks[i].used) {
+			zc = &desc->zerocopy_socks[i];
+			break;
+		}
+	}
+	if (!zc)
+		return 0;
+
+	if (setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) < 0)
+		return -errno;
+
+	zc->used = true;
+	zc->fd = fd;
+	zc->seq = 0;
+
+	return 0;
+}
+
+/**
+ * @brief Add a socket to the epoll set and enable MSG_ZEROCOPY on it.
+ * @param desc - Network interface instance, NULL for linux_net.
+ * @param fd - Socket.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_socket_watch(struct linux_socket_desc *desc, int fd)
+{
+	struct linux_socket_zerocopy *zc;
+	struct epoll_event ev = {
+		.events = EPOLLIN | EPOLLRDHUP,
+		.data.fd = fd
+	};
+	int32_t ret;
+
+	if (!desc)
+		return 0;
+
+	if (desc->zerocopy) {
+		ret = linux_socket_zerocopy_enable(desc, fd);
+		if (ret)
+			return ret;
+	}
+
+	if (epoll_ctl(desc->epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		ret = -errno;
+		zc = linux_socket_zerocopy_get(desc, fd);
+		if (zc)
+			zc->used = false;
+		return ret;
+	}
+
+	return 0;
+}
+
 /** @brief See \ref network_interface.socket_open */
 static int32_t linux_socket_open(void *desc, uint32_t *sock_id,
 				 enum socket_protocol prot, uint32_t buff_size)
 {
 	int32_t flags;
+	int cscov;
 	int err;
 
-	err = socket(AF_INET,SOCK_STREAM,IPPROTO_TCP);
+	switch (prot) {
+	case PROTOCOL_TCP:
+		err = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		break;
+	case PROTOCOL_UDP:
+		err = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		break;
+	case PROTOCOL_UDPLITE:
+		err = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDPLITE);
+		break;
+	default:
+		return -EPROTONOSUPPORT;
+	}
 	if(err < 0)
-		return err;
+		return -errno;
 
 	*sock_id = err;
 	flags = fcntl(*sock_id, F_GETFL);
 	fcntl(*sock_id, F_SETFL, flags | O_NONBLOCK);
 
+	if (prot == PROTOCOL_UDPLITE) {
+		/* Corrupted payloads are still delivered, only headers are checked */
+		cscov = LINUX_SOCKET_UDPLITE_CSCOV;
+		setsockopt(*sock_id, IPPROTO_UDPLITE, UDPLITE_SEND_CSCOV, &cscov,
+			   sizeof(cscov));
+	}
+
+	err = linux_socket_watch(desc, *sock_id);
+	if (err) {
+		close(*sock_id);
+		return err;
+	}
+
 	return 0;
 }
 
 /** @brief See \ref network_interface.socket_close */
 static int32_t linux_socket_close(void *desc, uint32_t sock_id)
 {
+	struct linux_socket_zerocopy *zc;
 	int32_t ret;
 
+	/* The descriptor may be reused by the next socket */
+	zc = linux_socket_zerocopy_get(desc, sock_id);
+	if (zc)
+		zc->used = false;
+
 	ret = close(sock_id);
 	if(ret < 0)
 		return -errno;
@@ -93,15 +302,13 @@ static int32_t linux_socket_connect(void *desc, uint32_t sock_id,
 				    struct socket_address *addr)
 {
 	int32_t ret;
-	struct hostent* hptr;
-
-	struct sockaddr_in saddr = {0};
-	saddr.sin_family = AF_INET;
-	saddr.sin_port = htons(addr->port);
-	hptr = gethostbyname(addr->addr);
-	saddr.sin_addr.s_addr = ((struct in_addr*) hptr->h_addr_list[0])->s_addr;
+	struct sockaddr_in saddr;
 	socklen_t len = sizeof(saddr);
 
+	ret = linux_socket_resolve(addr->addr, &saddr, addr->port);
+	if (ret)
+		return ret;
+
 	ret = connect(sock_id,(struct sockaddr*) &saddr,len);
 
 	if(ret < 0)
@@ -125,18 +332,170 @@ static int32_t linux_socket_disconnect(void *desc,
 	return 0;
 }
 
+/**
+ * @brief Wait for the completion of the last MSG_ZEROCOPY send, after which
+ * the sent memory may be reused.
+ * @param zc - MSG_ZEROCOPY state of the socket.
+ * @param sock_id - Socket id.
+ * @return 0 in case of success, -ETIMEDOUT if the peer didn't acknowledge the
+ * data in LINUX_SOCKET_ZEROCOPY_TIMEOUT_MS, negative error code otherwise.
+ */
+static int32_t linux_socket_zerocopy_wait(struct linux_socket_zerocopy *zc,
+		uint32_t sock_id)
+{
+	char control[CMSG_SPACE(sizeof(struct sock_extended_err))];
+	struct pollfd pfd = { .fd = sock_id, .events = 0 };
+	struct sock_extended_err *serr;
+	struct msghdr msg;
+	struct cmsghdr *cm;
+	int ret;
+
+	while (true) {
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		ret = recvmsg(sock_id, &msg, MSG_ERRQUEUE);
+		if (ret < 0) {
+			if (errno != EAGAIN)
+				return -errno;
+
+			if (pfd.revents & (POLLHUP | POLLNVAL))
+				return -ENOTCONN;
+
+			/* POLLERR is always reported, the error queue is not empty */
+			ret = poll(&pfd, 1, LINUX_SOCKET_ZEROCOPY_TIMEOUT_MS);
+			if (ret < 0)
+				return -errno;
+			if (!ret)
+				return -ETIMEDOUT;
+			continue;
+		}
+
+		cm = CMSG_FIRSTHDR(&msg);
+		if (!cm)
+			continue;
+
+		serr = (struct sock_extended_err *)CMSG_DATA(cm);
+		if (serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+			continue;
+
+		/* ee_info - ee_data is the range of completed sends */
+		if ((int32_t)(serr->ee_data - (zc->seq - 1)) >= 0)
+			return 0;
+	}
+}
+
 /** @brief See \ref network_interface.socket_send */
 static int32_t linux_socket_send(void *desc, uint32_t sock_id,
 				 const void *data, uint32_t size)
 {
+	struct linux_socket_desc *ldesc = desc;
+	struct linux_socket_zerocopy *zc;
+	int32_t err;
 	int32_t ret;
 
+	zc = linux_socket_zerocopy_get(ldesc, sock_id);
+	if (zc && size >= ldesc->zerocopy_min) {
+		ret = send(sock_id, data, size, MSG_ZEROCOPY);
+		if (ret < 0)
+			return -errno;
+
+		zc->seq++;
+		err = linux_socket_zerocopy_wait(zc, sock_id);
+		if (err)
+			return err;
+
+		/* The send may be partial, like a copying one */
+		return ret;
+	}
+
 	ret = send(sock_id, data, size, 0);
 
 	if(ret < 0)
 		return -errno;
 
-	return size;
+	return ret;
+}
+
+/** @brief See \ref network_interface.socket_sendv */
+static int32_t linux_socket_sendv(void *desc, uint32_t sock_id,
+				  const struct socket_iov *iov,
+				  uint32_t nb_iov)
+{
+	struct iovec liov[LINUX_SOCKET_IOV_MAX];
+	struct msghdr msg = {0};
+	uint32_t i;
+	int32_t ret;
+
+	if (!iov || !nb_iov || nb_iov > LINUX_SOCKET_IOV_MAX)
+		return -EINVAL;
+
+	for (i = 0; i < nb_iov; i++) {
+		liov[i].iov_base = (void *)iov[i].data;
+		liov[i].iov_len = iov[i].len;
+	}
+	msg.msg_iov = liov;
+	msg.msg_iovlen = nb_iov;
+
+	ret = sendmsg(sock_id, &msg, 0);
+	if (ret < 0)
+		return -errno;
+
+	return ret;
+}
+
+/** @brief See \ref network_interface.socket_setopt */
+static int32_t linux_socket_setopt(void *desc, uint32_t sock_id,
+				   const struct socket_options *opts)
+{
+	int val;
+
+	if (!opts)
+		return -EINVAL;
+
+	if (opts->snd_buff_size) {
+		val = opts->snd_buff_size;
+		if (setsockopt(sock_id, SOL_SOCKET, SO_SNDBUF, &val, sizeof(val)) < 0)
+			return -errno;
+	}
+
+	if (opts->rcv_buff_size) {
+		val = opts->rcv_buff_size;
+		if (setsockopt(sock_id, SOL_SOCKET, SO_RCVBUF, &val, sizeof(val)) < 0)
+			return -errno;
+	}
+
+	if (opts->no_delay) {
+		val = 1;
+		if (setsockopt(sock_id, IPPROTO_TCP, TCP_NODELAY, &val, sizeof(val)) < 0)
+			return -errno;
+	}
+
+	return 0;
+}
+
+/** @brief See \ref network_interface.socket_wait */
+static int32_t linux_socket_wait(void *desc, uint32_t *sock_ids,
+				 uint32_t nb_ids, uint32_t timeout_ms)
+{
+	struct epoll_event ev[LINUX_SOCKET_MAX_EVENTS];
+	struct linux_socket_desc *ldesc = desc;
+	int32_t ret;
+	int32_t i;
+
+	if (!ldesc)
+		return -ENOSYS;
+
+	ret = epoll_wait(ldesc->epoll_fd, ev, LINUX_SOCKET_MAX_EVENTS,
+			 timeout_ms);
+	if (ret < 0)
+		return errno == EINTR ? 0 : -errno;
+
+	for (i = 0; sock_ids && i < ret && i < (int32_t)nb_ids; i++)
+		sock_ids[i] = ev[i].data.fd;
+
+	return ret;
 }
 
 /** @brief See \ref network_interface.socket_recv */
@@ -165,22 +524,66 @@ static int32_t linux_socket_sendto(void *desc, uint32_t sock_id,
 				   const struct socket_address* to)
 {
 	int32_t ret;
-	struct sockaddr_in saddr_to = {0};
-	socklen_t len;
-	struct hostent* hptr;
+	struct sockaddr_in saddr_to;
 
-	saddr_to.sin_family = AF_INET;
-	saddr_to.sin_port = htons(to->port);
-	hptr = gethostbyname(to->addr);
-	saddr_to.sin_addr.s_addr = ((struct in_addr*) hptr->h_addr_list[0])->s_addr;
-	len = sizeof(saddr_to);
+	ret = linux_socket_resolve(to->addr, &saddr_to, to->port);
+	if (ret)
+		return ret;
 
-	ret = sendto(sock_id, data, size, 0, (struct sockaddr*) &saddr_to, len);
+	ret = sendto(sock_id, data, size, 0, (struct sockaddr*) &saddr_to,
+		     sizeof(saddr_to));
+	if(ret < 0)
+		return -errno;
 
-	if(ret != 0)
+	return ret;
+}
+
+/** @brief See \ref network_interface.socket_sendto_batch */
+static int32_t linux_socket_sendto_batch(void *desc, uint32_t sock_id,
+		const struct socket_datagram *dgrams,
+		uint32_t nb_dgrams,
+		const struct socket_address *to)
+{
+	struct mmsghdr msgs[LINUX_SOCKET_BATCH_MAX];
+	struct iovec iov[LINUX_SOCKET_BATCH_MAX][2];
+	struct sockaddr_in saddr_to;
+	uint32_t sent = 0;
+	uint32_t i, n;
+	int32_t ret;
+
+	ret = linux_socket_resolve(to->addr, &saddr_to, to->port);
+	if (ret)
 		return ret;
 
-	return 0;
+	while (sent < nb_dgrams) {
+		n = no_os_min(nb_dgrams - sent, LINUX_SOCKET_BATCH_MAX);
+		memset(msgs, 0, n * sizeof(*msgs));
+		for (i = 0; i < n; i++) {
+			iov[i][0].iov_base = (void *)dgrams[sent + i].hdr;
+			iov[i][0].iov_len = dgrams[sent + i].hdr_len;
+			iov[i][1].iov_base = (void *)dgrams[sent + i].data;
+			iov[i][1].iov_len = dgrams[sent + i].len;
+			msgs[i].msg_hdr.msg_name = &saddr_to;
+			msgs[i].msg_hdr.msg_namelen = sizeof(saddr_to);
+			msgs[i].msg_hdr.msg_iov = iov[i];
+			msgs[i].msg_hdr.msg_iovlen = 2;
+		}
+
+		ret = sendmmsg(sock_id, msgs, n, 0);
+		if (ret < 0) {
+			if (sent)
+				break;
+
+			return -errno;
+		}
+
+		sent += ret;
+		if ((uint32_t)ret < n)
+			/* Socket buffer full */
+			break;
+	}
+
+	return sent;
 }
 
 /** @brief See \ref network_interface.socket_recvfrom */
@@ -190,22 +593,17 @@ static int32_t linux_socket_recvfrom(void *desc, uint32_t sock_id,
 {
 	int32_t ret;
 	struct sockaddr_in saddr_from = {0};
-	socklen_t len;
-	struct hostent* hptr;
-
-	saddr_from.sin_family = AF_INET;
-	saddr_from.sin_port = htons(from->port);
-	hptr = gethostbyname(from->addr);
-	saddr_from.sin_addr.s_addr = ((struct in_addr*) hptr->h_addr_list[0])->s_addr;
-	len = sizeof(saddr_from);
+	socklen_t len = sizeof(saddr_from);
 
-	ret = recvfrom(sock_id, data, size, MSG_DONTWAIT,(struct sockaddr*) &saddr_from,
-		       &len);
+	ret = recvfrom(sock_id, data, size, MSG_DONTWAIT,
+		       (struct sockaddr*) &saddr_from, &len);
+	if(ret < 0)
+		return -errno;
 
-	if(ret != 0)
-		return ret;
+	if (from)
+		from->port = ntohs(saddr_from.sin_port);
 
-	return 0;
+	return ret;
 }
 
 /** @brief See \ref network_interface.socket_bind */
@@ -256,6 +654,13 @@ static int32_t linux_socket_accept(void *desc, uint32_t sock_id,
 
 	*client_socket_id = ret;
 
+	/* Buffer sizes and TCP_NODELAY are inherited from the listening socket */
+	ret = linux_socket_watch(desc, *client_socket_id);
+	if (ret) {
+		close(*client_socket_id);
+		return ret;
+	}
+
 	return 0;
 }
 
@@ -271,7 +676,65 @@ struct network_interface linux_net = {
 	.socket_recvfrom = (int32_t (*)(void *, uint32_t, void *, uint32_t, struct socket_address* from))linux_socket_recvfrom,
 	.socket_bind = (int32_t (*)(void *, uint32_t, uint16_t))linux_socket_bind,
 	.socket_listen = (int32_t (*)(void *, uint32_t, uint32_t))linux_socket_listen,
-	.socket_accept= (int32_t (*)(void *, uint32_t, uint32_t*))linux_socket_accept
+	.socket_accept= (int32_t (*)(void *, uint32_t, uint32_t*))linux_socket_accept,
+	.socket_sendto_batch = linux_socket_sendto_batch,
+	.socket_sendv = linux_socket_sendv,
+	.socket_setopt = linux_socket_setopt,
+	.socket_wait = linux_socket_wait
 };
 
+/**
+ * @brief Create a network interface instance with its own epoll set.
+ * @param desc - Address where to store the instance.
+ * @param param - Instance parameters, NULL for the defaults.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_socket_init(struct linux_socket_desc **desc,
+			  const struct linux_socket_init_param *param)
+{
+	struct linux_socket_desc *ldesc;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = (struct linux_socket_desc *)no_os_calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	ldesc->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (ldesc->epoll_fd < 0) {
+		no_os_free(ldesc);
+		return -errno;
+	}
+
+	if (param) {
+		ldesc->zerocopy = param->zerocopy;
+		ldesc->zerocopy_min = param->zerocopy_min;
+	}
+	if (!ldesc->zerocopy_min)
+		ldesc->zerocopy_min = LINUX_SOCKET_ZEROCOPY_MIN;
+
+	ldesc->net = linux_net;
+	ldesc->net.net = ldesc;
+	*desc = ldesc;
+
+	return 0;
+}
+
+/**
+ * @brief Free a network interface instance. The sockets must be closed first.
+ * @param desc - The instance.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_socket_remove(struct linux_socket_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	close(desc->epoll_fd);
+	no_os_free(desc);
+
+	return 0;
+}
+
 #endif
@@ -38,12 +38,75 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <stdbool.h>
 #include "network_interface.h"
 
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Sockets of an instance which can send with MSG_ZEROCOPY at the same time */
+#define LINUX_SOCKET_ZEROCOPY_SOCKETS	16
+
+/**
+ * @struct linux_socket_zerocopy
+ * @brief MSG_ZEROCOPY state of a socket. The kernel numbers the completions
+ * of each socket separately.
+ */
+struct linux_socket_zerocopy {
+	/** Entry in use */
+	bool		used;
+	/** Socket */
+	int		fd;
+	/** Number of MSG_ZEROCOPY sends issued, used to match completions */
+	uint32_t	seq;
+};
+
+/**
+ * @struct linux_socket_init_param
+ * @brief Parameters of a Linux network interface instance.
+ */
+struct linux_socket_init_param {
+	/**
+	 * Send large TCP writes with MSG_ZEROCOPY. The send call returns once
+	 * the kernel released the pages, i.e. the peer acknowledged the data.
+	 * Only the first LINUX_SOCKET_ZEROCOPY_SOCKETS sockets open at a time
+	 * use it, the others send by copying.
+	 */
+	bool		zerocopy;
+	/** Smallest send using MSG_ZEROCOPY, 0 - LINUX_SOCKET_ZEROCOPY_MIN */
+	uint32_t	zerocopy_min;
+};
+
+/**
+ * @struct linux_socket_desc
+ * @brief Linux network interface instance with its own epoll set.
+ */
+struct linux_socket_desc {
+	/** Network interface to be passed to tcp_socket_init_param */
+	struct network_interface	net;
+	/** epoll instance watching the opened and accepted sockets */
+	int				epoll_fd;
+	/** MSG_ZEROCOPY enabled */
+	bool				zerocopy;
+	/** Smallest send using MSG_ZEROCOPY */
+	uint32_t			zerocopy_min;
+	/** Sockets on which MSG_ZEROCOPY is enabled */
+	struct linux_socket_zerocopy	zerocopy_socks[LINUX_SOCKET_ZEROCOPY_SOCKETS];
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
 
+/* Interface without epoll set, kept for the existing users */
 extern struct network_interface linux_net;
 
+/* Create a network interface instance with its own epoll set */
+int32_t linux_socket_init(struct linux_socket_desc **desc,
+			  const struct linux_socket_init_param *param);
+
+/* Free a network interface instance */
+int32_t linux_socket_remove(struct linux_socket_desc *desc);
+
 #endif /* LINUX_SOCKET_H_ */
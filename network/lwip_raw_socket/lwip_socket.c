@@ -44,6 +44,7 @@
 #include "lwip/tcpbase.h"
 #include "lwip/tcpip.h"
 #include "lwip/tcp.h"
+#include "lwip/udp.h"
 #include "lwip/netif.h"
 #include "lwip/api.h"
 #include "lwip/etharp.h"
@@ -120,6 +121,61 @@ static void _release_socket(struct lwip_network_desc *desc, uint32_t id)
 	sock->state = SOCKET_CLOSED;
 }
 
+/**
+ * @brief Cap the receive window of a socket to the configured value.
+ * @param sock - socket descriptor (not a listening one).
+ * @param old_wnd - the receive window cap in use until now.
+ */
+static void _set_rcv_wnd(struct lwip_socket_desc *sock, uint32_t old_wnd)
+{
+	uint32_t wnd = TCP_WND;
+	uint32_t used;
+
+	if (!sock->pcb)
+		return;
+
+	if (sock->cfg.rcv_wnd && sock->cfg.rcv_wnd < TCP_WND)
+		wnd = sock->cfg.rcv_wnd;
+
+	/* Bytes received but not yet released with tcp_recved() */
+	used = old_wnd > sock->pcb->rcv_wnd ? old_wnd - sock->pcb->rcv_wnd : 0;
+	sock->pcb->rcv_wnd = wnd > used ? wnd - used : 0;
+}
+
+/**
+ * @brief Get the receive window cap of a socket.
+ * @param sock - socket descriptor.
+ * @return the receive window cap.
+ */
+static uint32_t _get_rcv_wnd(struct lwip_socket_desc *sock)
+{
+	if (sock->cfg.rcv_wnd && sock->cfg.rcv_wnd < TCP_WND)
+		return sock->cfg.rcv_wnd;
+
+	return TCP_WND;
+}
+
+/**
+ * @brief Output the data coalesced by lwip_socket_send().
+ * @param sock - socket descriptor.
+ * @return 0 in the case of success, negative error code otherwise
+ */
+static int32_t _flush_socket(struct lwip_socket_desc *sock)
+{
+	err_t err;
+
+	if (!sock->tx_pending || sock->state != SOCKET_CONNECTED)
+		return 0;
+
+	err = tcp_output(sock->pcb);
+	if (err != ERR_OK)
+		return err;
+
+	sock->tx_pending = 0;
+
+	return 0;
+}
+
 /**
  * @brief Low level pbuf output function. Lwip will call this to send data
  * on the wire.
@@ -175,6 +231,7 @@ static err_t lwip_netif_init(struct netif *netif)
  */
 int32_t no_os_lwip_step(struct lwip_network_desc *desc, void *data)
 {
+	uint32_t i;
 	int ret;
 
 	sys_check_timeouts();
@@ -188,6 +245,13 @@ int32_t no_os_lwip_step(struct lwip_network_desc *desc, void *data)
 			return ret;
 	}
 
+	/* Writes below the flush threshold are sent at the latest here */
+	for (i = 0; i < NO_OS_MAX_SOCKETS; i++) {
+		ret = _flush_socket(&desc->sockets[i]);
+		if (ret)
+			return ret;
+	}
+
 	return 0;
 }
 
@@ -448,6 +512,14 @@ static int32_t lwip_socket_close(void *net, uint32_t sock_id)
 	if (!sock)
 		return -EINVAL;
 
+	if (sock->udp_pcb) {
+		udp_remove(sock->udp_pcb);
+		sock->udp_pcb = NULL;
+		_release_socket(desc, sock_id);
+
+		return 0;
+	}
+
 	if (!sock->pcb)
 		return 0;
 
@@ -463,6 +535,7 @@ static int32_t lwip_socket_close(void *net, uint32_t sock_id)
 	sock->p_idx = 0;
 	sock->pcb = NULL;
 	sock->p = NULL;
+	sock->tx_pending = 0;
 	_release_socket(desc, sock_id);
 
 	return 0;
@@ -522,7 +595,7 @@ static void lwip_config_socket(struct lwip_socket_desc *desc)
  * @brief Create a TCP socket.
  * @param net - lwip sockets layer specific descriptor.
  * @param sock_id - index of the socket that was created.
- * @param proto - Layer 4 protocol (only TCP is supported).
+ * @param proto - Layer 4 protocol (TCP, UDP or UDP-Lite).
  * @param buff_size - unused.
  * @return 0 in the case of success, negative error code otherwise
  */
@@ -531,18 +604,42 @@ static int32_t lwip_socket_open(void *net, uint32_t *sock_id,
 				uint32_t buff_size)
 {
 	struct lwip_network_desc *desc = net;
+	struct udp_pcb *udp_pcb;
 	struct tcp_pcb *pcb;
 	uint32_t socket_id;
 	int32_t ret;
 
 	NO_OS_UNUSED_PARAM(buff_size);
-	if (proto != PROTOCOL_TCP)
+	if (proto != PROTOCOL_TCP && proto != PROTOCOL_UDP &&
+	    proto != PROTOCOL_UDPLITE)
 		return -EPROTONOSUPPORT;
 
 	ret = _get_closed_socket(desc, &socket_id);
 	if (ret)
 		return ret;
 
+	if (proto != PROTOCOL_TCP) {
+		udp_pcb = udp_new_ip_type(IPADDR_TYPE_ANY);
+		if (!udp_pcb)
+			return -ENOMEM;
+
+		if (proto == PROTOCOL_UDPLITE) {
+			/* Corrupted payloads are still delivered, only headers are checked */
+			udp_setflags(udp_pcb, UDP_FLAGS_UDPLITE);
+			udp_pcb->chksum_len_tx = NO_OS_UDPLITE_CSCOV;
+			udp_pcb->chksum_len_rx = NO_OS_UDPLITE_CSCOV;
+		}
+
+		desc->sockets[socket_id].udp_pcb = udp_pcb;
+		desc->sockets[socket_id].pcb = NULL;
+		desc->sockets[socket_id].desc = desc;
+		desc->sockets[socket_id].id = socket_id;
+		desc->sockets[socket_id].state = SOCKET_DATAGRAM;
+		*sock_id = socket_id;
+
+		return 0;
+	}
+
 	pcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
 	if (!pcb) {
 		_release_socket(desc, socket_id);
@@ -555,6 +652,10 @@ static int32_t lwip_socket_open(void *net, uint32_t *sock_id,
 	desc->sockets[socket_id].desc = desc;
 	desc->sockets[socket_id].id = socket_id;
 	desc->sockets[socket_id].p = NULL;
+	desc->sockets[socket_id].p_idx = 0;
+	desc->sockets[socket_id].tx_pending = 0;
+	memset(&desc->sockets[socket_id].cfg, 0,
+	       sizeof(desc->sockets[socket_id].cfg));
 
 	lwip_config_socket(&desc->sockets[socket_id]);
 
@@ -565,7 +666,9 @@ static int32_t lwip_socket_open(void *net, uint32_t *sock_id,
 }
 
 /**
- * @brief Send a TCP packet.
+ * @brief Send a TCP packet. Small writes are coalesced and only output once
+ * the socket's flush threshold is reached, the send buffer runs out, or at the
+ * next no_os_lwip_step() / lwip_socket_recv() call.
  * @param net - lwip sockets layer specific descriptor.
  * @param sock_id - index of the socket to send data to.
  * @param data - pointer to the data array.
@@ -577,6 +680,7 @@ static int32_t lwip_socket_send(void *net, uint32_t sock_id, const void *data,
 {
 	struct lwip_network_desc *desc = net;
 	struct lwip_socket_desc *sock;
+	uint32_t tx_flush;
 	uint32_t avail;
 	uint32_t flags;
 	err_t err;
@@ -599,9 +703,13 @@ static int32_t lwip_socket_send(void *net, uint32_t sock_id, const void *data,
 	if (err != ERR_OK)
 		return err;
 
-	if (!(flags & TCP_WRITE_FLAG_MORE)) {
+	sock->tx_pending += size;
+	tx_flush = sock->cfg.tx_flush ? sock->cfg.tx_flush : TCP_MSS;
+
+	if ((flags & TCP_WRITE_FLAG_MORE) || sock->tx_pending >= tx_flush ||
+	    tcp_sndqueuelen(sock->pcb) >= TCP_SND_QUEUELEN / 2) {
 		/* Mark data as ready to be sent */
-		err = tcp_output(sock->pcb);
+		err = _flush_socket(sock);
 		if (err != ERR_OK)
 			return err;
 	}
@@ -610,21 +718,53 @@ static int32_t lwip_socket_send(void *net, uint32_t sock_id, const void *data,
 }
 
 /**
- * @brief Receive a TCP packet.
- * @param net - lwip sockets layer specific descriptor.
+ * @brief Get the next contiguous received bytes of a socket, without copying
+ * them. The bytes stay queued until released with no_os_lwip_socket_consume().
+ * @param desc - lwip sockets layer specific descriptor.
  * @param sock_id - index of the socket to receive data from.
- * @param data - pointer to the data array.
- * @param size - size of data to be read.
+ * @param data - set to the first unread byte.
+ * @param len - number of contiguous bytes at data, 0 if nothing was received.
  * @return 0 in the case of success, negative error code otherwise
  */
-static int32_t lwip_socket_recv(void *net, uint32_t sock_id, void *data,
-				uint32_t size)
+int32_t no_os_lwip_socket_peek(struct lwip_network_desc *desc, uint32_t sock_id,
+			       const void **data, uint32_t *len)
+{
+	struct lwip_socket_desc *socket;
+
+	socket = _get_sock(desc, sock_id);
+	if (!socket || !data || !len)
+		return -EINVAL;
+
+	if (socket->state != SOCKET_CONNECTED)
+		return -ENOTCONN;
+
+	if (!socket->p) {
+		*len = 0;
+		return 0;
+	}
+
+	*data = (uint8_t *)socket->p->payload + socket->p_idx;
+	*len = socket->p->len - socket->p_idx;
+
+	return 0;
+}
+
+/**
+ * @brief Release received bytes. The pbufs which are completely consumed are
+ * freed and the receive window is reopened with a single tcp_recved() call.
+ * @param desc - lwip sockets layer specific descriptor.
+ * @param sock_id - index of the socket.
+ * @param len - number of bytes to be released.
+ * @return the number of bytes released, negative error code otherwise
+ */
+int32_t no_os_lwip_socket_consume(struct lwip_network_desc *desc,
+				  uint32_t sock_id, uint32_t len)
 {
-	struct lwip_network_desc *desc = net;
 	struct lwip_socket_desc *socket;
 	struct pbuf *p, *old_p;
-	uint8_t *buf, *pdata;
-	uint32_t i, len;
+	uint32_t released = 0;
+	uint32_t consumed = 0;
+	uint32_t n;
 
 	socket = _get_sock(desc, sock_id);
 	if (!socket)
@@ -633,18 +773,11 @@ static int32_t lwip_socket_recv(void *net, uint32_t sock_id, void *data,
 	if (socket->state != SOCKET_CONNECTED)
 		return -ENOTCONN;
 
-	i = 0;
 	p = socket->p;
-	pdata = data;
-
-	/* Iterate over payloads until requested data has been read */
-	while (p && i < size) {
-		len = no_os_min(size - i, p->len - socket->p_idx);
-		buf = p->payload;
-		buf += socket->p_idx;
-		memcpy(pdata + i, buf, len);
-		i += len;
-		socket->p_idx += len;
+	while (p && consumed < len) {
+		n = no_os_min(len - consumed, p->len - socket->p_idx);
+		consumed += n;
+		socket->p_idx += n;
 		if (socket->p_idx == p->len) {
 			/* Done with current p. Cleanup and mark as read */
 			old_p = p;
@@ -652,16 +785,116 @@ static int32_t lwip_socket_recv(void *net, uint32_t sock_id, void *data,
 			if (p)
 				pbuf_ref(p);
 
+			released += old_p->len;
 			if (old_p->ref > 0)
 				pbuf_free(old_p);
 
-			tcp_recved(socket->pcb, socket->p_idx);
 			socket->p_idx = 0;
 		}
 	}
 	socket->p = p;
 
-	return i;
+	while (released) {
+		n = no_os_min(released, 0xFFFF);
+		tcp_recved(socket->pcb, n);
+		released -= n;
+	}
+
+	return consumed;
+}
+
+/**
+ * @brief Receive a TCP packet.
+ * @param net - lwip sockets layer specific descriptor.
+ * @param sock_id - index of the socket to receive data from.
+ * @param data - pointer to the data array.
+ * @param size - size of data to be read.
+ * @return 0 in the case of success, negative error code otherwise
+ */
+static int32_t lwip_socket_recv(void *net, uint32_t sock_id, void *data,
+				uint32_t size)
+{
+	struct lwip_network_desc *desc = net;
+	struct lwip_socket_desc *socket;
+	struct pbuf *p;
+	uint8_t *pdata;
+	uint32_t i, len, idx;
+	int32_t ret;
+
+	socket = _get_sock(desc, sock_id);
+	if (!socket)
+		return -EINVAL;
+
+	if (socket->state != SOCKET_CONNECTED)
+		return -ENOTCONN;
+
+	/* The application waits for an answer, send what it wrote until now */
+	ret = _flush_socket(socket);
+	if (ret)
+		return ret;
+
+	i = 0;
+	p = socket->p;
+	idx = socket->p_idx;
+	pdata = data;
+
+	/* Copy the payloads until requested data has been read */
+	while (p && i < size) {
+		len = no_os_min(size - i, p->len - idx);
+		memcpy(pdata + i, (uint8_t *)p->payload + idx, len);
+		i += len;
+		idx = 0;
+		p = p->next;
+	}
+
+	return no_os_lwip_socket_consume(desc, sock_id, i);
+}
+
+/**
+ * @brief Output the writes coalesced on a socket.
+ * @param desc - lwip sockets layer specific descriptor.
+ * @param sock_id - index of the socket.
+ * @return 0 in the case of success, negative error code otherwise
+ */
+int32_t no_os_lwip_socket_flush(struct lwip_network_desc *desc,
+				uint32_t sock_id)
+{
+	struct lwip_socket_desc *socket;
+
+	socket = _get_sock(desc, sock_id);
+	if (!socket)
+		return -EINVAL;
+
+	return _flush_socket(socket);
+}
+
+/**
+ * @brief Set the receive window and send coalescing settings of a socket.
+ * Sockets accepted by a listening socket inherit its settings.
+ * @param desc - lwip sockets layer specific descriptor.
+ * @param sock_id - index of the socket.
+ * @param cfg - the new settings.
+ * @return 0 in the case of success, negative error code otherwise
+ */
+int32_t no_os_lwip_socket_config(struct lwip_network_desc *desc,
+				 uint32_t sock_id,
+				 const struct lwip_socket_config *cfg)
+{
+	struct lwip_socket_desc *socket;
+	uint32_t old_wnd;
+
+	socket = _get_sock(desc, sock_id);
+	if (!socket || !cfg)
+		return -EINVAL;
+
+	old_wnd = _get_rcv_wnd(socket);
+	socket->cfg = *cfg;
+
+	/* Listening pcbs have no receive window */
+	if (socket->state != SOCKET_LISTENING && socket->state != SOCKET_ACCEPTING)
+		_set_rcv_wnd(socket, old_wnd);
+
+	return 0;
 }
 
 /**
@@ -681,7 +914,10 @@ static int32_t lwip_socket_bind(void *net, uint32_t sock_id, uint16_t port)
 	if (!socket)
 		return -EINVAL;
 
-	err = tcp_bind(socket->pcb, IP_ANY_TYPE, port);
+	if (socket->udp_pcb)
+		err = udp_bind(socket->udp_pcb, IP_ANY_TYPE, port);
+	else
+		err = tcp_bind(socket->pcb, IP_ANY_TYPE, port);
 	if (err != ERR_OK) {
 		printf("Unable to bind port %"PRIu16"\n", port);
 		return -EINVAL;
@@ -746,6 +982,11 @@ static err_t lwip_accept_callback(void *arg, struct tcp_pcb *new_pcb, err_t err)
 	socket = _get_sock(desc, id);
 	socket->pcb = new_pcb;
 	socket->state = SOCKET_WAITING_ACCEPT;
+	socket->p = NULL;
+	socket->p_idx = 0;
+	socket->tx_pending = 0;
+	socket->cfg = serv_sock->cfg;
+	_set_rcv_wnd(socket, TCP_WND);
 
 	tcp_setprio(socket->pcb, 0);
 	lwip_config_socket(socket);
@@ -793,18 +1034,83 @@ static int32_t lwip_socket_accept(void *net, uint32_t sock_id,
 }
 
 /**
- * @brief Not implemented.
- * @param net - Not used.
- * @param sock_id - Not used.
- * @param data - Not used.
- * @param size - Not used.
- * @param to - Not used.
- * @return -ENOSYS
+ * @brief Send several datagrams over a UDP socket.
+ * @param net - lwip sockets layer specific descriptor.
+ * @param sock_id - index of the socket.
+ * @param dgrams - the datagrams (header and payload are copied in one pbuf).
+ * @param nb_dgrams - number of datagrams.
+ * @param to - address of the remote host (dotted decimal).
+ * @return the number of datagrams sent, negative error code otherwise
+ */
+static int32_t lwip_socket_sendto_batch(void *net, uint32_t sock_id,
+					const struct socket_datagram *dgrams,
+					uint32_t nb_dgrams,
+					const struct socket_address *to)
+{
+	struct lwip_network_desc *desc = net;
+	struct lwip_socket_desc *socket;
+	ip_addr_t ipaddr;
+	struct pbuf *p;
+	uint32_t i;
+	err_t err;
+
+	socket = _get_sock(desc, sock_id);
+	if (!socket || !to || !to->addr)
+		return -EINVAL;
+
+	if (!socket->udp_pcb)
+		return -EPROTOTYPE;
+
+	if (!ipaddr_aton(to->addr, &ipaddr))
+		return -EINVAL;
+
+	for (i = 0; i < nb_dgrams; i++) {
+		p = pbuf_alloc(PBUF_TRANSPORT, dgrams[i].hdr_len + dgrams[i].len,
+			       PBUF_RAM);
+		if (!p)
+			break;
+
+		if (dgrams[i].hdr_len)
+			pbuf_take(p, dgrams[i].hdr, dgrams[i].hdr_len);
+		if (dgrams[i].len)
+			pbuf_take_at(p, dgrams[i].data, dgrams[i].len,
+				     dgrams[i].hdr_len);
+
+		err = udp_sendto(socket->udp_pcb, p, &ipaddr, to->port);
+		pbuf_free(p);
+		if (err != ERR_OK)
+			break;
+	}
+
+	if (!i && nb_dgrams)
+		return -ENOMEM;
+
+	return i;
+}
+
+/**
+ * @brief Send a datagram over a UDP socket.
+ * @param net - lwip sockets layer specific descriptor.
+ * @param sock_id - index of the socket.
+ * @param data - pointer to the data array.
+ * @param size - size of data array.
+ * @param to - address of the remote host (dotted decimal).
+ * @return size in the case of success, negative error code otherwise
  */
 static int32_t lwip_socket_sendto(void *net, uint32_t sock_id, const void *data,
 				  uint32_t size, const struct socket_address *to)
 {
-	return -ENOSYS;
+	struct socket_datagram dgram = {
+		.data = data,
+		.len = size,
+	};
+	int32_t ret;
+
+	ret = lwip_socket_sendto_batch(net, sock_id, &dgram, 1, to);
+	if (ret < 0)
+		return ret;
+
+	return size;
 }
 
 /**
@@ -910,6 +1216,7 @@ struct network_interface lwip_socket_ops = {
 	.socket_bind = lwip_socket_bind,
 	.socket_listen = lwip_socket_listen,
 	.socket_accept = lwip_socket_accept,
+	.socket_sendto_batch = lwip_socket_sendto_batch,
 };
 
 /**
@@ -931,6 +1238,7 @@ static void lwip_config_if(struct lwip_network_desc *desc)
 	net->socket_bind = lwip_socket_bind;
 	net->socket_listen = lwip_socket_listen;
 	net->socket_accept = lwip_socket_accept;
+	net->socket_sendto_batch = lwip_socket_sendto_batch;
 
 	net->net = desc;
 }
@@ -54,6 +54,16 @@
 
 struct lwip_network_desc;
 
+struct lwip_socket_config {
+	/*
+	 * Receive window advertised to the peer, capped to TCP_WND. It also
+	 * bounds the pool pbufs the socket can hold unread. 0 - TCP_WND.
+	 */
+	uint32_t rcv_wnd;
+	/* Unsent bytes after which coalesced writes are output. 0 - TCP_MSS */
+	uint32_t tx_flush;
+};
+
 struct lwip_socket_desc {
 	/* Unique identifier */
 	uint32_t id;
@@ -69,13 +79,21 @@ struct lwip_socket_desc {
 		SOCKET_WAITING_ACCEPT,
 		/* Socket is connected to remote */
 		SOCKET_CONNECTED,
+		/* UDP socket */
+		SOCKET_DATAGRAM,
 	} state;
 	/* Lwip specific descriptor for each connection. */
 	struct tcp_pcb *pcb;
+	/* Lwip specific descriptor of a UDP socket */
+	struct udp_pcb *udp_pcb;
 	/* Either a packet buffer chain or queue containing the received frames */
 	struct pbuf *p;
 	/* Index of the current read byte in the first pbuf of the chain */
 	uint32_t p_idx;
+	/* Window and send coalescing settings */
+	struct lwip_socket_config cfg;
+	/* Bytes written with tcp_write() but not yet passed to tcp_output() */
+	uint32_t tx_pending;
 	/* Reference to the parent network descriptor. */
 	struct lwip_network_desc *desc;
 };
@@ -118,6 +136,18 @@ int32_t no_os_lwip_remove(struct lwip_network_desc *);
  */
 int32_t no_os_lwip_step(struct lwip_network_desc *, void *);
 
+/* Set the receive window and send coalescing settings of a socket */
+int32_t no_os_lwip_socket_config(struct lwip_network_desc *, uint32_t,
+				 const struct lwip_socket_config *);
+/* Get the next contiguous received bytes of a socket, without copying them */
+int32_t no_os_lwip_socket_peek(struct lwip_network_desc *, uint32_t,
+			       const void **, uint32_t *);
+/* Release bytes returned by no_os_lwip_socket_peek() */
+int32_t no_os_lwip_socket_consume(struct lwip_network_desc *, uint32_t,
+				  uint32_t);
+/* Output the writes coalesced on a socket */
+int32_t no_os_lwip_socket_flush(struct lwip_network_desc *, uint32_t);
+
 extern struct network_interface lwip_socket_ops;
 
 #endif /* NO_OS_LWIP_NETWORKING */
@@ -60,7 +60,7 @@
 static uint8_t lwip_buff[ADIN1110_LWIP_BUFF_SIZE];
 
 /**
- * @brief Read a frame from the RX FIFO.
+ * @brief Read a frame from the RX FIFO directly into a pool pbuf.
  * @param desc - ADIN1110 descriptor.
  * @param p - the received pbuf.
  * @param len - length of the frame.
@@ -69,27 +69,42 @@ static uint8_t lwip_buff[ADIN1110_LWIP_BUFF_SIZE];
 static int adin1110_read_frames(struct adin1110_desc *desc, struct pbuf **p,
 				uint32_t *len)
 {
-	struct adin1110_eth_buff mac_buff = {0};
+	struct adin1110_frag frags[ADIN1110_MAX_FRAGS];
+	struct pbuf *q;
+	uint32_t i;
 	int ret;
 
-	mac_buff.payload = &lwip_buff[ADIN1110_ETH_HDR_LEN];
-
-	ret = adin1110_read_fifo(desc, 0, &mac_buff);
-	if (ret)
+	ret = adin1110_rx_frame_len(desc, 0, len);
+	if (ret || !*len)
 		return ret;
 
-	*len = mac_buff.len;
-	if (!mac_buff.len)
-		return 0;
-
-	memcpy(lwip_buff, mac_buff.mac_dest, ADIN1110_ETH_HDR_LEN);
-	*p = pbuf_alloc(PBUF_RAW, mac_buff.len, PBUF_POOL);
+	/* The FIFO is read in 4 byte bursts, leave room for the last one */
+	*p = pbuf_alloc(PBUF_RAW, *len + ADIN1110_RD_SLACK, PBUF_POOL);
 	if (!*p)
 		return -ENOMEM;
 
-	pbuf_take(*p, lwip_buff, mac_buff.len);
+	for (q = *p, i = 0; q && i < ADIN1110_MAX_FRAGS; q = q->next, i++) {
+		frags[i].data = q->payload;
+		frags[i].len = q->len;
+	}
+
+	if (q) {
+		ret = -EMSGSIZE;
+		goto free_pbuf;
+	}
+
+	ret = adin1110_read_fifo_sg(desc, 0, frags, i, *len);
+	if (ret)
+		goto free_pbuf;
+
+	pbuf_realloc(*p, *len);
 
 	return 0;
+
+free_pbuf:
+	pbuf_free(*p);
+
+	return ret;
 }
 
 /**
@@ -104,15 +119,24 @@ static int32_t adin1110_step(struct lwip_network_desc *desc, void *data)
 	struct netif *netif_desc;
 	struct pbuf *p;
 	uint32_t len;
+	bool pending;
 	int ret;
 
 	netif_desc = desc->lwip_netif;
 	mac_desc = desc->mac_desc;
 
+	/* With the INT pin in use, the FIFO is not polled while idle */
+	ret = adin1110_rx_pending(mac_desc, &pending);
+	if (ret || !pending)
+		return ret;
+
 	do {
 		ret = adin1110_read_frames(mac_desc, &p, &len);
-		if (ret)
+		if (ret) {
+			/* Frames left in the FIFO won't assert the INT pin again */
+			adin1110_rx_restore(mac_desc);
 			return ret;
+		}
 
 		if (len) {
 			LINK_STATS_INC(link.recv);
@@ -128,30 +152,37 @@ static int32_t adin1110_step(struct lwip_network_desc *desc, void *data)
 }
 
 /**
- * @brief Write the data inside a pbuf on the wire.
+ * @brief Write the data inside a pbuf on the wire. The pbuf chain is sent
+ * without being copied, unless it has more than ADIN1110_MAX_FRAGS segments.
  * @param net - lwip network descriptor to send data to.
  * @param p - pbuf to be sent.
  * @return 0 in case of success, negative error otherwise.
  */
 static int32_t adin1110_netif_output(struct netif *net, struct pbuf *p)
 {
+	struct adin1110_frag frags[ADIN1110_MAX_FRAGS];
 	struct lwip_network_desc *lwip_desc;
 	struct adin1110_desc *mac_desc;
-	struct adin1110_eth_buff buff;
-	uint32_t frame_len;
+	struct pbuf *q;
+	uint32_t i;
 
 	lwip_desc = net->state;
 	mac_desc = lwip_desc->mac_desc;
 
 	LINK_STATS_INC(link.xmit);
-	frame_len = pbuf_copy_partial(p, lwip_buff, p->tot_len, 0);
 
-	memcpy(&buff.mac_dest, lwip_buff, ADIN1110_ETH_HDR_LEN);
+	for (q = p, i = 0; q && i < ADIN1110_MAX_FRAGS; q = q->next, i++) {
+		frags[i].data = q->payload;
+		frags[i].len = q->len;
+	}
 
-	buff.len = frame_len;
-	buff.payload = &lwip_buff[ADIN1110_ETH_HDR_LEN];
+	if (q) {
+		frags[0].data = lwip_buff;
+		frags[0].len = pbuf_copy_partial(p, lwip_buff, p->tot_len, 0);
+		i = 1;
+	}
 
-	return adin1110_write_fifo(mac_desc, 0, &buff);
+	return adin1110_write_fifo_sg(mac_desc, 0, frags, i);
 }
 
 /**
@@ -40,6 +40,7 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -53,9 +54,22 @@ enum socket_protocol {
 	/** TCP Protocol */
 	PROTOCOL_TCP,
 	/** UDP Protocol */
-	PROTOCOL_UDP
+	PROTOCOL_UDP,
+	/** UDP-Lite Protocol, the checksum only covers the datagram headers */
+	PROTOCOL_UDPLITE
 };
 
+/* Size of the UDP header */
+#define NO_OS_UDP_HDR_SIZE		8
+/*
+ * Size of the application header sent in front of each UDP-Lite payload,
+ * the udp_stream datagram header (sizeof(struct udp_stream_hdr)).
+ */
+#define NO_OS_UDPLITE_APP_HDR_SIZE	16
+/* Bytes covered by the UDP-Lite checksum: UDP header + application header */
+#define NO_OS_UDPLITE_CSCOV		(NO_OS_UDP_HDR_SIZE + \
+					 NO_OS_UDPLITE_APP_HDR_SIZE)
+
 /**
  * @struct socket_address
  * @brief Represent an endpoint of a connection.
@@ -67,6 +81,46 @@ struct socket_address {
 	uint16_t	port;
 };
 
+/**
+ * @struct socket_datagram
+ * @brief A datagram made of a header and a payload, sent without copying
+ * them together.
+ */
+struct socket_datagram {
+	/** Header */
+	const void	*hdr;
+	/** Size of the header in bytes */
+	uint32_t	hdr_len;
+	/** Payload */
+	const void	*data;
+	/** Size of the payload in bytes */
+	uint32_t	len;
+};
+
+/**
+ * @struct socket_iov
+ * @brief A piece of data sent together with others by socket_sendv.
+ */
+struct socket_iov {
+	/** Data */
+	const void	*data;
+	/** Size of the data in bytes */
+	uint32_t	len;
+};
+
+/**
+ * @struct socket_options
+ * @brief Per socket tuning, 0/false fields keep the stack defaults.
+ */
+struct socket_options {
+	/** Send buffer size in bytes (SO_SNDBUF) */
+	uint32_t	snd_buff_size;
+	/** Receive buffer size in bytes (SO_RCVBUF) */
+	uint32_t	rcv_buff_size;
+	/** Send small segments without waiting to coalesce them (TCP_NODELAY) */
+	bool		no_delay;
+};
+
 /**
  * @struct network_interface
  * @brief Interface that connect the data layer with the transport layer
@@ -212,6 +266,65 @@ struct network_interface {
 	 */
 	int32_t (*socket_accept)(void *net, uint32_t sock_id,
 				 uint32_t *client_socket_id);
+
+	/**
+	 * @brief Send several datagrams over a UDP socket with one call.
+	 *
+	 * Optional, socket_sendto is used for each datagram when NULL.
+	 * @param net - Network interface
+	 * @param sock_id - Socket id
+	 * @param dgrams - Datagrams to send
+	 * @param nb_dgrams - Number of datagrams
+	 * @param to - Address of the remote host
+	 * @return
+	 *  - Number of sent datagrams : On success
+	 *  - \ref Negative error code on failure
+	 */
+	int32_t (*socket_sendto_batch)(void *net, uint32_t sock_id,
+				       const struct socket_datagram *dgrams,
+				       uint32_t nb_dgrams,
+				       const struct socket_address *to);
+
+	/**
+	 * @brief Send several pieces of data over a TCP socket with one call.
+	 *
+	 * Optional, socket_send is used for each piece when NULL.
+	 * @param net - Network interface
+	 * @param sock_id - Socket id
+	 * @param iov - Pieces of data, sent in order
+	 * @param nb_iov - Number of pieces
+	 * @return
+	 *  - Number of sent bytes : On success
+	 *  - \ref Negative error code on failure
+	 */
+	int32_t (*socket_sendv)(void *net, uint32_t sock_id,
+				const struct socket_iov *iov, uint32_t nb_iov);
+
+	/**
+	 * @brief Apply buffer sizes and TCP_NODELAY to a socket. Optional.
+	 * @param net - Network interface
+	 * @param sock_id - Socket id
+	 * @param opts - Options to apply
+	 * @return
+	 *  - 0 : On success
+	 *  - \ref Negative error code on failure
+	 */
+	int32_t (*socket_setopt)(void *net, uint32_t sock_id,
+				 const struct socket_options *opts);
+
+	/**
+	 * @brief Wait until some of the sockets opened or accepted through
+	 * this interface have data to read or a pending connection. Optional.
+	 * @param net - Network interface
+	 * @param sock_ids - Where to store the ids of the ready sockets, or NULL
+	 * @param nb_ids - Size of sock_ids
+	 * @param timeout_ms - Time to wait, 0 to only query the readiness
+	 * @return
+	 *  - Number of ready sockets (0 on timeout) : On success
+	 *  - \ref Negative error code on failure
+	 */
+	int32_t (*socket_wait)(void *net, uint32_t *sock_ids, uint32_t nb_ids,
+			       uint32_t timeout_ms);
 };
 
 #endif
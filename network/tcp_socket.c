@@ -281,6 +281,20 @@ int32_t socket_init(struct tcp_socket_desc **desc,
 		return ret;
 	}
 
+	if (param->opts.snd_buff_size || param->opts.rcv_buff_size ||
+	    param->opts.no_delay) {
+		if (ldesc->net->socket_setopt)
+			ret = ldesc->net->socket_setopt(ldesc->net->net, ldesc->id,
+							&param->opts);
+		else
+			ret = -ENOSYS;
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			ldesc->net->socket_close(ldesc->net->net, ldesc->id);
+			no_os_free(ldesc);
+			return ret;
+		}
+	}
+
 #ifndef DISABLE_SECURE_SOCKET
 	if (!param->secure_init_param)
 		ldesc->secure = NULL;
@@ -384,6 +398,59 @@ int32_t socket_send(struct tcp_socket_desc *desc, const void *data,
 				      data, len);
 }
 
+/**
+ * @brief Send several pieces of data, with a single call when the network
+ * interface supports it.
+ * @param desc - Socket descriptor
+ * @param iov - Pieces of data, sent in order
+ * @param nb_iov - Number of pieces
+ * @return Number of sent bytes or negative error code
+ */
+int32_t socket_sendv(struct tcp_socket_desc *desc,
+		     const struct socket_iov *iov, uint32_t nb_iov)
+{
+	int32_t sent = 0;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || !iov)
+		return -EINVAL;
+
+#ifndef DISABLE_SECURE_SOCKET
+	if (!desc->secure && desc->net->socket_sendv)
+#else
+	if (desc->net->socket_sendv)
+#endif /* DISABLE_SECURE_SOCKET */
+		return desc->net->socket_sendv(desc->net->net, desc->id, iov,
+					       nb_iov);
+
+	for (i = 0; i < nb_iov; i++) {
+		ret = socket_send(desc, iov[i].data, iov[i].len);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return sent ? sent : ret;
+
+		sent += ret;
+		if ((uint32_t)ret < iov[i].len)
+			break;
+	}
+
+	return sent;
+}
+
+/** @brief See \ref network_interface.socket_wait */
+int32_t socket_wait(struct tcp_socket_desc *desc, uint32_t *sock_ids,
+		    uint32_t nb_ids, uint32_t timeout_ms)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->net->socket_wait)
+		return -ENOSYS;
+
+	return desc->net->socket_wait(desc->net->net, sock_ids, nb_ids,
+				      timeout_ms);
+}
+
 /** @brief See \ref network_interface.socket_recv */
 int32_t socket_recv(struct tcp_socket_desc *desc, void *data, uint32_t len)
 {
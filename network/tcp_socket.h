@@ -120,6 +120,12 @@ struct tcp_socket_init_param {
 	 *  DEFAULT_CONNECTION_BUFFER_SIZE from tcp_socket.c
 	 */
 	uint32_t			max_buff_size;
+	/**
+	 * Kernel send/receive buffer sizes and TCP_NODELAY. Applied when the
+	 * network interface implements socket_setopt, 0/false keeps the
+	 * default. Sockets accepted by a listening one inherit them.
+	 */
+	struct socket_options		opts;
 #ifndef DISABLE_SECURE_SOCKET
 	/**
 	 * Reference to \ref secure_init_param if a TCP socket over TLS should
@@ -151,6 +157,14 @@ int32_t socket_disconnect(struct tcp_socket_desc *desc);
 int32_t socket_send(struct tcp_socket_desc *desc, const void *data,
 		    uint32_t len);
 
+/* Socket send of several pieces of data */
+int32_t socket_sendv(struct tcp_socket_desc *desc,
+		     const struct socket_iov *iov, uint32_t nb_iov);
+
+/* Wait for sockets of the same network interface to become readable */
+int32_t socket_wait(struct tcp_socket_desc *desc, uint32_t *sock_ids,
+		    uint32_t nb_ids, uint32_t timeout_ms);
+
 /* Socket recv */
 int32_t socket_recv(struct tcp_socket_desc *desc, void *data, uint32_t len);
 
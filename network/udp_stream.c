@@ -0,0 +1,303 @@
+/***************************************************************************//**
+ *   @file   udp_stream.c
+ *   @brief  Sequence numbered datagram streaming over UDP sockets
+ *   @author Analog Devices Inc.
+********************************************************************************
+ *   @copyright
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include <assert.h>
+#include "udp_stream.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+#include "no_os_alloc.h"
+
+/* The UDP-Lite checksum coverage of the socket layers relies on this size */
+static_assert(UDP_STREAM_HDR_SIZE == NO_OS_UDPLITE_APP_HDR_SIZE,
+	      "udp_stream header size doesn't match the UDP-Lite coverage");
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Encode a datagram header.
+ * @param buf - Destination, UDP_STREAM_HDR_SIZE bytes.
+ * @param hdr - Header fields.
+ */
+static void udp_stream_hdr_put(uint8_t *buf, const struct udp_stream_hdr *hdr)
+{
+	no_os_put_unaligned_be32(hdr->magic, &buf[0]);
+	no_os_put_unaligned_be32(hdr->seq, &buf[4]);
+	no_os_put_unaligned_be16(hdr->stream, &buf[8]);
+	no_os_put_unaligned_be16(hdr->flags, &buf[10]);
+	no_os_put_unaligned_be32(hdr->offset, &buf[12]);
+}
+
+/**
+ * @brief Hand datagrams to the network interface.
+ * @param desc - Stream descriptor.
+ * @param nb - Number of datagrams in desc->dgrams.
+ * @return Number of datagrams sent or negative error code.
+ */
+static int32_t udp_stream_xmit(struct udp_stream_desc *desc, uint32_t nb)
+{
+	struct network_interface *net = desc->net;
+	struct socket_datagram *dgram;
+	int32_t ret;
+	uint32_t i;
+
+	if (net->socket_sendto_batch)
+		return net->socket_sendto_batch(net->net, desc->sock_id,
+						desc->dgrams, nb, &desc->peer);
+
+	/* No scatter/gather support, assemble each datagram */
+	for (i = 0; i < nb; i++) {
+		dgram = &desc->dgrams[i];
+		memcpy(desc->dgram_buff, dgram->hdr, dgram->hdr_len);
+		memcpy(desc->dgram_buff + dgram->hdr_len, dgram->data, dgram->len);
+		ret = net->socket_sendto(net->net, desc->sock_id, desc->dgram_buff,
+					 dgram->hdr_len + dgram->len, &desc->peer);
+		if (ret < 0)
+			return i ? (int32_t)i : ret;
+	}
+
+	return nb;
+}
+
+/**
+ * @brief Open the socket of a UDP stream.
+ * @param desc - Address where to store the stream descriptor.
+ * @param param - Initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t udp_stream_init(struct udp_stream_desc **desc,
+			const struct udp_stream_init_param *param)
+{
+	struct udp_stream_desc *ldesc;
+	uint32_t mtu;
+	int32_t ret;
+
+	if (!desc || !param || !param->net || !param->peer.addr)
+		return -EINVAL;
+
+	if (param->proto != PROTOCOL_UDP && param->proto != PROTOCOL_UDPLITE)
+		return -EPROTONOSUPPORT;
+
+	if (strlen(param->peer.addr) >= UDP_STREAM_ADDR_MAX)
+		return -EINVAL;
+
+	mtu = param->mtu ? param->mtu : UDP_STREAM_DEFAULT_MTU;
+	if (mtu <= UDP_STREAM_IP_UDP_SIZE + UDP_STREAM_HDR_SIZE)
+		return -EINVAL;
+
+	ldesc = (struct udp_stream_desc *)no_os_calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	if (!param->net->socket_sendto_batch) {
+		ldesc->dgram_buff = no_os_calloc(1, mtu - UDP_STREAM_IP_UDP_SIZE);
+		if (!ldesc->dgram_buff) {
+			ret = -ENOMEM;
+			goto free_desc;
+		}
+	}
+
+	ldesc->net = param->net;
+	ldesc->payload = mtu - UDP_STREAM_IP_UDP_SIZE - UDP_STREAM_HDR_SIZE;
+	strcpy(ldesc->addr, param->peer.addr);
+	ldesc->peer.addr = ldesc->addr;
+	ldesc->peer.port = param->peer.port;
+
+	ret = ldesc->net->socket_open(ldesc->net->net, &ldesc->sock_id,
+				      param->proto, 0);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		goto free_buff;
+
+	if (param->local_port) {
+		ret = ldesc->net->socket_bind(ldesc->net->net, ldesc->sock_id,
+					      param->local_port);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			goto close_socket;
+	}
+
+	*desc = ldesc;
+
+	return 0;
+
+close_socket:
+	ldesc->net->socket_close(ldesc->net->net, ldesc->sock_id);
+free_buff:
+	no_os_free(ldesc->dgram_buff);
+free_desc:
+	no_os_free(ldesc);
+
+	return ret;
+}
+
+/**
+ * @brief Close the socket and free the descriptor.
+ * @param desc - Stream descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t udp_stream_remove(struct udp_stream_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	desc->net->socket_close(desc->net->net, desc->sock_id);
+	no_os_free(desc->dgram_buff);
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Send a block of data as MTU sized datagrams. Datagrams the socket
+ * can't take are dropped but keep their sequence numbers, so the receiver
+ * accounts them as lost instead of the sender stalling.
+ * @param desc - Stream descriptor.
+ * @param stream - Stream id placed in the datagram headers.
+ * @param data - Block of data.
+ * @param len - Size of the block in bytes.
+ * @return len in case of success, negative error code otherwise.
+ */
+int32_t udp_stream_send(struct udp_stream_desc *desc, uint16_t stream,
+			const void *data, uint32_t len)
+{
+	const uint8_t *buf = data;
+	struct udp_stream_hdr hdr;
+	uint32_t offset = 0;
+	uint32_t i, nb;
+	int32_t ret;
+
+	if (!desc || (!data && len))
+		return -EINVAL;
+
+	hdr.magic = UDP_STREAM_MAGIC;
+	hdr.stream = stream;
+
+	while (offset < len) {
+		for (nb = 0; nb < UDP_STREAM_BATCH && offset < len; nb++) {
+			hdr.seq = desc->seq + nb;
+			hdr.flags = offset ? 0 : UDP_STREAM_FLAG_START;
+			hdr.offset = offset;
+			udp_stream_hdr_put(desc->hdrs[nb], &hdr);
+
+			desc->dgrams[nb].hdr = desc->hdrs[nb];
+			desc->dgrams[nb].hdr_len = UDP_STREAM_HDR_SIZE;
+			desc->dgrams[nb].data = buf + offset;
+			desc->dgrams[nb].len = no_os_min(len - offset, desc->payload);
+			offset += desc->dgrams[nb].len;
+		}
+
+		ret = udp_stream_xmit(desc, nb);
+		if (ret == -EAGAIN || ret == -ENOBUFS || ret == -ENOMEM)
+			ret = 0;
+		else if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		for (i = 0; i < (uint32_t)ret; i++)
+			desc->stats.tx_bytes += desc->dgrams[i].len;
+		desc->stats.tx_datagrams += ret;
+		desc->stats.tx_dropped += nb - ret;
+		desc->seq += nb;
+	}
+
+	return len;
+}
+
+/**
+ * @brief Get the sender side counters.
+ * @param desc - Stream descriptor.
+ * @param stats - Destination of the counters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t udp_stream_stats_get(struct udp_stream_desc *desc,
+			     struct udp_stream_stats *stats)
+{
+	if (!desc || !stats)
+		return -EINVAL;
+
+	*stats = desc->stats;
+
+	return 0;
+}
+
+/**
+ * @brief Decode a received datagram and update the receiver side counters.
+ * @param rx - Receiver state, zero initialized before the first datagram.
+ * @param dgram - Received datagram.
+ * @param len - Size of the datagram in bytes.
+ * @param hdr - Destination of the decoded header, may be NULL.
+ * @return Offset of the payload in the datagram, negative error code otherwise.
+ */
+int32_t udp_stream_rx_check(struct udp_stream_rx *rx, const void *dgram,
+			    uint32_t len, struct udp_stream_hdr *hdr)
+{
+	uint8_t *buf = (uint8_t *)dgram;
+	struct udp_stream_hdr lhdr;
+	int32_t diff;
+
+	if (!rx || !dgram || len < UDP_STREAM_HDR_SIZE)
+		return -EINVAL;
+
+	lhdr.magic = no_os_get_unaligned_be32(&buf[0]);
+	if (lhdr.magic != UDP_STREAM_MAGIC)
+		return -EPROTO;
+
+	lhdr.seq = no_os_get_unaligned_be32(&buf[4]);
+	lhdr.stream = no_os_get_unaligned_be16(&buf[8]);
+	lhdr.flags = no_os_get_unaligned_be16(&buf[10]);
+	lhdr.offset = no_os_get_unaligned_be32(&buf[12]);
+
+	diff = (int32_t)(lhdr.seq - rx->next_seq);
+	if (!rx->synced || diff >= 0) {
+		if (rx->synced)
+			rx->lost += diff;
+		rx->next_seq = lhdr.seq + 1;
+		rx->synced = true;
+	} else {
+		/* Late datagram, already accounted as lost */
+		rx->reordered++;
+		if (rx->lost)
+			rx->lost--;
+	}
+	rx->received++;
+
+	if (hdr)
+		*hdr = lhdr;
+
+	return UDP_STREAM_HDR_SIZE;
+}
@@ -0,0 +1,181 @@
+/***************************************************************************//**
+ *   @file   udp_stream.h
+ *   @brief  Sequence numbered datagram streaming over UDP sockets
+ *   @author Analog Devices Inc.
+********************************************************************************
+ *   @copyright
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef UDP_STREAM_H
+# define UDP_STREAM_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "network_interface.h"
+#include "no_os_util.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Magic number starting each datagram ("NOUS") */
+#define UDP_STREAM_MAGIC	0x4E4F5553
+/* Size in bytes of the header placed in front of each payload */
+#define UDP_STREAM_HDR_SIZE	sizeof(struct udp_stream_hdr)
+/* IPv4 + UDP headers */
+#define UDP_STREAM_IP_UDP_SIZE	28
+/* MTU used when none is given */
+#define UDP_STREAM_DEFAULT_MTU	1500
+/* Datagrams handed to the network interface at once */
+#define UDP_STREAM_BATCH	16
+/* Longest peer address */
+#define UDP_STREAM_ADDR_MAX	64
+
+/* The datagram carries the first bytes of a block */
+#define UDP_STREAM_FLAG_START	NO_OS_BIT(0)
+
+/**
+ * @struct udp_stream_hdr
+ * @brief Decoded datagram header. On the wire all the fields are big endian,
+ * in this order.
+ */
+struct udp_stream_hdr {
+	/** UDP_STREAM_MAGIC */
+	uint32_t	magic;
+	/** Incremented for each datagram, loss is detected from the gaps */
+	uint32_t	seq;
+	/** Stream the datagram belongs to (e.g. IIO device index) */
+	uint16_t	stream;
+	/** UDP_STREAM_FLAG_* */
+	uint16_t	flags;
+	/** Offset of the payload in the block passed to udp_stream_send() */
+	uint32_t	offset;
+};
+
+/**
+ * @struct udp_stream_stats
+ * @brief Sender side counters.
+ */
+struct udp_stream_stats {
+	/** Datagrams handed to the network interface */
+	uint32_t	tx_datagrams;
+	/** Payload bytes handed to the network interface */
+	uint32_t	tx_bytes;
+	/** Datagrams dropped because the socket could not take them */
+	uint32_t	tx_dropped;
+};
+
+/**
+ * @struct udp_stream_rx
+ * @brief Receiver side sequence tracking, see udp_stream_rx_check().
+ */
+struct udp_stream_rx {
+	/** Sequence number expected next */
+	uint32_t	next_seq;
+	/** Set once the first datagram was received */
+	bool		synced;
+	/** Datagrams received */
+	uint32_t	received;
+	/** Datagrams missing from the sequence */
+	uint32_t	lost;
+	/** Datagrams received after a newer one */
+	uint32_t	reordered;
+};
+
+/**
+ * @struct udp_stream_init_param
+ * @brief Parameters used to initialize a UDP stream.
+ */
+struct udp_stream_init_param {
+	/** Reference to the network interface */
+	struct network_interface	*net;
+	/** Receiver of the stream (the address string is copied) */
+	struct socket_address		peer;
+	/** Local port to bind to, 0 to let the stack pick one */
+	uint16_t			local_port;
+	/** Link MTU, 0 - UDP_STREAM_DEFAULT_MTU */
+	uint16_t			mtu;
+	/** PROTOCOL_UDP or PROTOCOL_UDPLITE */
+	enum socket_protocol		proto;
+};
+
+/**
+ * @struct udp_stream_desc
+ * @brief UDP stream descriptor.
+ */
+struct udp_stream_desc {
+	/** Reference to the network interface */
+	struct network_interface	*net;
+	/** Id of the opened socket */
+	uint32_t			sock_id;
+	/** Receiver of the stream */
+	struct socket_address		peer;
+	/** Storage for peer.addr */
+	char				addr[UDP_STREAM_ADDR_MAX];
+	/** Payload bytes carried by a datagram */
+	uint32_t			payload;
+	/** Sequence number of the next datagram */
+	uint32_t			seq;
+	/** Sender side counters */
+	struct udp_stream_stats		stats;
+	/** Headers of the datagrams being sent */
+	uint8_t				hdrs[UDP_STREAM_BATCH][UDP_STREAM_HDR_SIZE];
+	/** Datagrams being sent */
+	struct socket_datagram		dgrams[UDP_STREAM_BATCH];
+	/** Datagram assembly buffer, used without socket_sendto_batch */
+	uint8_t				*dgram_buff;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Open the socket of a UDP stream */
+int32_t udp_stream_init(struct udp_stream_desc **desc,
+			const struct udp_stream_init_param *param);
+
+/* Close the socket and free the descriptor */
+int32_t udp_stream_remove(struct udp_stream_desc *desc);
+
+/* Send a block of data as MTU sized datagrams */
+int32_t udp_stream_send(struct udp_stream_desc *desc, uint16_t stream,
+			const void *data, uint32_t len);
+
+/* Get the sender side counters */
+int32_t udp_stream_stats_get(struct udp_stream_desc *desc,
+			     struct udp_stream_stats *stats);
+
+/* Decode a received datagram and update the receiver side counters */
+int32_t udp_stream_rx_check(struct udp_stream_rx *rx, const void *dgram,
+			    uint32_t len, struct udp_stream_hdr *hdr);
+
+#endif
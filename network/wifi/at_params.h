@@ -189,12 +189,12 @@ struct cipserver_param {
 
 /**
  * @enum cipmode_param
- * @brief Not implemented
+ * @brief Transport mode
  */
 enum cipmode_param {
 	/** Normal mode */
 	NORMAL_MODE,
-	/** Unvernished mode */
+	/** Unvarnished (passthrough) mode. Single TCP connection only */
 	UNVARNISHED_MODE
 };
 
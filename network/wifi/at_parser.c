@@ -54,18 +54,27 @@
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
 
-/* Should be sizeof(async_msgs)/sizeof(*async_msgs) */
-#define NB_ASYNC_MESSAGES	3
-/* Should be sizeof(responses)/sizeof(*responses) */
-#define NB_RESPONSE_MESSAGES	4
 /* Max command length: at+cwsap=max_ssid_32,max_pass_64,0,0 -> 110 characters */
 #define CMD_BUFF_LEN		120u
 /* Maybe this could be smaller. Here must one response at a time */
 #define RESULT_BUFF_LEN		500u
+/* Size of the ring the UART writes the received data to. Power of 2 */
+#define RX_RING_LEN		4096u
+/* Max length of a line sent by the module */
+#define LINE_BUFF_LEN		256u
+/* Sends that can wait for their SEND OK */
+#define MAX_PENDING_SENDS	4
 /* Used to remove warnings on strings */
 #define PUI8(X)			((uint8_t *)(X))
 /* Timeout waiting for module response. (20 seconds) */
 #define MODULE_TIMEOUT		20000
+/* Silence required before the passthrough escape sequence (ms) */
+#define PASSTHROUGH_GUARD_MS	20
+/* Time the module needs to leave passthrough mode (ms) */
+#define PASSTHROUGH_EXIT_MS	1000
+/* Beginning of a line announcing a payload */
+#define IPD_PREFIX		"+IPD,"
+#define IPD_PREFIX_LEN		(sizeof(IPD_PREFIX) - 1)
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -113,6 +122,18 @@ struct connection_desc {
 	enum socket_type	type;
 };
 
+/* Final response of a command */
+enum at_response {
+	/* No response received yet */
+	AT_RESP_NONE,
+	/* OK */
+	AT_RESP_OK,
+	/* ERROR or FAIL */
+	AT_RESP_ERROR,
+	/* busy p... or busy s... : the command was dropped */
+	AT_RESP_BUSY
+};
+
 /* Structure storing the status of the parser */
 struct at_desc {
 	/* - Uart related fields */
@@ -137,48 +158,51 @@ struct at_desc {
 		uint8_t	result_buff[RESULT_BUFF_LEN];
 		uint8_t	app_result_buff[RESULT_BUFF_LEN];
 		uint8_t	cmd_buff[CMD_BUFF_LEN];
+		uint8_t	rx_ring[RX_RING_LEN];
+		/* One more for the null terminator */
+		uint8_t	line_buff[LINE_BUFF_LEN + 1];
 	} 			buffers;
 	/* Stores data received from the module */
-	volatile struct at_buff	result;
+	struct at_buff		result;
 	/* Buffer to build the command */
 	struct at_buff		cmd;
-	/* Buffer to read one char */
-	uint8_t			read_ch;
+	/* Line being framed */
+	struct at_buff		line;
+	/* Where data is discarded when the ring is full */
+	uint8_t			rx_drop;
+
+	/* - Reception fields. The UART callback only fills the ring. */
+	/* Bytes written in the ring by the UART. Free running. */
+	volatile uint32_t	rx_head;
+	/* Bytes handled by the parser. Free running. */
+	volatile uint32_t	rx_tail;
+	/* Length of the UART read in progress */
+	volatile uint32_t	rx_armed;
+	/* Payload bytes the module will send next, read in one transfer */
+	volatile uint32_t	rx_expect;
+	/* State of the parser */
+	enum {
+		/* Framing lines of the responses */
+		AT_RX_LINE,
+		/* Copying the payload of a connection */
+		AT_RX_PAYLOAD
+	}			rx_state;
 
 	/* - Control fields */
 	/* Variable to store errors */
-	uint32_t errors;
+	volatile uint32_t	errors;
 	/* Store the wifi status */
-	bool is_wifi_connected;
-	/* State of the callback */
-	volatile enum {
-		/* Normal mode. Read each char and interpret the result */
-		READING_RESPONSES,
-		/* When an +IPD is received, callback enter in this mode */
-		READING_PAYLOAD,
-		/* Used when a reset command have been sent */
-		RESETTING_MODULE,
-		/* Used when using AT_SEND to wait for the character '>' */
-		WAITING_SEND
-
-	}			callback_operation;
-	/* Indexes in the ready message */
-	uint8_t			ready_idx;
-	/* Indexes in the async response given by the driver */
-	uint8_t			async_idx[NB_ASYNC_MESSAGES];
-	/* Indexes in the response given by the driver */
-	uint8_t			resp_idx[NB_RESPONSE_MESSAGES];
-	/* Ipd idx */
-	uint8_t			ipd_idx;
-	/* State of ipd command message */
-	enum {
-		NOT_MATCH,
-		RAEDING_CONN,
-		WAITING_COMMA,
-		READING_LEN
-	}			ipd_stat;
-	/* Variable where current message length is built */
-	uint32_t		ipd_len;
+	bool			is_wifi_connected;
+	/* Set while the module resets, until the "ready" message */
+	bool			resetting;
+	/* Set while waiting for the '>' of AT_SEND */
+	bool			waiting_prompt;
+	/* Response of the last command */
+	enum at_response	response;
+	/* Sends waiting for SEND OK */
+	uint32_t		pending_sends;
+	/* Set while in passthrough (unvarnished) mode */
+	bool			passthrough;
 	/* Will be called when a new connection is created or closed */
 	void			(*connection_callback)(void *ctx, enum at_event,
 			uint32_t conn_id, struct no_os_circular_buffer **cb);
@@ -190,379 +214,419 @@ struct at_desc {
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
-/* Increment idx if current ch match in msg[idx] and return true if idx == len*/
-static inline bool match_message(const struct at_buff *msg, uint8_t *idx,
-				 uint8_t ch)
+/*
+ * Submit the next UART read, directly in the free part of the ring. When the
+ * length of the coming payload is known, it is read in a single transfer.
+ */
+static void at_rx_submit(struct at_desc *desc)
 {
-	if (ch == msg->buff[*idx]) {
-		/* Increment matching index if there is a match */
-		(*idx)++;
-		if (*idx == msg->len)
-			/* Return the index of the match message */
-			return true;
-	} else if (ch == msg->buff[0]) {
-		*idx = 1;
-	} else {
-		*idx = 0;
+	uint32_t	idx;
+	uint32_t	len;
+
+	idx = desc->rx_head & (RX_RING_LEN - 1);
+	len = RX_RING_LEN - (desc->rx_head - desc->rx_tail);
+	if (!len) {
+		/* The parser is late. Data from uart is discarded */
+		if (!desc->resetting)
+			desc->errors |= AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
+		desc->rx_armed = 0;
+		no_os_uart_read_nonblocking(desc->uart_desc, &desc->rx_drop, 1);
+		return ;
 	}
 
-	return false;
+	len = no_os_min(len, RX_RING_LEN - idx);
+	len = no_os_min(len, no_os_max(desc->rx_expect, 1u));
+	desc->rx_armed = len;
+	no_os_uart_read_nonblocking(desc->uart_desc,
+				    &desc->buffers.rx_ring[idx], len);
 }
 
-/* Check if new payload message have been received and set the payload size in
- * to_read if so.
- */
-static inline bool is_payload_message(struct at_desc *desc, uint8_t ch)
+/* Handle the uart read done */
+static void at_callback_rd_done(struct at_desc *desc)
 {
-	static const struct at_buff	at_ipd = {PUI8("\r\n+IPD,"), 7};
-	/* max_ch_search = at_ipd.len + sizeof("0,1024") */
-	bool		ret;
-
-	ret = false;
-	/* Update ipd_idx until at_ipd message is matched */
-	if (desc->ipd_idx < at_ipd.len) {
-		if (match_message(&at_ipd, &desc->ipd_idx, ch)) {
-			if (desc->multiple_conections)
-				desc->ipd_stat = RAEDING_CONN;
-			else
-				desc->ipd_stat = READING_LEN;
-		}
-		return false;
-	}
-	/* Update ipd_idx until ':' is found. Similar to match_messages but
-	 * the message is not fix so we could use that function
-	 */
-	switch (desc->ipd_stat) {
-	case RAEDING_CONN:
-		if (ch < '0' || ch > '4')
-			goto reset;
-		desc->current_conn = ch - '0';
-		desc->ipd_stat = WAITING_COMMA;
-		desc->ipd_idx++;
-		break;
-	case WAITING_COMMA:
-		if (ch != ',')
-			goto reset;
-		desc->ipd_stat = READING_LEN;
-		desc->ipd_idx++;
-		break;
-	case READING_LEN:
-		if (ch < '0' || ch > '9') {
-			if (ch == ':' && desc->ipd_len > 0) {
-				desc->conn[desc->current_conn].to_read =
-					desc->ipd_len;
-				desc->result.len -= desc->ipd_idx;
-				ret = true;
-			}
-			goto reset;
-		}
-		desc->ipd_len = desc->ipd_len * 10 + (ch - '0');
-		desc->ipd_idx++;
-		break;
-	default:
-		goto reset;
-	}
+	uint32_t len = desc->rx_armed;
 
-	return false;
-reset:
-	desc->ipd_idx = 0;
-	desc->ipd_len = 0;
-	desc->ipd_stat = NOT_MATCH;
+	desc->rx_expect -= no_os_min(desc->rx_expect, len);
+	desc->rx_head += len;
 
-	return ret;
+	at_rx_submit(desc);
 }
 
-static inline int32_t check_conn_id(struct at_desc *desc, struct at_buff *msg,
-				    int32_t msg_idx)
+/* Handle the uart error */
+static void at_callback_error(struct at_desc *desc)
 {
-	int32_t	id;
-	int32_t	j;
-
-	/* Get the connection number of the closed connection */
-	desc->result.len -= (msg->len - 1);
-	/* Update connection state */
-	id = 0;
-	if (desc->multiple_conections) {
-		//Response: 2,CLOSED -> id = 0
-		j = desc->result.len - 2;
-		if (j < 0) {
-			id = -1;
-		} else {
-			if (desc->result.buff[j] >= '0' &&
-			    desc->result.buff[j] <= '3') {
-				id = desc->result.buff[j] - '0';
-				desc->result.len -= 2;
-			} else {
-				id = -1;
-			}
-		}
-	}
-	if (id >= 0 && id < 4) {//Maximum of 4 connections
-		/* Close connection */
-		desc->current_conn = id;
-		desc->conn[id].active = false;
-		desc->conn[id].cbuff = NULL;
-		/* Notify that a connection was closed */
-		desc->connection_callback(desc->callback_ctx,
-					  AT_CLOSED_CONNECTION, id, NULL);
-	} else {//Not id
-		desc->async_idx[msg_idx] = 0;
-		return false;
-	}
+	if (!desc->resetting)
+		desc->errors |= AT_ERROR_UART;
 
-	return true;
+	/* Submit buffer to read the next data */
+	at_rx_submit(desc);
 }
 
-/* Check if an asynchronous messages was sent by the module and update desc */
-static bool is_async_messages(struct at_desc *desc, uint8_t ch)
+/* Notify the application about a new connection */
+static void at_conn_open(struct at_desc *desc, uint32_t id)
 {
-	const static struct at_buff async_msgs[NB_ASYNC_MESSAGES] = {
-		{PUI8("CLOSED\r\n"), 8},
-		{PUI8("WIFI DISCONNECT\r\n"), 17},
-		{PUI8("WIFI GOT IP\r\n"), 13}
-	};
+	struct connection_desc	*conn = &desc->conn[id];
 
-	int32_t	i;
+	if (conn->active)
+		return ;
 
-	for (i = 0; i < NB_ASYNC_MESSAGES; i++) {
-		if (match_message(&async_msgs[i], &desc->async_idx[i], ch))
-			break;
-	}
+	/*
+	 * Application needs to set a cbuff for the connection where data will
+	 * be written. If it doesn't, the data of the connection is discarded.
+	 */
+	desc->connection_callback(desc->callback_ctx, AT_NEW_CONNECTION, id,
+				  &conn->cbuff);
+	if (conn->cbuff)
+		conn->active = true;
+}
 
-	switch (i) {
-	case 0: //Match CLOSED\r\n
-		if (check_conn_id(desc, (struct at_buff *)&async_msgs[i], i))
-			return false;
-		break;
-	case 1: //WIFI DISCONNECT\r\n
-		desc->is_wifi_connected = false;
-		break;
-	case 2:
-		desc->is_wifi_connected = true;
-		break;
-	default:
+/* Notify the application about a closed connection */
+static void at_conn_close(struct at_desc *desc, uint32_t id)
+{
+	desc->conn[id].active = false;
+	desc->conn[id].cbuff = NULL;
+	desc->connection_callback(desc->callback_ctx, AT_CLOSED_CONNECTION, id,
+				  NULL);
+}
+
+/* Handle "<id>,CONNECT", "<id>,CLOSED" and "CLOSED" */
+static bool at_conn_event(struct at_desc *desc, const char *line)
+{
+	uint32_t id = 0;
+
+	if (line[0] >= '0' && line[0] < '0' + MAX_CONNECTIONS &&
+	    line[1] == ',') {
+		id = line[0] - '0';
+		line += 2;
+	} else if (desc->multiple_conections) {
 		return false;
 	}
 
-	/* Clear response indexes */
-	memset(desc->async_idx, 0, sizeof(desc->async_idx));
+	if (!strcmp(line, "CLOSED"))
+		at_conn_close(desc, id);
+	else if (!strcmp(line, "CONNECT"))
+		at_conn_open(desc, id);
+	else
+		return false;
 
 	return true;
 }
 
-/* Mark the circular buffer transaction as ended */
-static inline void end_conn_read(struct at_desc *desc)
+/* Start copying the payload announced by +IPD,[<id>,]<len>: */
+static void at_start_payload(struct at_desc *desc, char *params)
 {
-	struct connection_desc	*conn;
-
-	conn = &desc->conn[desc->current_conn];
+	uint32_t	id = 0;
+	uint32_t	len;
+	uint32_t	avail;
 
-	no_os_cb_end_async_write(conn->cbuff);
+	if (desc->multiple_conections) {
+		id = strtoul(params, &params, 10);
+		if (*params++ != ',' || id >= MAX_CONNECTIONS)
+			return ;
+	}
+	len = strtoul(params, &params, 10);
+	if (!len || (*params != ':' && *params != ','))
+		return ;
+
+	at_conn_open(desc, id);
+	desc->current_conn = id;
+	desc->conn[id].to_read = len;
+	desc->rx_state = AT_RX_PAYLOAD;
+
+	/* Let the UART read what is still to come in one go */
+	no_os_irq_disable(desc->irq_desc, desc->uart_irq_id);
+	avail = desc->rx_head - desc->rx_tail;
+	desc->rx_expect = len > avail ? len - avail : 0;
+	no_os_irq_enable(desc->irq_desc, desc->uart_irq_id);
 }
 
-/* Start new read operation */
-static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
+/* Copy payload from the ring to the connection buffer */
+static uint32_t at_copy_payload(struct at_desc *desc, const uint8_t *data,
+				uint32_t len)
 {
 	struct connection_desc	*conn;
-	uint8_t			*buff;
-	uint32_t		available_len;
-	int32_t			ret;
 
 	conn = &desc->conn[desc->current_conn];
+	/* In passthrough mode everything received is payload */
+	if (!desc->passthrough)
+		len = no_os_min(len, conn->to_read);
+
+	if (conn->cbuff)
+		no_os_cb_write(conn->cbuff, data, len);
 
-	if (is_new_message && !conn->active) {
-		/*
-		 * Notify that a new connection has started. Application needs
-		 * to set a cbuff for the connection where data will be written.
-		 */
-		desc->connection_callback(desc->callback_ctx,
-					  AT_NEW_CONNECTION,
-					  desc->current_conn,
-					  &conn->cbuff);
-		if (conn->cbuff)
-			conn->active = true;
-		/*
-		 * Else, a AT_STOP_CONNECTION command should be sent to the
-		 * esp8266 module. (Application rejects the connection)
-		 * This could be done only if implement at_run_cmd with
-		 * no_os_uart_write_nonblocking
-		 */
+	if (!desc->passthrough) {
+		conn->to_read -= len;
+		if (!conn->to_read) {
+			desc->rx_state = AT_RX_LINE;
+			desc->current_conn = -1;
+		}
 	}
 
-	if (!conn->cbuff)
-		/* There is no buffer set for this connection */
-		goto dummy_read;
+	return len;
+}
 
-	/* Get buffer where data from uart can be written using DMA */
-	ret = no_os_cb_prepare_async_write(conn->cbuff, conn->to_read,
-					   (void **)&buff, &available_len);
-	if (NO_OS_IS_ERR_VALUE(ret))
-		goto dummy_read;
+/* Interpret a line received from the module */
+static void at_handle_line(struct at_desc *desc)
+{
+	char		*line = (char *)desc->line.buff;
+	uint32_t	len = desc->line.len;
+
+	line[len] = '\0';
+	if (desc->resetting) {
+		if (!strncmp(line, "ready", 5))
+			desc->resetting = false;
+		return ;
+	}
 
-	no_os_uart_read_nonblocking(desc->uart_desc, buff, available_len);
-	conn->to_read -= available_len;
+	if (line[len - 1] == ':' &&
+	    !strncmp(line, IPD_PREFIX, IPD_PREFIX_LEN)) {
+		at_start_payload(desc, line + IPD_PREFIX_LEN);
+		return ;
+	}
 
-	return ;
-dummy_read:
-	/* Data from uart is discarded because an error occured or
-	 * there is no buffer available
-	 */
-	no_os_uart_read_nonblocking(desc->uart_desc, &desc->read_ch, 1);
-	conn->to_read -= 1;
+	/* Remove the surrounding spaces and \r\n */
+	while (len && (line[len - 1] == '\n' || line[len - 1] == '\r' ||
+		       line[len - 1] == ' '))
+		line[--len] = '\0';
+	while (*line == ' ') {
+		line++;
+		len--;
+	}
+	if (!len)
+		return ;
+
+	if (!strcmp(line, "OK")) {
+		desc->response = AT_RESP_OK;
+	} else if (!strcmp(line, "ERROR") || !strcmp(line, "FAIL")) {
+		desc->response = AT_RESP_ERROR;
+	} else if (!strncmp(line, "busy ", 5)) {
+		desc->response = AT_RESP_BUSY;
+	} else if (!strcmp(line, "SEND OK") || !strcmp(line, "SEND FAIL")) {
+		if (desc->pending_sends)
+			desc->pending_sends--;
+		if (line[5] == 'F')
+			desc->errors |= AT_ERROR_CONNECTION_LOST;
+	} else if (!strncmp(line, "Recv ", 5)) {
+		/* Payload of AT_SEND received by the module */
+	} else if (!strcmp(line, "WIFI DISCONNECT")) {
+		desc->is_wifi_connected = false;
+	} else if (!strcmp(line, "WIFI GOT IP")) {
+		desc->is_wifi_connected = true;
+	} else if (!at_conn_event(desc, line)) {
+		/* Add received line to result buffer */
+		if (desc->result.len + len + 2 >= RESULT_BUFF_LEN) {
+			desc->errors |= AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
+			desc->result.len = 0;
+			return ;
+		}
+		memcpy(desc->result.buff + desc->result.len, line, len);
+		desc->result.len += len;
+		desc->result.buff[desc->result.len++] = '\r';
+		desc->result.buff[desc->result.len++] = '\n';
+	}
 }
 
-/* Handle the uart read done */
-static void at_callback_rd_done(struct at_desc *desc)
+/*
+ * Frame what the UART wrote in the ring. Lines end with '\n', except the
+ * +IPD header which ends with ':' and is followed by the payload.
+ * Returns true if data was processed.
+ */
+static bool at_parse_rx(struct at_desc *desc)
 {
-	static const struct at_buff ready_msg = {PUI8("ready\r\n"), 7};
+	uint8_t		*data;
+	uint8_t		*end;
+	uint32_t	avail;
+	uint32_t	idx;
+	uint32_t	len;
+	uint8_t		delim;
+	bool		processed = false;
+
+	while ((avail = desc->rx_head - desc->rx_tail)) {
+		processed = true;
+		idx = desc->rx_tail & (RX_RING_LEN - 1);
+		len = no_os_min(avail, RX_RING_LEN - idx);
+		data = &desc->buffers.rx_ring[idx];
+
+		if (desc->rx_state == AT_RX_PAYLOAD) {
+			desc->rx_tail += at_copy_payload(desc, data, len);
+			continue;
+		}
 
-	switch (desc->callback_operation) {
-	case RESETTING_MODULE:
-		if (match_message(&ready_msg, &desc->ready_idx,
-				  desc->read_ch))
-			desc->callback_operation = READING_RESPONSES;
-		break;
-	case WAITING_SEND:
-	case READING_RESPONSES:
-		if (is_payload_message(desc, desc->read_ch)) {
-			/* New payload received */
-			desc->callback_operation = READING_PAYLOAD;
-			start_conn_read(desc, true);
-			return ;
+		if (!desc->line.len && desc->waiting_prompt && *data == '>') {
+			desc->waiting_prompt = false;
+			desc->rx_tail++;
+			continue;
 		}
 
-		if (desc->read_ch == '>' && desc->callback_operation ==
-		    WAITING_SEND) {
-			desc->callback_operation = READING_RESPONSES;
-		} else if (desc->result.len >= RESULT_BUFF_LEN) {
-			desc->errors |=
-				AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
-			desc->result.len = 0;
-		} else if (!is_async_messages(desc, desc->read_ch))
-			/* Add received character to result buffer */
-			desc->result.buff[desc->result.len++] =
-				desc->read_ch;
-		break;
-	case READING_PAYLOAD:
-		/* Receiving payload from connection */
-		end_conn_read(desc);
-		if (!desc->conn[desc->current_conn].to_read) {
-			desc->callback_operation = READING_RESPONSES;
-			desc->current_conn = -1;
-			break;
+		/* The beginning of the line tells which delimiter is used */
+		delim = '\n';
+		if (desc->line.len < IPD_PREFIX_LEN)
+			len = no_os_min(len, IPD_PREFIX_LEN - desc->line.len);
+		else if (!memcmp(desc->line.buff, IPD_PREFIX, IPD_PREFIX_LEN))
+			delim = ':';
+
+		end = memchr(data, delim, len);
+		if (end)
+			len = end - data + 1;
+
+		if (desc->line.len + len > LINE_BUFF_LEN) {
+			/* Keep the beginning, which holds the interesting part */
+			if (!desc->resetting)
+				desc->errors |= AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
+			memcpy(desc->line.buff + desc->line.len, data,
+			       LINE_BUFF_LEN - desc->line.len);
+			desc->line.len = LINE_BUFF_LEN;
 		} else {
-			start_conn_read(desc, false);
-			return ;
+			memcpy(desc->line.buff + desc->line.len, data, len);
+			desc->line.len += len;
+		}
+		desc->rx_tail += len;
+
+		if (end) {
+			at_handle_line(desc);
+			desc->line.len = 0;
 		}
-		break;
 	}
 
-	/* Submit buffer to read the next char */
-	no_os_uart_read_nonblocking(desc->uart_desc, &desc->read_ch, 1);
+	return processed;
 }
 
-/* Handle the uart error */
-static void at_callback_error(struct at_desc *desc)
+/* Conditions waited by at_wait */
+static bool at_got_response(struct at_desc *desc)
 {
-	if (desc->callback_operation != RESETTING_MODULE)
-		desc->errors |= AT_ERROR_UART;
+	return desc->response != AT_RESP_NONE;
+}
+
+static bool at_got_prompt(struct at_desc *desc)
+{
+	return !desc->waiting_prompt;
+}
+
+static bool at_is_ready(struct at_desc *desc)
+{
+	return !desc->resetting;
+}
+
+static bool at_can_send(struct at_desc *desc)
+{
+	return desc->pending_sends < MAX_PENDING_SENDS;
+}
+
+static bool at_is_disconnected(struct at_desc *desc)
+{
+	return !desc->is_wifi_connected;
+}
+
+/*
+ * Run the parser until the condition is met or for MODULE_TIMEOUT
+ * milliseconds without data from the module
+ */
+static int32_t at_wait(struct at_desc *desc, bool (*cond)(struct at_desc *))
+{
+	uint32_t timeout = MODULE_TIMEOUT;
 
-	/* Submit buffer to read the next char */
-	no_os_uart_read_nonblocking(desc->uart_desc, &desc->read_ch, 1);
+	while (!cond(desc)) {
+		if (at_parse_rx(desc))
+			continue;
+		if (!--timeout)
+			return -ETIMEDOUT;
+		no_os_mdelay(1);
+	}
+
+	return 0;
 }
 
-/* Wait the response for the last command for MODULE_TIMEOUT milliseconds */
+/* Wait the response for the last command */
 static int32_t wait_for_response(struct at_desc *desc)
 {
-	const static struct at_buff responses[NB_RESPONSE_MESSAGES] = {
-		{PUI8("\r\nERROR\r\n"), 9},
-		{PUI8("\r\nFAIL\r\n"), 8},
-		{PUI8("\r\nOK\r\n"), 6},
-		{PUI8("\r\nSEND OK\r\n"), 11}
-	};
-	uint32_t	timeout;
-	uint32_t	result;
-	uint32_t	i;
-	uint32_t	j;
-
-	i = 0;
-	timeout = MODULE_TIMEOUT;
-	result = -1;
+	enum at_response	response;
+	int32_t			ret;
+
+	ret = at_wait(desc, at_got_response);
+	if (ret)
+		return -1;
+
+	response = desc->response;
+	desc->response = AT_RESP_NONE;
+
+	if (response == AT_RESP_BUSY)
+		return -EBUSY;
+
+	return response == AT_RESP_OK ? 0 : -1;
+}
+
+/* Write desc->cmd and wait for the response. Retry while the module is busy */
+static int32_t write_cmd(struct at_desc *desc)
+{
+	uint32_t	retry = MODULE_TIMEOUT;
+	bool		prompt = desc->waiting_prompt;
+	int32_t		ret;
+
 	do {
-		if (i < desc->result.len) {
-			for (j = 0; j < NB_RESPONSE_MESSAGES; j++)
-				if (match_message(&responses[j],
-						  &desc->resp_idx[j],
-						  desc->result.buff[i]))
-					break;
-
-			i++;
-			switch (j) {
-			case 0: // \r\nERROR\r\n
-			case 1: // \r\nFAIL\r\n
-				result = -1;
-				goto end;
-			case 2: // \r\nOK\r\n
-			case 3: // \r\nSEND OK\r\n
-				result = 0;
-				goto end;
-			default:
-				break;
-			}
-		}
+		desc->response = AT_RESP_NONE;
+		desc->waiting_prompt = prompt;
+		no_os_uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
+		ret = wait_for_response(desc);
+		if (ret != -EBUSY)
+			break;
+		/* A previous send is still in progress */
 		no_os_mdelay(1);
-	} while (--timeout);
-
-end:
-	if (timeout) //If a response arrived clean the result
-		desc->result.len -= desc->resp_idx[j];
+	} while (--retry);
 
-	memset(desc->resp_idx, 0, sizeof(desc->resp_idx));
+	if (ret)
+		desc->waiting_prompt = false;
 
-	return result;
+	return ret;
 }
 
 /* Send what is in desc->cmd over the UART and handle special case of AT_SEND */
 static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 			union in_param *in_param)
 {
-	uint32_t timeout = MODULE_TIMEOUT;
+	int32_t	ret;
 
-	no_os_uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
 	if (cmd == AT_SEND) {
-		desc->callback_operation = WAITING_SEND;
-		/* Waiting for ok */
-		if (0 != wait_for_response(desc))
+		if (desc->passthrough)
+			/* The data goes directly to the connection */
+			return no_os_uart_write(desc->uart_desc,
+						in_param->send_data.data.buff,
+						in_param->send_data.data.len);
+
+		/* Don't wait for SEND OK, unless too many sends are pending */
+		ret = at_wait(desc, at_can_send);
+		if (ret)
 			return -1;
+
+		desc->waiting_prompt = true;
+		ret = write_cmd(desc);
+		if (ret)
+			return ret;
+
 		/* Wait until '>' is received */
-		while (timeout--) {
-			if (WAITING_SEND != desc->callback_operation)
-				break;
-			no_os_mdelay(1);
-		}
-		if (timeout == 0)
+		ret = at_wait(desc, at_got_prompt);
+		if (ret)
 			return -1;
+
 		/* Write payload */
 		no_os_uart_write(desc->uart_desc, in_param->send_data.data.buff,
 				 in_param->send_data.data.len);
-	} else if (cmd == AT_DISCONNECT_NETWORK) {
-		if (desc->is_wifi_connected) {
-			/* Wait for WIFI_DISCONNECT */
-			do {
-				if (desc->is_wifi_connected == 0)
-					break;
-				no_os_mdelay(1);
-			} while (timeout--);
-
-			if (timeout == 0)
-				return -1;
+		desc->pending_sends++;
 
-			return 0;
-		}
+		return 0;
 	}
 
-	/* Wait for OK, SEND OK or ERROR */
-	return wait_for_response(desc);
+	ret = write_cmd(desc);
+	if (ret)
+		return ret;
+
+	if (cmd == AT_DISCONNECT_NETWORK && desc->is_wifi_connected) {
+		/* Wait for WIFI DISCONNECT */
+		ret = at_wait(desc, at_is_disconnected);
+		if (ret)
+			return -1;
+	}
+
+	return 0;
 }
 
 /*
@@ -769,9 +833,11 @@ static void build_cmd(struct at_desc *desc, enum at_cmd cmd,
 	desc->cmd.buff[desc->cmd.len++] = '\n';
 }
 
+
 /* Send ATE0 command to stop echo */
 static int32_t stop_echo(struct at_desc *desc)
 {
+	desc->response = AT_RESP_NONE;
 	no_os_uart_write(desc->uart_desc, (uint8_t *)"ATE0\r\n", 6);
 
 	if (0 != wait_for_response(desc))
@@ -781,32 +847,89 @@ static int32_t stop_echo(struct at_desc *desc)
 	return 0;
 }
 
-/* Handle special cases */
-static int32_t handle_special(struct at_desc *desc, enum at_cmd cmd)
+/*
+ * Enter or leave the passthrough (unvarnished) mode. In this mode the data
+ * written to the UART goes directly to the connection and everything received
+ * is payload, which removes the AT_SEND round-trips. The module supports it
+ * only for a single TCP connection.
+ */
+static int32_t set_transport_mode(struct at_desc *desc, enum cipmode_param mode)
 {
-	uint32_t timeout;
+	int32_t ret;
+
+	if (mode == UNVARNISHED_MODE) {
+		if (desc->passthrough)
+			return 0;
+		if (desc->multiple_conections || !desc->conn[0].active ||
+		    desc->conn[0].type != SOCKET_TCP)
+			return -1;
+
+		ret = write_cmd(desc);
+		if (ret)
+			return ret;
+
+		/* AT+CIPSEND without parameters starts the transmission */
+		memcpy(desc->cmd.buff, "AT+CIPSEND\r\n", 12);
+		desc->cmd.len = 12;
+		desc->waiting_prompt = true;
+		ret = write_cmd(desc);
+		if (ret)
+			return ret;
+
+		ret = at_wait(desc, at_got_prompt);
+		if (ret)
+			return -1;
+
+		desc->current_conn = 0;
+		desc->rx_state = AT_RX_PAYLOAD;
+		desc->passthrough = true;
+
+		return 0;
+	}
+
+	if (desc->passthrough) {
+		/* The escape sequence must be surrounded by silence */
+		no_os_mdelay(PASSTHROUGH_GUARD_MS);
+		no_os_uart_write(desc->uart_desc, (uint8_t *)"+++", 3);
+		no_os_mdelay(PASSTHROUGH_EXIT_MS);
+
+		/* What was received until now is still payload */
+		at_parse_rx(desc);
+		desc->passthrough = false;
+		desc->rx_state = AT_RX_LINE;
+		desc->current_conn = -1;
+		desc->line.len = 0;
+	}
+
+	return write_cmd(desc);
+}
 
+/* Handle special cases */
+static int32_t handle_special(struct at_desc *desc, enum at_cmd cmd,
+			      union in_out_param *param)
+{
 	switch (cmd) {
 	case AT_RESET:
-		desc->callback_operation = RESETTING_MODULE;
+		desc->resetting = true;
 		no_os_uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
-		timeout = MODULE_TIMEOUT;
-		do {
-			/* Wait for "ready" message */
-			if (desc->callback_operation != RESETTING_MODULE)
-				break;
-			no_os_mdelay(1);
-		} while (--timeout);
-		if (!timeout)
+		/* Wait for "ready" message */
+		if (at_wait(desc, at_is_ready))
 			return -1;
 
-		desc->callback_operation = READING_PAYLOAD;
+		desc->errors = 0;
 		desc->result.len = 0;
+		desc->pending_sends = 0;
+		desc->passthrough = false;
+		desc->rx_state = AT_RX_LINE;
 		if (0 != stop_echo(desc))
 			return -1;
 		at_run_cmd(desc, AT_DISCONNECT_NETWORK, AT_EXECUTE_OP, NULL);
 
 		break;
+	case AT_SET_TRANSPORT_MODE:
+		if (!param)
+			return -1;
+		return set_transport_mode(desc, param->in.transport_mode);
 	case AT_DEEP_SLEEP:
 		/* TODO : Implement when needed if possible */
 		return -1;
@@ -830,6 +953,7 @@ static int32_t parse_result(struct at_desc *desc, enum at_cmd cmd,
 	return 0;
 }
 
+
 /**
  * @brief Execut an AT command
  * @param desc - AT parser reference
@@ -847,16 +971,22 @@ int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 	uint32_t	id;
 	int32_t		ret;
 
-	if (!desc || cmd == AT_SET_TRANSPORT_MODE)
+	if (!desc)
 		return -1;
 
 	if (!(g_map[cmd].type & op))
 		return -1;
 
+	/* Only the data and the exit from passthrough can be sent */
+	if (desc->passthrough && cmd != AT_SEND &&
+	    !(cmd == AT_SET_TRANSPORT_MODE && op == AT_SET_OP))
+		return -EBUSY;
+
 	build_cmd(desc, cmd, op, param);
 
-	if (cmd == AT_DEEP_SLEEP || cmd == AT_RESET)
-		return handle_special(desc, cmd);
+	if (cmd == AT_DEEP_SLEEP || cmd == AT_RESET ||
+	    (cmd == AT_SET_TRANSPORT_MODE && op == AT_SET_OP))
+		return handle_special(desc, cmd, param);
 
 	ret = send_cmd(desc, cmd, &param->in);
 	if (NO_OS_IS_ERR_VALUE(ret))
@@ -950,11 +1080,14 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 	ldesc->result.len = 0;
 	ldesc->cmd.buff = ldesc->buffers.cmd_buff;
 	ldesc->cmd.len = CMD_BUFF_LEN;
+	ldesc->line.buff = ldesc->buffers.line_buff;
+	ldesc->line.len = 0;
 
-	ldesc->callback_operation = READING_RESPONSES;
+	ldesc->rx_state = AT_RX_LINE;
+	ldesc->current_conn = -1;
 
-	/* The read will be handled by the callback */
-	no_os_uart_read_nonblocking(ldesc->uart_desc, &ldesc->read_ch, 1);
+	/* The callback fills the ring, at_process interprets it */
+	at_rx_submit(ldesc);
 
 	/** Software reset */
 	if (param->sw_reset_en)
@@ -1052,3 +1185,22 @@ int32_t at_to_str(uint8_t **dest, const struct at_buff *src)
 
 	return 0;
 }
+
+/**
+ * @brief Process the data received from the module: copy the payloads to the
+ * connection buffers and handle the connection events. It doesn't block, call
+ * it before reading from a connection buffer.
+ * @param desc - AT parser reference
+ * @return
+ *  - 0 : On success
+ *  - -EINVAL : For invalid parameters
+ */
+int32_t at_process(struct at_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	at_parse_rx(desc);
+
+	return 0;
+}
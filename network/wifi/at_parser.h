@@ -40,6 +40,15 @@
  *  A command can be executed with \ref at_run_cmd and data from a connection
  *  can be read with \ref at_read_buffer .
  *
+ *  The UART callback only writes the received data in a ring buffer. The
+ *  payloads announced by +IPD are read in a single UART transfer. The ring is
+ *  framed by \ref at_run_cmd while waiting for a response and by
+ *  \ref at_process , which must be called periodically to receive the data
+ *  of the connections.
+ *  AT_SEND doesn't wait for SEND OK, so several sends can be in progress.
+ *  For a single TCP connection, the passthrough mode set by
+ *  AT_SET_TRANSPORT_MODE removes the AT_SEND round-trips.
+ *
  *  How AT command work can be found at:\n
  *  https://cdn.sparkfun.com/datasheets/Wireless/WiFi/Command%20Doc.pdf\n
  *  https://github.com/espressif/ESP8266_AT/wiki/basic_at_0019000902
@@ -197,7 +206,9 @@ enum at_cmd {
 	 */
 	AT_SET_SERVER,			// "+CIPSERVER"
 	/**
-	 * Set transport mode: Not supported command.
+	 * Set transport mode. \ref UNVARNISHED_MODE is only available for a
+	 * single TCP connection. While it is set, only AT_SEND and
+	 * AT_SET_TRANSPORT_MODE with \ref NORMAL_MODE can be used.
 	 * Use \ref in_param.transport_mode as set parameter
 	 */
 	AT_SET_TRANSPORT_MODE,		// "+CIPMODE"
@@ -345,6 +356,8 @@ int32_t at_remove(struct at_desc *desc);
 /* Execute an AT command */
 int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 		   union in_out_param *param);
+/* Process the data received from the module */
+int32_t at_process(struct at_desc *desc);
 /* Convert null terminated string to at_buff */
 int32_t str_to_at(struct at_buff *dest, const uint8_t *src);
 /* Convert at_buff to null terminated string */
@@ -104,6 +104,10 @@ struct wifi_desc {
 	struct network_interface	interface;
 	/* Will be used in callback */
 	int32_t				conn_id_to_sock_id[MAX_CONNECTIONS];
+	/* Use the passthrough mode for the client connection */
+	bool				passthrough;
+	/* Set while the module is in passthrough mode */
+	bool				passthrough_active;
 };
 
 /******************************************************************************/
@@ -319,6 +323,7 @@ int32_t wifi_init(struct wifi_desc **desc, struct wifi_init_param *param)
 	at_param.connection_callback = _wifi_connection_callback;
 	at_param.callback_ctx = ldesc;
 	at_param.sw_reset_en = param->sw_reset_en;
+	ldesc->passthrough = param->passthrough;
 
 	result = at_init(&ldesc->at, &at_param);
 	if (NO_OS_IS_ERR_VALUE(result))
@@ -331,7 +336,9 @@ int32_t wifi_init(struct wifi_desc **desc, struct wifi_init_param *param)
 	if (NO_OS_IS_ERR_VALUE(result))
 		goto at_err;
 
-	par.in.conn_type = MULTIPLE_CONNECTION;
+	/* The passthrough mode needs the single connection mode */
+	par.in.conn_type = ldesc->passthrough ? SINGLE_CONNECTION :
+			   MULTIPLE_CONNECTION;
 	result = at_run_cmd(ldesc->at, AT_SET_CONNECTION_TYPE, AT_SET_OP, &par);
 	if (NO_OS_IS_ERR_VALUE(result))
 		goto at_err;
@@ -568,6 +575,14 @@ static int32_t wifi_socket_connect(struct wifi_desc *desc, uint32_t sock_id,
 
 	sock->state = SOCKET_CONNECTED;
 
+	if (desc->passthrough && sock->type == PROTOCOL_TCP) {
+		/* Fall back to AT_SEND if the module refuses */
+		param.in.transport_mode = UNVARNISHED_MODE;
+		ret = at_run_cmd(desc->at, AT_SET_TRANSPORT_MODE, AT_SET_OP,
+				 &param);
+		desc->passthrough_active = !NO_OS_IS_ERR_VALUE(ret);
+	}
+
 	return 0;
 }
 
@@ -612,6 +627,15 @@ static int32_t wifi_socket_disconnect(struct wifi_desc *desc, uint32_t sock_id)
 		/* Remove server reference */
 		desc->server.id = INVALID_ID;
 	} else {
+		if (desc->passthrough_active) {
+			param.in.transport_mode = NORMAL_MODE;
+			ret = at_run_cmd(desc->at, AT_SET_TRANSPORT_MODE,
+					 AT_SET_OP, &param);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+			desc->passthrough_active = false;
+		}
+
 		param.in.conn_id = sock->conn_id;
 		ret = at_run_cmd(desc->at, AT_STOP_CONNECTION, AT_SET_OP,
 				 &param);
@@ -644,7 +668,10 @@ static int32_t wifi_socket_send(struct wifi_desc *desc, uint32_t sock_id,
 
 	i = 0;
 	do {
-		to_send = no_os_min(size - i, MAX_CIPSEND_DATA);
+		/* In passthrough mode there is no size limit */
+		to_send = size - i;
+		if (!desc->passthrough_active)
+			to_send = no_os_min(to_send, MAX_CIPSEND_DATA);
 		param.in.send_data.id = sock->conn_id;
 		param.in.send_data.data.buff = ((uint8_t *)data) + i;
 		param.in.send_data.data.len = to_send;
@@ -670,6 +697,10 @@ static int32_t wifi_socket_recv(struct wifi_desc *desc, uint32_t sock_id,
 	    desc->server.id == sock_id)
 		return -EINVAL;
 
+	ret = at_process(desc->at);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
 	/* TODO read data even if disconnected ? */
 	sock = &desc->sockets[sock_id];
 	if (sock->state != SOCKET_CONNECTED)
@@ -731,6 +762,10 @@ static int32_t wifi_socket_bind(struct wifi_desc *desc, uint32_t sock_id,
 	if (desc->sockets[sock_id].state == SOCKET_UNUSED)
 		return -ENODEV;
 
+	/* The module can't be a server in single connection mode */
+	if (desc->passthrough)
+		return -EPERM;
+
 	/* Configure current socket as server */
 	desc->server.id = sock_id;
 	desc->server.port = port;
@@ -817,6 +852,9 @@ static int32_t wifi_socket_accept(struct wifi_desc *desc, uint32_t sock_id,
 	if (desc->sockets[desc->server.id].state != SOCKET_LISTENING)
 		return -ENOTCONN;
 
+	/* New connections are reported while processing the received data */
+	at_process(desc->at);
+
 	for (i = 0; i < NB_SOCKETS; i++)
 		if (desc->sockets[i].state == SOCKET_WAITING_ACCEPT) {
 			desc->sockets[i].state = SOCKET_CONNECTED;
@@ -69,6 +69,12 @@ struct wifi_init_param {
 	void			*uart_irq_conf;
 	/** ESP8266 Software reset enable */
 	bool			sw_reset_en;
+	/**
+	 * Use the passthrough mode of the module for the best throughput.
+	 * Only one TCP client socket can be connected and no server can be
+	 * used.
+	 */
+	bool			passthrough;
 };
 
 /******************************************************************************/
@@ -16,6 +16,7 @@ INCS +=	$(INCLUDE)/no_os_uart.h \
 	$(INCLUDE)/no_os_alloc.h \
 	$(INCLUDE)/no_os_mutex.h \
 	$(INCLUDE)/no_os_dma.h \
+	$(INCLUDE)/no_os_crc16.h \
 
 SRCS += $(DRIVERS)/api/no_os_spi.c \
 	$(DRIVERS)/api/no_os_gpio.c \
@@ -29,6 +30,7 @@ SRCS += $(DRIVERS)/api/no_os_spi.c \
 	$(NO-OS)/util/no_os_util.c \
 	$(NO-OS)/util/no_os_alloc.c \
 	$(NO-OS)/util/no_os_mutex.c \
+	$(NO-OS)/util/no_os_crc16.c \
 	$(DRIVERS)/afe/ad5940/bia_measurement.c \
 	$(DRIVERS)/afe/ad5940/ad5940.c
 
@@ -40,6 +40,8 @@
 #include "no_os_uart.h"
 #include "no_os_spi.h"
 #include "no_os_gpio.h"
+#include "no_os_util.h"
+#include "no_os_crc16.h"
 #include "bia_measurement.h"
 #include "mux_board.h"
 #include "app.h"
@@ -48,6 +50,21 @@
 extern struct no_os_uart_desc *uart;
 
 #define APPBUFF_SIZE 100
+
+/* Binary result record: sync, type, sequence, payload length, payload and
+ * CRC16 (CCITT polynomial, 0xFFFF seed) over everything before it. All
+ * multi-byte fields are little endian. */
+#define BIN_RECORD_SYNC		0xA5
+#define BIN_RECORD_HDR_SIZE	4
+#define BIN_RECORD_MAX_PAYLOAD	(4 * sizeof(uint32_t))
+#define BIN_RECORD_CRC16_POLY	0x1021
+#define BIN_RECORD_CRC16_SEED	0xFFFF
+#define BIN_RECORD_VOLTAGE	'V' // Voltage DFT real, imaginary
+#define BIN_RECORD_IMPEDANCE	'Z' // Voltage DFT, then current DFT
+#define BIN_RECORD_RTIA		'R' // Calibrated RTIA real, imaginary (float)
+
+NO_OS_DECLARE_CRC16_TABLE(bin_record_crc16);
+static uint8_t bin_record_seq;
 uint32_t AppBuff[APPBUFF_SIZE];
 struct electrode_combo swComboSeq[256]; // TODO review when nElCount is 32
 
@@ -134,6 +151,17 @@ void ParseResultMode(struct measurement_config *pMeasCfg)
 				pMeasCfg->bMagnitudeMode = true;
 		}
 	}
+
+	cmd_ptr = strtok(NULL, ",");
+	pMeasCfg->bBinaryMode = false;
+	if (cmd_ptr) { // If parameter exists read it
+		strcpy(hex_string_byte_param, cmd_ptr);
+		cmd_ok = sscanf(hex_string_byte_param, "%c", &cTmp);
+		if (cmd_ok) {
+			if (cTmp == 'B')
+				pMeasCfg->bBinaryMode = true;
+		}
+	}
 }
 
 int32_t ParseConfig(char  *pStr,
@@ -252,13 +280,57 @@ void SendResultIeee754(float *data, uint32_t DataCount)
 	printf("%lx", pVal[i]);
 }
 
-void SendResult(uint32_t *pData, uint16_t len,
-		bool bImpedanceReadMode, bool bMagnitudeMode)
+void SendResultBinary(uint8_t type, uint32_t *pData, uint16_t len)
+{
+	uint8_t rec[BIN_RECORD_HDR_SIZE + BIN_RECORD_MAX_PAYLOAD + 2];
+	uint16_t crc;
+	uint32_t i;
+	uint32_t n = 0;
+
+	if (len * sizeof(uint32_t) > BIN_RECORD_MAX_PAYLOAD)
+		return;
+
+	rec[n++] = BIN_RECORD_SYNC;
+	rec[n++] = type;
+	rec[n++] = bin_record_seq++;
+	rec[n++] = len * sizeof(uint32_t);
+	for (i = 0; i < len; i++, n += sizeof(uint32_t))
+		no_os_put_unaligned_le32(pData[i], &rec[n]);
+
+	crc = no_os_crc16(bin_record_crc16, rec, n, BIN_RECORD_CRC16_SEED);
+	no_os_put_unaligned_le16(crc, &rec[n]);
+	n += 2;
+
+	// Text written through stdio so far must go out first.
+	fflush(stdout);
+	no_os_uart_write(uart, rec, n);
+}
+
+/* The host needs the calibrated RTIA to turn the raw DFT into impedance. */
+void SendRtiaBinary(void)
+{
+	AppBiaCfg_Type *pBiaCfg;
+	uint32_t rtia[2];
+
+	AppBiaGetCfg(&pBiaCfg);
+	memcpy(rtia, pBiaCfg->RtiaCurrValue, sizeof(rtia));
+	SendResultBinary(BIN_RECORD_RTIA, rtia, 2);
+}
+
+void SendResult(uint32_t *pData, uint16_t len, bool bImpedanceReadMode,
+		bool bMagnitudeMode, bool bBinaryMode)
 {
 	float fMagVal = 0;
 	fImpCar_Type fCarZval;
 	iImpCar_Type iCarVval;
 	signExtend18To32(pData, len);
+	if (bBinaryMode) { // Raw DFT results, converted on the host side
+		if (bImpedanceReadMode && (len == 4))
+			SendResultBinary(BIN_RECORD_IMPEDANCE, pData, 4);
+		else if ((!bImpedanceReadMode) && (len == 2))
+			SendResultBinary(BIN_RECORD_VOLTAGE, pData, 2);
+		return;
+	}
 	if (bImpedanceReadMode && (len == 4)) { // Send Impedance
 		fCarZval = computeImpedance(pData);
 		if (bMagnitudeMode) { // Complex to Magnitude
@@ -372,12 +444,14 @@ int app_main(struct no_os_i2c_desc *i2c, struct ad5940_init_param *ad5940_ip)
 		return ret;
 
 	AD5940BiaStructInit(); /* Configure your parameters in this function */
+	no_os_crc16_populate_msb(bin_record_crc16, BIN_RECORD_CRC16_POLY);
 
 	oldMeasCfg.bImpedanceReadMode = true;
 	oldMeasCfg.bMagnitudeMode = false;
 	oldMeasCfg.nFrequency = 10;	// default 10 Khz Excitation
 	oldMeasCfg.nAmplitudePP = 300; // default 300mV peak to peak excitation
 	oldMeasCfg.bSweepEn = false;
+	oldMeasCfg.bBinaryMode = false;
 
 	oldElCfg.F_plus = 0;
 	oldElCfg.F_minus = 3;
@@ -446,6 +520,8 @@ int app_main(struct no_os_i2c_desc *i2c, struct ad5940_init_param *ad5940_ip)
 						AppBiaInit(ad5940, AppBuff, APPBUFF_SIZE);
 						no_os_udelay(10);
 						printf("%s","!Q ");
+						if (newMeasCfg.bBinaryMode)
+							SendRtiaBinary();
 						setMuxSwitch(i2c, ad5940, newElCfg, MUXBOARD_SIZE);
 						no_os_udelay(3);
 						AppBiaCtrl(ad5940, BIACTRL_START, 0);
@@ -493,6 +569,8 @@ int app_main(struct no_os_i2c_desc *i2c, struct ad5940_init_param *ad5940_ip)
 						no_os_udelay(10);
 						AppBiaCtrl(ad5940, BIACTRL_START, 0);
 						printf("%s","!V ");
+						if (newMeasCfg.bBinaryMode)
+							SendRtiaBinary();
 					} else
 						printf("%s","!Send C Command first to configure!\n");
 				}
@@ -514,14 +592,14 @@ int app_main(struct no_os_i2c_desc *i2c, struct ad5940_init_param *ad5940_ip)
 				//If Q command is being ran return result
 				if (runningCmd == 'Q') {
 					SendResult(AppBuff, temp, newMeasCfg.bImpedanceReadMode,
-						   newMeasCfg.bMagnitudeMode);
+						   newMeasCfg.bMagnitudeMode, newMeasCfg.bBinaryMode);
 					putchar('\n');
 					runningCmd = 0;
 				}
 				//If V or Z command is being ran and this is the last set of ADC, send a terminator character
 				if ((runningCmd == 'V') && switchSeqNum >= switchSeqCnt) {
 					SendResult(AppBuff, temp, newMeasCfg.bImpedanceReadMode,
-						   newMeasCfg.bMagnitudeMode);
+						   newMeasCfg.bMagnitudeMode, newMeasCfg.bBinaryMode);
 					putchar('\n');;
 					runningCmd = 0;
 				}
@@ -529,8 +607,10 @@ int app_main(struct no_os_i2c_desc *i2c, struct ad5940_init_param *ad5940_ip)
 				//if V is still running and switch combinations are not exhausted, restart AFE Seq with new switch combo
 				if ((runningCmd == 'V') && switchSeqNum < switchSeqCnt) {
 					SendResult(AppBuff, temp, newMeasCfg.bImpedanceReadMode,
-						   newMeasCfg.bMagnitudeMode);
-					putchar(',');
+						   newMeasCfg.bMagnitudeMode, newMeasCfg.bBinaryMode);
+					// Binary records are self delimiting
+					if (!newMeasCfg.bBinaryMode)
+						putchar(',');
 					setMuxSwitch(i2c, ad5940, swComboSeq[switchSeqNum++], newEitCfg.nElectrodeCnt);
 					no_os_udelay(3);
 					AppBiaCtrl(ad5940, BIACTRL_START, 0);
@@ -53,6 +53,9 @@ struct measurement_config {
 	bool bImpedanceReadMode; // If true, it will measure Impedance
 	// otherwise, it will measure Voltage.
 	bool bSweepEn;			 // Enable Sweep Frequency
+	bool bBinaryMode;		 // If true, will return raw DFT
+	// results as binary framed records
+	// otherwise, will return hex strings
 };
 
 extern volatile uint32_t
@@ -74,6 +74,7 @@ int iio_example_main()
 	struct iio_app_init_param app_init_param = { 0 };
 
 	adxl355_iio_ip.adxl355_dev_init = &adxl355_ip;
+	adxl355_iio_ip.fifo_watermark = 0;
 	ret = adxl355_iio_init(&adxl355_iio_desc, &adxl355_iio_ip);
 	if (ret)
 		return ret;
@@ -75,6 +75,7 @@ int iio_trigger_example_main()
 
 	/* Initialize IIO device */
 	adxl355_iio_ip.adxl355_dev_init = &adxl355_ip;
+	adxl355_iio_ip.fifo_watermark = 0;
 	ret = adxl355_iio_init(&adxl355_iio_desc, &adxl355_iio_ip);
 	if (ret)
 		return ret;
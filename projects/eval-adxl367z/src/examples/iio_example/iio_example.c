@@ -69,6 +69,7 @@ int iio_example_main()
 	};
 
 	adxl367_iio_ip.adxl367_initial_param = &init_param;
+	adxl367_iio_ip.fifo_watermark = 0;
 	ret = adxl367_iio_init(&adxl367_iio_desc, &adxl367_iio_ip);
 	if (ret)
 		return ret;
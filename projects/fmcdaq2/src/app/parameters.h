@@ -42,6 +42,8 @@
 #endif
 
 #define UART_BAUDRATE                           115200
+/* ADC DMA blocks kept in flight while an IIO client reads the buffer */
+#define RX_DMA_BLOCKS				4
 #ifndef ALTERA_PLATFORM
 #ifdef PLATFORM_MB
 #define SPI_DEVICE_ID				XPAR_SPI_0_DEVICE_ID
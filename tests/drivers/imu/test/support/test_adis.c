@@ -45,6 +45,8 @@
 #include "mock_no_os_spi.h"
 #include "mock_no_os_alloc.h"
 #include <errno.h>
+#include <stdlib.h>
+#include <string.h>
 
 /*******************************************************************************
  *    PRIVATE DATA
@@ -3972,6 +3974,339 @@ void test_adis_read_burst_data_6(void)
 	TEST_ASSERT_EQUAL_INT(-EINVAL, retval);
 }
 
+/**
+ * @brief Test adis_reg_batch with invalid read size.
+ */
+void test_adis_reg_batch_1(void)
+{
+	struct adis_reg_op ops[] = {
+		{ .reg = 0x10, .size = ADIS_1_BYTE_SIZE, .write = false },
+	};
+	device_alloc.info = adis_chip_info;
+
+	retval = adis_reg_batch(&device_alloc, ops, NO_OS_ARRAY_SIZE(ops));
+	TEST_ASSERT_EQUAL_INT(-EINVAL, retval);
+}
+
+/**
+ * @brief Test adis_reg_batch with unsuccessful memory allocation.
+ */
+void test_adis_reg_batch_2(void)
+{
+	struct adis_reg_op ops[] = {
+		{ .reg = 0x10, .size = ADIS_2_BYTES_SIZE, .write = false },
+		{ .reg = 0x12, .size = ADIS_4_BYTES_SIZE, .write = false },
+	};
+	device_alloc.info = adis_chip_info;
+
+	no_os_calloc_IgnoreAndReturn(NULL);
+	retval = adis_reg_batch(&device_alloc, ops, NO_OS_ARRAY_SIZE(ops));
+	TEST_ASSERT_EQUAL_INT(-ENOMEM, retval);
+}
+
+/**
+ * @brief Test adis_diag_snapshot with unsuccessful SPI transfer.
+ */
+void test_adis_diag_snapshot_1(void)
+{
+	device_alloc.info = adis_chip_info;
+
+	no_os_spi_transfer_IgnoreAndReturn(-1);
+	retval = adis_diag_snapshot(&device_alloc);
+	TEST_ASSERT_EQUAL_INT(-1, retval);
+	TEST_ASSERT_FALSE(device_alloc.diag_snapshot);
+}
+
+/**
+ * @brief Test adis_read_diag_* being served from a snapshot, without any
+ * SPI transfer.
+ */
+void test_adis_diag_snapshot_2(void)
+{
+	uint32_t res;
+	device_alloc.info = adis_chip_info;
+
+	device_alloc.diag_snapshot = true;
+	device_alloc.diag_flags.clk_err = 1;
+	retval = adis_read_diag_clk_err(&device_alloc, &res);
+	TEST_ASSERT_EQUAL_INT(0, retval);
+	TEST_ASSERT_EQUAL_INT(1, res);
+	adis_diag_snapshot_release(&device_alloc);
+	TEST_ASSERT_FALSE(device_alloc.diag_snapshot);
+}
+
+static void *test_adis_calloc(size_t nitems, size_t size, int cmock_num_calls)
+{
+	return calloc(nitems, size);
+}
+
+static void test_adis_free(void *ptr, int cmock_num_calls)
+{
+	free(ptr);
+}
+
+static uint16_t test_adis_get_unaligned_be16(uint8_t *buf, int cmock_num_calls)
+{
+	return (buf[0] << 8) | buf[1];
+}
+
+static uint32_t test_adis_field_get(uint32_t mask, uint32_t word,
+				    int cmock_num_calls)
+{
+	if (!mask)
+		return 0;
+
+	return (word & mask) / (mask & ~(mask - 1));
+}
+
+/**
+ * @brief Chained register batch transfer callback. Checks the frames built
+ * for the accesses of test_adis_reg_batch_3() and answers each read request
+ * in the following frame.
+ */
+static int32_t test_adis_reg_batch_transfer(struct no_os_spi_desc *desc,
+		struct no_os_spi_msg *msgs, uint32_t len, int cmock_num_calls)
+{
+	const uint8_t tx[][2] = {
+		/* Page 0: 16-bit read of 0x0E, then 32-bit read of 0x10 */
+		{ADIS_READ_REG(0x0E), 0x00},
+		{ADIS_READ_REG(0x12), 0x00},
+		{ADIS_READ_REG(0x10), 0x00},
+		/* Page 1: 16-bit write of 0x86, then 16-bit read of 0x84 */
+		{ADIS_WRITE_REG(ADIS_REG_PAGE_ID), 0x01},
+		{ADIS_WRITE_REG(0x86), 0xEF},
+		{ADIS_WRITE_REG(0x87), 0xBE},
+		{ADIS_READ_REG(0x84), 0x00},
+		/* Trailing frame */
+		{0x00, 0x00},
+	};
+	const uint8_t rx[][2] = {
+		{0xFF, 0xFF},
+		{0x12, 0x34},
+		{0xA5, 0xA5},
+		{0x5A, 0x5A},
+		{0xFF, 0xFF},
+		{0xFF, 0xFF},
+		{0xFF, 0xFF},
+		{0xCA, 0xFE},
+	};
+	uint32_t i;
+
+	TEST_ASSERT_EQUAL_INT(NO_OS_ARRAY_SIZE(tx), len);
+	for (i = 0; i < len; i++) {
+		TEST_ASSERT_EQUAL_INT(2, msgs[i].bytes_number);
+		TEST_ASSERT_EQUAL_HEX8_ARRAY(tx[i], msgs[i].tx_buff, 2);
+		TEST_ASSERT_EQUAL_INT(1, msgs[i].cs_change);
+		TEST_ASSERT_EQUAL_INT(i == len - 1 ? 0 : adis_chip_info->cs_change_delay,
+				      msgs[i].cs_change_delay);
+		TEST_ASSERT_EQUAL_INT(tx[i][0] & NO_OS_BIT(7) ? adis_chip_info->write_delay :
+				      adis_chip_info->read_delay, msgs[i].cs_delay_last);
+	}
+
+	for (i = 0; i < len; i++)
+		memcpy(msgs[i].rx_buff, rx[i], 2);
+
+	return 0;
+}
+
+/**
+ * @brief Test adis_reg_batch with accesses on two pages: accesses are grouped
+ * by page, PAGE_ID is written once and read values are taken from the frame
+ * following each read request.
+ */
+void test_adis_reg_batch_3(void)
+{
+	struct adis_reg_op ops[] = {
+		{ .reg = 0x0E, .size = ADIS_2_BYTES_SIZE, .write = false },
+		{ .reg = 0x86, .size = ADIS_2_BYTES_SIZE, .write = true, .val = 0xBEEF },
+		{ .reg = 0x10, .size = ADIS_4_BYTES_SIZE, .write = false },
+		{ .reg = 0x84, .size = ADIS_2_BYTES_SIZE, .write = false },
+	};
+	device_alloc.info = adis_chip_info;
+	device_alloc.is_locked = false;
+	device_alloc.current_page = 0;
+
+	no_os_calloc_StubWithCallback(test_adis_calloc);
+	no_os_free_StubWithCallback(test_adis_free);
+	no_os_get_unaligned_be16_StubWithCallback(test_adis_get_unaligned_be16);
+	no_os_spi_transfer_StubWithCallback(test_adis_reg_batch_transfer);
+	retval = adis_reg_batch(&device_alloc, ops, NO_OS_ARRAY_SIZE(ops));
+	TEST_ASSERT_EQUAL_INT(0, retval);
+	TEST_ASSERT_EQUAL_HEX32(0x1234, ops[0].val);
+	TEST_ASSERT_EQUAL_HEX32(0xBEEF, ops[1].val);
+	TEST_ASSERT_EQUAL_HEX32(0xA5A55A5A, ops[2].val);
+	TEST_ASSERT_EQUAL_HEX32(0xCAFE, ops[3].val);
+	TEST_ASSERT_EQUAL_INT(1, device_alloc.current_page);
+}
+
+static int test_adis_diag_snapshot_transfers;
+
+static int32_t test_adis_diag_snapshot_transfer(struct no_os_spi_desc *desc,
+		struct no_os_spi_msg *msgs, uint32_t len, int cmock_num_calls)
+{
+	test_adis_diag_snapshot_transfers++;
+
+	return 0;
+}
+
+/**
+ * @brief Test adis_diag_snapshot with a successful DIAG_STAT read: all the
+ * adis_read_diag_*() accessors are decoded from the single read until the
+ * snapshot is released.
+ */
+void test_adis_diag_snapshot_3(void)
+{
+	const struct adis_data_field_map_def *field_map =
+			adis_chip_info->field_map;
+	uint32_t res;
+	device_alloc.info = adis_chip_info;
+	device_alloc.current_page = field_map->diag_stat.reg_addr / ADIS_PAGE_SIZE;
+	test_adis_diag_snapshot_transfers = 0;
+
+	no_os_spi_transfer_StubWithCallback(test_adis_diag_snapshot_transfer);
+	no_os_get_unaligned_be16_IgnoreAndReturn(field_map->diag_clk_err_mask |
+			field_map->diag_spi_comm_err_mask);
+	no_os_field_get_StubWithCallback(test_adis_field_get);
+	retval = adis_diag_snapshot(&device_alloc);
+	TEST_ASSERT_EQUAL_INT(0, retval);
+	TEST_ASSERT_TRUE(device_alloc.diag_snapshot);
+	TEST_ASSERT_EQUAL_INT(1, test_adis_diag_snapshot_transfers);
+
+	retval = adis_read_diag_clk_err(&device_alloc, &res);
+	TEST_ASSERT_EQUAL_INT(0, retval);
+	TEST_ASSERT_EQUAL_INT(1, res);
+	retval = adis_read_diag_spi_comm_err(&device_alloc, &res);
+	TEST_ASSERT_EQUAL_INT(0, retval);
+	TEST_ASSERT_EQUAL_INT(1, res);
+	retval = adis_read_diag_data_path_overrun(&device_alloc, &res);
+	TEST_ASSERT_EQUAL_INT(0, retval);
+	TEST_ASSERT_EQUAL_INT(0, res);
+	TEST_ASSERT_EQUAL_INT(1, test_adis_diag_snapshot_transfers);
+
+	adis_diag_snapshot_release(&device_alloc);
+	retval = adis_read_diag_clk_err(&device_alloc, &res);
+	TEST_ASSERT_EQUAL_INT(0, retval);
+	TEST_ASSERT_EQUAL_INT(2, test_adis_diag_snapshot_transfers);
+}
+
+/**
+ * @brief Test adis_read_burst_fifo with unsuccessful SPI transfer.
+ */
+void test_adis_read_burst_fifo_1(void)
+{
+	device_alloc.info = adis_chip_info;
+	struct adis_burst_data data[ADIS_MAX_FIFO_BURST_SAMPLES];
+	uint16_t nb_read;
+
+	device_alloc.burst32 = 0;
+	device_alloc.burst_sel = 0;
+
+	no_os_spi_transfer_IgnoreAndReturn(-1);
+	retval = adis_read_burst_fifo(&device_alloc, data, ADIS_MAX_FIFO_BURST_SAMPLES,
+				      device_alloc.burst32, device_alloc.burst_sel, true, &nb_read);
+	TEST_ASSERT_EQUAL_INT(-1, retval);
+	TEST_ASSERT_EQUAL_INT(0, nb_read);
+}
+
+/**
+ * @brief Test adis_read_burst_fifo with too many requested samples.
+ */
+void test_adis_read_burst_fifo_2(void)
+{
+	device_alloc.info = adis_chip_info;
+	struct adis_burst_data data[ADIS_MAX_FIFO_BURST_SAMPLES];
+	uint16_t nb_read;
+
+	device_alloc.burst32 = 0;
+	device_alloc.burst_sel = 0;
+
+	retval = adis_read_burst_fifo(&device_alloc, data,
+				      ADIS_MAX_FIFO_BURST_SAMPLES + 1,
+				      device_alloc.burst32, device_alloc.burst_sel, true, &nb_read);
+	TEST_ASSERT_EQUAL_INT(-EINVAL, retval);
+}
+
+/**
+ * @brief Test adis_read_burst_fifo on a device without FIFO.
+ */
+void test_adis_read_burst_fifo_3(void)
+{
+	device_alloc.info = adis_chip_info;
+	struct adis_burst_data data[ADIS_MAX_FIFO_BURST_SAMPLES];
+	uint16_t nb_read;
+
+	retval = adis_read_burst_fifo(&device_alloc, data, ADIS_MAX_FIFO_BURST_SAMPLES,
+				      false, 0, true, &nb_read);
+	TEST_ASSERT_EQUAL_INT(-ENOSYS, retval);
+}
+
+/**
+ * @brief Chained FIFO transfer callback: the first frame returns stale output
+ * registers, the second one a FIFO entry, the third one an empty FIFO entry
+ * and the last, non popping, frame returns the entry popped by the third one.
+ */
+static int32_t test_adis_read_burst_fifo_transfer(struct no_os_spi_desc *desc,
+		struct no_os_spi_msg *msgs, uint32_t len, int cmock_num_calls)
+{
+	static const uint8_t stale[] = {0xAA, 0xAA, 0xAA, 0xAA};
+	static const uint8_t entry_1[] = {0x12, 0x34, 0x56, 0x78};
+	static const uint8_t entry_2[] = {0x9A, 0xBC, 0xDE, 0xF0};
+
+	TEST_ASSERT_EQUAL_INT(4, len);
+	TEST_ASSERT_EQUAL_HEX8(ADIS_READ_BURST_DATA_CMD_MSB, msgs[0].tx_buff[0]);
+	TEST_ASSERT_EQUAL_HEX8(ADIS_READ_BURST_DATA_CMD_MSB, msgs[2].tx_buff[0]);
+	TEST_ASSERT_EQUAL_HEX8(0x00, msgs[3].tx_buff[0]);
+	TEST_ASSERT_EQUAL_INT(1, msgs[0].cs_change);
+
+	/* x_gyro_msb and y_gyro_msb follow the command and the diag word */
+	memcpy(&msgs[0].rx_buff[4], stale, sizeof(stale));
+	memcpy(&msgs[1].rx_buff[4], entry_1, sizeof(entry_1));
+	memcpy(&msgs[3].rx_buff[4], entry_2, sizeof(entry_2));
+
+	return 0;
+}
+
+/**
+ * @brief Test adis_read_burst_fifo with a successful chained transfer, stale
+ * and empty frames are dropped and FIFO entries are decoded in order.
+ */
+void test_adis_read_burst_fifo_4(void)
+{
+	device_alloc.info = adis_chip_info;
+	struct adis_burst_data data[ADIS_MAX_FIFO_BURST_SAMPLES];
+	static const uint8_t entry_1[] = {0x12, 0x34, 0x56, 0x78};
+	static const uint8_t entry_2[] = {0x9A, 0xBC, 0xDE, 0xF0};
+	uint16_t nb_read;
+
+	device_alloc.burst32 = 0;
+	device_alloc.burst_sel = 0;
+
+	memset(data, 0xFF, sizeof(data));
+	no_os_spi_transfer_StubWithCallback(test_adis_read_burst_fifo_transfer);
+	no_os_get_unaligned_be16_IgnoreAndReturn(7);
+	no_os_field_get_IgnoreAndReturn(0);
+	retval = adis_read_burst_fifo(&device_alloc, data, 3, device_alloc.burst32,
+				      device_alloc.burst_sel, false, &nb_read);
+	TEST_ASSERT_EQUAL_INT(0, retval);
+	TEST_ASSERT_EQUAL_INT(2, nb_read);
+
+	TEST_ASSERT_EQUAL_MEMORY(&entry_1[0], &data[0].x_gyro_msb, 2);
+	TEST_ASSERT_EQUAL_MEMORY(&entry_1[2], &data[0].y_gyro_msb, 2);
+	TEST_ASSERT_EQUAL_HEX16(0, data[0].x_gyro_lsb);
+	TEST_ASSERT_EQUAL_HEX16(0, data[0].z_gyro_msb);
+	TEST_ASSERT_EQUAL_HEX16(0, data[0].temp_msb);
+	TEST_ASSERT_EQUAL_HEX16(7, data[0].data_cntr_lsb);
+
+	TEST_ASSERT_EQUAL_MEMORY(&entry_2[0], &data[1].x_gyro_msb, 2);
+	TEST_ASSERT_EQUAL_MEMORY(&entry_2[2], &data[1].y_gyro_msb, 2);
+	TEST_ASSERT_EQUAL_HEX16(0, data[1].x_gyro_lsb);
+	TEST_ASSERT_EQUAL_HEX16(0, data[1].z_gyro_msb);
+
+	/* Entries past nb_read are left untouched */
+	TEST_ASSERT_EQUAL_HEX16(0xFFFF, data[2].x_gyro_msb);
+	TEST_ASSERT_FALSE(device_alloc.diag_flags.checksum_err);
+}
+
 /**
  * @brief Test adis_update_ext_clk_freq with unsuccessful SPI read for
  * sync mode.
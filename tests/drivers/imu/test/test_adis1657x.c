@@ -797,6 +797,27 @@ void test_adis1657x_read_burst_data(void)
 	test_adis_read_burst_data_6();
 }
 
+void test_adis1657x_reg_batch(void)
+{
+	test_adis_reg_batch_1();
+	test_adis_reg_batch_2();
+	test_adis_reg_batch_3();
+}
+
+void test_adis1657x_diag_snapshot(void)
+{
+	test_adis_diag_snapshot_1();
+	test_adis_diag_snapshot_2();
+	test_adis_diag_snapshot_3();
+}
+
+void test_adis1657x_read_burst_fifo(void)
+{
+	test_adis_read_burst_fifo_1();
+	test_adis_read_burst_fifo_2();
+	test_adis_read_burst_fifo_4();
+}
+
 void test_adis1657x_update_ext_clk_freq(void)
 {
 	test_adis_update_ext_clk_freq_1();
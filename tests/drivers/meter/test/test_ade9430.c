@@ -0,0 +1,252 @@
+/***************************************************************************//**
+ *   @file   test_ade9430.c
+ *   @brief  Implementation of test_ade9430.c
+ *   @author Antoniu Miclaus (antoniu.miclaus@analog.com)
+ *******************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "unity.h"
+#include "ade9430.h"
+#include "mock_no_os_delay.h"
+#include "mock_no_os_util.h"
+#include "mock_no_os_spi.h"
+#include "mock_no_os_alloc.h"
+#include <errno.h>
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+static struct ade9430_dev dev;
+static struct no_os_spi_desc spi_desc;
+static uint8_t wfb_buff[2 + ADE9430_WFB_BURST_PAGES * ADE9430_WFB_PAGE_WORDS * 4];
+static int32_t data[ADE9430_WFB_PAGES * ADE9430_WFB_PAGE_WORDS];
+/* Last page reported in WFB_TRG_STAT */
+static uint8_t last_page;
+/* Waveform buffer pages read so far, in order */
+static uint8_t pages_read[ADE9430_WFB_PAGES];
+static uint8_t nb_pages_read;
+static int retval;
+
+/*******************************************************************************
+ *    SETUP, TEARDOWN
+ ******************************************************************************/
+
+void setUp(void)
+{
+	dev.spi_desc = &spi_desc;
+	dev.wfb_cap = ADE9430_WFB_FIXED_RATE;
+	dev.wfb_buff = wfb_buff;
+	nb_pages_read = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *    HELPERS
+ ******************************************************************************/
+
+static uint16_t test_ade9430_get_unaligned_be16(uint8_t *buf,
+		int cmock_num_calls)
+{
+	return (buf[0] << 8) | buf[1];
+}
+
+static uint32_t test_ade9430_get_unaligned_be32(uint8_t *buf,
+		int cmock_num_calls)
+{
+	return (buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
+}
+
+static void test_ade9430_put_unaligned_be32(uint32_t val, uint8_t *buf,
+		int cmock_num_calls)
+{
+	buf[0] = val >> 24;
+	buf[1] = val >> 16;
+	buf[2] = val >> 8;
+	buf[3] = val;
+}
+
+static uint32_t test_ade9430_field_get(uint32_t mask, uint32_t word,
+				       int cmock_num_calls)
+{
+	if (!mask)
+		return 0;
+
+	return (word & mask) / (mask & ~(mask - 1));
+}
+
+/**
+ * @brief SPI transfer callback. Reports a pending PAGE_FULL with last_page in
+ * WFB_TRG_STAT and fills each waveform buffer sample with its page and word
+ * index.
+ */
+static int32_t test_ade9430_transfer(struct no_os_spi_desc *desc,
+				     uint8_t *buff, uint16_t len,
+				     int cmock_num_calls)
+{
+	uint16_t addr = (buff[0] << 4) | (buff[1] >> 4);
+	uint32_t i, page, nb_words;
+
+	if (!(buff[1] & ADE9430_SPI_READ))
+		return 0;
+
+	if (addr == ADE9430_REG_STATUS0) {
+		test_ade9430_put_unaligned_be32(ADE9430_STATUS0_PAGE_FULL, &buff[2], 0);
+	} else if (addr == ADE9430_REG_WFB_TRG_STAT) {
+		/* 16-bit register */
+		TEST_ASSERT_EQUAL_INT(4, len);
+		buff[2] = last_page << 4;
+		buff[3] = 0;
+	} else if (addr >= ADE9430_WFB_ADDR) {
+		page = (addr - ADE9430_WFB_ADDR) / ADE9430_WFB_PAGE_WORDS;
+		nb_words = (len - 2) / 4;
+		TEST_ASSERT_EQUAL_INT(0, nb_words % ADE9430_WFB_PAGE_WORDS);
+		TEST_ASSERT_TRUE(page + nb_words / ADE9430_WFB_PAGE_WORDS <=
+				 ADE9430_WFB_PAGES);
+
+		for (i = 0; i < nb_words; i++)
+			test_ade9430_put_unaligned_be32(page * ADE9430_WFB_PAGE_WORDS + i,
+							&buff[2 + i * 4], 0);
+
+		for (i = 0; i < nb_words / ADE9430_WFB_PAGE_WORDS; i++)
+			pages_read[nb_pages_read++] = page + i;
+	}
+
+	return 0;
+}
+
+static void test_ade9430_stub_transfer(void)
+{
+	no_os_spi_write_and_read_StubWithCallback(test_ade9430_transfer);
+	no_os_get_unaligned_be16_StubWithCallback(test_ade9430_get_unaligned_be16);
+	no_os_get_unaligned_be32_StubWithCallback(test_ade9430_get_unaligned_be32);
+	no_os_put_unaligned_be32_StubWithCallback(test_ade9430_put_unaligned_be32);
+	no_os_field_get_StubWithCallback(test_ade9430_field_get);
+}
+
+/**
+ * @brief Check that data holds the pages from first on, in ring order.
+ */
+static void test_ade9430_check_pages(uint8_t first, uint8_t nb_pages)
+{
+	uint32_t i, page;
+
+	TEST_ASSERT_EQUAL_INT(nb_pages, nb_pages_read);
+	for (i = 0; i < nb_pages; i++) {
+		page = (first + i) % ADE9430_WFB_PAGES;
+		TEST_ASSERT_EQUAL_INT(page, pages_read[i]);
+		TEST_ASSERT_EQUAL_INT(page * ADE9430_WFB_PAGE_WORDS,
+				      data[i * ADE9430_WFB_PAGE_WORDS]);
+		TEST_ASSERT_EQUAL_INT(page * ADE9430_WFB_PAGE_WORDS +
+				      ADE9430_WFB_PAGE_WORDS - 1,
+				      data[(i + 1) * ADE9430_WFB_PAGE_WORDS - 1]);
+	}
+}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+
+/**
+ * @brief Test ade9430_wfb_drain with invalid parameters.
+ */
+void test_ade9430_wfb_drain_1(void)
+{
+	uint8_t nb_pages;
+
+	retval = ade9430_wfb_drain(NULL, data, &nb_pages);
+	TEST_ASSERT_EQUAL_INT(-EINVAL, retval);
+	retval = ade9430_wfb_drain(&dev, NULL, &nb_pages);
+	TEST_ASSERT_EQUAL_INT(-EINVAL, retval);
+	retval = ade9430_wfb_drain(&dev, data, NULL);
+	TEST_ASSERT_EQUAL_INT(-EINVAL, retval);
+}
+
+/**
+ * @brief Test ade9430_wfb_drain without wrapping: pages 0..7 are read.
+ */
+void test_ade9430_wfb_drain_2(void)
+{
+	uint8_t nb_pages;
+
+	test_ade9430_stub_transfer();
+	dev.wfb_page = 0;
+	last_page = 7;
+
+	retval = ade9430_wfb_drain(&dev, data, &nb_pages);
+	TEST_ASSERT_EQUAL_INT(0, retval);
+	TEST_ASSERT_EQUAL_INT(8, nb_pages);
+	TEST_ASSERT_EQUAL_INT(8, dev.wfb_page);
+	test_ade9430_check_pages(0, 8);
+}
+
+/**
+ * @brief Test ade9430_wfb_drain when the filled pages wrap around the end of
+ * the buffer: pages 12..15 and then 0..3 are read.
+ */
+void test_ade9430_wfb_drain_3(void)
+{
+	uint8_t nb_pages;
+
+	test_ade9430_stub_transfer();
+	dev.wfb_page = 12;
+	last_page = 3;
+
+	retval = ade9430_wfb_drain(&dev, data, &nb_pages);
+	TEST_ASSERT_EQUAL_INT(0, retval);
+	TEST_ASSERT_EQUAL_INT(8, nb_pages);
+	TEST_ASSERT_EQUAL_INT(4, dev.wfb_page);
+	test_ade9430_check_pages(12, 8);
+}
+
+/**
+ * @brief Test ade9430_wfb_drain when the whole buffer was filled since the
+ * previous drain, starting in the middle of it.
+ */
+void test_ade9430_wfb_drain_4(void)
+{
+	uint8_t nb_pages;
+
+	test_ade9430_stub_transfer();
+	dev.wfb_page = 12;
+	last_page = 11;
+
+	retval = ade9430_wfb_drain(&dev, data, &nb_pages);
+	TEST_ASSERT_EQUAL_INT(0, retval);
+	TEST_ASSERT_EQUAL_INT(ADE9430_WFB_PAGES, nb_pages);
+	TEST_ASSERT_EQUAL_INT(12, dev.wfb_page);
+	test_ade9430_check_pages(12, ADE9430_WFB_PAGES);
+}
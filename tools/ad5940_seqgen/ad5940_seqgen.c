@@ -0,0 +1,346 @@
+/***************************************************************************//**
+ *   @file   ad5940_seqgen.c
+ *   @brief  Host side AD5940 sequence compiler.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+/*
+ * Runs the bia_measurement sequence generator against a model of the AD5940
+ * register file and prints the resulting sequencer image as C source. The
+ * image is loaded on target through AppBiaCfg.pSeqImage, which skips the
+ * generator and writes the whole image with one ad5940_SEQCmdWrite() burst.
+ *
+ * The model starts from the register reset values. Registers the generator
+ * reads back before modifying them therefore take their reset value, not the
+ * one the target has at that point.
+ *
+ * Usage: ad5940_seqgen [-f freq_hz] [-a amplitude_mvpp] [-v] [-n name]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "no_os_spi.h"
+#include "no_os_util.h"
+#include "ad5940.h"
+#include "bia_measurement.h"
+
+#define SEQGEN_REG_SPACE	0x4000
+#define SEQGEN_SRAM_WORDS	0x800
+#define SEQGEN_BUFF_SIZE	512
+
+struct seqgen_reg_default {
+	uint16_t addr;
+	uint32_t val;
+};
+
+/* Registers with a non zero reset value, all the others reset to 0 */
+static const struct seqgen_reg_default seqgen_reg_defaults[] = {
+	{REG_AFECON_CLKCON0, REG_AFECON_CLKCON0_RESET},
+	{REG_AFECON_CLKEN1, REG_AFECON_CLKEN1_RESET},
+	{REG_AFECON_SWRSTCON, REG_AFECON_SWRSTCON_RESET},
+	{REG_WUPTMR_SEQ0WUPL, REG_WUPTMR_SEQ0WUPL_RESET},
+	{REG_WUPTMR_SEQ0WUPH, REG_WUPTMR_SEQ0WUPH_RESET},
+	{REG_WUPTMR_SEQ0SLEEPL, REG_WUPTMR_SEQ0SLEEPL_RESET},
+	{REG_WUPTMR_SEQ0SLEEPH, REG_WUPTMR_SEQ0SLEEPH_RESET},
+	{REG_WUPTMR_SEQ1WUPL, REG_WUPTMR_SEQ1WUPL_RESET},
+	{REG_WUPTMR_SEQ1WUPH, REG_WUPTMR_SEQ1WUPH_RESET},
+	{REG_WUPTMR_SEQ1SLEEPL, REG_WUPTMR_SEQ1SLEEPL_RESET},
+	{REG_WUPTMR_SEQ1SLEEPH, REG_WUPTMR_SEQ1SLEEPH_RESET},
+	{REG_WUPTMR_SEQ2WUPL, REG_WUPTMR_SEQ2WUPL_RESET},
+	{REG_WUPTMR_SEQ2WUPH, REG_WUPTMR_SEQ2WUPH_RESET},
+	{REG_WUPTMR_SEQ2SLEEPL, REG_WUPTMR_SEQ2SLEEPL_RESET},
+	{REG_WUPTMR_SEQ2SLEEPH, REG_WUPTMR_SEQ2SLEEPH_RESET},
+	{REG_WUPTMR_SEQ3WUPL, REG_WUPTMR_SEQ3WUPL_RESET},
+	{REG_WUPTMR_SEQ3WUPH, REG_WUPTMR_SEQ3WUPH_RESET},
+	{REG_WUPTMR_SEQ3SLEEPL, REG_WUPTMR_SEQ3SLEEPL_RESET},
+	{REG_WUPTMR_SEQ3SLEEPH, REG_WUPTMR_SEQ3SLEEPH_RESET},
+	{REG_ALLON_PWRMOD, REG_ALLON_PWRMOD_RESET},
+	{REG_ALLON_OSCCON, REG_ALLON_OSCCON_RESET},
+	{REG_ALLON_EICLR, REG_ALLON_EICLR_RESET},
+	{REG_ALLON_LOSCTST, REG_ALLON_LOSCTST_RESET},
+	{REG_ALLON_CLKEN0, REG_ALLON_CLKEN0_RESET},
+	{REG_SPII2CS_PNTR1, REG_SPII2CS_PNTR1_RESET},
+	{REG_SPII2CS_PNTR2, REG_SPII2CS_PNTR2_RESET},
+	{REG_AFE_AFECON, REG_AFE_AFECON_RESET},
+	{REG_AFE_SEQCON, REG_AFE_SEQCON_RESET},
+	{REG_AFE_FIFOCON, REG_AFE_FIFOCON_RESET},
+	{REG_AFE_SWCON, REG_AFE_SWCON_RESET},
+	{REG_AFE_HSDACCON, REG_AFE_HSDACCON_RESET},
+	{REG_AFE_WGCON, REG_AFE_WGCON_RESET},
+	{REG_AFE_ADCFILTERCON, REG_AFE_ADCFILTERCON_RESET},
+	{REG_AFE_HSDACDAT, REG_AFE_HSDACDAT_RESET},
+	{REG_AFE_SEQCRC, REG_AFE_SEQCRC_RESET},
+	{REG_AFE_HPOSCCON, REG_AFE_HPOSCCON_RESET},
+	{REG_AFE_DFTCON, REG_AFE_DFTCON_RESET},
+	{REG_AFE_LPTIACON0, REG_AFE_LPTIACON0_RESET},
+	{REG_AFE_HSRTIACON, REG_AFE_HSRTIACON_RESET},
+	{REG_AFE_DE0RESCON, REG_AFE_DE0RESCON_RESET},
+	{REG_AFE_LPMODECON, REG_AFE_LPMODECON_RESET},
+	{REG_AFE_LPDACCON0, REG_AFE_LPDACCON0_RESET},
+	{REG_AFE_BUFSENCON, REG_AFE_BUFSENCON_RESET},
+	{REG_AFE_PSWSTA, REG_AFE_PSWSTA_RESET},
+	{REG_AFE_NSWSTA, REG_AFE_NSWSTA_RESET},
+	{REG_AFE_CMDDATACON, REG_AFE_CMDDATACON_RESET},
+	{REG_AFE_REPEATADCCNV, REG_AFE_REPEATADCCNV_RESET},
+	{REG_AFE_ADCGAINTEMPSENS0, REG_AFE_ADCGAINTEMPSENS0_RESET},
+	{REG_AFE_ADCGAINGN1, REG_AFE_ADCGAINGN1_RESET},
+	{REG_AFE_DACGAIN, REG_AFE_DACGAIN_RESET},
+	{REG_AFE_ADCGAINGN1P5, REG_AFE_ADCGAINGN1P5_RESET},
+	{REG_AFE_ADCGAINGN2, REG_AFE_ADCGAINGN2_RESET},
+	{REG_AFE_ADCGAINGN4, REG_AFE_ADCGAINGN4_RESET},
+	{REG_AFE_ADCGNHSTIA, REG_AFE_ADCGNHSTIA_RESET},
+	{REG_AFE_ADCGNLPTIA0, REG_AFE_ADCGNLPTIA0_RESET},
+	{REG_AFE_ADCPGAGN4OFCAL, REG_AFE_ADCPGAGN4OFCAL_RESET},
+	{REG_AFE_ADCGAINGN9, REG_AFE_ADCGAINGN9_RESET},
+	{REG_AFE_ADCGAINDIOTEMPSENS, REG_AFE_ADCGAINDIOTEMPSENS_RESET},
+	{REG_AFE_ADCGNLPTIA1, REG_AFE_ADCGNLPTIA1_RESET},
+	{REG_AFE_PMBW, REG_AFE_PMBW_RESET},
+	{REG_AFE_AFE_TEMPSEN_DIO, REG_AFE_AFE_TEMPSEN_DIO_RESET},
+	{REG_AFE_ADCBUFCON, REG_AFE_ADCBUFCON_RESET},
+	{REG_INTC_INTCSEL0, REG_INTC_INTCSEL0_RESET},
+};
+
+static uint32_t seqgen_regs[SEQGEN_REG_SPACE];
+static uint32_t seqgen_sram[SEQGEN_SRAM_WORDS];
+static uint16_t seqgen_addr;
+
+static bool seqgen_reg_is_32bit(uint16_t addr)
+{
+	return addr >= 0x1000 && addr <= 0x3014;
+}
+
+/* Apply one chip select frame to the register model */
+static int32_t seqgen_spi_frame(uint8_t *data, uint16_t len)
+{
+	uint32_t val;
+
+	if (!len)
+		return 0;
+
+	switch (data[0]) {
+	case SPICMD_SETADDR:
+		if (len < 3)
+			return -EINVAL;
+		seqgen_addr = no_os_get_unaligned_be16(&data[1]);
+		if (seqgen_addr >= SEQGEN_REG_SPACE)
+			return -EINVAL;
+		break;
+	case SPICMD_WRITEREG:
+		if (seqgen_reg_is_32bit(seqgen_addr)) {
+			if (len < 5)
+				return -EINVAL;
+			val = no_os_get_unaligned_be32(&data[1]);
+		} else {
+			if (len < 3)
+				return -EINVAL;
+			val = no_os_get_unaligned_be16(&data[1]);
+		}
+		seqgen_regs[seqgen_addr] = val;
+		if (seqgen_addr == REG_AFE_CMDFIFOWRITE)
+			seqgen_sram[seqgen_regs[REG_AFE_CMDFIFOWADDR] %
+						    SEQGEN_SRAM_WORDS] = val;
+		break;
+	case SPICMD_READREG:
+		val = seqgen_regs[seqgen_addr];
+		memset(&data[1], 0, len - 1);
+		if (seqgen_reg_is_32bit(seqgen_addr) && len >= 6)
+			no_os_put_unaligned_be32(val, &data[2]);
+		else if (len >= 4)
+			no_os_put_unaligned_be16(val, &data[2]);
+		break;
+	default:
+		/* The data FIFO of the model is always empty */
+		memset(data, 0, len);
+		break;
+	}
+
+	return 0;
+}
+
+static int32_t seqgen_spi_write_and_read(struct no_os_spi_desc *desc,
+		uint8_t *data, uint16_t bytes_number)
+{
+	return seqgen_spi_frame(data, bytes_number);
+}
+
+static int32_t seqgen_spi_transfer(struct no_os_spi_desc *desc,
+				   struct no_os_spi_msg *msgs, uint32_t len)
+{
+	uint8_t frame[64];
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < len; i++) {
+		if (msgs[i].bytes_number > sizeof(frame))
+			return -EINVAL;
+		memcpy(frame, msgs[i].tx_buff, msgs[i].bytes_number);
+		ret = seqgen_spi_frame(frame, msgs[i].bytes_number);
+		if (ret)
+			return ret;
+		if (msgs[i].rx_buff)
+			memcpy(msgs[i].rx_buff, frame, msgs[i].bytes_number);
+	}
+
+	return 0;
+}
+
+static const struct no_os_spi_platform_ops seqgen_spi_ops = {
+	.write_and_read = seqgen_spi_write_and_read,
+	.transfer = seqgen_spi_transfer,
+};
+
+/* Normally provided by the application, not used by the generator */
+uint32_t ClrMCUIntFlag(void)
+{
+	return 1;
+}
+
+static void seqgen_print_seq(const SEQInfo_Type *seq)
+{
+	uint32_t i;
+
+	printf("\t/* SEQID_%u, %u commands */\n", (unsigned)seq->SeqId,
+	       (unsigned)seq->SeqLen);
+	for (i = 0; i < seq->SeqLen; i++)
+		printf("\t0x%08X,\n",
+		       (unsigned)seqgen_sram[(seq->SeqRamAddr + i) % SEQGEN_SRAM_WORDS]);
+}
+
+static void seqgen_print_info(const char *name, const SEQInfo_Type *seq,
+			      uint32_t base)
+{
+	printf("\t{\n");
+	printf("\t\t.SeqId = SEQID_%u,\n", (unsigned)seq->SeqId);
+	printf("\t\t.SeqRamAddr = %u,\n", (unsigned)seq->SeqRamAddr);
+	printf("\t\t.SeqLen = %u,\n", (unsigned)seq->SeqLen);
+	printf("\t\t.pSeqCmd = &%s_cmd[%u],\n", name,
+	       (unsigned)(seq->SeqRamAddr - base));
+	printf("\t},\n");
+}
+
+static void seqgen_usage(const char *prog)
+{
+	fprintf(stderr,
+		"Usage: %s [-f freq_hz] [-a amplitude_mvpp] [-v] [-n name]\n"
+		"  -f  excitation frequency in Hz (default 10000)\n"
+		"  -a  excitation amplitude in mV peak to peak (default 300)\n"
+		"  -v  voltage only measurement (default impedance)\n"
+		"  -n  name of the generated image (default ad5940_bia_seq)\n",
+		prog);
+}
+
+int main(int argc, char **argv)
+{
+	static uint32_t buff[SEQGEN_BUFF_SIZE];
+	struct no_os_spibus_desc bus = {0};
+	struct no_os_spi_desc spi = {
+		.bus = &bus,
+		.platform_ops = &seqgen_spi_ops,
+	};
+	struct ad5940_dev dev = {
+		.spi = &spi,
+	};
+	const char *name = "ad5940_bia_seq";
+	AppBiaCfg_Type *pBiaCfg;
+	const SEQInfo_Type *init, *meas;
+	uint32_t i;
+	int ret;
+	int opt;
+
+	for (i = 0; i < NO_OS_ARRAY_SIZE(seqgen_reg_defaults); i++)
+		seqgen_regs[seqgen_reg_defaults[i].addr] = seqgen_reg_defaults[i].val;
+
+	/* Same defaults as the CN0565 application */
+	AppBiaGetCfg(&pBiaCfg);
+	pBiaCfg->SeqStartAddr = 0;
+	pBiaCfg->MaxSeqLen = 512;
+	pBiaCfg->RcalVal = 1000.0;
+	pBiaCfg->DftNum = DFTNUM_8192;
+	pBiaCfg->BiaODR = 20;
+	pBiaCfg->ADCSinc3Osr = ADCSINC3OSR_2;
+	pBiaCfg->DacVoltPP = 300.0;
+	pBiaCfg->SinFreq = 10000.0;
+	pBiaCfg->SweepCfg.SweepEn = false;
+	pBiaCfg->bImpedanceReadMode = true;
+
+	while ((opt = getopt(argc, argv, "f:a:vn:h")) != -1) {
+		switch (opt) {
+		case 'f':
+			pBiaCfg->SinFreq = strtof(optarg, NULL);
+			break;
+		case 'a':
+			pBiaCfg->DacVoltPP = strtof(optarg, NULL);
+			break;
+		case 'v':
+			pBiaCfg->bImpedanceReadMode = false;
+			break;
+		case 'n':
+			name = optarg;
+			break;
+		default:
+			seqgen_usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	ret = AppBiaSeqGen(&dev, buff, SEQGEN_BUFF_SIZE);
+	if (ret) {
+		fprintf(stderr, "Sequence generation failed: %d\n", ret);
+		return 1;
+	}
+
+	init = &pBiaCfg->InitSeqInfo;
+	meas = &pBiaCfg->MeasureSeqInfo;
+
+	printf("/* Generated by ad5940_seqgen: %.1f Hz, %.1f mVpp, %s mode */\n",
+	       pBiaCfg->SinFreq, pBiaCfg->DacVoltPP,
+	       pBiaCfg->bImpedanceReadMode ? "impedance" : "voltage");
+	printf("#include \"no_os_util.h\"\n");
+	printf("#include \"ad5940.h\"\n\n");
+	printf("static const uint32_t %s_cmd[] = {\n", name);
+	seqgen_print_seq(init);
+	seqgen_print_seq(meas);
+	printf("};\n\n");
+	printf("static const SEQInfo_Type %s_info[] = {\n", name);
+	seqgen_print_info(name, init, init->SeqRamAddr);
+	seqgen_print_info(name, meas, init->SeqRamAddr);
+	printf("};\n\n");
+	printf("const SEQImage_Type %s = {\n", name);
+	printf("\t.SeqRamAddr = %u,\n", (unsigned)init->SeqRamAddr);
+	printf("\t.SeqLen = %u,\n", (unsigned)(init->SeqLen + meas->SeqLen));
+	printf("\t.pSeqCmd = %s_cmd,\n", name);
+	printf("\t.SeqCnt = NO_OS_ARRAY_SIZE(%s_info),\n", name);
+	printf("\t.pSeqInfo = %s_info,\n", name);
+	printf("};\n");
+
+	return 0;
+}
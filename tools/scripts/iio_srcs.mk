@@ -12,3 +12,33 @@ ifeq (y,$(strip $(NETWORKING)))
 DISABLE_SECURE_SOCKET ?= y
 SRC_DIRS += $(NO-OS)/network
 endif
+
+ifeq (y,$(strip $(IIO_UDP_STREAM)))
+CFLAGS += -DIIO_UDP_STREAM
+ifneq (y,$(strip $(NETWORKING)))
+SRCS += $(NO-OS)/network/udp_stream.c
+INCS += $(NO-OS)/network/udp_stream.h
+endif
+endif
+
+ifeq (y,$(strip $(IIO_RECORDER)))
+SRCS += $(NO-OS)/iio/iio_recorder.c
+INCS += $(NO-OS)/iio/iio_recorder.h
+ifneq ($(if $(findstring fatfs, $(LIBRARIES)), 1),)
+CFLAGS += -DIIO_RECORDER_FATFS
+endif
+endif
+
+ifeq (y,$(strip $(IIO_UART_TRANSPORT)))
+CFLAGS += -DIIO_UART_TRANSPORT
+SRCS += $(NO-OS)/iio/iio_uart.c
+INCS += $(NO-OS)/iio/iio_uart.h
+SRCS += $(DRIVERS)/api/no_os_irq.c
+INCS += $(INCLUDE)/no_os_irq.h
+endif
+
+ifeq (y,$(strip $(IIO_THREADED)))
+CFLAGS += -DIIO_THREADED
+SRCS += $(DRIVERS)/platform/linux/linux_mutex.c
+LDFLAGS += -pthread
+endif